@@ -149,6 +149,7 @@ static const char* kSnapshotKindNames[] = {
   V(script_snapshot, script_snapshot_filename)                                 \
   V(dependencies, dependencies_filename)                                       \
   V(load_compilation_trace, load_compilation_trace_filename)                   \
+  V(load_type_feedback, load_type_feedback_filename)                           \
   V(package_root, commandline_package_root)                                    \
   V(packages, commandline_packages_file)                                       \
   V(save_obfuscation_map, obfuscation_map_filename)
@@ -246,6 +247,7 @@ static void PrintUsage() {
 "{--embedder_entry_points_manifest=<input-file>}                             \n"
 "[--obfuscate]                                                               \n"
 "[--save-obfuscation-map=<map-filename>]                                     \n"
+"[--load_type_feedback=<input-file>]                                         \n"
 " <dart-script-file>                                                         \n"
 "                                                                            \n"
 "To create an AOT application snapshot as assembly suitable for compilation  \n"
@@ -255,6 +257,7 @@ static void PrintUsage() {
 "{--embedder_entry_points_manifest=<input-file>}                             \n"
 "[--obfuscate]                                                               \n"
 "[--save-obfuscation-map=<map-filename>]                                     \n"
+"[--load_type_feedback=<input-file>]                                         \n"
 "<dart-script-file>                                                          \n"
 "                                                                            \n"
 "AOT snapshots require entry points manifest files, which list the places    \n"
@@ -274,6 +277,11 @@ static void PrintUsage() {
 "using --save-obfuscation-map=<filename> option. See dartbug.com/30524       \n"
 "for implementation details and limitations of the obfuscation pass.         \n"
 "                                                                            \n"
+"AOT compilation can be guided by the call counts and receiver classes       \n"
+"observed in a training run of the program in the JIT, saved with            \n"
+"`dart --save_type_feedback=<filename>`. Pass the saved file with            \n"
+"--load_type_feedback=<filename>.                                            \n"
+"                                                                            \n"
 "\n");
   if (verbose) {
     Log::PrintErr(
@@ -1145,6 +1153,16 @@ static void LoadCompilationTrace() {
   }
 }
 
+static void LoadTypeFeedback() {
+  if (load_type_feedback_filename != NULL) {
+    uint8_t* buffer = NULL;
+    intptr_t size = 0;
+    ReadFile(load_type_feedback_filename, &buffer, &size);
+    Dart_Handle result = Dart_LoadTypeFeedback(buffer, size);
+    CHECK_RESULT(result);
+  }
+}
+
 static void CreateAndWriteCoreSnapshot() {
   ASSERT(snapshot_kind == kCore);
   ASSERT(vm_snapshot_data_filename != NULL);
@@ -1270,6 +1288,8 @@ static void CreateAndWritePrecompiledSnapshot(
   ASSERT(IsSnapshottingForPrecompilation());
   Dart_Handle result;
 
+  LoadTypeFeedback();
+
   // Precompile with specified embedder entry points
   result = Dart_Precompile(standalone_entry_points);
   CHECK_RESULT(result);
@@ -8,21 +8,77 @@
 namespace dart {
 namespace bin {
 
+IsolateGroupData::IsolateGroupData(const char* url,
+                                   const char* package_root,
+                                   const char* packages_file,
+                                   AppSnapshot* app_snapshot)
+    : script_url_((url != NULL) ? strdup(url) : NULL),
+      package_root_((package_root != NULL) ? strdup(package_root) : NULL),
+      packages_file_((packages_file != NULL) ? strdup(packages_file) : NULL),
+      reloaded_(false),
+      app_snapshot_(app_snapshot),
+      kernel_buffer_(NULL),
+      kernel_buffer_size_(0),
+      owns_kernel_buffer_(false) {}
+
+static bool SameString(const char* a, const char* b) {
+  if ((a == NULL) || (b == NULL)) {
+    return a == b;
+  }
+  return strcmp(a, b) == 0;
+}
+
+bool IsolateGroupData::CanShareProgram(const char* url,
+                                       const char* package_root,
+                                       const char* packages_file) const {
+  if (reloaded_ || (url == NULL) || !SameString(url, script_url_)) {
+    return false;
+  }
+  // The same script may resolve its package imports differently.
+  if (!SameString(package_root, package_root_) ||
+      !SameString(packages_file, packages_file_)) {
+    return false;
+  }
+  return (kernel_buffer_ != NULL) || (app_snapshot_ != NULL);
+}
+
+IsolateGroupData::~IsolateGroupData() {
+  free(script_url_);
+  script_url_ = NULL;
+  free(package_root_);
+  package_root_ = NULL;
+  free(packages_file_);
+  packages_file_ = NULL;
+  if (owns_kernel_buffer_) {
+    ASSERT(kernel_buffer_ != NULL);
+    free(kernel_buffer_);
+  }
+  kernel_buffer_ = NULL;
+  kernel_buffer_size_ = 0;
+  delete app_snapshot_;
+  app_snapshot_ = NULL;
+}
+
 IsolateData::IsolateData(const char* url,
                          const char* package_root,
                          const char* packages_file,
-                         AppSnapshot* app_snapshot)
+                         AppSnapshot* app_snapshot,
+                         IsolateGroupData* group)
     : script_url((url != NULL) ? strdup(url) : NULL),
       package_root(NULL),
       packages_file(NULL),
+      group_(group),
       builtin_lib_(NULL),
       loader_(NULL),
-      app_snapshot_(app_snapshot),
       dependencies_(NULL),
-      resolved_packages_config_(NULL),
-      kernel_buffer_(NULL),
-      kernel_buffer_size_(0),
-      owns_kernel_buffer_(false) {
+      resolved_packages_config_(NULL) {
+  if (group_ != NULL) {
+    ASSERT(app_snapshot == NULL);
+    group_->Retain();
+  } else {
+    group_ = new IsolateGroupData(url, package_root, packages_file,
+                                  app_snapshot);
+  }
   if (package_root != NULL) {
     ASSERT(packages_file == NULL);
     this->package_root = strdup(package_root);
@@ -47,14 +103,8 @@ IsolateData::~IsolateData() {
   packages_file = NULL;
   free(resolved_packages_config_);
   resolved_packages_config_ = NULL;
-  if (owns_kernel_buffer_) {
-    ASSERT(kernel_buffer_ != NULL);
-    free(kernel_buffer_);
-  }
-  kernel_buffer_ = NULL;
-  kernel_buffer_size_ = 0;
-  delete app_snapshot_;
-  app_snapshot_ = NULL;
+  group_->Release();
+  group_ = NULL;
 }
 
 }  // namespace bin
@@ -5,6 +5,7 @@
 #ifndef RUNTIME_BIN_ISOLATE_DATA_H_
 #define RUNTIME_BIN_ISOLATE_DATA_H_
 
+#include "bin/reference_counting.h"
 #include "include/dart_api.h"
 #include "platform/assert.h"
 #include "platform/globals.h"
@@ -25,17 +26,77 @@ class AppSnapshot;
 class EventHandler;
 class Loader;
 
+// Data shared by the isolates of an isolate group in the standalone VM
+// embedding. An isolate spawned with Isolate.spawn runs the same program as
+// the isolate that spawned it, so it joins that isolate's group and is
+// loaded from the group's kernel binary or app snapshot instead of reading
+// (or compiling) the script again. The VM refers to the kernel binary for
+// as long as an isolate runs, so the group also keeps a single copy of it
+// in memory. The group is released when its last isolate shuts down.
+//
+// Only these embedder buffers are shared. Each isolate still has its own
+// heap, class table and code.
+class IsolateGroupData : public ReferenceCounted<IsolateGroupData> {
+ public:
+  IsolateGroupData(const char* url,
+                   const char* package_root,
+                   const char* packages_file,
+                   AppSnapshot* app_snapshot);
+
+  const char* script_url() const { return script_url_; }
+  AppSnapshot* app_snapshot() const { return app_snapshot_; }
+
+  const uint8_t* kernel_buffer() const { return kernel_buffer_; }
+  intptr_t kernel_buffer_size() const { return kernel_buffer_size_; }
+  void set_kernel_buffer(uint8_t* buffer, intptr_t size, bool take_ownership) {
+    ASSERT(kernel_buffer_ == NULL);
+    kernel_buffer_ = buffer;
+    kernel_buffer_size_ = size;
+    owns_kernel_buffer_ = take_ownership;
+  }
+
+  // Returns true if an isolate running the script at [url] with the given
+  // package resolution can be loaded from the program of this group.
+  bool CanShareProgram(const char* url,
+                       const char* package_root,
+                       const char* packages_file) const;
+
+  // Called when an isolate of the group is hot reloaded. Its program no
+  // longer matches the buffers of the group, so later spawns load their own.
+  void set_reloaded() { reloaded_ = true; }
+
+ private:
+  ~IsolateGroupData();
+
+  char* script_url_;
+  char* package_root_;
+  char* packages_file_;
+  bool reloaded_;
+  AppSnapshot* app_snapshot_;
+  uint8_t* kernel_buffer_;
+  intptr_t kernel_buffer_size_;
+  bool owns_kernel_buffer_;
+
+  friend class ReferenceCounted<IsolateGroupData>;
+  DISALLOW_COPY_AND_ASSIGN(IsolateGroupData);
+};
+
 // Data associated with every isolate in the standalone VM
 // embedding. This is used to free external resources for each isolate
 // when the isolate shuts down.
 class IsolateData {
  public:
+  // The isolate joins [group] if given and otherwise starts a new group
+  // that takes ownership of [app_snapshot].
   IsolateData(const char* url,
               const char* package_root,
               const char* packages_file,
-              AppSnapshot* app_snapshot);
+              AppSnapshot* app_snapshot,
+              IsolateGroupData* group = NULL);
   ~IsolateData();
 
+  IsolateGroupData* group() const { return group_; }
+
   Dart_Handle builtin_lib() const {
     ASSERT(builtin_lib_ != NULL);
     ASSERT(!Dart_IsError(builtin_lib_));
@@ -52,13 +113,10 @@ class IsolateData {
   char* package_root;
   char* packages_file;
 
-  const uint8_t* kernel_buffer() const { return kernel_buffer_; }
-  intptr_t kernel_buffer_size() const { return kernel_buffer_size_; }
+  const uint8_t* kernel_buffer() const { return group_->kernel_buffer(); }
+  intptr_t kernel_buffer_size() const { return group_->kernel_buffer_size(); }
   void set_kernel_buffer(uint8_t* buffer, intptr_t size, bool take_ownership) {
-    ASSERT(kernel_buffer_ == NULL);
-    kernel_buffer_ = buffer;
-    kernel_buffer_size_ = size;
-    owns_kernel_buffer_ = take_ownership;
+    group_->set_kernel_buffer(buffer, size, take_ownership);
   }
 
   void UpdatePackagesFile(const char* packages_file_) {
@@ -99,14 +157,11 @@ class IsolateData {
   void OnIsolateShutdown();
 
  private:
+  IsolateGroupData* group_;
   Dart_Handle builtin_lib_;
   Loader* loader_;
-  AppSnapshot* app_snapshot_;
   MallocGrowableArray<char*>* dependencies_;
   char* resolved_packages_config_;
-  uint8_t* kernel_buffer_;
-  intptr_t kernel_buffer_size_;
-  bool owns_kernel_buffer_;
 
   DISALLOW_COPY_AND_ASSIGN(IsolateData);
 };
@@ -661,6 +661,14 @@ Dart_Handle Loader::LibraryTagHandler(Dart_LibraryTag tag,
   if (Dart_IsError(result)) {
     return result;
   }
+  if (Dart_IsReloading()) {
+    // Every hot reload loads the new program through this handler.
+    IsolateData* isolate_data =
+        reinterpret_cast<IsolateData*>(Dart_CurrentIsolateData());
+    if (isolate_data != NULL) {
+      isolate_data->group()->set_reloaded();
+    }
+  }
   if (tag == Dart_kKernelTag) {
     uint8_t* kernel_buffer = NULL;
     intptr_t kernel_buffer_size = 0;
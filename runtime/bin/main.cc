@@ -618,12 +618,15 @@ static Dart_Isolate CreateAndSetupServiceIsolate(const char* script_uri,
 }
 
 // Returns newly created Isolate on success, NULL on failure.
+// The isolate joins [parent_group], the group of the isolate spawning it,
+// if that group runs the same script.
 static Dart_Isolate CreateIsolateAndSetupHelper(bool is_main_isolate,
                                                 const char* script_uri,
                                                 const char* main,
                                                 const char* package_root,
                                                 const char* packages_config,
                                                 Dart_IsolateFlags* flags,
+                                                IsolateGroupData* parent_group,
                                                 char** error,
                                                 int* exit_code) {
   int64_t start = Dart_TimelineGetMicros();
@@ -631,6 +634,12 @@ static Dart_Isolate CreateIsolateAndSetupHelper(bool is_main_isolate,
   uint8_t* kernel_buffer = NULL;
   intptr_t kernel_buffer_size = 0;
   AppSnapshot* app_snapshot = NULL;
+  IsolateGroupData* group = NULL;
+  if ((parent_group != NULL) &&
+      parent_group->CanShareProgram(script_uri, package_root,
+                                    packages_config)) {
+    group = parent_group;
+  }
 
 #if defined(DART_PRECOMPILED_RUNTIME)
   // AOT: All isolates start from the app snapshot.
@@ -651,6 +660,13 @@ static Dart_Isolate CreateIsolateAndSetupHelper(bool is_main_isolate,
     isolate_run_app_snapshot = true;
     isolate_snapshot_data = app_isolate_snapshot_data;
     isolate_snapshot_instructions = app_isolate_snapshot_instructions;
+  } else if ((group != NULL) && (group->app_snapshot() != NULL)) {
+    isolate_run_app_snapshot = true;
+    const uint8_t* ignore_vm_snapshot_data;
+    const uint8_t* ignore_vm_snapshot_instructions;
+    group->app_snapshot()->SetBuffers(
+        &ignore_vm_snapshot_data, &ignore_vm_snapshot_instructions,
+        &isolate_snapshot_data, &isolate_snapshot_instructions);
   } else if (!is_main_isolate) {
     app_snapshot = Snapshot::TryReadAppSnapshot(script_uri);
     if (app_snapshot != NULL) {
@@ -662,16 +678,26 @@ static Dart_Isolate CreateIsolateAndSetupHelper(bool is_main_isolate,
           &isolate_snapshot_data, &isolate_snapshot_instructions);
     }
   }
-  if (!isolate_run_app_snapshot) {
+  if (!isolate_run_app_snapshot && (group == NULL)) {
     dfe.ReadScript(script_uri, &kernel_buffer, &kernel_buffer_size);
   }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
-  IsolateData* isolate_data =
-      new IsolateData(script_uri, package_root, packages_config, app_snapshot);
-  if (kernel_buffer != NULL) {
-    isolate_data->set_kernel_buffer(kernel_buffer, kernel_buffer_size,
-                                    true /*take ownership*/);
+  IsolateData* isolate_data = NULL;
+  if (group != NULL) {
+    // The kernel binary, if any, was read or compiled by the first isolate
+    // of the group and is shared by all of them.
+    isolate_data = new IsolateData(script_uri, package_root, packages_config,
+                                   NULL, group);
+    kernel_buffer = const_cast<uint8_t*>(group->kernel_buffer());
+    kernel_buffer_size = group->kernel_buffer_size();
+  } else {
+    isolate_data = new IsolateData(script_uri, package_root, packages_config,
+                                   app_snapshot);
+    if (kernel_buffer != NULL) {
+      isolate_data->set_kernel_buffer(kernel_buffer, kernel_buffer_size,
+                                      true /*take ownership*/);
+    }
   }
   if (is_main_isolate && (Options::snapshot_deps_filename() != NULL)) {
     isolate_data->set_dependencies(new MallocGrowableArray<char*>());
@@ -772,9 +798,13 @@ static Dart_Isolate CreateIsolateAndSetup(const char* script_uri,
                                         &exit_code);
   }
   bool is_main_isolate = false;
+  IsolateData* parent_isolate_data = reinterpret_cast<IsolateData*>(data);
+  IsolateGroupData* parent_group = (parent_isolate_data != NULL)
+                                       ? parent_isolate_data->group()
+                                       : NULL;
   return CreateIsolateAndSetupHelper(is_main_isolate, script_uri, main,
-                                     package_root, package_config, flags, error,
-                                     &exit_code);
+                                     package_root, package_config, flags,
+                                     parent_group, error, &exit_code);
 }
 
 char* BuildIsolateName(const char* script_name, const char* func_name) {
@@ -969,7 +999,7 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
   } else {
     isolate = CreateIsolateAndSetupHelper(
         is_main_isolate, script_name, "main", Options::package_root(),
-        Options::packages_file(), &flags, &error, &exit_code);
+        Options::packages_file(), &flags, NULL, &error, &exit_code);
   }
 
   if (isolate == NULL) {
@@ -1080,6 +1110,13 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
         result = Dart_LoadCompilationTrace(buffer, size);
         CHECK_RESULT(result);
       }
+      if (Options::load_type_feedback_filename() != NULL) {
+        uint8_t* buffer = NULL;
+        intptr_t size = 0;
+        ReadFile(Options::load_type_feedback_filename(), &buffer, &size);
+        result = Dart_LoadTypeFeedback(buffer, size);
+        CHECK_RESULT(result);
+      }
 
       // Create a closure for the main entry point which is in the exported
       // namespace of the root library or invoke a getter of the same name
@@ -1123,6 +1160,13 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
         CHECK_RESULT(result);
         WriteFile(Options::save_compilation_trace_filename(), buffer, size);
       }
+      if (Options::save_type_feedback_filename() != NULL) {
+        uint8_t* buffer = NULL;
+        intptr_t size = 0;
+        result = Dart_SaveTypeFeedback(&buffer, &size);
+        CHECK_RESULT(result);
+        WriteFile(Options::save_type_feedback_filename(), buffer, size);
+      }
     }
   }
 
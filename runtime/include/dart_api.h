@@ -962,6 +962,11 @@ DART_EXPORT void Dart_EnterIsolate(Dart_Isolate isolate);
  * |deadline| is measured in microseconds against the system's monotonic time.
  * This clock can be accessed via Dart_TimelineGetMicros().
  *
+ * The work is done in bounded steps, each started only if it is expected to
+ * finish before |deadline|, so short notifications are cheap and may be sent
+ * frequently. The idle time offered and used is reported through the
+ * heap.idle.* metrics.
+ *
  * Requires there to be a current isolate.
  */
 DART_EXPORT void Dart_NotifyIdle(int64_t deadline);
@@ -3375,6 +3380,37 @@ Dart_SaveCompilationTrace(uint8_t** buffer, intptr_t* buffer_length);
 DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
 Dart_LoadCompilationTrace(uint8_t* buffer, intptr_t buffer_length);
 
+/**
+ * Record the type feedback gathered by the unoptimized code of all functions
+ * compiled in the current isolate: usage and deoptimization counters, call
+ * counts and the classes seen at each call site. The feedback is in a
+ * versioned binary format.
+ *
+ * \param buffer Returns a pointer to a buffer containing the feedback.
+ *   This buffer is scope allocated and is only valid  until the next call to
+ *   Dart_ExitScope.
+ * \param size Returns the size of the buffer.
+ * \return Returns an valid handle upon success.
+ */
+DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
+Dart_SaveTypeFeedback(uint8_t** buffer, intptr_t* buffer_length);
+
+/**
+ * Load data from Dart_SaveTypeFeedback. Like the compilation trace, this data
+ * is fuzzy: functions and call sites that cannot be matched against the
+ * current program are ignored.
+ *
+ * In the JIT, the named functions are compiled, the feedback is merged into
+ * their call sites, and functions that were hot when the feedback was saved
+ * are queued for background optimization, skipping the warm-up. Before
+ * Dart_Precompile, the feedback guides the precompiler's inlining decisions.
+ *
+ * \return Returns an error handle if the data is malformed or a compilation
+ *   error was encountered.
+ */
+DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
+Dart_LoadTypeFeedback(uint8_t* buffer, intptr_t buffer_length);
+
 /*
  * ==============
  * Precompilation
@@ -11,6 +11,7 @@
 #include "vm/dart_api_message.h"
 #include "vm/dart_entry.h"
 #include "vm/exceptions.h"
+#include "vm/flags.h"
 #include "vm/lockers.h"
 #include "vm/longjump.h"
 #include "vm/message_handler.h"
@@ -25,6 +26,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, isolate_pool_size);
+
 DEFINE_NATIVE_ENTRY(CapabilityImpl_factory, 1) {
   ASSERT(TypeArguments::CheckedHandle(arguments->NativeArgAt(0)).IsNull());
   uint64_t id = isolate->random()->NextUInt64();
@@ -111,7 +114,8 @@ static void ThrowIsolateSpawnException(const String& message) {
 
 class SpawnIsolateTask : public ThreadPool::Task {
  public:
-  explicit SpawnIsolateTask(IsolateSpawnState* state) : state_(state) {}
+  SpawnIsolateTask(IsolateSpawnState* state, IsolatePool* pool)
+      : state_(state), pool_(pool) {}
 
   virtual void Run() {
     // Create a new isolate.
@@ -126,12 +130,22 @@ class SpawnIsolateTask : public ThreadPool::Task {
       return;
     }
 
-    // Make a copy of the state's isolate flags and hand it to the callback.
-    Dart_IsolateFlags api_flags = *(state_->isolate_flags());
+    // Claim a pooled isolate, if any, before the spawn count of the parent
+    // drops and it may shut down the pool.
+    Isolate* isolate = NULL;
+    if (pool_ != NULL) {
+      isolate = pool_->Claim(state_);
+      pool_ = NULL;
+    }
+    if (isolate == NULL) {
+      // Make a copy of the state's isolate flags and hand it to the callback.
+      Dart_IsolateFlags api_flags = *(state_->isolate_flags());
 
-    Isolate* isolate = reinterpret_cast<Isolate*>((callback)(
-        state_->script_url(), state_->function_name(), state_->package_root(),
-        state_->package_config(), &api_flags, state_->init_data(), &error));
+      isolate = reinterpret_cast<Isolate*>((callback)(
+          state_->script_url(), state_->function_name(),
+          state_->package_root(), state_->package_config(), &api_flags,
+          state_->init_data(), &error));
+    }
     state_->DecrementSpawnCount();
     if (isolate == NULL) {
       ReportError(error);
@@ -167,6 +181,7 @@ class SpawnIsolateTask : public ThreadPool::Task {
   }
 
   IsolateSpawnState* state_;
+  IsolatePool* pool_;
 
   DISALLOW_COPY_AND_ASSIGN(SpawnIsolateTask);
 };
@@ -228,7 +243,9 @@ DEFINE_NATIVE_ENTRY(Isolate_spawnFunction, 10) {
           isolate->spawn_count_monitor(), isolate->spawn_count(),
           utf8_package_root, utf8_package_config, paused.value(), fatal_errors,
           on_exit_port, on_error_port);
-      ThreadPool::Task* spawn_task = new SpawnIsolateTask(state);
+      IsolatePool* pool =
+          (FLAG_isolate_pool_size > 0) ? isolate->isolate_pool() : NULL;
+      ThreadPool::Task* spawn_task = new SpawnIsolateTask(state, pool);
 
       isolate->IncrementSpawnCount();
       if (!Dart::thread_pool()->Run(spawn_task)) {
@@ -364,7 +381,7 @@ DEFINE_NATIVE_ENTRY(Isolate_spawnUri, 12) {
     flags->enable_type_checks = is_checked && !flags->strong;
   }
 
-  ThreadPool::Task* spawn_task = new SpawnIsolateTask(state);
+  ThreadPool::Task* spawn_task = new SpawnIsolateTask(state, NULL);
 
   isolate->IncrementSpawnCount();
   if (!Dart::thread_pool()->Run(spawn_task)) {
@@ -416,4 +433,123 @@ DEFINE_NATIVE_ENTRY(Isolate_sendOOB, 2) {
   return Object::null();
 }
 
+// Returns the number of bytes in [instance], which must be a typed data,
+// external typed data or typed data view.
+static intptr_t TypedDataLengthInBytes(const Instance& instance) {
+  if (instance.IsTypedData()) {
+    return TypedData::Cast(instance).LengthInBytes();
+  }
+  if (instance.IsExternalTypedData()) {
+    return ExternalTypedData::Cast(instance).LengthInBytes();
+  }
+  if (!instance.IsNull() &&
+      RawObject::IsTypedDataViewClassId(instance.GetClassId())) {
+    return Smi::Value(TypedDataView::Length(instance)) *
+           TypedDataView::ElementSizeInBytes(instance);
+  }
+  Exceptions::ThrowArgumentError(instance);
+  UNREACHABLE();
+  return 0;
+}
+
+// Copies the bytes of [instance] to [dst]. Must not be interrupted by a GC,
+// which could move the bytes of an internal typed data.
+static void CopyTypedDataBytes(Zone* zone,
+                               const Instance& instance,
+                               intptr_t length_in_bytes,
+                               uint8_t* dst) {
+  if (length_in_bytes == 0) {
+    return;
+  }
+  Instance& data = Instance::Handle(zone, instance.raw());
+  intptr_t offset_in_bytes = 0;
+  if (RawObject::IsTypedDataViewClassId(instance.GetClassId())) {
+    data = TypedDataView::Data(instance);
+    offset_in_bytes = Smi::Value(TypedDataView::OffsetInBytes(instance));
+  }
+  void* src;
+  if (data.IsExternalTypedData()) {
+    src = ExternalTypedData::Cast(data).DataAddr(offset_in_bytes);
+  } else {
+    src = TypedData::Cast(data).DataAddr(offset_in_bytes);
+  }
+  memmove(dst, src, length_in_bytes);
+}
+
+static void ExternalTypedDataFinalizer(void* isolate_callback_data,
+                                       Dart_WeakPersistentHandle handle,
+                                       void* peer) {
+  free(peer);
+}
+
+DEFINE_NATIVE_ENTRY(TransferableTypedData_factory, 2) {
+  ASSERT(TypeArguments::CheckedHandle(arguments->NativeArgAt(0)).IsNull());
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, list, arguments->NativeArgAt(1));
+
+  Array& array = Array::Handle(zone);
+  intptr_t array_length;
+  if (list.IsGrowableObjectArray()) {
+    const GrowableObjectArray& growable = GrowableObjectArray::Cast(list);
+    array = growable.data();
+    array_length = growable.Length();
+  } else {
+    ASSERT(list.IsArray());
+    array ^= list.raw();
+    array_length = array.Length();
+  }
+
+  Instance& instance = Instance::Handle(zone);
+  const intptr_t kMaxBytes = TypedData::MaxElements(kTypedDataUint8ArrayCid);
+  intptr_t total_bytes = 0;
+  for (intptr_t i = 0; i < array_length; i++) {
+    instance ^= array.At(i);
+    total_bytes += TypedDataLengthInBytes(instance);
+    if (total_bytes > kMaxBytes) {
+      const Integer& value = Integer::Handle(zone, Integer::New(total_bytes));
+      Exceptions::ThrowRangeError("list", value, 0, kMaxBytes);
+      UNREACHABLE();
+    }
+  }
+
+  // An empty buffer is still owned, so it must not look transferred.
+  uint8_t* data = reinterpret_cast<uint8_t*>(
+      malloc(Utils::Maximum<intptr_t>(total_bytes, 1)));
+  if (data == NULL) {
+    OUT_OF_MEMORY();
+  }
+  intptr_t offset = 0;
+  for (intptr_t i = 0; i < array_length; i++) {
+    instance ^= array.At(i);
+    const intptr_t length_in_bytes = TypedDataLengthInBytes(instance);
+    NoSafepointScope no_safepoint;
+    CopyTypedDataBytes(zone, instance, length_in_bytes, data + offset);
+    offset += length_in_bytes;
+  }
+  ASSERT(offset == total_bytes);
+  return TransferableTypedData::New(data, total_bytes);
+}
+
+DEFINE_NATIVE_ENTRY(TransferableTypedData_materialize, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(TransferableTypedData, transferable,
+                               arguments->NativeArgAt(0));
+  TransferableTypedDataPeer* peer = transferable.peer();
+  if (peer->data() == NULL) {
+    const String& error = String::Handle(
+        zone, String::New("Attempt to materialize object that was "
+                          "transferred already."));
+    Exceptions::ThrowArgumentError(error);
+    UNREACHABLE();
+  }
+
+  // The bytes now belong to the external typed data.
+  uint8_t* data = peer->data();
+  const intptr_t length = peer->length();
+  const ExternalTypedData& typed_data = ExternalTypedData::Handle(
+      zone,
+      ExternalTypedData::New(kExternalTypedDataUint8ArrayCid, data, length));
+  peer->ClearData();
+  typed_data.AddFinalizer(data, &ExternalTypedDataFinalizer, length);
+  return typed_data.raw();
+}
+
 }  // namespace dart
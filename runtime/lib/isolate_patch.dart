@@ -7,13 +7,15 @@
 /// used by patches of that library. We plan to change this when we have a
 /// shared front end and simply use parts.
 
-import "dart:_internal" show VMLibraryHooks, patch;
+import "dart:_internal" show ClassID, VMLibraryHooks, patch;
 
 import "dart:async"
     show Completer, Future, Stream, StreamController, StreamSubscription, Timer;
 
 import "dart:collection" show HashMap;
 
+import "dart:typed_data" show ByteBuffer, TypedData, Uint8List;
+
 /// These are the additional parts of this patch library:
 // part "timer_impl.dart";
 
@@ -629,3 +631,33 @@ class Isolate {
 
   static String _getCurrentRootUriStr() native "Isolate_getCurrentRootUriStr";
 }
+
+@patch
+class TransferableTypedData {
+  @patch
+  factory TransferableTypedData.fromList(List<TypedData> list) {
+    if (list == null) {
+      throw new ArgumentError.notNull("list");
+    }
+    final int cid = ClassID.getID(list);
+    if (cid != ClassID.cidArray &&
+        cid != ClassID.cidGrowableObjectArray &&
+        cid != ClassID.cidImmutableArray) {
+      list = new List<TypedData>.from(list, growable: false);
+    }
+    return new _TransferableTypedDataImpl(list);
+  }
+}
+
+class _TransferableTypedDataImpl implements TransferableTypedData {
+  factory _TransferableTypedDataImpl(List<TypedData> list)
+      native "TransferableTypedData_factory";
+
+  ByteBuffer materialize() {
+    return _materializeIntoUint8List().buffer;
+  }
+
+  Uint8List _materializeIntoUint8List()
+      native "TransferableTypedData_materialize";
+}
+
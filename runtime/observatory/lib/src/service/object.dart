@@ -3140,6 +3140,7 @@ class ServiceFunction extends HeapObject implements M.ServiceFunction {
   int deoptimizations;
   String qualifiedName;
   int usageCounter;
+  int optimizationTier;
   bool isDart;
   ProfileFunction profile;
   Instance icDataArray;
@@ -3191,6 +3192,7 @@ class ServiceFunction extends HeapObject implements M.ServiceFunction {
     unoptimizedCode = map['_unoptimizedCode'];
     deoptimizations = map['_deoptimizations'];
     usageCounter = map['_usageCounter'];
+    optimizationTier = map['_optimizationTier'];
     icDataArray = map['_icDataArray'];
     field = map['_field'];
   }
@@ -0,0 +1,51 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+// VMOptions=--no_background_compilation --optimization_counter_threshold=10 --second_tier_counter_threshold=20 --no-use-osr
+
+import 'package:observatory/service_io.dart';
+import 'package:unittest/unittest.dart';
+import 'test_helper.dart';
+import 'service_test_common.dart';
+import 'dart:developer';
+
+int hotFunction(int x) => x * 3 + 1;
+
+int warmFunction(int x) => x * 5 + 2;
+
+int coldFunction(int x) => x * 7 + 3;
+
+void testFunction() {
+  var sum = 0;
+  for (var i = 0; i < 100; i++) {
+    sum += hotFunction(i);
+  }
+  for (var i = 0; i < 15; i++) {
+    sum += warmFunction(i);
+  }
+  sum += coldFunction(sum);
+  print(sum);
+  debugger();
+}
+
+Future<int> optimizationTier(Isolate isolate, String name) async {
+  var root = isolate.rootLibrary;
+  await root.load();
+  var func = root.functions.singleWhere((f) => f.name == name);
+  await func.load();
+  return func.optimizationTier;
+}
+
+var tests = <IsolateTest>[
+  hasStoppedAtBreakpoint,
+  (Isolate isolate) async {
+    // Still hot after its first optimization: reoptimized in the second tier.
+    expect(await optimizationTier(isolate, 'hotFunction'), equals(2));
+    // Optimized once, but not called often enough since.
+    expect(await optimizationTier(isolate, 'warmFunction'), equals(1));
+    // Never optimized.
+    expect(await optimizationTier(isolate, 'coldFunction'), isZero);
+  },
+];
+
+main(args) => runIsolateTests(args, tests, testeeConcurrent: testFunction);
@@ -839,6 +839,7 @@ var tests = <IsolateTest>[
     expect(result['_usageCounter'], isPositive);
     expect(result['_optimizedCallSiteCount'], isZero);
     expect(result['_deoptimizations'], isZero);
+    expect(result['_optimizationTier'], isZero);
   },
 
   // invalid function.
@@ -0,0 +1,64 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+// VMOptions=--isolate_pool_size=2
+
+import 'dart:async';
+import 'dart:isolate' as I;
+
+import 'package:observatory/service_io.dart';
+import 'package:unittest/unittest.dart';
+import 'test_helper.dart';
+
+const spawnCount = 4;
+
+final idlePort = new I.ReceivePort();
+
+void increment(List args) {
+  final int value = args[0];
+  final I.SendPort replyPort = args[1];
+  replyPort.send(value + 1);
+}
+
+void idle(I.SendPort replyPort) {
+  // Keeps the isolate alive until the test is done.
+  final port = new I.ReceivePort();
+  replyPort.send(port.sendPort);
+}
+
+Future spawnAll() async {
+  // One at a time, so that the later spawns claim isolates from the pool.
+  for (var i = 0; i < spawnCount; i++) {
+    final port = new I.ReceivePort();
+    final exitPort = new I.ReceivePort();
+    await I.Isolate.spawn(increment, [i, port.sendPort],
+        onExit: exitPort.sendPort);
+    await port.first;
+    await exitPort.first;
+  }
+  // Claims an isolate that the pool created for [increment].
+  await I.Isolate.spawn(idle, idlePort.sendPort);
+  await idlePort.first;
+}
+
+var tests = <VMTest>[
+  (VM vm) async {
+    var result = await vm.invokeRpcNoUpgrade('getVM', {});
+    var pool = result['_isolatePool'];
+    expect(pool['size'], equals(2));
+    expect(pool['hits'] + pool['misses'], equals(spawnCount + 1));
+    expect(pool['hits'], isPositive);
+    expect(pool['misses'], isPositive);
+  },
+  (VM vm) async {
+    await vm.reload();
+    // Pooled isolates are named after the function they were spawned with,
+    // and claimed ones after the function they run.
+    var names = vm.isolates.map((isolate) => isolate.name).toList();
+    expect(names.where((name) => name.endsWith(':idle()')).length, equals(1));
+    expect(names.where((name) => name.endsWith(':increment()')),
+        isNotEmpty);
+  },
+];
+
+main(args) async => runVMTests(args, tests, testeeBefore: spawnAll);
@@ -0,0 +1,57 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that isolates spawned from the same program, directly or by other
+// spawned isolates, share the program but not its mutable state.
+
+import "dart:async";
+import "dart:isolate";
+import "package:expect/expect.dart";
+
+int counter = 0;
+
+// Increments [counter] and, while [depth] is positive, spawns another
+// isolate that does the same. Replies with the counters seen on the way
+// back up.
+void child(List args) {
+  final int depth = args[0];
+  final SendPort replyPort = args[1];
+  counter++;
+  if (depth == 0) {
+    replyPort.send([counter]);
+    return;
+  }
+  final port = new ReceivePort();
+  Isolate.spawn(child, [depth - 1, port.sendPort]);
+  port.first.then((List counters) {
+    replyPort.send(<int>[counter]..addAll(counters));
+  });
+}
+
+Future testNested() async {
+  const int kDepth = 4;
+  final port = new ReceivePort();
+  await Isolate.spawn(child, [kDepth, port.sendPort]);
+  final List counters = await port.first;
+  Expect.listEquals(new List<int>.filled(kDepth + 1, 1), counters);
+  Expect.equals(0, counter);
+}
+
+Future testMany() async {
+  const int kIsolates = 8;
+  final ports = new List<ReceivePort>.generate(kIsolates, (_) {
+    return new ReceivePort();
+  });
+  await Future.wait(ports.map((port) {
+    return Isolate.spawn(child, [0, port.sendPort]);
+  }));
+  for (final port in ports) {
+    Expect.listEquals([1], await port.first);
+  }
+}
+
+main() async {
+  await testNested();
+  await testMany();
+}
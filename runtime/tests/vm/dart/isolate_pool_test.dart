@@ -0,0 +1,53 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that isolates claimed from the pool of pre-created isolates start
+// from a fresh state and run the function they are spawned with.
+
+// VMOptions=--isolate_pool_size=2
+// VMOptions=--isolate_pool_size=4
+
+import "dart:async";
+import "dart:isolate";
+import "package:expect/expect.dart";
+
+int counter = 0;
+
+void increment(List args) {
+  final int value = args[0];
+  final SendPort replyPort = args[1];
+  counter += value;
+  replyPort.send(counter);
+}
+
+void negate(List args) {
+  final int value = args[0];
+  final SendPort replyPort = args[1];
+  replyPort.send(-value);
+}
+
+Future<int> spawn(void entryPoint(List args), int value) async {
+  final port = new ReceivePort();
+  final exitPort = new ReceivePort();
+  await Isolate.spawn(entryPoint, [value, port.sendPort],
+      onExit: exitPort.sendPort);
+  final int result = await port.first;
+  await exitPort.first;
+  return result;
+}
+
+main() async {
+  // One at a time, so that most spawns claim an isolate from the pool.
+  for (int i = 1; i <= 10; i++) {
+    Expect.equals(i, await spawn(increment, i));
+    Expect.equals(-i, await spawn(negate, i));
+  }
+
+  // More at once than the pool holds.
+  final results = await Future.wait(
+      new List<Future<int>>.generate(16, (i) => spawn(increment, i)));
+  Expect.listEquals(new List<int>.generate(16, (i) => i), results);
+
+  Expect.equals(0, counter);
+}
@@ -0,0 +1,41 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures the resident memory each isolate adds when many isolates of the
+// same program are alive together. Unlike the IsolateSpawnRSS benchmark in
+// run_vm_tests, the isolates are created by Isolate.spawn through the
+// standalone embedder, so they join the isolate group of this one and share
+// its program. The score is printed in the format of run_vm_tests benchmarks.
+
+import "dart:io";
+import "dart:isolate";
+import "package:expect/expect.dart";
+
+const int kIsolates = 32;
+
+// Tells the spawner it is running, then stays alive until told to exit.
+void child(SendPort replyPort) {
+  final port = new ReceivePort();
+  replyPort.send(port.sendPort);
+  port.first.then((_) => port.close());
+}
+
+main() async {
+  final rssBefore = ProcessInfo.currentRss;
+  final children = <SendPort>[];
+  for (int i = 0; i < kIsolates; i++) {
+    final port = new ReceivePort();
+    await Isolate.spawn(child, port.sendPort);
+    children.add(await port.first);
+  }
+  final rssAfter = ProcessInfo.currentRss;
+
+  print("IsolateSpawnRSS(MemoryUse): "
+      "${(rssAfter - rssBefore) ~/ kIsolates}");
+
+  Expect.equals(kIsolates, children.length);
+  for (final child in children) {
+    child.send(null);
+  }
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that values live across loops with calls and high register pressure
+// keep their values when the register allocator moves their spills out of
+// the loops and coalesces phi moves.
+
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation --no-loop-aware-spilling
+
+import "package:expect/expect.dart";
+
+int sideEffects = 0;
+
+@NoInline()
+int call(int x) {
+  sideEffects++;
+  return x;
+}
+
+// Many values live across the loop nest, only used after it.
+int liveAcross(int a, int b, int c, int d, int e, int f, int g, int h) {
+  final p = a * 3, q = b * 5, r = c * 7, s = d * 11;
+  final t = e * 13, u = f * 17, v = g * 19, w = h * 23;
+  int sum = 0;
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 3; j++) {
+      sum += call(i * j) + i + j;
+    }
+  }
+  return sum + p + q + r + s + t + u + v + w;
+}
+
+// Values used as memory operands inside the loop and in registers after it.
+int usedInLoop(List<int> list, int a, int b, int c, int d) {
+  final x = a + b, y = b + c, z = c + d, k = d + a;
+  int sum = 0;
+  for (int i = 0; i < list.length; i++) {
+    sum += call(list[i]);
+    if (list[i] == x || list[i] == y) sum++;
+  }
+  return sum * x + y * z + k;
+}
+
+// Loop phis that rotate values between each other.
+int rotate(int n) {
+  int a = 1, b = 2, c = 3, d = 4;
+  for (int i = 0; i < n; i++) {
+    final t = a;
+    a = b;
+    b = c;
+    c = d;
+    d = t + call(i);
+  }
+  return a * 1000 + b * 100 + c * 10 + d;
+}
+
+double doubles(List<double> list, double a, double b) {
+  final x = a * b, y = a - b, z = a + b;
+  double sum = 0.0;
+  for (int i = 0; i < list.length; i++) {
+    sum += list[i] * x;
+    call(i);
+  }
+  return sum + y * z;
+}
+
+void main() {
+  final list = new List<int>.generate(10, (i) => i * 2);
+  final dlist = new List<double>.generate(10, (i) => i / 2);
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(48 + 3 + 10 + 21 + 44 + 65 + 102 + 133 + 184,
+        liveAcross(1, 2, 3, 4, 5, 6, 7, 8));
+    Expect.equals(90 * 3 + 5 * 7 + 5, usedInLoop(list, 1, 2, 3, 4));
+    Expect.equals(2341, rotate(1));
+    Expect.equals(1357, rotate(4));
+    Expect.equals(22.5 * 6.0 + 1.0 * 5.0, doubles(dlist, 3.0, 2.0));
+  }
+  Expect.isTrue(sideEffects > 0);
+}
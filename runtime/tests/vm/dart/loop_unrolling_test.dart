@@ -0,0 +1,96 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that loops with a known trip count compute the same results after
+// they are unrolled, including when an unrolled iteration deoptimizes.
+
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation --no-loop-unrolling
+
+import "package:expect/expect.dart";
+
+int sum4(List<int> a) {
+  int sum = 0;
+  for (int i = 0; i < 4; i++) {
+    sum += a[i];
+  }
+  return sum;
+}
+
+int sumOdd(List<int> a) {
+  int sum = 0;
+  for (int i = 1; i <= 7; i += 2) {
+    sum += a[i];
+  }
+  return sum;
+}
+
+int sumDown(List<int> a) {
+  int sum = 0;
+  for (int i = 5; i > 1; i--) {
+    sum = sum * 2 + a[2 * i - 1];
+  }
+  return sum;
+}
+
+int lastIndex() {
+  int i = 0;
+  for (; i < 3; i++) {}
+  return i;
+}
+
+int never(List<int> a) {
+  int sum = 0;
+  for (int i = 10; i < 4; i++) {
+    sum += a[i];
+  }
+  return sum;
+}
+
+void fill(List<int> a) {
+  for (int i = 0; i < 3; i++) {
+    a[i + 1] = a[i] + 1;
+  }
+}
+
+int nested(List<int> a) {
+  int sum = 0;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 2; j++) {
+      sum += a[i * 2 + j];
+    }
+  }
+  return sum;
+}
+
+int addAll(List<int> a, int x) {
+  for (int i = 0; i < 2; i++) {
+    x += a[i];
+  }
+  return x;
+}
+
+void main() {
+  final a = new List<int>.generate(10, (i) => i + 1);
+  for (int i = 0; i < 50; i++) {
+    Expect.equals(10, sum4(a));
+    Expect.equals(2 + 4 + 6 + 8, sumOdd(a));
+    Expect.equals(((10 * 2 + 8) * 2 + 6) * 2 + 4, sumDown(a));
+    Expect.equals(3, lastIndex());
+    Expect.equals(0, never(a));
+    Expect.equals(21, nested(a));
+    Expect.equals(13, addAll(a, 10));
+
+    final b = new List<int>(4);
+    b[0] = i;
+    fill(b);
+    Expect.listEquals([i, i + 1, i + 2, i + 3], b);
+  }
+
+  // Deoptimize inside the unrolled iterations.
+  Expect.throws(() => sum4(new List<int>(3)..fillRange(0, 3, 1)));
+  Expect.equals(1 << 62, addAll(a, (1 << 62) - 3));
+  Expect.equals(10, sum4(a));
+  Expect.equals(13, addAll(a, 10));
+}
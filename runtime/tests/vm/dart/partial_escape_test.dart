@@ -0,0 +1,118 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that objects escaping only on some paths keep their state and identity
+// when they are allocated on these paths only.
+
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation --no-partial-escape-analysis
+
+import "package:expect/expect.dart";
+
+class Point {
+  int x;
+  int y;
+  Point(this.x, this.y);
+}
+
+class Box<T> {
+  T value;
+  Box(this.value);
+}
+
+Point escaped;
+List<Object> log = [];
+
+void record(Object o) {
+  log.add(o);
+}
+
+int sumOrEscape(int x, int y, bool escape) {
+  final p = new Point(x, y);
+  if (escape) {
+    escaped = p;
+  }
+  return p.x + p.y;
+}
+
+int updateAfterEscape(int x, bool escape) {
+  final p = new Point(x, 0);
+  p.y = x + 1;
+  if (escape) {
+    record(p);
+    p.x = 100;
+    record(p);
+  }
+  return p.x + p.y;
+}
+
+int escapeOnBothPaths(int x, int n) {
+  final p = new Point(x, x);
+  if (n == 0) {
+    record(p);
+  } else if (n == 1) {
+    p.y = 7;
+    escaped = p;
+  }
+  return p.y;
+}
+
+Box<T> boxOrNull<T>(T value, bool escape) {
+  final b = new Box<T>(value);
+  if (escape) {
+    return b;
+  }
+  return null;
+}
+
+int deoptAfter(int x, bool escape, Object o) {
+  final p = new Point(x, x + 1);
+  if (escape) {
+    record(p);
+  }
+  // Deoptimizes when o is not an int and needs p's state.
+  return (o as int) + p.x + p.y;
+}
+
+void main() {
+  for (int i = 0; i < 50; i++) {
+    log.clear();
+    escaped = null;
+
+    Expect.equals(2 * i + 1, sumOrEscape(i, i + 1, false));
+    Expect.isNull(escaped);
+    Expect.equals(2 * i + 1, sumOrEscape(i, i + 1, (i & 3) == 0));
+    if ((i & 3) == 0) {
+      Expect.equals(i, escaped.x);
+      Expect.equals(i + 1, escaped.y);
+    }
+
+    Expect.equals(2 * i + 1, updateAfterEscape(i, false));
+    Expect.equals(100 + i + 1, updateAfterEscape(i, true));
+    Expect.equals(2, log.length);
+    Expect.identical(log[0], log[1]);
+    Expect.equals(100, (log[0] as Point).x);
+    Expect.equals(i + 1, (log[0] as Point).y);
+
+    log.clear();
+    Expect.equals(i, escapeOnBothPaths(i, 0));
+    Expect.equals(i, (log[0] as Point).y);
+    Expect.equals(7, escapeOnBothPaths(i, 1));
+    Expect.equals(7, escaped.y);
+    Expect.equals(i, escapeOnBothPaths(i, 2));
+
+    Expect.isNull(boxOrNull<String>("a", false));
+    final box = boxOrNull<String>("b$i", true);
+    Expect.isTrue(box is Box<String>);
+    Expect.equals("b$i", box.value);
+
+    Expect.equals(1 + 2 * i + 1, deoptAfter(i, (i & 1) == 0, 1));
+  }
+
+  Expect.throws(() => deoptAfter(1, false, "x"));
+  log.clear();
+  Expect.throws(() => deoptAfter(1, true, "x"));
+  Expect.equals(1, (log[0] as Point).x);
+  Expect.equals(3, deoptAfter(0, false, 0) + deoptAfter(0, true, 1));
+}
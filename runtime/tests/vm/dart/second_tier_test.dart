@@ -0,0 +1,101 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that functions that stay hot after their first optimization compute
+// the same results when they are reoptimized in the second tier with larger
+// inlining and polymorphic check budgets, and after that code deoptimizes.
+
+// VMOptions=--optimization_counter_threshold=10 --second_tier_counter_threshold=20 --no-use-osr --no-background-compilation
+// VMOptions=--optimization_counter_threshold=10 --second_tier_counter_threshold=0 --no-use-osr --no-background-compilation
+// VMOptions=--optimization_counter_threshold=10 --second_tier_counter_threshold=20 --second_tier_max_polymorphic_checks=1 --no-use-osr --no-background-compilation
+
+import "package:expect/expect.dart";
+
+abstract class Shape {
+  int get sides;
+  int area(int n);
+}
+
+class Triangle extends Shape {
+  int get sides => 3;
+  int area(int n) => n * n ~/ 2;
+}
+
+class Square extends Shape {
+  int get sides => 4;
+  int area(int n) => n * n;
+}
+
+class Pentagon extends Shape {
+  int get sides => 5;
+  int area(int n) => n * n + n;
+}
+
+class Hexagon extends Shape {
+  int get sides => 6;
+  int area(int n) => 2 * n * n;
+}
+
+class Octagon extends Shape {
+  int get sides => 8;
+  int area(int n) => 3 * n * n;
+}
+
+class Circle extends Shape {
+  int get sides => 0;
+  int area(int n) => 3 * n * n + n ~/ 7;
+}
+
+int total(List<Shape> shapes, int n) {
+  int sum = 0;
+  for (int i = 0; i < shapes.length; i++) {
+    sum += shapes[i].sides + shapes[i].area(n);
+  }
+  return sum;
+}
+
+int unrolled(List<int> a) {
+  int sum = 0;
+  for (int i = 0; i < 12; i++) {
+    sum += a[i];
+  }
+  return sum;
+}
+
+int expected(List<Shape> shapes, int n) {
+  int sum = 0;
+  for (var shape in shapes) {
+    if (shape is Triangle) sum += 3 + n * n ~/ 2;
+    if (shape is Square) sum += 4 + n * n;
+    if (shape is Pentagon) sum += 5 + n * n + n;
+    if (shape is Hexagon) sum += 6 + 2 * n * n;
+    if (shape is Octagon) sum += 8 + 3 * n * n;
+  }
+  return sum;
+}
+
+void main() {
+  final shapes = <Shape>[
+    new Triangle(),
+    new Square(),
+    new Pentagon(),
+    new Hexagon(),
+    new Octagon(),
+  ];
+  final a = new List<int>.generate(12, (i) => i);
+  for (int i = 0; i < 200; i++) {
+    Expect.equals(expected(shapes, i), total(shapes, i));
+    Expect.equals(66, unrolled(a));
+  }
+
+  // A new receiver class and a non-smi element deoptimize the second tier
+  // code.
+  shapes.add(new Circle());
+  Expect.equals(expected(shapes, 7) + 0 + 3 * 49 + 1, total(shapes, 7));
+  a[11] = 1 << 62;
+  Expect.equals(55 + (1 << 62), unrolled(a));
+  for (int i = 0; i < 200; i++) {
+    Expect.equals(expected(shapes, i) + 3 * i * i + i ~/ 7, total(shapes, i));
+  }
+}
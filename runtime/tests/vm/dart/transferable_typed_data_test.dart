@@ -0,0 +1,92 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that TransferableTypedData moves its bytes between isolates and can
+// only be materialized once.
+
+import "dart:async";
+import "dart:isolate";
+import "dart:typed_data";
+import "package:expect/expect.dart";
+
+// Materializes the received bytes, increments each of them and sends them
+// back as a new transferable.
+void echo(SendPort replyPort) {
+  final port = new ReceivePort();
+  replyPort.send(port.sendPort);
+  port.listen((message) {
+    if (message == null) {
+      port.close();
+      return;
+    }
+    final TransferableTypedData transferable = message;
+    final bytes = transferable.materialize().asUint8List();
+    for (int i = 0; i < bytes.length; i++) {
+      bytes[i]++;
+    }
+    replyPort.send(new TransferableTypedData.fromList([bytes]));
+  });
+}
+
+void testFromList() {
+  final ints = new Int32List.fromList([1, 2]);
+  final bytes = new Uint8List.fromList([3, 4, 5, 6, 7]);
+  final view = new Uint8List.view(bytes.buffer, 1, 3);
+  final data = new ByteData(2)..setUint8(0, 8)..setUint8(1, 9);
+  final transferable =
+      new TransferableTypedData.fromList([ints, view, data, new Uint8List(0)]);
+
+  final result = transferable.materialize().asUint8List();
+  final expected = new Uint8List(13);
+  expected.setRange(0, 8, ints.buffer.asUint8List());
+  expected.setRange(8, 13, [4, 5, 6, 8, 9]);
+  Expect.listEquals(expected, result);
+
+  // The bytes were moved into [result].
+  Expect.throws(() => transferable.materialize(), (e) => e is ArgumentError);
+
+  Expect.equals(0,
+      new TransferableTypedData.fromList([]).materialize().lengthInBytes);
+  Expect.throws(() => new TransferableTypedData.fromList([null]),
+      (e) => e is ArgumentError);
+}
+
+Future testSend() async {
+  final port = new ReceivePort();
+  await Isolate.spawn(echo, port.sendPort);
+  final replies = new StreamIterator(port);
+  Expect.isTrue(await replies.moveNext());
+  final SendPort echoPort = replies.current;
+
+  const int kLength = 1 << 20;
+  final bytes = new Uint8List(kLength);
+  for (int i = 0; i < kLength; i++) {
+    bytes[i] = i & 0x7F;
+  }
+  var transferable = new TransferableTypedData.fromList([bytes]);
+  for (int round = 1; round <= 3; round++) {
+    echoPort.send(transferable);
+
+    // Once sent, the bytes belong to the receiver.
+    Expect.throws(() => transferable.materialize(), (e) => e is ArgumentError);
+    Expect.throws(() => echoPort.send(transferable), (e) => e is ArgumentError);
+
+    Expect.isTrue(await replies.moveNext());
+    transferable = replies.current;
+  }
+
+  final result = transferable.materialize().asUint8List();
+  Expect.equals(kLength, result.length);
+  for (int i = 0; i < kLength; i++) {
+    Expect.equals((i & 0x7F) + 3, result[i]);
+  }
+
+  echoPort.send(null);
+  await replies.cancel();
+}
+
+main() async {
+  testFromList();
+  await testSend();
+}
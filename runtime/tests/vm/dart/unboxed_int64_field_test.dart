@@ -0,0 +1,58 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that int64 fields which only ever hold values outside of the Smi range
+// are stored in a private box that optimized code updates in place, and that
+// values read from such fields never alias that box.
+
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation --no-unbox-numeric-fields
+
+import "package:expect/expect.dart";
+
+const int kBig = 0x4000000000000000;
+
+class Acc {
+  int sum;
+  double scale;
+  Acc(this.sum, this.scale);
+}
+
+void add(Acc acc, int x) {
+  acc.sum += x;
+  acc.scale *= 2.0;
+}
+
+int read(Acc acc) => acc.sum;
+
+void main() {
+  final acc = new Acc(kBig, 1.0);
+  final values = <int>[];
+  for (int i = 0; i < 100; i++) {
+    add(acc, 3);
+    values.add(read(acc));
+  }
+  for (int i = 0; i < values.length; i++) {
+    Expect.equals(kBig + 3 * (i + 1), values[i]);
+  }
+  Expect.equals(kBig + 300, acc.sum);
+  Expect.equals(1.0 * (1 << 50) * (1 << 50), acc.scale);
+
+  // Values previously read from the field are not affected by later stores.
+  final before = acc.sum;
+  add(acc, 1);
+  Expect.equals(kBig + 300, before);
+  Expect.equals(kBig + 301, acc.sum);
+
+  // Storing a Smi changes the guarded class of the field and deoptimizes.
+  add(acc, -acc.sum + 5);
+  Expect.equals(5, acc.sum);
+  Expect.equals(5, read(acc));
+  // Steps small enough that the sum stays within the int64 range.
+  const int kStep = kBig ~/ 32;
+  for (int i = 0; i < 20; i++) {
+    add(acc, kStep);
+  }
+  Expect.equals(5 + 20 * kStep, acc.sum);
+}
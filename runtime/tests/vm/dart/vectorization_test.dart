@@ -0,0 +1,142 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that loops over typed data compute the same results when they are
+// rewritten into SIMD operations followed by a scalar epilogue.
+
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation --no-loop-vectorization
+
+import "dart:typed_data";
+import "package:expect/expect.dart";
+
+void copy(Uint8List dst, Uint8List src) {
+  for (int i = 0; i < dst.length; i++) {
+    dst[i] = src[i];
+  }
+}
+
+void mask(Uint8List dst, Uint8List src, int key) {
+  for (int i = 0; i < src.length; i++) {
+    dst[i] = src[i] ^ key;
+  }
+}
+
+void xorFrom(Uint8List dst, Uint8List a, Uint8List b, int start, int n) {
+  for (int i = start; i < n; i++) {
+    dst[i] = (a[i] ^ b[i]) & 0x7F;
+  }
+}
+
+void mul(Float64List c, Float64List a, Float64List b) {
+  for (int i = 0; i < c.length; i++) {
+    c[i] = a[i] * b[i];
+  }
+}
+
+void axpy(Float64List y, Float64List x, double a) {
+  for (int i = 0; i < y.length; i++) {
+    y[i] = a * x[i] + y[i];
+  }
+}
+
+void add32(Float32List c, Float32List a, Float32List b) {
+  for (int i = 0; i < c.length; i++) {
+    c[i] = a[i] + b[i];
+  }
+}
+
+Uint8List bytes(int n, int seed) {
+  final result = new Uint8List(n);
+  for (int i = 0; i < n; i++) {
+    result[i] = (i * 31 + seed) & 0xFF;
+  }
+  return result;
+}
+
+Float64List doubles(int n, double seed) {
+  final result = new Float64List(n);
+  for (int i = 0; i < n; i++) {
+    result[i] = seed + i / 4;
+  }
+  return result;
+}
+
+void testBytes(int n) {
+  final src = bytes(n, 7);
+  final other = bytes(n, 100);
+
+  final dst = new Uint8List(n);
+  copy(dst, src);
+  Expect.listEquals(src, dst);
+
+  mask(dst, src, 0x15A);
+  for (int i = 0; i < n; i++) {
+    Expect.equals((src[i] ^ 0x5A), dst[i]);
+  }
+
+  dst.fillRange(0, n, 1);
+  xorFrom(dst, src, other, 3, n - 1);
+  for (int i = 0; i < n; i++) {
+    final expected =
+        (i >= 3 && i < n - 1) ? ((src[i] ^ other[i]) & 0x7F) : 1;
+    Expect.equals(expected, dst[i]);
+  }
+}
+
+void testDoubles(int n) {
+  final a = doubles(n, 1.5);
+  final b = doubles(n, -2.0);
+
+  final c = new Float64List(n);
+  mul(c, a, b);
+  for (int i = 0; i < n; i++) {
+    Expect.equals(a[i] * b[i], c[i]);
+  }
+
+  final y = doubles(n, 0.25);
+  final expected = new List<double>.generate(n, (i) => 3.0 * a[i] + y[i]);
+  axpy(y, a, 3.0);
+  for (int i = 0; i < n; i++) {
+    Expect.equals(expected[i], y[i]);
+  }
+
+  final a32 = new Float32List.fromList(a);
+  final b32 = new Float32List.fromList(b);
+  final c32 = new Float32List(n);
+  add32(c32, a32, b32);
+  for (int i = 0; i < n; i++) {
+    Expect.equals(new Float32List.fromList([a32[i] + b32[i]])[0], c32[i]);
+  }
+}
+
+void main() {
+  for (int i = 0; i < 50; i++) {
+    // Lengths below, at and above the vector sizes.
+    for (int n in [0, 1, 5, 16, 17, 35, 100]) {
+      testBytes(n);
+    }
+    for (int n in [0, 1, 2, 3, 8, 11, 50]) {
+      testDoubles(n);
+    }
+  }
+
+  // The scalar epilogue throws at the first index that is out of bounds,
+  // after all stores to the elements in front of it.
+  final dst = new Uint8List(40);
+  final short = bytes(35, 9);
+  Expect.throws(() => copy(dst, short), (e) => e is RangeError);
+  Expect.listEquals(short, dst.sublist(0, 35));
+  Expect.listEquals(new Uint8List(5), dst.sublist(35));
+  final src = bytes(40, 1);
+  copy(dst, src);
+  Expect.listEquals(src, dst);
+
+  final c = new Float64List(9);
+  Expect.throws(
+      () => mul(c, doubles(9, 1.0), doubles(4, 1.0)), (e) => e is RangeError);
+  Expect.listEquals(
+      [1.0, 1.25 * 1.25, 1.5 * 1.5, 1.75 * 1.75], c.sublist(0, 4));
+  Expect.equals(0.0, c[4]);
+}
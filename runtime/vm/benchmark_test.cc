@@ -15,6 +15,8 @@
 #include "vm/clustered_snapshot.h"
 #include "vm/compiler_stats.h"
 #include "vm/dart_api_impl.h"
+#include "vm/message_handler.h"
+#include "vm/port.h"
 #include "vm/stack_frame.h"
 
 using dart::bin::File;
@@ -23,6 +25,7 @@ namespace dart {
 
 DECLARE_FLAG(bool, use_dart_frontend);
 DECLARE_FLAG(bool, strong);
+DECLARE_FLAG(int, snapshot_fill_tasks);
 
 Benchmark* Benchmark::first_ = NULL;
 Benchmark* Benchmark::tail_ = NULL;
@@ -197,6 +200,46 @@ BENCHMARK(CorelibIsolateStartup) {
   Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
 }
 
+//
+// Measure creation of core isolate from a snapshot when the clusters are
+// filled by the given number of helper tasks.
+//
+static void IsolateStartupWithFillTasks(Benchmark* benchmark,
+                                        Thread* thread,
+                                        int fill_tasks) {
+  const int kNumIterations = 1000;
+  Timer timer(true, "CorelibIsolateStartup");
+  const int saved_fill_tasks = FLAG_snapshot_fill_tasks;
+  FLAG_snapshot_fill_tasks = fill_tasks;
+  Isolate* isolate = thread->isolate();
+  Dart_ExitIsolate();
+  for (int i = 0; i < kNumIterations; i++) {
+    timer.Start();
+    TestCase::CreateTestIsolate();
+    timer.Stop();
+    Dart_ShutdownIsolate();
+  }
+  benchmark->set_score(timer.TotalElapsedTime() / kNumIterations);
+  Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
+  FLAG_snapshot_fill_tasks = saved_fill_tasks;
+}
+
+BENCHMARK(CorelibIsolateStartupFillTasks0) {
+  IsolateStartupWithFillTasks(benchmark, thread, 0);
+}
+
+BENCHMARK(CorelibIsolateStartupFillTasks1) {
+  IsolateStartupWithFillTasks(benchmark, thread, 1);
+}
+
+BENCHMARK(CorelibIsolateStartupFillTasks2) {
+  IsolateStartupWithFillTasks(benchmark, thread, 2);
+}
+
+BENCHMARK(CorelibIsolateStartupFillTasks4) {
+  IsolateStartupWithFillTasks(benchmark, thread, 4);
+}
+
 //
 // Measure invocation of Dart API functions.
 //
@@ -301,6 +344,103 @@ BENCHMARK(UseDartApi) {
   benchmark->set_score(elapsed_time);
 }
 
+//
+// Measure the performance of short counted loops that are candidates for
+// unrolling and bounds check elimination.
+//
+BENCHMARK(SmallLoops) {
+  const int kNumIterations = 1000000;
+  const char* kScriptChars =
+      "int dot4(List<int> a, List<int> b) {\n"
+      "  int sum = 0;\n"
+      "  for (int i = 0; i < 4; i++) {\n"
+      "    sum += a[i] * b[i];\n"
+      "  }\n"
+      "  return sum;\n"
+      "}\n"
+      "\n"
+      "int sumEven(List<int> a) {\n"
+      "  int sum = 0;\n"
+      "  for (int i = 0; i < a.length; i += 2) {\n"
+      "    sum += a[i];\n"
+      "  }\n"
+      "  return sum;\n"
+      "}\n"
+      "\n"
+      "int benchmark(int count) {\n"
+      "  List<int> a = new List<int>(16);\n"
+      "  List<int> b = new List<int>(16);\n"
+      "  for (int i = 0; i < 16; i++) {\n"
+      "    a[i] = i;\n"
+      "    b[i] = 16 - i;\n"
+      "  }\n"
+      "  int result = 0;\n"
+      "  for (int i = 0; i < count; i++) {\n"
+      "    result = (result + dot4(a, b) + sumEven(a)) & 0xFFFF;\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n";
+
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_Handle args[1];
+  args[0] = Dart_NewInteger(kNumIterations);
+
+  // Warmup first to avoid compilation jitters.
+  Dart_Handle result = Dart_Invoke(lib, NewString("benchmark"), 1, args);
+  EXPECT_VALID(result);
+
+  Timer timer(true, "SmallLoops benchmark");
+  timer.Start();
+  result = Dart_Invoke(lib, NewString("benchmark"), 1, args);
+  EXPECT_VALID(result);
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+//
+// Count scavenges caused by a hot loop whose temporary objects escape only
+// on a rarely taken path. The allocation is moved onto that path by the
+// partial escape analysis in allocation sinking.
+//
+BENCHMARK_COUNT(PartialEscapeScavenges) {
+  const int kNumIterations = 10000000;
+  const char* kScriptChars =
+      "class Point {\n"
+      "  final int x;\n"
+      "  final int y;\n"
+      "  Point(this.x, this.y);\n"
+      "}\n"
+      "\n"
+      "Point escaped;\n"
+      "\n"
+      "int benchmark(int count) {\n"
+      "  int result = 0;\n"
+      "  for (int i = 0; i < count; i++) {\n"
+      "    final p = new Point(i, result);\n"
+      "    if ((i & 0xFFFF) == 0) {\n"
+      "      escaped = p;\n"
+      "    }\n"
+      "    result = (p.x + p.y) & 0xFFFF;\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n";
+
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_Handle args[1];
+  args[0] = Dart_NewInteger(kNumIterations);
+
+  // Warmup first to avoid counting scavenges of the unoptimized code.
+  Dart_Handle result = Dart_Invoke(lib, NewString("benchmark"), 1, args);
+  EXPECT_VALID(result);
+
+  Heap* heap = thread->isolate()->heap();
+  intptr_t collections = heap->Collections(Heap::kNew);
+  result = Dart_Invoke(lib, NewString("benchmark"), 1, args);
+  EXPECT_VALID(result);
+  benchmark->set_score(heap->Collections(Heap::kNew) - collections);
+}
+
 static void NoopFinalizer(void* isolate_callback_data,
                           Dart_WeakPersistentHandle handle,
                           void* peer) {}
@@ -655,6 +795,56 @@ BENCHMARK(SimpleMessage) {
   benchmark->set_score(elapsed_time);
 }
 
+//
+// Measure round trips of a large buffer between isolates, once copied as a
+// typed data and once moved as a transferable typed data.
+//
+static const intptr_t kLargeMessageBytes = 50 * MB;
+static const intptr_t kLargeMessageRoundTrips = 20;
+
+static RawObject* SendAndReceive(Thread* thread, const Object& object) {
+  MessageWriter writer(true);
+  Message* message =
+      writer.WriteMessage(object, ILLEGAL_PORT, Message::kNormalPriority);
+  MessageSnapshotReader reader(message, thread);
+  const Object& result = Object::Handle(reader.ReadObject());
+  delete message;
+  return result.raw();
+}
+
+BENCHMARK(LargeTypedDataMessage) {
+  TransitionNativeToVM transition(thread);
+  const TypedData& data = TypedData::Handle(
+      TypedData::New(kTypedDataUint8ArrayCid, kLargeMessageBytes, Heap::kOld));
+  Object& object = Object::Handle();
+  Timer timer(true, "Large TypedData Message");
+  timer.Start();
+  for (intptr_t i = 0; i < kLargeMessageRoundTrips; i++) {
+    StackZone zone(thread);
+    object = SendAndReceive(thread, data);
+    object = SendAndReceive(thread, object);
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(TransferableTypedDataMessage) {
+  TransitionNativeToVM transition(thread);
+  uint8_t* bytes = reinterpret_cast<uint8_t*>(malloc(kLargeMessageBytes));
+  memset(bytes, 0, kLargeMessageBytes);
+  Object& object =
+      Object::Handle(TransferableTypedData::New(bytes, kLargeMessageBytes));
+  Timer timer(true, "Transferable TypedData Message");
+  timer.Start();
+  for (intptr_t i = 0; i < kLargeMessageRoundTrips; i++) {
+    StackZone zone(thread);
+    object = SendAndReceive(thread, object);
+    object = SendAndReceive(thread, object);
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
 BENCHMARK(LargeMap) {
   const char* kScript =
       "makeMap() {\n"
@@ -687,8 +877,261 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+static const intptr_t kTenuredAllocationCount = 200000;
+static const intptr_t kTenuredAllocationHelpers = 3;
+
+static void AllocateTenured(Thread* thread) {
+  for (intptr_t i = 0; i < kTenuredAllocationCount; i += 1000) {
+    HANDLESCOPE(thread);
+    Array& array = Array::Handle(thread->zone());
+    for (intptr_t j = 0; j < 1000; j++) {
+      array = Array::New(4, Heap::kOld);
+    }
+  }
+}
+
+class TenuredAllocationTask : public ThreadPool::Task {
+ public:
+  TenuredAllocationTask(Isolate* isolate, Monitor* monitor, intptr_t* done)
+      : isolate_(isolate), monitor_(monitor), done_(done) {}
+
+  virtual void Run() {
+    Thread::EnterIsolateAsHelper(isolate_, Thread::kUnknownTask);
+    {
+      Thread* thread = Thread::Current();
+      StackZone stack_zone(thread);
+      AllocateTenured(thread);
+    }
+    Thread::ExitIsolateAsHelper();
+    {
+      MonitorLocker ml(monitor_);
+      ++*done_;
+      ml.Notify();
+    }
+  }
+
+ private:
+  Isolate* isolate_;
+  Monitor* monitor_;
+  intptr_t* done_;
+};
+
+// Old-space allocation by the mutator while helper threads do the same.
+BENCHMARK(TenuredAllocation) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  NoHeapGrowthControlScope no_growth_control;
+  Monitor monitor;
+  intptr_t done = 0;
+  Timer timer(true, "Tenured allocation");
+  timer.Start();
+  for (intptr_t i = 0; i < kTenuredAllocationHelpers; i++) {
+    Dart::thread_pool()->Run(
+        new TenuredAllocationTask(thread->isolate(), &monitor, &done));
+  }
+  AllocateTenured(thread);
+  {
+    MonitorLocker ml(&monitor);
+    while (done < kTenuredAllocationHelpers) {
+      ml.WaitWithSafepointCheck(thread);
+    }
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+//
+// Measure the pause of scavenging a graph of young objects that survive,
+// interleaved with garbage, when the given number of scavenger tasks
+// evacuates new space. Zero tasks is the serial scavenger.
+//
+static void ScavengeWithTasks(Benchmark* benchmark,
+                              Thread* thread,
+                              intptr_t scavenger_tasks) {
+  const intptr_t kNumIterations = 20;
+  const intptr_t kNumRoots = 5000;
+  const intptr_t kChainLength = 10;
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  Heap* heap = thread->isolate()->heap();
+  const intptr_t saved_scavenger_tasks = FLAG_scavenger_tasks;
+  FLAG_scavenger_tasks = scavenger_tasks;
+  Timer timer(true, "Scavenge");
+  Array& old = Array::Handle(Array::New(kNumRoots, Heap::kOld));
+  Array& neu = Array::Handle();
+  Array& next = Array::Handle();
+  Array& garbage = Array::Handle();
+  for (intptr_t n = 0; n < kNumIterations; n++) {
+    heap->CollectAllGarbage();
+    for (intptr_t i = 0; i < kNumRoots; i++) {
+      neu = Array::New(2, Heap::kNew);
+      old.SetAt(i, neu);
+      for (intptr_t j = 0; j < kChainLength; j++) {
+        next = Array::New(2, Heap::kNew);
+        garbage = Array::New(2, Heap::kNew);
+        garbage.SetAt(0, next);
+        neu.SetAt(0, next);
+        neu = next.raw();
+      }
+    }
+    neu = Array::null();
+    next = Array::null();
+    garbage = Array::null();
+    timer.Start();
+    heap->CollectGarbage(Heap::kNew);
+    timer.Stop();
+  }
+  FLAG_scavenger_tasks = saved_scavenger_tasks;
+  benchmark->set_score(timer.TotalElapsedTime() / kNumIterations);
+}
+
+BENCHMARK(ScavengeTasks0) {
+  ScavengeWithTasks(benchmark, thread, 0);
+}
+
+BENCHMARK(ScavengeTasks1) {
+  ScavengeWithTasks(benchmark, thread, 1);
+}
+
+BENCHMARK(ScavengeTasks2) {
+  ScavengeWithTasks(benchmark, thread, 2);
+}
+
+BENCHMARK(ScavengeTasks4) {
+  ScavengeWithTasks(benchmark, thread, 4);
+}
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
 
+//
+// Measure the latency and the memory footprint of creating many isolates
+// that run the same program and stay alive at the same time, as a process
+// with a pool of worker isolates does.
+//
+static void SpawnIsolates(Thread* thread,
+                          int64_t* latency_micros,
+                          int64_t* rss_per_isolate) {
+  const intptr_t kNumIsolates = 32;
+  Dart_Isolate isolates[kNumIsolates];
+  Timer timer(true, "IsolateSpawn");
+  Isolate* isolate = thread->isolate();
+  Dart_ExitIsolate();
+  const int64_t rss_before = bin::Process::CurrentRSS();
+  for (intptr_t i = 0; i < kNumIsolates; i++) {
+    timer.Start();
+    isolates[i] = TestCase::CreateTestIsolate();
+    timer.Stop();
+    EXPECT(isolates[i] != NULL);
+    Dart_ExitIsolate();
+  }
+  const int64_t rss_after = bin::Process::CurrentRSS();
+  for (intptr_t i = 0; i < kNumIsolates; i++) {
+    Dart_EnterIsolate(isolates[i]);
+    Dart_ShutdownIsolate();
+  }
+  Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
+  *latency_micros = timer.TotalElapsedTime() / kNumIsolates;
+  *rss_per_isolate = (rss_after - rss_before) / kNumIsolates;
+}
+
+BENCHMARK(IsolateSpawnLatency) {
+  int64_t latency_micros = 0;
+  int64_t rss_per_isolate = 0;
+  SpawnIsolates(thread, &latency_micros, &rss_per_isolate);
+  benchmark->set_score(latency_micros);
+}
+
+BENCHMARK_MEMORY(IsolateSpawnRSS) {
+  int64_t latency_micros = 0;
+  int64_t rss_per_isolate = 0;
+  SpawnIsolates(thread, &latency_micros, &rss_per_isolate);
+  benchmark->set_score(rss_per_isolate);
+}
+
+//
+// Measure how lookups in the port map scale when several threads post
+// messages at the same time. Each thread posts to its own port, so the port
+// map is the only structure the threads share. With perfect scaling the
+// score stays the same as the number of threads grows.
+//
+static const intptr_t kPortMapMessages = 1 << 16;
+
+class PortMapBenchmarkHandler : public MessageHandler {
+ public:
+  PortMapBenchmarkHandler() {}
+
+  MessageStatus HandleMessage(Message* message) { return kOK; }
+};
+
+class PortMapPostMessageTask : public ThreadPool::Task {
+ public:
+  PortMapPostMessageTask(Dart_Port port, Monitor* monitor, intptr_t* done)
+      : port_(port), monitor_(monitor), done_(done) {}
+
+  virtual void Run() {
+    for (intptr_t i = 0; i < kPortMapMessages; i++) {
+      PortMap::PostMessage(
+          new Message(port_, Smi::New(i), Message::kNormalPriority));
+    }
+    MonitorLocker ml(monitor_);
+    ++*done_;
+    ml.Notify();
+  }
+
+ private:
+  Dart_Port port_;
+  Monitor* monitor_;
+  intptr_t* done_;
+};
+
+static void PortMapPostMessage(Benchmark* benchmark, intptr_t num_threads) {
+  PortMapBenchmarkHandler* handlers =
+      new PortMapBenchmarkHandler[num_threads];
+  Dart_Port* ports = new Dart_Port[num_threads];
+  for (intptr_t i = 0; i < num_threads; i++) {
+    ports[i] = PortMap::CreatePort(&handlers[i]);
+  }
+  Monitor monitor;
+  intptr_t done = 0;
+  Timer timer(true, "PortMap PostMessage");
+  timer.Start();
+  for (intptr_t i = 0; i < num_threads; i++) {
+    Dart::thread_pool()->Run(
+        new PortMapPostMessageTask(ports[i], &monitor, &done));
+  }
+  {
+    MonitorLocker ml(&monitor);
+    while (done < num_threads) {
+      ml.Wait();
+    }
+  }
+  timer.Stop();
+  for (intptr_t i = 0; i < num_threads; i++) {
+    PortMap::ClosePorts(&handlers[i]);
+  }
+  delete[] ports;
+  delete[] handlers;
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(PortMapPostMessage1) {
+  PortMapPostMessage(benchmark, 1);
+}
+
+BENCHMARK(PortMapPostMessage2) {
+  PortMapPostMessage(benchmark, 2);
+}
+
+BENCHMARK(PortMapPostMessage4) {
+  PortMapPostMessage(benchmark, 4);
+}
+
+BENCHMARK(PortMapPostMessage8) {
+  PortMapPostMessage(benchmark, 8);
+}
+
 }  // namespace dart
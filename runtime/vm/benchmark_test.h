@@ -54,6 +54,7 @@ extern const uint8_t* core_isolate_snapshot_instructions;
 #define BENCHMARK(name) BENCHMARK_HELPER(name, "RunTime")
 #define BENCHMARK_SIZE(name) BENCHMARK_HELPER(name, "CodeSize")
 #define BENCHMARK_MEMORY(name) BENCHMARK_HELPER(name, "MemoryUse")
+#define BENCHMARK_COUNT(name) BENCHMARK_HELPER(name, "Count")
 
 inline Dart_Handle NewString(const char* str) {
   return Dart_NewStringFromCString(str);
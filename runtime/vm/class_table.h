@@ -294,7 +294,8 @@ class ClassTable {
  private:
   friend class GCMarker;
   friend class MarkingWeakVisitor;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class ScavengerWeakVisitor;
   friend class ClassHeapStatsTestHelper;
   static const int initial_capacity_ = 512;
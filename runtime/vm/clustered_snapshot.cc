@@ -8,6 +8,7 @@
 #include "vm/bootstrap.h"
 #include "vm/compiler/backend/code_statistics.h"
 #include "vm/dart.h"
+#include "vm/flags.h"
 #include "vm/heap/heap.h"
 #include "vm/image_snapshot.h"
 #include "vm/native_entry.h"
@@ -16,6 +17,8 @@
 #include "vm/program_visitor.h"
 #include "vm/stub_code.h"
 #include "vm/symbols.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/version.h"
 
@@ -23,6 +26,12 @@
 
 namespace dart {
 
+DEFINE_FLAG(int,
+            snapshot_fill_tasks,
+            2,
+            "The number of helper tasks that fill snapshot clusters "
+            "alongside the isolate's thread. 0 fills them on that thread.");
+
 static RawObject* AllocateUninitialized(PageSpace* old_space, intptr_t size) {
   ASSERT(Utils::IsAligned(size, kObjectAlignment));
   uword address =
@@ -173,6 +182,9 @@ class ClassDeserializationCluster : public DeserializationCluster {
   ClassDeserializationCluster() {}
   virtual ~ClassDeserializationCluster() {}
 
+  // Filling registers the classes in the class table.
+  bool CanReadFillConcurrently() const { return false; }
+
   void ReadAlloc(Deserializer* d) {
     predefined_start_index_ = d->next_index();
     PageSpace* old_space = d->heap()->old_space();
@@ -669,6 +681,7 @@ class FunctionDeserializationCluster : public DeserializationCluster {
         func->ptr()->deoptimization_counter_ = 0;
         func->ptr()->state_bits_ = 0;
         func->ptr()->inlining_depth_ = 0;
+        func->ptr()->optimization_tier_ = 0;
 #endif
       }
     }
@@ -1670,6 +1683,9 @@ class CodeSerializationCluster : public SerializationCluster {
   }
 
   void WriteAlloc(Serializer* s) {
+    if (s->kind() == Snapshot::kFullAOT) {
+      OrderByTrainingRun();
+    }
     s->WriteCid(kCodeCid);
     intptr_t count = objects_.length();
     s->WriteUnsigned(count);
@@ -1736,6 +1752,40 @@ class CodeSerializationCluster : public SerializationCluster {
   }
 
  private:
+  // The instructions are written in the order of objects_. Move the code that
+  // was hot in the training run to the front, hottest first, so it is packed
+  // together in the text section. The rest keeps the order it was traced in.
+  void OrderByTrainingRun() {
+    const Array& code_order =
+        Array::Handle(Isolate::Current()->object_store()->code_order());
+    if (code_order.IsNull()) {
+      return;
+    }
+    typedef RawPointerKeyValueTrait<RawCode, bool> PlacedTrait;
+    DirectChainedHashMap<PlacedTrait> placed;
+    for (intptr_t i = 0; i < objects_.length(); i++) {
+      placed.Insert(PlacedTrait::Pair(objects_[i], false));
+    }
+    GrowableArray<RawCode*> ordered(objects_.length());
+    for (intptr_t i = 0; i < code_order.Length(); i++) {
+      RawCode* code = Code::RawCast(code_order.At(i));
+      PlacedTrait::Pair* pair = placed.Lookup(code);
+      if ((pair != NULL) && !pair->value) {
+        pair->value = true;
+        ordered.Add(code);
+      }
+    }
+    for (intptr_t i = 0; i < objects_.length(); i++) {
+      if (!placed.LookupValue(objects_[i])) {
+        ordered.Add(objects_[i]);
+      }
+    }
+    ASSERT(ordered.length() == objects_.length());
+    for (intptr_t i = 0; i < objects_.length(); i++) {
+      objects_[i] = ordered[i];
+    }
+  }
+
   GrowableArray<RawCode*> objects_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
@@ -3124,6 +3174,9 @@ class TypeDeserializationCluster : public DeserializationCluster {
       : type_(AbstractType::Handle()), instr_(Instructions::Handle()) {}
   virtual ~TypeDeserializationCluster() {}
 
+  // Filling sets type testing stubs through handles.
+  bool CanReadFillConcurrently() const { return false; }
+
   void ReadAlloc(Deserializer* d) {
     canonical_start_index_ = d->next_index();
     PageSpace* old_space = d->heap()->old_space();
@@ -3276,6 +3329,9 @@ class TypeRefDeserializationCluster : public DeserializationCluster {
       : type_(AbstractType::Handle()), instr_(Instructions::Handle()) {}
   virtual ~TypeRefDeserializationCluster() {}
 
+  // Filling sets type testing stubs through handles.
+  bool CanReadFillConcurrently() const { return false; }
+
   void ReadAlloc(Deserializer* d) {
     start_index_ = d->next_index();
     PageSpace* old_space = d->heap()->old_space();
@@ -3389,6 +3445,9 @@ class TypeParameterDeserializationCluster : public DeserializationCluster {
       : type_(AbstractType::Handle()), instr_(Instructions::Handle()) {}
   virtual ~TypeParameterDeserializationCluster() {}
 
+  // Filling sets type testing stubs through handles.
+  bool CanReadFillConcurrently() const { return false; }
+
   void ReadAlloc(Deserializer* d) {
     start_index_ = d->next_index();
     PageSpace* old_space = d->heap()->old_space();
@@ -4975,15 +5034,37 @@ void Serializer::Serialize() {
   // We should have assigned a ref to every object we pushed.
   ASSERT((next_ref_index_ - 1) == num_objects);
 
+  // Reserve the table of fill section offsets. It is patched once the
+  // sections are written and lets the deserializer fill clusters out of
+  // order.
+  uint32_t* fill_offsets = zone_->Alloc<uint32_t>(num_clusters + 1);
+  intptr_t fill_offsets_size = (num_clusters + 1) * sizeof(uint32_t);
+  intptr_t fill_offsets_position = stream_.Position();
+  memset(fill_offsets, 0, fill_offsets_size);
+  WriteBytes(reinterpret_cast<uint8_t*>(fill_offsets), fill_offsets_size);
+
+  intptr_t fill_start = stream_.Position();
+  intptr_t cluster_index = 0;
   for (intptr_t cid = 1; cid < num_cids_; cid++) {
     SerializationCluster* cluster = clusters_by_cid_[cid];
     if (cluster != NULL) {
+      fill_offsets[cluster_index++] = stream_.Position() - fill_start;
       cluster->WriteAndMeasureFill(this);
 #if defined(DEBUG)
       Write<int32_t>(kSectionMarker);
 #endif
     }
   }
+  ASSERT(cluster_index == num_clusters);
+
+  intptr_t fill_end = stream_.Position();
+  if (!Utils::IsUint(32, fill_end - fill_start)) {
+    FATAL("Fill sections overflow");
+  }
+  fill_offsets[num_clusters] = fill_end - fill_start;
+  stream_.SetPosition(fill_offsets_position);
+  WriteBytes(reinterpret_cast<uint8_t*>(fill_offsets), fill_offsets_size);
+  stream_.SetPosition(fill_end);
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
   if (FLAG_print_snapshot_sizes_verbose) {
@@ -5150,6 +5231,7 @@ Deserializer::Deserializer(Thread* thread,
                            const uint8_t* shared_data_buffer,
                            const uint8_t* shared_instructions_buffer)
     : StackResource(thread),
+      parent_(NULL),
       heap_(thread->isolate()->heap()),
       zone_(thread->zone()),
       kind_(kind),
@@ -5157,7 +5239,9 @@ Deserializer::Deserializer(Thread* thread,
       image_reader_(NULL),
       refs_(NULL),
       next_ref_index_(1),
-      clusters_(NULL) {
+      clusters_(NULL),
+      fill_start_(0),
+      fill_offsets_(NULL) {
   if (Snapshot::IncludesCode(kind)) {
     ASSERT(instructions_buffer != NULL);
     ASSERT(data_buffer != NULL);
@@ -5167,8 +5251,29 @@ Deserializer::Deserializer(Thread* thread,
   }
 }
 
+Deserializer::Deserializer(Thread* thread, const Deserializer* parent)
+    : StackResource(thread),
+      parent_(parent),
+      heap_(parent->heap_),
+      zone_(thread->zone()),
+      kind_(parent->kind_),
+      stream_(parent->stream_.buffer(), parent->stream_.size()),
+      image_reader_(parent->image_reader_),
+      num_base_objects_(parent->num_base_objects_),
+      num_objects_(parent->num_objects_),
+      num_clusters_(parent->num_clusters_),
+      refs_(parent->refs_),
+      next_ref_index_(parent->next_ref_index_),
+      clusters_(parent->clusters_),
+      fill_start_(parent->fill_start_),
+      fill_offsets_(parent->fill_offsets_) {
+  ASSERT(thread->isolate() == parent->isolate());
+}
+
 Deserializer::~Deserializer() {
-  delete[] clusters_;
+  if (parent_ == NULL) {
+    delete[] clusters_;
+  }
 }
 
 DeserializationCluster* Deserializer::ReadCluster() {
@@ -5392,6 +5497,43 @@ void Deserializer::Prepare() {
   refs_ = Array::New(num_objects_ + 1, Heap::kOld);
 }
 
+// Fills clusters on a helper thread while the isolate's thread waits in
+// Deserializer::Deserialize, which keeps the heap from being collected.
+class ReadFillTask : public ThreadPool::Task {
+ public:
+  ReadFillTask(Isolate* isolate,
+               const Deserializer* parent,
+               ThreadBarrier* barrier,
+               intptr_t* next_cluster)
+      : isolate_(isolate),
+        parent_(parent),
+        barrier_(barrier),
+        next_cluster_(next_cluster) {}
+
+  virtual void Run() {
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kUnknownTask, true);
+    ASSERT(result);
+    {
+      Deserializer deserializer(Thread::Current(), parent_);
+      deserializer.ReadFillConcurrently(next_cluster_);
+    }
+    Thread::ExitIsolateAsHelper(true);
+
+    barrier_->Sync();
+    // This task is done. Notify the original thread.
+    barrier_->Exit();
+  }
+
+ private:
+  Isolate* isolate_;
+  const Deserializer* parent_;
+  ThreadBarrier* barrier_;
+  intptr_t* next_cluster_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReadFillTask);
+};
+
 void Deserializer::Deserialize() {
   if (num_base_objects_ != (next_ref_index_ - 1)) {
     FATAL2("Snapshot expects %" Pd
@@ -5418,16 +5560,60 @@ void Deserializer::Deserialize() {
   {
     NOT_IN_PRODUCT(TimelineDurationScope tds(
         thread(), Timeline::GetIsolateStream(), "ReadFill"));
+    fill_offsets_ = zone_->Alloc<uint32_t>(num_clusters_ + 1);
+    ReadBytes(reinterpret_cast<uint8_t*>(fill_offsets_),
+              (num_clusters_ + 1) * sizeof(uint32_t));
+    fill_start_ = stream_.Position();
+
     for (intptr_t i = 0; i < num_clusters_; i++) {
-      clusters_[i]->ReadFill(this);
-#if defined(DEBUG)
-      int32_t section_marker = Read<int32_t>();
-      ASSERT(section_marker == kSectionMarker);
-#endif
+      if (!clusters_[i]->CanReadFillConcurrently()) {
+        ReadFill(i);
+      }
+    }
+
+    intptr_t num_tasks = Utils::Minimum<intptr_t>(FLAG_snapshot_fill_tasks,
+                                                  num_clusters_ - 1);
+    intptr_t next_cluster = 0;
+    if ((num_tasks > 0) && (Dart::thread_pool() != NULL)) {
+      ThreadBarrier barrier(num_tasks + 1, heap_->barrier(),
+                            heap_->barrier_done());
+      for (intptr_t i = 0; i < num_tasks; i++) {
+        Dart::thread_pool()->Run(
+            new ReadFillTask(isolate(), this, &barrier, &next_cluster));
+      }
+      ReadFillConcurrently(&next_cluster);
+      barrier.Sync();
+      barrier.Exit();
+    } else {
+      ReadFillConcurrently(&next_cluster);
+    }
+
+    stream_.SetPosition(fill_start_ + fill_offsets_[num_clusters_]);
+  }
+}
+
+void Deserializer::ReadFillConcurrently(intptr_t* next_cluster) {
+  for (;;) {
+    intptr_t i = AtomicOperations::FetchAndIncrement(next_cluster);
+    if (i >= num_clusters_) {
+      break;
+    }
+    if (clusters_[i]->CanReadFillConcurrently()) {
+      ReadFill(i);
     }
   }
 }
 
+void Deserializer::ReadFill(intptr_t cluster_index) {
+  stream_.SetPosition(fill_start_ + fill_offsets_[cluster_index]);
+  clusters_[cluster_index]->ReadFill(this);
+#if defined(DEBUG)
+  int32_t section_marker = Read<int32_t>();
+  ASSERT(section_marker == kSectionMarker);
+#endif
+  ASSERT(stream_.Position() == fill_start_ + fill_offsets_[cluster_index + 1]);
+}
+
 class HeapLocker : public StackResource {
  public:
   HeapLocker(Thread* thread, PageSpace* page_space)
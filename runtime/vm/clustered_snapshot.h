@@ -44,6 +44,8 @@ class ImageReader;
 // initialization/fill secton is read for each cluster, using the indices into
 // the reference array to fill pointers. At this point, every object has been
 // touched exactly once and in order, making this approach very cache friendly.
+// The fill sections are preceded by a table of their offsets, so most clusters
+// are filled concurrently by helper threads (see --snapshot_fill_tasks).
 // Finally, each cluster is given an opportunity to perform some fix-ups that
 // require the graph has been fully loaded, such as rehashing, though most
 // clusters do not require fixups.
@@ -90,6 +92,11 @@ class DeserializationCluster : public ZoneAllocated {
   // Initialize the cluster's objects. Do not touch the memory of other objects.
   virtual void ReadFill(Deserializer* deserializer) = 0;
 
+  // Whether ReadFill may run on a helper thread at the same time as the
+  // ReadFill of other clusters. Clusters that update isolate state or use
+  // handles are filled on the isolate's own thread.
+  virtual bool CanReadFillConcurrently() const { return true; }
+
   // Complete any action that requires the full graph to be deserialized, such
   // as rehashing.
   virtual void PostLoad(const Array& refs, Snapshot::Kind kind, Zone* zone) {}
@@ -297,6 +304,9 @@ class Deserializer : public StackResource {
                const uint8_t* instructions_buffer,
                const uint8_t* shared_data_buffer,
                const uint8_t* shared_instructions_buffer);
+  // Creates a deserializer for a helper thread that fills clusters of
+  // [parent], which must have read the alloc sections.
+  Deserializer(Thread* thread, const Deserializer* parent);
   ~Deserializer();
 
   void ReadIsolateSnapshot(ObjectStore* object_store);
@@ -361,6 +371,10 @@ class Deserializer : public StackResource {
   void Prepare();
   void Deserialize();
 
+  // Fills the clusters that can be filled concurrently, claiming the next
+  // unfilled one from [next_cluster] until all are taken.
+  void ReadFillConcurrently(intptr_t* next_cluster);
+
   DeserializationCluster* ReadCluster();
 
   intptr_t next_index() const { return next_ref_index_; }
@@ -368,6 +382,9 @@ class Deserializer : public StackResource {
   Snapshot::Kind kind() const { return kind_; }
 
  private:
+  void ReadFill(intptr_t cluster_index);
+
+  const Deserializer* parent_;
   Heap* heap_;
   Zone* zone_;
   Snapshot::Kind kind_;
@@ -379,6 +396,10 @@ class Deserializer : public StackResource {
   RawArray* refs_;
   intptr_t next_ref_index_;
   DeserializationCluster** clusters_;
+  // Start of the fill sections and their offsets from it, followed by the
+  // offset of their end.
+  intptr_t fill_start_;
+  uint32_t* fill_offsets_;
 };
 
 class FullSnapshotWriter {
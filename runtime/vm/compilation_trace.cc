@@ -4,6 +4,7 @@
 
 #include "vm/compilation_trace.h"
 
+#include "vm/dart_entry.h"
 #include "vm/longjump.h"
 #include "vm/object_store.h"
 #include "vm/resolver.h"
@@ -253,4 +254,588 @@ RawObject* CompilationTraceLoader::EvaluateInitializer(const Field& field) {
   return Object::null();
 }
 
+// Type feedback is a header followed by one record per function:
+//   header:    magic[4], version
+//   function:  uri, class, name, usage counter, deoptimization counter,
+//              number of call sites
+//   call site: token pos, selector, count, deoptimization reasons,
+//              number of arguments tested (N), number of checks
+//   check:     N x (uri, class), count
+// Strings are written as their length followed by their UTF-8 bytes; all
+// integers use the variable length encoding of WriteStream.
+const uint8_t TypeFeedbackSaver::kMagic[4] = {'D', 'T', 'F', 'B'};
+
+static uint8_t* ZoneReAlloc(uint8_t* ptr,
+                            intptr_t old_size,
+                            intptr_t new_size) {
+  return Thread::Current()->zone()->Realloc<uint8_t>(ptr, old_size, new_size);
+}
+
+// Returns the ICData of the call at the current position of [iter], or NULL
+// if it has none.
+static const ICData* ICDataAt(
+    const PcDescriptors::Iterator& iter,
+    const ZoneGrowableArray<const ICData*>& ic_data_array) {
+  const intptr_t deopt_id = iter.DeoptId();
+  if ((deopt_id < 0) || (deopt_id >= ic_data_array.length())) {
+    return NULL;
+  }
+  return ic_data_array[deopt_id];
+}
+
+static const intptr_t kCallKindMask =
+    RawPcDescriptors::kIcCall | RawPcDescriptors::kUnoptStaticCall;
+
+TypeFeedbackSaver::TypeFeedbackSaver(Zone* zone)
+    : buffer_(NULL),
+      stream_(&buffer_, ZoneReAlloc, 4 * KB),
+      ic_data_array_(new (zone) ZoneGrowableArray<const ICData*>()),
+      code_(Code::Handle(zone)),
+      string_(String::Handle(zone)),
+      cls_(Class::Handle(zone)),
+      lib_(Library::Handle(zone)) {
+  stream_.WriteBytes(kMagic, sizeof(kMagic));
+  stream_.Write<int64_t>(kVersion);
+}
+
+void TypeFeedbackSaver::WriteString(const String& value) {
+  const char* cstr = value.ToCString();
+  const intptr_t length = strlen(cstr);
+  stream_.Write<int64_t>(length);
+  stream_.WriteBytes(reinterpret_cast<const uint8_t*>(cstr), length);
+}
+
+void TypeFeedbackSaver::WriteClass(const Class& cls) {
+  lib_ = cls.library();
+  string_ = lib_.IsNull() ? String::null() : lib_.url();
+  WriteString(string_.IsNull() ? Symbols::Empty() : string_);
+  string_ = cls.Name();
+  string_ = String::RemovePrivateKey(string_);
+  WriteString(string_);
+}
+
+void TypeFeedbackSaver::Visit(const Function& function) {
+  if (function.parent_function() != Function::null()) {
+    // Local functions cannot be found by name, see CompilationTraceSaver.
+    return;
+  }
+  code_ = function.unoptimized_code();
+  if (code_.IsNull() || (function.ic_data_array() == Array::null())) {
+    return;
+  }
+
+  ic_data_array_->Clear();
+  function.RestoreICDataMap(ic_data_array_, /* clone_ic_data = */ false);
+  const PcDescriptors& descriptors =
+      PcDescriptors::Handle(code_.pc_descriptors());
+  intptr_t num_call_sites = 0;
+  PcDescriptors::Iterator count_iter(descriptors, kCallKindMask);
+  while (count_iter.MoveNext()) {
+    const ICData* ic_data = ICDataAt(count_iter, *ic_data_array_);
+    if ((ic_data != NULL) && (ic_data->AggregateCount() > 0)) {
+      num_call_sites++;
+    }
+  }
+
+  intptr_t usage = function.usage_counter();
+  if ((usage < 0) || function.HasOptimizedCode()) {
+    // The counter is reset when the function is queued for optimization.
+    usage = Utils::Maximum(
+        usage, static_cast<intptr_t>(FLAG_optimization_counter_threshold));
+  }
+  if ((usage <= 0) && (num_call_sites == 0)) {
+    return;  // Never executed.
+  }
+
+  cls_ = function.Owner();
+  WriteClass(cls_);
+  string_ = function.name();
+  string_ = String::RemovePrivateKey(string_);
+  WriteString(string_);
+  stream_.Write<int64_t>(usage);
+  stream_.Write<int64_t>(function.deoptimization_counter());
+  stream_.Write<int64_t>(num_call_sites);
+
+  ClassTable* class_table = Isolate::Current()->class_table();
+  GrowableArray<intptr_t> class_ids;
+  PcDescriptors::Iterator iter(descriptors, kCallKindMask);
+  while (iter.MoveNext()) {
+    const ICData* ic_data = ICDataAt(iter, *ic_data_array_);
+    if ((ic_data == NULL) || (ic_data->AggregateCount() == 0)) {
+      continue;
+    }
+    stream_.Write<int64_t>(iter.TokenPos().value());
+    string_ = ic_data->target_name();
+    string_ = String::RemovePrivateKey(string_);
+    WriteString(string_);
+    stream_.Write<int64_t>(ic_data->AggregateCount());
+    stream_.Write<int64_t>(ic_data->DeoptReasons());
+
+    // Static calls have a fixed target; only their count matters.
+    const intptr_t num_args_tested =
+        (ic_data->rebind_rule() == ICData::kInstance)
+            ? ic_data->NumArgsTested()
+            : 0;
+    const intptr_t num_checks =
+        (num_args_tested == 0) ? 0 : ic_data->NumberOfChecks();
+    stream_.Write<int64_t>(num_args_tested);
+    stream_.Write<int64_t>(num_checks);
+    for (intptr_t i = 0; i < num_checks; i++) {
+      ic_data->GetClassIdsAt(i, &class_ids);
+      for (intptr_t j = 0; j < num_args_tested; j++) {
+        cls_ = class_table->At(class_ids[j]);
+        WriteClass(cls_);
+      }
+      stream_.Write<int64_t>(ic_data->GetCountAt(i));
+    }
+  }
+}
+
+TypeFeedbackLoader::TypeFeedbackLoader(Thread* thread, bool precompiling)
+    : thread_(thread),
+      zone_(thread->zone()),
+      stream_(NULL),
+      truncated_(false),
+      precompiling_(precompiling),
+      ic_data_array_(new (zone_) ZoneGrowableArray<const ICData*>()),
+      call_site_map_(),
+      uri_(String::Handle(zone_)),
+      class_name_(String::Handle(zone_)),
+      function_name_(String::Handle(zone_)),
+      selector_(String::Handle(zone_)),
+      lib_(Library::Handle(zone_)),
+      cls_(Class::Handle(zone_)),
+      function_(Function::Handle(zone_)),
+      target_(Function::Handle(zone_)),
+      error_(Object::Handle(zone_)),
+      call_sites_(GrowableObjectArray::Handle(zone_,
+                                              GrowableObjectArray::New())),
+      receivers_(GrowableObjectArray::Handle(zone_,
+                                             GrowableObjectArray::New())),
+      hot_functions_(GrowableObjectArray::Handle(zone_,
+                                                 GrowableObjectArray::New())),
+      feedback_(GrowableObjectArray::Handle(zone_)) {}
+
+int64_t TypeFeedbackLoader::ReadInt() {
+  // Check that the value is complete before decoding it: the buffer comes
+  // from a file and ReadStream only asserts that it stays in bounds.
+  const uint8_t* cursor = stream_->AddressOfCurrentPosition();
+  const intptr_t limit = Utils::Minimum<intptr_t>(stream_->PendingBytes(), 10);
+  for (intptr_t i = 0; i < limit; i++) {
+    if (cursor[i] > kMaxUnsignedDataPerByte) {
+      return stream_->Read<int64_t>();
+    }
+  }
+  truncated_ = true;
+  stream_->SetPosition(stream_->Position() + stream_->PendingBytes());
+  return 0;
+}
+
+const char* TypeFeedbackLoader::ReadCString() {
+  const int64_t length = ReadInt();
+  if ((length < 0) || (length > stream_->PendingBytes())) {
+    truncated_ = true;
+    stream_->SetPosition(stream_->Position() + stream_->PendingBytes());
+    return "";
+  }
+  char* result = zone_->Alloc<char>(length + 1);
+  stream_->ReadBytes(reinterpret_cast<uint8_t*>(result), length);
+  result[length] = '\0';
+  return result;
+}
+
+void TypeFeedbackLoader::SkipString() {
+  const int64_t length = ReadInt();
+  if ((length < 0) || (length > stream_->PendingBytes())) {
+    truncated_ = true;
+    stream_->SetPosition(stream_->Position() + stream_->PendingBytes());
+    return;
+  }
+  stream_->SetPosition(stream_->Position() + length);
+}
+
+// Walks the records without resolving or applying them. Returns false if the
+// buffer is truncated or its counts are out of range.
+bool TypeFeedbackLoader::Validate() {
+  while (!truncated_ && (stream_->PendingBytes() > 0)) {
+    SkipString();  // Library.
+    SkipString();  // Class.
+    SkipString();  // Function.
+    ReadInt();     // Usage counter.
+    ReadInt();     // Deoptimization counter.
+    const int64_t num_call_sites = ReadInt();
+    if (num_call_sites < 0) {
+      truncated_ = true;
+    }
+    for (int64_t i = 0; (i < num_call_sites) && !truncated_; i++) {
+      ReadInt();     // Token position.
+      SkipString();  // Selector.
+      ReadInt();     // Count.
+      ReadInt();     // Deoptimization reasons.
+      const int64_t num_args_tested = ReadInt();
+      const int64_t num_checks = ReadInt();
+      if ((num_args_tested < 0) || (num_args_tested > 2) || (num_checks < 0)) {
+        truncated_ = true;
+      }
+      for (int64_t j = 0; (j < num_checks) && !truncated_; j++) {
+        for (int64_t k = 0; k < num_args_tested; k++) {
+          SkipString();  // Library.
+          SkipString();  // Class.
+        }
+        ReadInt();  // Count.
+      }
+    }
+  }
+  return !truncated_;
+}
+
+static intptr_t ClampCount(int64_t count) {
+  return Utils::Maximum<int64_t>(0, Utils::Minimum<int64_t>(count, kMaxInt32));
+}
+
+RawObject* TypeFeedbackLoader::LoadFeedback(uint8_t* buffer, intptr_t size) {
+  ReadStream stream(buffer, size);
+  stream_ = &stream;
+  const intptr_t kMagicSize = sizeof(TypeFeedbackSaver::kMagic);
+  if ((size < kMagicSize) ||
+      (memcmp(buffer, TypeFeedbackSaver::kMagic, kMagicSize) != 0)) {
+    return ApiError::New(String::Handle(
+        zone_, String::New("Type feedback has an unrecognized format")));
+  }
+  stream.SetPosition(kMagicSize);
+  const int64_t version = ReadInt();
+  if (version != TypeFeedbackSaver::kVersion) {
+    return ApiError::New(String::Handle(
+        zone_, String::NewFormatted("Type feedback version %" Pd64
+                                    " does not match the expected %" Pd,
+                                    version, TypeFeedbackSaver::kVersion)));
+  }
+
+  // Reject a damaged buffer before any ICData or counter is modified.
+  const intptr_t records_start = stream.Position();
+  if (!Validate()) {
+    return ApiError::New(
+        String::Handle(zone_, String::New("Type feedback is truncated")));
+  }
+  stream.SetPosition(records_start);
+
+  ObjectStore* object_store = thread_->isolate()->object_store();
+  if (precompiling_) {
+    feedback_ = object_store->type_feedback();
+    if (feedback_.IsNull()) {
+      feedback_ = GrowableObjectArray::New(Heap::kOld);
+    }
+  }
+
+  while (!truncated_ && (stream.PendingBytes() > 0)) {
+    error_ = LoadFunction();
+    if (error_.IsError()) {
+      return error_.raw();
+    }
+  }
+  if (truncated_) {
+    return ApiError::New(
+        String::Handle(zone_, String::New("Type feedback is truncated")));
+  }
+
+  if (precompiling_) {
+    object_store->set_type_feedback(feedback_);
+  } else {
+    OptimizeHotFunctions();
+  }
+  return Object::null();
+}
+
+RawObject* TypeFeedbackLoader::LoadFunction() {
+  const char* uri = ReadCString();
+  const char* cls_name = ReadCString();
+  const char* func_name = ReadCString();
+  const intptr_t usage = ClampCount(ReadInt());
+  const intptr_t deopt_count = ClampCount(ReadInt());
+  const int64_t num_call_sites = ReadInt();
+  if (truncated_) {
+    return Object::null();
+  }
+
+  error_ = LookupFunction(uri, cls_name, func_name);
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+  function_ = error_.IsFunction() ? Function::Cast(error_).raw()
+                                  : Function::null();
+  error_ = PrepareFunction();
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+
+  for (int64_t i = 0; (i < num_call_sites) && !truncated_; i++) {
+    error_ = LoadCallSite();
+    if (error_.IsError()) {
+      return error_.raw();
+    }
+  }
+
+  if (!function_.IsNull() && !precompiling_) {
+    function_.set_deoptimization_counter(Utils::Minimum<intptr_t>(
+        Utils::Maximum<intptr_t>(function_.deoptimization_counter(),
+                                 deopt_count),
+        kMaxInt8));
+    if (usage > function_.usage_counter()) {
+      function_.SetUsageCounter(usage);
+      function_.SetWasExecuted(true);
+    }
+    if (usage >= FLAG_optimization_counter_threshold) {
+      hot_functions_.Add(function_);
+    }
+  }
+  FlushFunction(usage);
+  return Object::null();
+}
+
+RawObject* TypeFeedbackLoader::PrepareFunction() {
+  call_site_map_.Clear();
+  if (function_.IsNull() || precompiling_) {
+    return Object::null();
+  }
+  if (function_.is_abstract() || function_.IsIrregexpFunction()) {
+    function_ = Function::null();
+    return Object::null();
+  }
+  error_ = Compiler::EnsureUnoptimizedCode(thread_, function_);
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+
+  ic_data_array_->Clear();
+  function_.RestoreICDataMap(ic_data_array_, /* clone_ic_data = */ false);
+  const Code& code = Code::Handle(zone_, function_.unoptimized_code());
+  const PcDescriptors& descriptors =
+      PcDescriptors::Handle(zone_, code.pc_descriptors());
+  PcDescriptors::Iterator iter(descriptors, kCallKindMask);
+  while (iter.MoveNext()) {
+    const ICData* ic_data = ICDataAt(iter, *ic_data_array_);
+    if (ic_data != NULL) {
+      CallSite site = {iter.TokenPos(), ic_data};
+      call_site_map_.Add(site);
+    }
+  }
+  return Object::null();
+}
+
+const ICData* TypeFeedbackLoader::FindCallSite(TokenPosition token_pos,
+                                               const String& selector) {
+  for (intptr_t i = 0; i < call_site_map_.length(); i++) {
+    if (call_site_map_[i].token_pos != token_pos) {
+      continue;
+    }
+    selector_ = call_site_map_[i].ic_data->target_name();
+    if (String::EqualsIgnoringPrivateKey(selector_, selector)) {
+      return call_site_map_[i].ic_data;
+    }
+  }
+  return NULL;
+}
+
+RawObject* TypeFeedbackLoader::LoadCallSite() {
+  const TokenPosition token_pos(ReadInt());
+  const String& selector =
+      String::Handle(zone_, Symbols::New(thread_, ReadCString()));
+  const intptr_t count = ClampCount(ReadInt());
+  const uint32_t deopt_reasons = static_cast<uint32_t>(ReadInt());
+  const int64_t num_args_tested = ReadInt();
+  const int64_t num_checks = ReadInt();
+  if (truncated_ || (num_args_tested < 0) || (num_args_tested > 2)) {
+    truncated_ = true;
+    return Object::null();
+  }
+
+  const ICData* ic_data = NULL;
+  if (!function_.IsNull()) {
+    if (precompiling_) {
+      FlushCallSite();
+      call_sites_.Add(Smi::Handle(zone_, Smi::New(token_pos.value())));
+      call_sites_.Add(selector);
+      call_sites_.Add(Smi::Handle(zone_, Smi::New(count)));
+      call_sites_.Add(Object::null_object());
+    } else {
+      ic_data = FindCallSite(token_pos, selector);
+    }
+  }
+  if (ic_data != NULL) {
+    ic_data->SetDeoptReasons(ic_data->DeoptReasons() | deopt_reasons);
+    if ((num_args_tested == 0) && (ic_data->NumberOfChecks() > 0)) {
+      ic_data->SetCountAt(0, Utils::Maximum(ic_data->GetCountAt(0), count));
+    }
+    if (ic_data->NumArgsTested() != num_args_tested) {
+      ic_data = NULL;  // The call changed, its checks no longer apply.
+    }
+  }
+
+  GrowableArray<intptr_t> class_ids(2);
+  Class& receiver = Class::Handle(zone_);
+  for (int64_t i = 0; (i < num_checks) && !truncated_; i++) {
+    class_ids.Clear();
+    for (int64_t j = 0; j < num_args_tested; j++) {
+      const char* uri = ReadCString();
+      const char* cls_name = ReadCString();
+      if (truncated_ || function_.IsNull()) {
+        continue;
+      }
+      error_ = LookupClass(uri, cls_name);
+      if (error_.IsError()) {
+        return error_.raw();
+      }
+      if (error_.IsClass()) {
+        class_ids.Add(Class::Cast(error_).id());
+        if (j == 0) {
+          receiver ^= error_.raw();
+        }
+      }
+    }
+    const intptr_t check_count = ClampCount(ReadInt());
+    if (truncated_ || (class_ids.length() != num_args_tested)) {
+      continue;  // Missing class.
+    }
+    if (precompiling_) {
+      AddReceiver(receiver, check_count);
+    } else if (ic_data != NULL) {
+      AddCheck(*ic_data, class_ids, check_count);
+    }
+  }
+  return Object::null();
+}
+
+void TypeFeedbackLoader::AddCheck(const ICData& ic_data,
+                                  const GrowableArray<intptr_t>& class_ids,
+                                  intptr_t count) {
+  GrowableArray<intptr_t> existing(class_ids.length());
+  for (intptr_t i = 0; i < ic_data.NumberOfChecks(); i++) {
+    ic_data.GetClassIdsAt(i, &existing);
+    bool same = true;
+    for (intptr_t j = 0; j < class_ids.length(); j++) {
+      same = same && (existing[j] == class_ids[j]);
+    }
+    if (same) {
+      ic_data.SetCountAt(i, Utils::Maximum(ic_data.GetCountAt(i), count));
+      return;
+    }
+  }
+
+  // The target is determined by the receiver, as in the IC miss handler.
+  cls_ = thread_->isolate()->class_table()->At(class_ids[0]);
+  selector_ = ic_data.target_name();
+  ArgumentsDescriptor args_desc(
+      Array::Handle(zone_, ic_data.arguments_descriptor()));
+  target_ =
+      Resolver::ResolveDynamicForReceiverClass(cls_, selector_, args_desc);
+  if (target_.IsNull()) {
+    return;  // Would call noSuchMethod.
+  }
+  if (class_ids.length() == 1) {
+    ic_data.AddReceiverCheck(class_ids[0], target_, count);
+  } else {
+    ic_data.AddCheck(class_ids, target_, count);
+  }
+}
+
+void TypeFeedbackLoader::AddReceiver(const Class& cls, intptr_t count) {
+  // The precompiler only uses the receiver, so merge checks that differ in
+  // the other arguments.
+  for (intptr_t i = 0; i < receivers_.Length(); i += 2) {
+    if (receivers_.At(i) == cls.raw()) {
+      const intptr_t merged =
+          Smi::Value(Smi::RawCast(receivers_.At(i + 1))) + count;
+      receivers_.SetAt(i + 1, Smi::Handle(zone_, Smi::New(merged)));
+      return;
+    }
+  }
+  receivers_.Add(cls);
+  receivers_.Add(Smi::Handle(zone_, Smi::New(count)));
+}
+
+void TypeFeedbackLoader::FlushCallSite() {
+  if (receivers_.Length() == 0) {
+    return;
+  }
+  ASSERT(call_sites_.Length() > 0);
+  call_sites_.SetAt(call_sites_.Length() - 1,
+                    Array::Handle(zone_, Array::MakeFixedLength(receivers_)));
+}
+
+void TypeFeedbackLoader::FlushFunction(intptr_t usage) {
+  if (!precompiling_) {
+    return;
+  }
+  FlushCallSite();
+  // Functions without call sites are kept for their usage, which orders the
+  // code in the snapshot.
+  if (!function_.IsNull() && ((usage > 0) || (call_sites_.Length() > 0))) {
+    feedback_.Add(function_, Heap::kOld);
+    feedback_.Add(Smi::Handle(zone_, Smi::New(usage)), Heap::kOld);
+    feedback_.Add(Array::Handle(zone_, Array::MakeFixedLength(call_sites_)),
+                  Heap::kOld);
+  }
+  call_sites_.SetLength(0);
+}
+
+// Queue the functions that were hot in the training run for optimization, now
+// that the feedback of their callees has been installed as well.
+void TypeFeedbackLoader::OptimizeHotFunctions() {
+  Isolate* isolate = thread_->isolate();
+  if (!FLAG_background_compilation || BackgroundCompiler::IsDisabled(isolate)) {
+    // The functions optimize on their first invocation instead.
+    return;
+  }
+  for (intptr_t i = 0; i < hot_functions_.Length(); i++) {
+    function_ ^= hot_functions_.At(i);
+    if (function_.HasOptimizedCode() ||
+        !function_.is_background_optimizable() ||
+        !Compiler::CanOptimizeFunction(thread_, function_)) {
+      continue;
+    }
+    // As in OptimizeInvokedFunction, keep the function from triggering its
+    // own optimization while it is queued.
+    function_.SetUsageCounter(INT_MIN);
+    BackgroundCompiler::Start(isolate);
+    isolate->background_compiler()->CompileOptimized(function_);
+  }
+}
+
+RawObject* TypeFeedbackLoader::LookupClass(const char* uri_cstr,
+                                           const char* cls_cstr) {
+  uri_ = Symbols::New(thread_, uri_cstr);
+  class_name_ = Symbols::New(thread_, cls_cstr);
+  lib_ = Library::LookupLibrary(thread_, uri_);
+  if (lib_.IsNull()) {
+    return Object::null();
+  }
+  if (class_name_.Equals(Symbols::TopLevel())) {
+    return lib_.toplevel_class();
+  }
+  cls_ = lib_.SlowLookupClassAllowMultiPartPrivate(class_name_);
+  if (cls_.IsNull()) {
+    return Object::null();
+  }
+  error_ = cls_.EnsureIsFinalized(thread_);
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+  return cls_.raw();
+}
+
+RawObject* TypeFeedbackLoader::LookupFunction(const char* uri_cstr,
+                                              const char* cls_cstr,
+                                              const char* func_cstr) {
+  error_ = LookupClass(uri_cstr, cls_cstr);
+  if (!error_.IsClass()) {
+    return error_.raw();
+  }
+  cls_ ^= error_.raw();
+  function_name_ = Symbols::New(thread_, func_cstr);
+  if (cls_.IsTopLevel()) {
+    return lib_.LookupFunctionAllowPrivate(function_name_);
+  }
+  return cls_.LookupFunctionAllowPrivate(function_name_);
+}
+
 }  // namespace dart
@@ -7,6 +7,7 @@
 
 #include "platform/assert.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/datastream.h"
 #include "vm/object.h"
 #include "vm/program_visitor.h"
 #include "vm/zone_text_buffer.h"
@@ -59,6 +60,103 @@ class CompilationTraceLoader : public ValueObject {
   Object& error_;
 };
 
+// Records the type feedback gathered by the unoptimized code of each compiled
+// function: its usage and deoptimization counters, and for each call site the
+// call count, the deoptimization reasons and the classes of the checked
+// arguments with their counts. The feedback is written in a versioned binary
+// format and can be loaded by a later run of the same program, either to
+// warm up the JIT or to guide the precompiler.
+class TypeFeedbackSaver : public FunctionVisitor {
+ public:
+  explicit TypeFeedbackSaver(Zone* zone);
+  void Visit(const Function& function);
+
+  void StealBuffer(uint8_t** buffer, intptr_t* buffer_length) {
+    *buffer = buffer_;
+    *buffer_length = stream_.bytes_written();
+  }
+
+  static const uint8_t kMagic[4];
+  static const intptr_t kVersion = 1;
+
+ private:
+  void WriteString(const String& value);
+  void WriteClass(const Class& cls);
+
+  uint8_t* buffer_;
+  WriteStream stream_;
+  ZoneGrowableArray<const ICData*>* ic_data_array_;
+  Code& code_;
+  String& string_;
+  Class& cls_;
+  Library& lib_;
+};
+
+// Resolves the names in feedback produced by TypeFeedbackSaver against the
+// current program. Entries that no longer resolve are dropped, so the feedback
+// may come from a slightly different version of the program.
+//
+// When precompiling, the feedback is stored in the object store as (Function,
+// Smi usage, Array call sites) triples, where the precompiler picks it up.
+// Otherwise it is merged into the ICData of the functions, which are compiled
+// if needed, and the functions that were hot in the training run are queued
+// for background optimization. The whole buffer
+// is checked before any of it is applied.
+class TypeFeedbackLoader : public ValueObject {
+ public:
+  TypeFeedbackLoader(Thread* thread, bool precompiling);
+
+  RawObject* LoadFeedback(uint8_t* buffer, intptr_t buffer_length);
+
+ private:
+  struct CallSite {
+    TokenPosition token_pos;
+    const ICData* ic_data;
+  };
+
+  bool Validate();
+  RawObject* LoadFunction();
+  RawObject* LoadCallSite();
+  RawObject* PrepareFunction();
+  const ICData* FindCallSite(TokenPosition token_pos, const String& selector);
+  void AddCheck(const ICData& ic_data,
+                const GrowableArray<intptr_t>& class_ids,
+                intptr_t count);
+  void AddReceiver(const Class& cls, intptr_t count);
+  void FlushCallSite();
+  void FlushFunction(intptr_t usage);
+  void OptimizeHotFunctions();
+
+  int64_t ReadInt();
+  const char* ReadCString();
+  void SkipString();
+  RawObject* LookupClass(const char* uri_cstr, const char* cls_cstr);
+  RawObject* LookupFunction(const char* uri_cstr,
+                            const char* cls_cstr,
+                            const char* func_cstr);
+
+  Thread* thread_;
+  Zone* zone_;
+  ReadStream* stream_;
+  bool truncated_;
+  const bool precompiling_;
+  ZoneGrowableArray<const ICData*>* ic_data_array_;
+  GrowableArray<CallSite> call_site_map_;
+  String& uri_;
+  String& class_name_;
+  String& function_name_;
+  String& selector_;
+  Library& lib_;
+  Class& cls_;
+  Function& function_;
+  Function& target_;
+  Object& error_;
+  const GrowableObjectArray& call_sites_;
+  const GrowableObjectArray& receivers_;
+  const GrowableObjectArray& hot_functions_;
+  GrowableObjectArray& feedback_;
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_COMPILATION_TRACE_H_
@@ -979,6 +979,7 @@ void AotCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
         // within the whole hierarchy. Replace InstanceCall with StaticCall.
         const Function& target = Function::ZoneHandle(Z, single_target.raw());
         StaticCallInstr* call = StaticCallInstr::FromCall(Z, instr, target);
+        AddCallCountFeedback(instr, call);
         instr->ReplaceWith(call, current_iterator());
         return;
       } else if ((ic_data.raw() != ICData::null()) &&
@@ -1012,6 +1013,81 @@ void AotCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
     instr->ReplaceWith(call, current_iterator());
     return;
   }
+
+  TryCreatePolymorphicCallFromFeedback(instr);
+}
+
+// Replaces [instr] with a polymorphic call over the receiver classes seen at
+// this call site in the training run, so that the inliner can inline the hot
+// targets. The call is not complete: other receivers still use the generic
+// dispatch.
+bool AotCallSpecializer::TryCreatePolymorphicCallFromFeedback(
+    InstanceCallInstr* instr) {
+  if (precompiler_ == NULL) {
+    return false;
+  }
+  const Function& function = flow_graph()->function();
+  Array& receivers = Array::Handle(Z);
+  const intptr_t count = precompiler_->CallSiteFeedback(
+      function, instr->token_pos(), instr->function_name(), &receivers);
+  if ((count == 0) || receivers.IsNull()) {
+    return false;
+  }
+
+  const Array& args_desc_array =
+      Array::Handle(Z, instr->GetArgumentsDescriptor());
+  const ICData& ic_data = ICData::Handle(
+      Z, ICData::New(function, instr->function_name(), args_desc_array,
+                     Thread::kNoDeoptId, /* args_tested = */ 1,
+                     ICData::kOptimized));
+  Class& cls = Class::Handle(Z);
+  Function& target = Function::Handle(Z);
+  for (intptr_t i = 0; i < receivers.Length(); i += 2) {
+    cls ^= receivers.At(i);
+    // Skip artificial functions for the same reason as the CHA based
+    // devirtualization above.
+    target = instr->ResolveForReceiverClass(cls);
+    if (target.IsNull() || target.IsMethodExtractor() ||
+        target.IsInvokeFieldDispatcher()) {
+      continue;
+    }
+    ic_data.AddReceiverCheck(cls.id(), target,
+                             Smi::Value(Smi::RawCast(receivers.At(i + 1))));
+  }
+  if (ic_data.NumberOfChecksIs(0)) {
+    return false;
+  }
+
+  CallTargets* targets = CallTargets::Create(Z, ic_data);
+  PolymorphicInstanceCallInstr* call =
+      new (Z) PolymorphicInstanceCallInstr(instr, *targets,
+                                           /* complete = */ false);
+  call->set_total_call_count(count);
+  instr->ReplaceWith(call, current_iterator());
+  return true;
+}
+
+// Carries the call count recorded in the training run for [instr] over to
+// the static call that replaces it, so that the inliner sees how hot it is.
+void AotCallSpecializer::AddCallCountFeedback(InstanceCallInstr* instr,
+                                              StaticCallInstr* call) {
+  if (precompiler_ == NULL) {
+    return;
+  }
+  const intptr_t count = precompiler_->CallSiteFeedback(
+      flow_graph()->function(), instr->token_pos(), instr->function_name(),
+      NULL);
+  if (count == 0) {
+    return;
+  }
+  const ICData& ic_data = ICData::ZoneHandle(
+      Z, ICData::New(flow_graph()->function(), instr->function_name(),
+                     Array::Handle(Z, instr->GetArgumentsDescriptor()),
+                     instr->deopt_id(), /* args_tested = */ 0,
+                     ICData::kStatic));
+  ic_data.AddTarget(call->function());
+  ic_data.SetCountAt(0, count);
+  call->set_ic_data(&ic_data);
 }
 
 void AotCallSpecializer::VisitStaticCall(StaticCallInstr* instr) {
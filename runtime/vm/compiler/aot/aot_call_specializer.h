@@ -63,6 +63,11 @@ class AotCallSpecializer : public CallSpecializer {
   bool TryExpandCallThroughGetter(const Class& receiver_class,
                                   InstanceCallInstr* call);
 
+  // Use the type feedback of a training run, if any, loaded by the
+  // precompiler.
+  bool TryCreatePolymorphicCallFromFeedback(InstanceCallInstr* call);
+  void AddCallCountFeedback(InstanceCallInstr* instr, StaticCallInstr* call);
+
   Precompiler* precompiler_;
 
   bool has_unique_no_such_method_;
@@ -253,6 +253,7 @@ Precompiler::Precompiler(Thread* thread)
       types_to_retain_(),
       consts_to_retain_(),
       field_type_map_(),
+      hot_functions_(GrowableObjectArray::Handle(GrowableObjectArray::New())),
       error_(Error::Handle()),
       get_runtime_type_is_unique_(false) {}
 
@@ -273,6 +274,7 @@ void Precompiler::DoCompileAll(
       ASSERT(Error::Handle(Z, T->sticky_error()).IsNull());
 
       ClassFinalizer::SortClasses();
+      LoadTypeFeedback();
 
       // Collects type usage information which allows us to decide when/how to
       // optimize runtime type tests.
@@ -363,6 +365,7 @@ void Precompiler::DoCompileAll(
     Obfuscate();
 
     ProgramVisitor::Dedup();
+    OrderCode();
 
     zone_ = NULL;
   }
@@ -2645,8 +2648,115 @@ void Precompiler::FinalizeAllClasses() {
   I->set_all_classes_finalized(true);
 }
 
+struct FunctionUsage {
+  const Function* function;
+  intptr_t usage;
+};
+
+static int CompareUsage(const FunctionUsage* a, const FunctionUsage* b) {
+  // Most used first.
+  if (a->usage != b->usage) {
+    return (a->usage > b->usage) ? -1 : 1;
+  }
+  return 0;
+}
+
+void Precompiler::LoadTypeFeedback() {
+  ObjectStore* object_store = I->object_store();
+  const GrowableObjectArray& feedback =
+      GrowableObjectArray::Handle(Z, object_store->type_feedback());
+  if (feedback.IsNull()) {
+    return;
+  }
+  // Entries are (Function, Smi usage, Array of call sites) triples, see
+  // TypeFeedbackLoader.
+  GrowableArray<FunctionUsage> usages;
+  for (intptr_t i = 0; i < feedback.Length(); i += 3) {
+    const Function& function =
+        Function::ZoneHandle(Z, Function::RawCast(feedback.At(i)));
+    const intptr_t usage = Smi::Value(Smi::RawCast(feedback.At(i + 1)));
+    const Array& call_sites =
+        Array::ZoneHandle(Z, Array::RawCast(feedback.At(i + 2)));
+    if (call_sites.Length() > 0) {
+      function_feedback_map_.Insert(
+          FunctionFeedbackPair(&function, &call_sites));
+    }
+    if (usage > 0) {
+      FunctionUsage entry = {&function, usage};
+      usages.Add(entry);
+    }
+  }
+  usages.Sort(CompareUsage);
+  for (intptr_t i = 0; i < usages.length(); i++) {
+    hot_functions_.Add(*usages[i].function);
+  }
+  object_store->set_type_feedback(GrowableObjectArray::Handle(Z));
+  if (FLAG_trace_precompiler) {
+    THR_Print("Loaded type feedback for %" Pd " functions\n",
+              feedback.Length() / 3);
+  }
+}
+
+// Records the code of the functions that ran in the training run, most used
+// first, for the snapshot writer to lay out at the start of the text section.
+// Keeping hot code together reduces the instruction cache and TLB footprint.
+void Precompiler::OrderCode() {
+  if (hot_functions_.Length() == 0) {
+    return;
+  }
+  const GrowableObjectArray& code_order =
+      GrowableObjectArray::Handle(Z, GrowableObjectArray::New());
+  Function& function = Function::Handle(Z);
+  Code& code = Code::Handle(Z);
+  for (intptr_t i = 0; i < hot_functions_.Length(); i++) {
+    function ^= hot_functions_.At(i);
+    if (!function.HasCode()) {
+      continue;
+    }
+    code = function.CurrentCode();
+    code_order.Add(code);
+  }
+  I->object_store()->set_code_order(
+      Array::Handle(Z, Array::MakeFixedLength(code_order)));
+  if (FLAG_trace_precompiler) {
+    THR_Print("Ordered code of %" Pd " functions\n", code_order.Length());
+  }
+}
+
+intptr_t Precompiler::CallSiteFeedback(const Function& function,
+                                       TokenPosition token_pos,
+                                       const String& selector,
+                                       Array* receivers) {
+  if (function_feedback_map_.IsEmpty()) {
+    return 0;
+  }
+  const Array* call_sites = function_feedback_map_.LookupValue(&function);
+  if (call_sites == NULL) {
+    return 0;
+  }
+  // Call sites are (Smi token pos, String selector, Smi count, Array
+  // receivers) tuples. Private names are compared without their keys since
+  // the training run may have mangled them differently.
+  String& name = String::Handle(Z);
+  for (intptr_t i = 0; i < call_sites->Length(); i += 4) {
+    if (Smi::Value(Smi::RawCast(call_sites->At(i))) != token_pos.value()) {
+      continue;
+    }
+    name ^= call_sites->At(i + 1);
+    if (!String::EqualsIgnoringPrivateKey(name, selector)) {
+      continue;
+    }
+    if (receivers != NULL) {
+      *receivers ^= call_sites->At(i + 3);
+    }
+    return Smi::Value(Smi::RawCast(call_sites->At(i + 2)));
+  }
+  return 0;
+}
+
 void Precompiler::PopulateWithICData(const Function& function,
-                                     FlowGraph* graph) {
+                                     FlowGraph* graph,
+                                     Precompiler* precompiler) {
   Zone* zone = Thread::Current()->zone();
 
   for (BlockIterator block_it = graph->reverse_postorder_iterator();
@@ -2689,6 +2799,14 @@ void Precompiler::PopulateWithICData(const Function& function,
                                 arguments_descriptor, call->deopt_id(),
                                 num_args_checked, ICData::kStatic));
           ic_data.AddTarget(target);
+          if (precompiler != NULL) {
+            const intptr_t count = precompiler->CallSiteFeedback(
+                function, call->token_pos(),
+                String::Handle(zone, target.name()), NULL);
+            if (count > 0) {
+              ic_data.SetCountAt(0, count);
+            }
+          }
           call->set_ic_data(&ic_data);
         }
       }
@@ -2838,7 +2956,7 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 
       if (optimized()) {
         Precompiler::PopulateWithICData(parsed_function()->function(),
-                                        flow_graph);
+                                        flow_graph, precompiler_);
       }
 
       const bool print_flow_graph =
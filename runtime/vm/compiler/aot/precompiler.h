@@ -21,8 +21,6 @@ class GrowableObjectArray;
 class RawError;
 class SequenceNode;
 class String;
-class ParsedJSONObject;
-class ParsedJSONArray;
 class Precompiler;
 class FlowGraph;
 class PrecompilerEntryPointsPrinter;
@@ -281,41 +279,34 @@ struct IntptrPair {
 
 typedef DirectChainedHashMap<IntptrPair> CidMap;
 
-struct FunctionFeedbackKey {
-  FunctionFeedbackKey() : owner_cid_(kIllegalCid), token_(0), kind_(0) {}
-  FunctionFeedbackKey(intptr_t owner_cid, intptr_t token, intptr_t kind)
-      : owner_cid_(owner_cid), token_(token), kind_(kind) {}
-
-  intptr_t owner_cid_;
-  intptr_t token_;
-  intptr_t kind_;
-};
-
-struct FunctionFeedbackPair {
+// Maps a function to the call site feedback recorded for it by a training run,
+// see TypeFeedbackLoader.
+class FunctionFeedbackPair {
+ public:
   // Typedefs needed for the DirectChainedHashMap template.
-  typedef FunctionFeedbackKey Key;
-  typedef ParsedJSONObject* Value;
+  typedef const Function* Key;
+  typedef const Array* Value;
   typedef FunctionFeedbackPair Pair;
 
-  static Key KeyOf(Pair kv) { return kv.key_; }
+  static Key KeyOf(Pair kv) { return kv.function_; }
 
-  static Value ValueOf(Pair kv) { return kv.value_; }
+  static Value ValueOf(Pair kv) { return kv.call_sites_; }
 
   static inline intptr_t Hashcode(Key key) {
-    return key.token_ ^ key.owner_cid_ ^ key.kind_;
+    return FunctionKeyValueTrait::Hashcode(key);
   }
 
   static inline bool IsKeyEqual(Pair pair, Key key) {
-    return (pair.key_.owner_cid_ == key.owner_cid_) &&
-           (pair.key_.token_ == key.token_) && (pair.key_.kind_ == key.kind_);
+    return pair.function_->raw() == key->raw();
   }
 
-  FunctionFeedbackPair(Key key, Value value) : key_(key), value_(value) {}
+  FunctionFeedbackPair(const Function* function, const Array* call_sites)
+      : function_(function), call_sites_(call_sites) {}
 
-  FunctionFeedbackPair() : key_(), value_(NULL) {}
+  FunctionFeedbackPair() : function_(NULL), call_sites_(NULL) {}
 
-  Key key_;
-  Value value_;
+  const Function* function_;
+  const Array* call_sites_;
 };
 
 typedef DirectChainedHashMap<FunctionFeedbackPair> FunctionFeedbackMap;
@@ -344,7 +335,20 @@ class Precompiler : public ValueObject {
 
   FieldTypeMap* field_type_map() { return &field_type_map_; }
 
-  static void PopulateWithICData(const Function& func, FlowGraph* graph);
+  // Creates ICData for the calls in [graph], carrying over the call counts
+  // recorded by a training run if [precompiler] has type feedback.
+  static void PopulateWithICData(const Function& func,
+                                 FlowGraph* graph,
+                                 Precompiler* precompiler);
+
+  // Returns the number of times the call to [selector] at [token_pos] in
+  // [function] was executed in the training run, or 0 if there is no
+  // feedback for it. If [receivers] is not NULL it is set to the
+  // (Class, Smi count) pairs seen at the call site.
+  intptr_t CallSiteFeedback(const Function& function,
+                            TokenPosition token_pos,
+                            const String& selector,
+                            Array* receivers);
 
  private:
   explicit Precompiler(Thread* thread);
@@ -401,6 +405,9 @@ class Precompiler : public ValueObject {
 
   void FinalizeAllClasses();
 
+  void LoadTypeFeedback();
+  void OrderCode();
+
   Thread* thread() const { return thread_; }
   Zone* zone() const { return zone_; }
   Isolate* isolate() const { return isolate_; }
@@ -432,8 +439,9 @@ class Precompiler : public ValueObject {
   AbstractTypeSet types_to_retain_;
   InstanceSet consts_to_retain_;
   FieldTypeMap field_type_map_;
-  CidMap feedback_cid_map_;
   FunctionFeedbackMap function_feedback_map_;
+  // The functions that ran in the training run, most used first.
+  const GrowableObjectArray& hot_functions_;
   Error& error_;
 
   bool get_runtime_type_is_unique_;
@@ -954,6 +954,37 @@ void Assembler::StoreIntoObject(Register object,
   Label done;
   StoreIntoObjectFilter(object, value, &done, kValueCanBeSmi, kJumpToNoUpdate);
   // A store buffer update is required.
+  CallUpdateStoreBuffer(object, value);
+  Bind(&done);
+}
+
+void Assembler::StoreIntoArray(Register object,
+                               Register slot,
+                               Register value,
+                               CanBeSmi can_be_smi) {
+  ASSERT(object != value);
+  ASSERT((slot != TMP) && (slot != TMP2));
+  str(value, Address(slot, 0));
+  Label done, remember_card;
+  StoreIntoObjectFilter(object, value, &done, can_be_smi, kJumpToNoUpdate);
+  LoadFieldFromOffset(TMP, object, Object::tags_offset(), kWord);
+  tbnz(&remember_card, TMP, RawObject::kCardRememberedBit);
+  // A store buffer update is required.
+  CallUpdateStoreBuffer(object, value);
+  b(&done);
+
+  // Dirty the card covering the slot.
+  Bind(&remember_card);
+  andi(TMP, object, Immediate(kPageMask));
+  sub(TMP2, slot, Operand(TMP));
+  ldr(TMP, Address(TMP, HeapPage::card_table_offset()));
+  add(TMP, TMP, Operand(TMP2, LSR, HeapPage::kBytesPerCardLog2));
+  LoadImmediate(TMP2, 1);
+  str(TMP2, Address(TMP, 0), kUnsignedByte);
+  Bind(&done);
+}
+
+void Assembler::CallUpdateStoreBuffer(Register object, Register value) {
   if (value != R0) {
     // Preserve R0.
     Push(R0);
@@ -969,7 +1000,6 @@ void Assembler::StoreIntoObject(Register object,
     // Restore R0.
     Pop(R0);
   }
-  Bind(&done);
 }
 
 void Assembler::StoreIntoObjectNoBarrier(Register object,
@@ -1465,6 +1465,12 @@ class Assembler : public ValueObject {
                              int32_t offset,
                              Register value,
                              CanBeSmi can_value_be_smi = kValueCanBeSmi);
+  // Storing into the array slot whose address is in 'slot'. Knowing the slot
+  // lets card-remembered arrays dirty a card instead of the store buffer.
+  void StoreIntoArray(Register object,
+                      Register slot,
+                      Register value,
+                      CanBeSmi can_value_be_smi = kValueCanBeSmi);
   void StoreIntoObjectNoBarrier(Register object,
                                 const Address& dest,
                                 Register value);
@@ -2244,6 +2250,9 @@ class Assembler : public ValueObject {
                              CanBeSmi can_be_smi,
                              BarrierFilterMode barrier_filter_mode);
 
+  // Calls the store buffer stub for 'object', preserving 'value'.
+  void CallUpdateStoreBuffer(Register object, Register value);
+
   DISALLOW_ALLOCATION();
   DISALLOW_COPY_AND_ASSIGN(Assembler);
 };
@@ -1251,8 +1251,35 @@ void Assembler::StoreIntoObject(Register object,
                                 CanBeSmi can_be_smi) {
   ASSERT(object != value);
   movq(dest, value);
-  Label done;
+  if (FLAG_concurrent_mark) {
+    // Marking barrier: grey unmarked old values while the old generation is
+    // being marked concurrently. Must precede the filter, which clobbers
+    // 'value'.
+    Label marked;
+    cmpq(Address(THR, Thread::marking_stack_block_offset()), Immediate(0));
+    j(EQUAL, &marked, kNearJump);
+    if (can_be_smi == kValueCanBeSmi) {
+      testq(value, Immediate(kSmiTagMask));
+      j(ZERO, &marked, kNearJump);
+    }
+    testq(value, Immediate(kNewObjectAlignmentOffset));
+    j(NOT_ZERO, &marked, kNearJump);
+    testb(FieldAddress(value, Object::tags_offset()),
+          Immediate(1 << RawObject::kMarkBit));
+    j(NOT_ZERO, &marked, kNearJump);
+    if (value != RDX) {
+      pushq(RDX);
+      movq(RDX, value);
+    }
+    call(Address(THR, Thread::update_marking_stack_entry_point_offset()));
+    if (value != RDX) popq(RDX);
+    Bind(&marked);
+  }
+  Label done, remember_card;
   StoreIntoObjectFilter(object, value, &done, can_be_smi, kJumpToNoUpdate);
+  testb(FieldAddress(object, Object::tags_offset()),
+        Immediate(1 << RawObject::kCardRememberedBit));
+  j(NOT_ZERO, &remember_card, kNearJump);
   // A store buffer update is required.
   if (value != RDX) pushq(RDX);
   if (object != RDX) {
@@ -1261,6 +1288,18 @@ void Assembler::StoreIntoObject(Register object,
   call(Address(THR, Thread::update_store_buffer_entry_point_offset()));
 
   if (value != RDX) popq(RDX);
+  jmp(&done, kNearJump);
+
+  // Dirty the card covering the slot. The filter clobbered 'value', so it is
+  // free to hold the card index.
+  Bind(&remember_card);
+  leaq(value, dest);
+  movq(TMP, object);
+  andq(TMP, Immediate(kPageMask));
+  subq(value, TMP);
+  shrq(value, Immediate(HeapPage::kBytesPerCardLog2));
+  movq(TMP, Address(TMP, HeapPage::card_table_offset()));
+  movb(Address(TMP, value, TIMES_1, 0), Immediate(1));
   Bind(&done);
 }
 
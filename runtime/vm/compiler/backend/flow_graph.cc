@@ -22,6 +22,15 @@ namespace dart {
 DEFINE_FLAG(bool, trace_smi_widening, false, "Trace Smi->Int32 widening pass.");
 #endif
 DEFINE_FLAG(bool, prune_dead_locals, true, "optimize dead locals away");
+DEFINE_FLAG(int,
+            second_tier_scale,
+            2,
+            "Factor applied to inlining and unrolling budgets when a function "
+            "is reoptimized in the second tier.");
+DEFINE_FLAG(int,
+            second_tier_max_polymorphic_checks,
+            8,
+            "Maximum number of polymorphic checks in second tier code.");
 DECLARE_FLAG(bool, verify_compiler);
 
 FlowGraph::FlowGraph(const ParsedFunction& parsed_function,
@@ -51,10 +60,24 @@ FlowGraph::FlowGraph(const ParsedFunction& parsed_function,
       await_token_positions_(NULL),
       captured_parameters_(new (zone()) BitVector(zone(), variable_count())),
       inlining_id_(-1),
+      optimization_tier_(0),
       should_print_(FlowGraphPrinter::ShouldPrint(parsed_function.function())) {
   DiscoverBlocks();
 }
 
+intptr_t FlowGraph::ScaleForTier(intptr_t limit) const {
+  return (optimization_tier_ > 1) ? limit * FLAG_second_tier_scale : limit;
+}
+
+intptr_t FlowGraph::MaxPolymorphicChecks() const {
+  if (optimization_tier_ > 1) {
+    return Utils::Maximum(
+        static_cast<intptr_t>(FLAG_max_polymorphic_checks),
+        static_cast<intptr_t>(FLAG_second_tier_max_polymorphic_checks));
+  }
+  return FLAG_max_polymorphic_checks;
+}
+
 void FlowGraph::EnsureSSATempIndex(Definition* defn, Definition* replacement) {
   if ((replacement->ssa_temp_index() == -1) && (defn->ssa_temp_index() != -1)) {
     AllocateSSAIndexes(replacement);
@@ -313,6 +313,19 @@ class FlowGraph : public ZoneAllocated {
   intptr_t inlining_id() const { return inlining_id_; }
   void set_inlining_id(intptr_t value) { inlining_id_ = value; }
 
+  // Optimizing tier this graph is compiled for: 1 for the first optimization
+  // of a function and 2 when hot optimized code is reoptimized. Unoptimized
+  // graphs have tier 0.
+  intptr_t optimization_tier() const { return optimization_tier_; }
+  void set_optimization_tier(intptr_t value) { optimization_tier_ = value; }
+
+  // Scales an optimization budget (inlining sizes, unrolling limits) by
+  // --second_tier_scale when compiling for the second tier.
+  intptr_t ScaleForTier(intptr_t limit) const;
+
+  // Maximum number of receiver classes checked at a polymorphic call site.
+  intptr_t MaxPolymorphicChecks() const;
+
   // Returns true if any instructions were canonicalized away.
   bool Canonicalize();
 
@@ -387,6 +400,7 @@ class FlowGraph : public ZoneAllocated {
   friend class BranchSimplifier;
   friend class ConstantPropagator;
   friend class DeadCodeElimination;
+  friend class LoopVectorizer;
 
   // SSA transformation methods and fields.
   void ComputeDominators(GrowableArray<BitVector*>* dominance_frontier);
@@ -481,6 +495,7 @@ class FlowGraph : public ZoneAllocated {
   BitVector* captured_parameters_;
 
   intptr_t inlining_id_;
+  intptr_t optimization_tier_;
   bool should_print_;
 };
 
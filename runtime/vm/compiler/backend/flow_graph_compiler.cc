@@ -63,6 +63,7 @@ DECLARE_FLAG(charp, deoptimize_filter);
 DECLARE_FLAG(bool, intrinsify);
 DECLARE_FLAG(int, regexp_optimization_counter_threshold);
 DECLARE_FLAG(int, reoptimization_counter_threshold);
+DECLARE_FLAG(int, second_tier_counter_threshold);
 DECLARE_FLAG(int, stacktrace_every);
 DECLARE_FLAG(charp, stacktrace_filter);
 DECLARE_FLAG(bool, trace_compiler);
@@ -125,6 +126,7 @@ FlowGraphCompiler::FlowGraphCompiler(
       is_optimizing_(is_optimizing),
       speculative_policy_(speculative_policy),
       may_reoptimize_(false),
+      may_tier_up_(false),
       intrinsic_mode_(false),
       stats_(stats),
       double_class_(
@@ -179,7 +181,9 @@ bool FlowGraphCompiler::IsUnboxedField(const Field& field) {
   bool valid_class =
       (SupportsUnboxedDoubles() && (field.guarded_cid() == kDoubleCid)) ||
       (SupportsUnboxedSimd128() && (field.guarded_cid() == kFloat32x4Cid)) ||
-      (SupportsUnboxedSimd128() && (field.guarded_cid() == kFloat64x2Cid));
+      (SupportsUnboxedSimd128() && (field.guarded_cid() == kFloat64x2Cid)) ||
+      (SupportsUnboxedInt64() && (kBitsPerWord == 64) &&
+       (field.guarded_cid() == kMintCid));
   return field.is_unboxing_candidate() && !field.is_final() &&
          !field.is_nullable() && valid_class;
 }
@@ -220,6 +224,14 @@ void FlowGraphCompiler::InitCompiler() {
     }
   }
 
+  // Optimized code that does not reoptimize through its IC calls counts
+  // invocations at entry instead, and is compiled again in the second tier
+  // if it stays hot.
+  may_tier_up_ = is_optimizing() && !may_reoptimize_ &&
+                 !flow_graph().IsCompiledForOsr() &&
+                 (FLAG_second_tier_counter_threshold >= 0) &&
+                 (flow_graph().optimization_tier() == 1);
+
   if (!is_optimizing()) {
     // Initialize edge counter array.
     const intptr_t num_counters = flow_graph_.preorder().length();
@@ -1693,7 +1705,9 @@ const ICData* FlowGraphCompiler::GetOrAddStaticCallICData(
 
 intptr_t FlowGraphCompiler::GetOptimizationThreshold() const {
   intptr_t threshold;
-  if (is_optimizing()) {
+  if (may_tier_up()) {
+    threshold = FLAG_second_tier_counter_threshold;
+  } else if (is_optimizing()) {
     threshold = FLAG_reoptimization_counter_threshold;
   } else if (parsed_function_.function().IsIrregexpFunction()) {
     threshold = FLAG_regexp_optimization_counter_threshold;
@@ -2113,7 +2127,7 @@ void FlowGraphCompiler::FrameStateUpdateWith(Instruction* instr) {
 void FlowGraphCompiler::FrameStatePush(Definition* defn) {
   Representation rep = defn->representation();
   if ((rep == kUnboxedDouble) || (rep == kUnboxedFloat64x2) ||
-      (rep == kUnboxedFloat32x4)) {
+      (rep == kUnboxedFloat32x4) || (rep == kUnboxedInt64)) {
     // LoadField instruction lies about its representation in the unoptimized
     // code because Definition::representation() can't depend on the type of
     // compilation but MakeLocationSummary and EmitNativeCode can.
@@ -673,6 +673,7 @@ class FlowGraphCompiler : public ValueObject {
   }
 
   bool may_reoptimize() const { return may_reoptimize_; }
+  bool may_tier_up() const { return may_tier_up_; }
 
   // Use in unoptimized compilation to preserve/reuse ICData.
   const ICData* GetOrAddInstanceCallICData(intptr_t deopt_id,
@@ -929,6 +930,9 @@ class FlowGraphCompiler : public ValueObject {
   SpeculativeInliningPolicy* speculative_policy_;
   // Set to true if optimized code has IC calls.
   bool may_reoptimize_;
+  // Set to true if first tier optimized code counts invocations so that it
+  // can be reoptimized in the second tier.
+  bool may_tier_up_;
   // True while emitting intrinsic code.
   bool intrinsic_mode_;
   Label intrinsic_slow_path_label_;
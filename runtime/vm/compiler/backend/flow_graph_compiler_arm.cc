@@ -788,7 +788,7 @@ static const Register new_pp = NOTFP;
 void FlowGraphCompiler::EmitFrameEntry() {
   const Function& function = parsed_function().function();
   if (CanOptimizeFunction() && function.IsOptimizable() &&
-      (!is_optimizing() || may_reoptimize())) {
+      (!is_optimizing() || may_reoptimize() || may_tier_up())) {
     __ Comment("Invocation Count Check");
     const Register function_reg = R8;
     // The pool pointer is not setup before entering the Dart frame.
@@ -799,8 +799,9 @@ void FlowGraphCompiler::EmitFrameEntry() {
 
     __ ldr(R3, FieldAddress(function_reg, Function::usage_counter_offset()));
     // Reoptimization of an optimized function is triggered by counting in
-    // IC stubs, but not at the entry of the function.
-    if (!is_optimizing()) {
+    // IC stubs, but not at the entry of the function, unless the code can
+    // be reoptimized in the second tier.
+    if (!is_optimizing() || may_tier_up()) {
       __ add(R3, R3, Operand(1));
       __ str(R3, FieldAddress(function_reg, Function::usage_counter_offset()));
     }
@@ -764,7 +764,7 @@ void FlowGraphCompiler::EmitFrameEntry() {
   const Function& function = parsed_function().function();
   Register new_pp = kNoRegister;
   if (CanOptimizeFunction() && function.IsOptimizable() &&
-      (!is_optimizing() || may_reoptimize())) {
+      (!is_optimizing() || may_reoptimize() || may_tier_up())) {
     __ Comment("Invocation Count Check");
     const Register function_reg = R6;
     new_pp = R13;
@@ -778,8 +778,9 @@ void FlowGraphCompiler::EmitFrameEntry() {
     __ LoadFieldFromOffset(R7, function_reg, Function::usage_counter_offset(),
                            kWord);
     // Reoptimization of an optimized function is triggered by counting in
-    // IC stubs, but not at the entry of the function.
-    if (!is_optimizing()) {
+    // IC stubs, but not at the entry of the function, unless the code can
+    // be reoptimized in the second tier.
+    if (!is_optimizing() || may_tier_up()) {
       __ add(R7, R7, Operand(1));
       __ StoreFieldToOffset(R7, function_reg, Function::usage_counter_offset(),
                             kWord);
@@ -314,8 +314,9 @@ void FlowGraphCompiler::EmitFrameEntry() {
   const int num_locals = parsed_function().num_stack_locals();
 
   if (CanOptimizeFunction() && function.IsOptimizable() &&
-      (!is_optimizing() || may_reoptimize())) {
-    __ HotCheck(!is_optimizing(), GetOptimizationThreshold());
+      (!is_optimizing() || may_reoptimize() || may_tier_up())) {
+    __ HotCheck(!is_optimizing() || may_tier_up(),
+                GetOptimizationThreshold());
   }
 
   if (is_optimizing()) {
@@ -746,14 +746,15 @@ void FlowGraphCompiler::GenerateInlinedSetter(intptr_t offset) {
 void FlowGraphCompiler::EmitFrameEntry() {
   const Function& function = parsed_function().function();
   if (CanOptimizeFunction() && function.IsOptimizable() &&
-      (!is_optimizing() || may_reoptimize())) {
+      (!is_optimizing() || may_reoptimize() || may_tier_up())) {
     __ Comment("Invocation Count Check");
     const Register function_reg = EBX;
     __ LoadObject(function_reg, function);
 
     // Reoptimization of an optimized function is triggered by counting in
-    // IC stubs, but not at the entry of the function.
-    if (!is_optimizing()) {
+    // IC stubs, but not at the entry of the function, unless the code can
+    // be reoptimized in the second tier.
+    if (!is_optimizing() || may_tier_up()) {
       __ incl(FieldAddress(function_reg, Function::usage_counter_offset()));
     }
     __ cmpl(FieldAddress(function_reg, Function::usage_counter_offset()),
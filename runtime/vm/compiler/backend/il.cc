@@ -44,7 +44,7 @@ DEFINE_FLAG(bool,
 DEFINE_FLAG(bool,
             unbox_numeric_fields,
             !USING_DBC,
-            "Support unboxed double and float32x4 fields.");
+            "Support unboxed double, float32x4 and int64 fields.");
 DECLARE_FLAG(bool, eliminate_type_checks);
 
 const CidRangeVector& HierarchyInfo::SubtypeRangesForClass(
@@ -673,6 +673,8 @@ Representation LoadFieldInstr::representation() const {
         return kUnboxedFloat32x4;
       case kFloat64x2Cid:
         return kUnboxedFloat64x2;
+      case kMintCid:
+        return kUnboxedInt64;
       default:
         UNREACHABLE();
     }
@@ -702,6 +704,8 @@ Representation StoreInstanceFieldInstr::RequiredInputRepresentation(
         return kUnboxedFloat32x4;
       case kFloat64x2Cid:
         return kUnboxedFloat64x2;
+      case kMintCid:
+        return kUnboxedInt64;
       default:
         UNREACHABLE();
     }
@@ -4785,6 +4789,17 @@ SimdOpInstr* SimdOpInstr::CreateFromFactoryCall(Zone* zone,
   return op;
 }
 
+SimdOpInstr* SimdOpInstr::Create(Kind kind,
+                                 const GrowableArray<Value*>& inputs,
+                                 intptr_t deopt_id) {
+  SimdOpInstr* op = new SimdOpInstr(kind, deopt_id);
+  ASSERT(inputs.length() == op->InputCount());
+  for (intptr_t i = 0; i < op->InputCount(); i++) {
+    op->SetInputAt(i, inputs[i]);
+  }
+  return op;
+}
+
 SimdOpInstr::Kind SimdOpInstr::KindForOperator(intptr_t cid, Token::Kind op) {
   switch (cid) {
     case kFloat32x4Cid:
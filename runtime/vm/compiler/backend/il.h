@@ -1026,6 +1026,8 @@ class Instruction : public ZoneAllocated {
   // GetDeoptId and/or CopyDeoptIdFrom.
   friend class CallSiteInliner;
   friend class LICM;
+  friend class LoopUnroller;
+  friend class LoopVectorizer;
   friend class ComparisonInstr;
   friend class Scheduler;
   friend class BlockEntryInstr;
@@ -4539,6 +4541,7 @@ class StoreIndexedInstr : public TemplateDefinition<3, NoThrow> {
   intptr_t index_scale() const { return index_scale_; }
   intptr_t class_id() const { return class_id_; }
   bool aligned() const { return alignment_ == kAlignedAccess; }
+  StoreBarrierType emit_store_barrier() const { return emit_store_barrier_; }
 
   bool ShouldEmitStoreBarrier() const {
     return value()->NeedsStoreBuffer() &&
@@ -6553,6 +6556,7 @@ class CheckStackOverflowInstr : public TemplateInstruction<0, NoThrow> {
   virtual TokenPosition token_pos() const { return token_pos_; }
   bool in_loop() const { return loop_depth_ > 0; }
   intptr_t loop_depth() const { return loop_depth_; }
+  Kind kind() const { return kind_; }
 
   DECLARE_INSTRUCTION(CheckStackOverflow)
 
@@ -7418,6 +7422,11 @@ class SimdOpInstr : public Definition {
     return new SimdOpInstr(kind, left, right, deopt_id);
   }
 
+  // Create a SimdOp with the given inputs, e.g. a splat or a constructor.
+  static SimdOpInstr* Create(Kind kind,
+                             const GrowableArray<Value*>& inputs,
+                             intptr_t deopt_id);
+
   // Create a binary SimdOp instr.
   static SimdOpInstr* Create(MethodRecognizer::Kind kind,
                              Value* left,
@@ -1168,8 +1168,13 @@ void LoadIndexedInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       case kTypedDataFloat64x2ArrayCid:
       case kTypedDataInt32x4ArrayCid:
       case kTypedDataFloat32x4ArrayCid:
-        ASSERT(aligned());
-        __ fldrq(result, element_address);
+        if (aligned()) {
+          __ fldrq(result, element_address);
+        } else {
+          // Unlike the general-purpose loads above, q register loads from
+          // normal memory do not fault on unaligned addresses.
+          __ fldrq(result, Address(address));
+        }
         break;
       default:
         UNREACHABLE();
@@ -1361,7 +1366,10 @@ Representation StoreIndexedInstr::RequiredInputRepresentation(
 LocationSummary* StoreIndexedInstr::MakeLocationSummary(Zone* zone,
                                                         bool opt) const {
   const intptr_t kNumInputs = 3;
-  const intptr_t kNumTemps = aligned() ? 0 : 2;
+  // Stores with a barrier need the slot address to dirty its card.
+  const bool needs_slot =
+      (class_id() == kArrayCid) && ShouldEmitStoreBarrier();
+  const intptr_t kNumTemps = aligned() ? (needs_slot ? 1 : 0) : 2;
   LocationSummary* locs = new (zone)
       LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
   locs->set_in(0, Location::RequiresRegister());
@@ -1406,6 +1414,8 @@ LocationSummary* StoreIndexedInstr::MakeLocationSummary(Zone* zone,
   if (!aligned()) {
     locs->set_temp(0, Location::RequiresRegister());
     locs->set_temp(1, Location::RequiresRegister());
+  } else if (needs_slot) {
+    locs->set_temp(0, Location::RequiresRegister());
   }
   return locs;
 }
@@ -1414,11 +1424,14 @@ void StoreIndexedInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   // The array register points to the backing store for external arrays.
   const Register array = locs()->in(0).reg();
   const Location index = locs()->in(1);
-  const Register address = aligned() ? kNoRegister : locs()->temp(0).reg();
+  const bool needs_slot =
+      (class_id() == kArrayCid) && ShouldEmitStoreBarrier();
+  const Register address =
+      (aligned() && !needs_slot) ? kNoRegister : locs()->temp(0).reg();
   const Register scratch = aligned() ? kNoRegister : locs()->temp(1).reg();
 
   Address element_address(TMP);  // Bad address.
-  if (aligned()) {
+  if (aligned() && !needs_slot) {
     element_address =
         index.IsRegister()
             ? __ ElementAddressForRegIndex(false,  // Store.
@@ -1445,7 +1458,7 @@ void StoreIndexedInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       ASSERT(aligned());
       if (ShouldEmitStoreBarrier()) {
         const Register value = locs()->in(2).reg();
-        __ StoreIntoObject(array, element_address, value);
+        __ StoreIntoArray(array, address, value);
       } else if (locs()->in(2).IsConstant()) {
         const Object& constant = locs()->in(2).constant();
         __ StoreIntoObjectNoBarrier(array, element_address, constant);
@@ -1549,9 +1562,12 @@ void StoreIndexedInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     case kTypedDataFloat64x2ArrayCid:
     case kTypedDataInt32x4ArrayCid:
     case kTypedDataFloat32x4ArrayCid: {
-      ASSERT(aligned());
       const VRegister value_reg = locs()->in(2).fpu_reg();
-      __ fstrq(value_reg, element_address);
+      if (aligned()) {
+        __ fstrq(value_reg, element_address);
+      } else {
+        __ fstrq(value_reg, Address(address));
+      }
       break;
     }
     default:
@@ -1922,7 +1938,9 @@ LocationSummary* StoreInstanceFieldInstr::MakeLocationSummary(Zone* zone,
 
   summary->set_in(0, Location::RequiresRegister());
   if (IsUnboxedStore() && opt) {
-    summary->set_in(1, Location::RequiresFpuRegister());
+    summary->set_in(1, (field().UnboxedFieldCid() == kMintCid)
+                           ? Location::RequiresRegister()
+                           : Location::RequiresFpuRegister());
     summary->set_temp(0, Location::RequiresRegister());
     summary->set_temp(1, Location::RequiresRegister());
   } else if (IsPotentialUnboxedStore()) {
@@ -1945,7 +1963,6 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   const Register instance_reg = locs()->in(0).reg();
 
   if (IsUnboxedStore() && compiler->is_optimizing()) {
-    const VRegister value = locs()->in(1).fpu_reg();
     const Register temp = locs()->temp(0).reg();
     const Register temp2 = locs()->temp(1).reg();
     const intptr_t cid = field().UnboxedFieldCid();
@@ -1962,6 +1979,9 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
         case kFloat64x2Cid:
           cls = &compiler->float64x2_class();
           break;
+        case kMintCid:
+          cls = &compiler->mint_class();
+          break;
         default:
           UNREACHABLE();
       }
@@ -1972,6 +1992,12 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     } else {
       __ LoadFieldFromOffset(temp, instance_reg, offset_in_bytes_);
     }
+    if (cid == kMintCid) {
+      __ Comment("UnboxedInt64StoreInstanceFieldInstr");
+      __ StoreFieldToOffset(locs()->in(1).reg(), temp, Mint::value_offset());
+      return;
+    }
+    const VRegister value = locs()->in(1).fpu_reg();
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleStoreInstanceFieldInstr");
@@ -2007,6 +2033,7 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label store_double;
     Label store_float32x4;
     Label store_float64x2;
+    Label store_mint;
 
     __ LoadObject(temp, Field::ZoneHandle(Z, field().Original()));
 
@@ -2035,6 +2062,13 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     __ CompareImmediate(temp2, kFloat64x2Cid);
     __ b(&store_float64x2, EQ);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64()) {
+      __ LoadFieldFromOffset(temp2, temp, Field::guarded_cid_offset(),
+                             kUnsignedHalfword);
+      __ CompareImmediate(temp2, kMintCid);
+      __ b(&store_mint, EQ);
+    }
+
     // Fall through.
     __ b(&store_pointer);
 
@@ -2070,6 +2104,15 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ b(&skip_store);
     }
 
+    {
+      __ Bind(&store_mint);
+      EnsureMutableBox(compiler, this, temp, compiler->mint_class(),
+                       instance_reg, offset_in_bytes_, temp2);
+      __ LoadFieldFromOffset(temp2, value_reg, Mint::value_offset());
+      __ StoreFieldToOffset(temp2, temp, Mint::value_offset());
+      __ b(&skip_store);
+    }
+
     __ Bind(&store_pointer);
   }
 
@@ -2295,10 +2338,15 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   ASSERT(sizeof(classid_t) == kInt16Size);
   const Register instance_reg = locs()->in(0).reg();
   if (IsUnboxedLoad() && compiler->is_optimizing()) {
-    const VRegister result = locs()->out(0).fpu_reg();
     const Register temp = locs()->temp(0).reg();
     __ LoadFieldFromOffset(temp, instance_reg, offset_in_bytes());
     const intptr_t cid = field()->UnboxedFieldCid();
+    if (cid == kMintCid) {
+      __ Comment("UnboxedInt64LoadFieldInstr");
+      __ LoadFieldFromOffset(locs()->out(0).reg(), temp, Mint::value_offset());
+      return;
+    }
+    const VRegister result = locs()->out(0).fpu_reg();
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleLoadFieldInstr");
@@ -2325,6 +2373,7 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label load_double;
     Label load_float32x4;
     Label load_float64x2;
+    Label load_mint;
 
     __ LoadObject(result_reg, Field::ZoneHandle(field()->Original()));
 
@@ -2349,6 +2398,12 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     __ CompareImmediate(temp, kFloat64x2Cid);
     __ b(&load_float64x2, EQ);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64()) {
+      __ ldr(temp, field_cid_operand, kUnsignedHalfword);
+      __ CompareImmediate(temp, kMintCid);
+      __ b(&load_mint, EQ);
+    }
+
     // Fall through.
     __ b(&load_pointer);
 
@@ -2386,6 +2441,16 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ b(&done);
     }
 
+    {
+      __ Bind(&load_mint);
+      BoxAllocationSlowPath::Allocate(compiler, this, compiler->mint_class(),
+                                      result_reg, temp);
+      __ LoadFieldFromOffset(temp, instance_reg, offset_in_bytes());
+      __ LoadFieldFromOffset(temp, temp, Mint::value_offset());
+      __ StoreFieldToOffset(temp, result_reg, Mint::value_offset());
+      __ b(&done);
+    }
+
     __ Bind(&load_pointer);
   }
   __ LoadFieldFromOffset(result_reg, instance_reg, offset_in_bytes());
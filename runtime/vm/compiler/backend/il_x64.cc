@@ -1819,7 +1819,9 @@ LocationSummary* StoreInstanceFieldInstr::MakeLocationSummary(Zone* zone,
 
   summary->set_in(0, Location::RequiresRegister());
   if (IsUnboxedStore() && opt) {
-    summary->set_in(1, Location::RequiresFpuRegister());
+    summary->set_in(1, (field().UnboxedFieldCid() == kMintCid)
+                           ? Location::RequiresRegister()
+                           : Location::RequiresFpuRegister());
     summary->set_temp(0, Location::RequiresRegister());
     summary->set_temp(1, Location::RequiresRegister());
   } else if (IsPotentialUnboxedStore()) {
@@ -1862,7 +1864,6 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   Register instance_reg = locs()->in(0).reg();
 
   if (IsUnboxedStore() && compiler->is_optimizing()) {
-    XmmRegister value = locs()->in(1).fpu_reg();
     Register temp = locs()->temp(0).reg();
     Register temp2 = locs()->temp(1).reg();
     const intptr_t cid = field().UnboxedFieldCid();
@@ -1879,6 +1880,9 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
         case kFloat64x2Cid:
           cls = &compiler->float64x2_class();
           break;
+        case kMintCid:
+          cls = &compiler->mint_class();
+          break;
         default:
           UNREACHABLE();
       }
@@ -1890,6 +1894,12 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     } else {
       __ movq(temp, FieldAddress(instance_reg, offset_in_bytes_));
     }
+    if (cid == kMintCid) {
+      __ Comment("UnboxedInt64StoreInstanceFieldInstr");
+      __ movq(FieldAddress(temp, Mint::value_offset()), locs()->in(1).reg());
+      return;
+    }
+    XmmRegister value = locs()->in(1).fpu_reg();
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleStoreInstanceFieldInstr");
@@ -1925,6 +1935,7 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label store_double;
     Label store_float32x4;
     Label store_float64x2;
+    Label store_mint;
 
     __ LoadObject(temp, Field::ZoneHandle(Z, field().Original()));
 
@@ -1948,6 +1959,12 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
             Immediate(kFloat64x2Cid));
     __ j(EQUAL, &store_float64x2);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64()) {
+      __ cmpw(FieldAddress(temp, Field::guarded_cid_offset()),
+              Immediate(kMintCid));
+      __ j(EQUAL, &store_mint);
+    }
+
     // Fall through.
     __ jmp(&store_pointer);
 
@@ -1983,6 +2000,15 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ jmp(&skip_store);
     }
 
+    {
+      __ Bind(&store_mint);
+      EnsureMutableBox(compiler, this, temp, compiler->mint_class(),
+                       instance_reg, offset_in_bytes_, temp2);
+      __ movq(temp2, FieldAddress(value_reg, Mint::value_offset()));
+      __ movq(FieldAddress(temp, Mint::value_offset()), temp2);
+      __ jmp(&skip_store);
+    }
+
     __ Bind(&store_pointer);
   }
 
@@ -2214,10 +2240,15 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   ASSERT(sizeof(classid_t) == kInt16Size);
   Register instance_reg = locs()->in(0).reg();
   if (IsUnboxedLoad() && compiler->is_optimizing()) {
-    XmmRegister result = locs()->out(0).fpu_reg();
     Register temp = locs()->temp(0).reg();
     __ movq(temp, FieldAddress(instance_reg, offset_in_bytes()));
     intptr_t cid = field()->UnboxedFieldCid();
+    if (cid == kMintCid) {
+      __ Comment("UnboxedInt64LoadFieldInstr");
+      __ movq(locs()->out(0).reg(), FieldAddress(temp, Mint::value_offset()));
+      return;
+    }
+    XmmRegister result = locs()->out(0).fpu_reg();
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleLoadFieldInstr");
@@ -2247,6 +2278,7 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label load_double;
     Label load_float32x4;
     Label load_float64x2;
+    Label load_mint;
 
     __ LoadObject(result, Field::ZoneHandle(field()->Original()));
 
@@ -2265,6 +2297,11 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     __ cmpw(field_cid_operand, Immediate(kFloat64x2Cid));
     __ j(EQUAL, &load_float64x2);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64()) {
+      __ cmpw(field_cid_operand, Immediate(kMintCid));
+      __ j(EQUAL, &load_mint);
+    }
+
     // Fall through.
     __ jmp(&load_pointer);
 
@@ -2302,6 +2339,16 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ jmp(&done);
     }
 
+    {
+      __ Bind(&load_mint);
+      BoxAllocationSlowPath::Allocate(compiler, this, compiler->mint_class(),
+                                      result, temp);
+      __ movq(temp, FieldAddress(instance_reg, offset_in_bytes()));
+      __ movq(temp, FieldAddress(temp, Mint::value_offset()));
+      __ movq(FieldAddress(result, Mint::value_offset()), temp);
+      __ jmp(&done);
+    }
+
     __ Bind(&load_pointer);
   }
   __ movq(result, FieldAddress(instance_reg, offset_in_bytes()));
@@ -697,7 +697,10 @@ class CallSiteInliner : public ValueObject {
     if (inliner_->AlwaysInline(callee)) {
       return InliningDecision::Yes("AlwaysInline");
     }
-    if (inlined_size_ > FLAG_inlining_caller_size_threshold) {
+    // Second tier code is reoptimized because it stayed hot, so it gets
+    // larger size budgets.
+    if (inlined_size_ >
+        caller_graph_->ScaleForTier(FLAG_inlining_caller_size_threshold)) {
       // Prevent methods becoming humongous and thus slow to compile.
       return InliningDecision::No("--inlining-caller-size-threshold");
     }
@@ -706,16 +709,19 @@ class CallSiteInliner : public ValueObject {
         return InliningDecision(
             false, "--inlining-constant-arguments-max-size-threshold");
       }
-    } else if (instr_count > FLAG_inlining_callee_size_threshold) {
+    } else if (instr_count > caller_graph_->ScaleForTier(
+                                 FLAG_inlining_callee_size_threshold)) {
       return InliningDecision::No("--inlining-callee-size-threshold");
     }
     int callee_inlining_depth = callee.inlining_depth();
     if (callee_inlining_depth > 0 && callee_inlining_depth + inlining_depth_ >
-                                         FLAG_inlining_depth_threshold) {
+                                         inlining_depth_threshold_) {
       return InliningDecision::No("--inlining-depth-threshold");
     }
     // 'instr_count' can be 0 if it was not computed yet.
-    if ((instr_count != 0) && (instr_count <= FLAG_inlining_size_threshold)) {
+    if ((instr_count != 0) &&
+        (instr_count <=
+         caller_graph_->ScaleForTier(FLAG_inlining_size_threshold))) {
       return InliningDecision::Yes("--inlining-size-threshold");
     }
     if (call_site_count <= FLAG_inlining_callee_call_sites_threshold) {
@@ -749,7 +755,8 @@ class CallSiteInliner : public ValueObject {
     while (collected_call_sites_->HasCalls()) {
       TRACE_INLINING(
           THR_Print("  Depth %" Pd " ----------\n", inlining_depth_));
-      if (collected_call_sites_->NumCalls() > FLAG_max_inlined_per_depth) {
+      if (collected_call_sites_->NumCalls() >
+          caller_graph_->ScaleForTier(FLAG_max_inlined_per_depth)) {
         break;
       }
       if (FLAG_print_inlining_tree) {
@@ -972,10 +979,12 @@ class CallSiteInliner : public ValueObject {
             CalleeGraphValidator::Validate(callee_graph);
           }
         }
+        callee_graph->set_optimization_tier(caller_graph_->optimization_tier());
 #ifdef DART_PRECOMPILER
         if (FLAG_precompiled_mode) {
           Precompiler::PopulateWithICData(parsed_function->function(),
-                                          callee_graph);
+                                          callee_graph,
+                                          inliner_->precompiler_);
         }
 #endif
 
@@ -2024,7 +2033,7 @@ bool PolymorphicInliner::Inline() {
   intptr_t total = call_->total_call_count();
   for (intptr_t var_idx = 0; var_idx < variants_.length(); ++var_idx) {
     TargetInfo* info = variants_.TargetAt(var_idx);
-    if (variants_.length() > FLAG_max_polymorphic_checks) {
+    if (variants_.length() > owner_->caller_graph()->MaxPolymorphicChecks()) {
       non_inlined_variants_->Add(info);
       continue;
     }
@@ -2208,7 +2217,8 @@ int FlowGraphInliner::Inline() {
     printer.PrintBlocks();
   }
 
-  intptr_t inlining_depth_threshold = FLAG_inlining_depth_threshold;
+  intptr_t inlining_depth_threshold =
+      flow_graph_->ScaleForTier(FLAG_inlining_depth_threshold);
 
   CallSiteInliner inliner(this, inlining_depth_threshold);
   inliner.InlineCalls();
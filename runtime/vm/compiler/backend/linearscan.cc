@@ -17,6 +17,12 @@
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            loop_aware_spilling,
+            true,
+            "Move spills of values that are not used in registers inside a "
+            "loop out of the loop and hint phis with their inputs' registers.");
+
 #if defined(DEBUG)
 #define TRACE_ALLOC(statement)                                                 \
   do {                                                                         \
@@ -930,13 +936,32 @@ void FlowGraphAllocator::ConnectIncomingPhiMoves(JoinEntryInstr* join) {
       MoveOperands* move =
           goto_instr->parallel_move()->MoveOperandsAt(move_idx);
       move->set_dest(Location::PrefersRegister());
-      range->AddUse(pos, move->dest_slot());
+      // Hint the phi with the location of its input so that the phi move
+      // can be coalesced when the input's register is still free. Inputs
+      // flowing in on forward edges are allocated before the phi.
+      Definition* input = phi->InputAt(pred_idx)->definition();
+      const bool hint_with_input =
+          FLAG_loop_aware_spilling && !input->IsConstant();
+      if (hint_with_input) {
+        range->AddHintedUse(
+            pos, move->dest_slot(),
+            GetLiveRange(input->ssa_temp_index())->assigned_location_slot());
+      } else {
+        range->AddUse(pos, move->dest_slot());
+      }
       if (is_pair_phi) {
         LiveRange* second_range = GetLiveRange(ToSecondPairVreg(vreg));
         MoveOperands* second_move =
             goto_instr->parallel_move()->MoveOperandsAt(move_idx + 1);
         second_move->set_dest(Location::PrefersRegister());
-        second_range->AddUse(pos, second_move->dest_slot());
+        if (hint_with_input) {
+          second_range->AddHintedUse(
+              pos, second_move->dest_slot(),
+              GetLiveRange(ToSecondPairVreg(input->ssa_temp_index()))
+                  ->assigned_location_slot());
+        } else {
+          second_range->AddUse(pos, second_move->dest_slot());
+        }
       }
     }
 
@@ -1893,6 +1918,9 @@ void FlowGraphAllocator::SpillBetween(LiveRange* range,
   TRACE_ALLOC(THR_Print("spill v%" Pd " [%" Pd ", %" Pd ") "
                         "between [%" Pd ", %" Pd ")\n",
                         range->vreg(), range->Start(), range->End(), from, to));
+  if (FLAG_loop_aware_spilling) {
+    from = SpillPositionOutsideLoops(range, from, to);
+  }
   LiveRange* tail = range->SplitAt(from);
 
   if (tail->Start() < to) {
@@ -1910,24 +1938,36 @@ void FlowGraphAllocator::SpillAfter(LiveRange* range, intptr_t from) {
   TRACE_ALLOC(THR_Print("spill v%" Pd " [%" Pd ", %" Pd ") after %" Pd "\n",
                         range->vreg(), range->Start(), range->End(), from));
 
-  // When spilling the value inside the loop check if this spill can
-  // be moved outside.
-  BlockInfo* block_info = BlockInfoAt(from);
-  if (block_info->is_loop_header() || (block_info->loop() != NULL)) {
-    BlockInfo* loop_header =
-        block_info->is_loop_header() ? block_info : block_info->loop();
+  from = SpillPositionOutsideLoops(range, from, kMaxPosition);
+  LiveRange* tail = range->SplitAt(from);
+  Spill(tail);
+}
 
-    if ((range->Start() <= loop_header->entry()->start_pos()) &&
-        RangeHasOnlyUnconstrainedUsesInLoop(range, loop_header->loop_id())) {
-      ASSERT(loop_header->entry()->start_pos() <= from);
-      from = loop_header->entry()->start_pos();
-      TRACE_ALLOC(
-          THR_Print("  moved spill position to loop header %" Pd "\n", from));
+intptr_t FlowGraphAllocator::SpillPositionOutsideLoops(LiveRange* range,
+                                                       intptr_t from,
+                                                       intptr_t to) {
+  // When spilling the value inside the loop check if this spill can
+  // be moved outside: the value must be live into the loop, it must not
+  // need a register anywhere inside it and it must not be reloaded before
+  // the loop ends. Continue with the enclosing loops so that the value stays
+  // in memory for the whole loop nest instead of occupying a register in
+  // the outer loops.
+  BlockInfo* loop_header = BlockInfoAt(from)->loop_header();
+  while (loop_header != NULL) {
+    const intptr_t loop_start = loop_header->entry()->start_pos();
+    if ((range->Start() > loop_start) ||
+        (to < loop_header->last_block()->end_pos()) ||
+        !RangeHasOnlyUnconstrainedUsesInLoop(range, loop_header->loop_id())) {
+      break;
     }
+    ASSERT(loop_start <= from);
+    from = loop_start;
+    TRACE_ALLOC(
+        THR_Print("  moved spill position to loop header %" Pd "\n", from));
+    if (!FLAG_loop_aware_spilling) break;
+    loop_header = loop_header->loop();
   }
-
-  LiveRange* tail = range->SplitAt(from);
-  Spill(tail);
+  return from;
 }
 
 void FlowGraphAllocator::AllocateSpillSlotFor(LiveRange* range) {
@@ -2936,6 +2976,61 @@ void FlowGraphAllocator::CollectRepresentations() {
   }
 }
 
+static void CountMoves(ParallelMoveInstr* parallel_move,
+                       intptr_t* spills,
+                       intptr_t* reloads,
+                       intptr_t* moves) {
+  for (intptr_t i = 0; i < parallel_move->NumMoves(); i++) {
+    MoveOperands* move = parallel_move->MoveOperandsAt(i);
+    if (move->IsRedundant()) continue;
+    if (move->dest().HasStackIndex()) {
+      (*spills)++;
+    } else if (move->src().HasStackIndex()) {
+      (*reloads)++;
+    } else {
+      (*moves)++;
+    }
+  }
+}
+
+void FlowGraphAllocator::PrintMovesByLoopDepth() {
+  GrowableArray<intptr_t> spills;
+  GrowableArray<intptr_t> reloads;
+  GrowableArray<intptr_t> moves;
+  for (intptr_t i = 0; i < block_order_.length(); i++) {
+    BlockEntryInstr* block = block_order_[i];
+    intptr_t depth = 0;
+    for (BlockInfo* loop = BlockInfoAt(block->start_pos())->loop_header();
+         loop != NULL; loop = loop->loop()) {
+      depth++;
+    }
+    while (spills.length() <= depth) {
+      spills.Add(0);
+      reloads.Add(0);
+      moves.Add(0);
+    }
+    if (block->HasParallelMove()) {
+      CountMoves(block->parallel_move(), &spills[depth], &reloads[depth],
+                 &moves[depth]);
+    }
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      Instruction* current = it.Current();
+      if (current->IsParallelMove()) {
+        CountMoves(current->AsParallelMove(), &spills[depth], &reloads[depth],
+                   &moves[depth]);
+      } else if (current->IsGoto() && current->AsGoto()->HasParallelMove()) {
+        CountMoves(current->AsGoto()->parallel_move(), &spills[depth],
+                   &reloads[depth], &moves[depth]);
+      }
+    }
+  }
+  for (intptr_t depth = 0; depth < spills.length(); depth++) {
+    THR_Print("  loop depth %" Pd ": %" Pd " spills, %" Pd " reloads, %" Pd
+              " moves\n",
+              depth, spills[depth], reloads[depth], moves[depth]);
+  }
+}
+
 void FlowGraphAllocator::AllocateRegisters() {
   CollectRepresentations();
 
@@ -3036,6 +3131,11 @@ void FlowGraphAllocator::AllocateRegisters() {
     PrintLiveRanges();
     THR_Print("----------------------------------------------\n");
 
+    THR_Print("-- [after ssa allocator] moves [%s] ----------\n",
+              function.ToFullyQualifiedCString());
+    PrintMovesByLoopDepth();
+    THR_Print("----------------------------------------------\n");
+
     THR_Print("-- [after ssa allocator] ir [%s] -------------\n",
               function.ToFullyQualifiedCString());
     if (FLAG_support_il_printer) {
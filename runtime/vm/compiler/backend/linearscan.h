@@ -228,6 +228,14 @@ class FlowGraphAllocator : public ValueObject {
   // Spill the given live range from the given position onwards.
   void SpillAfter(LiveRange* range, intptr_t from);
 
+  // Returns the position at which the given range should be spilled instead
+  // of from: the header of the outermost loop around from that the range is
+  // live into, has no register uses in and is not reloaded in (to is the
+  // position of the reload).
+  intptr_t SpillPositionOutsideLoops(LiveRange* range,
+                                     intptr_t from,
+                                     intptr_t to);
+
   // Spill the given live range from the given position until some
   // position preceding the to position.
   void SpillBetween(LiveRange* range, intptr_t from, intptr_t to);
@@ -246,6 +254,10 @@ class FlowGraphAllocator : public ValueObject {
 
   void PrintLiveRanges();
 
+  // Print the number of spill, reload and register moves emitted by the
+  // allocator for each loop nesting depth.
+  void PrintMovesByLoopDepth();
+
   const FlowGraph& flow_graph_;
 
   ReachingDefs reaching_defs_;
@@ -0,0 +1,764 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/loops.h"
+
+#include "vm/bit_vector.h"
+#include "vm/compiler/backend/constant_propagator.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool, trace_loop_analysis, false, "Trace loop analysis.");
+DEFINE_FLAG(bool,
+            loop_unrolling,
+            true,
+            "Fully unroll small loops with a constant trip count.");
+DEFINE_FLAG(int,
+            loop_unrolling_max_trip_count,
+            8,
+            "Do not unroll loops that run more iterations than this.");
+DEFINE_FLAG(int,
+            loop_unrolling_max_size,
+            64,
+            "Maximum number of instructions an unrolled loop may expand to.");
+
+// Returns true and sets *result if the given definition is an integer
+// constant that fits into 32 bits. Keeping all quantities this small
+// guarantees that none of the arithmetic on induction variables below can
+// overflow.
+static bool IsInt32Constant(Definition* def, int64_t* result) {
+  ConstantInstr* constant = def->AsConstant();
+  if ((constant == NULL) || !constant->value().IsInteger()) {
+    return false;
+  }
+  const int64_t value = Integer::Cast(constant->value()).AsInt64Value();
+  if (!Utils::IsInt(32, value)) {
+    return false;
+  }
+  *result = value;
+  return true;
+}
+
+// Integer operations that do not wrap around at 32 bits.
+static BinaryIntegerOpInstr* AsInductionOp(Definition* def) {
+  BinaryIntegerOpInstr* op = def->AsBinaryIntegerOp();
+  if ((op == NULL) || op->IsBinaryUint32Op()) {
+    return NULL;
+  }
+  return op;
+}
+
+// Conversions and redefinitions do not change the value of an induction
+// variable.
+static Definition* UnwrapValuePreserving(Definition* def) {
+  while (true) {
+    if (def->IsBox() || def->IsUnbox() || def->IsRedefinition() ||
+        def->IsConstraint()) {
+      def = def->InputAt(0)->definition();
+    } else {
+      return def;
+    }
+  }
+}
+
+InductionVar::InductionVar(PhiInstr* phi, Definition* initial, int64_t stride)
+    : def_(phi),
+      basic_(this),
+      initial_(initial),
+      stride_(stride),
+      scale_(1),
+      offset_(0) {}
+
+InductionVar::InductionVar(Definition* def,
+                           InductionVar* basic,
+                           int64_t scale,
+                           int64_t offset)
+    : def_(def),
+      basic_(basic),
+      initial_(NULL),
+      stride_(0),
+      scale_(scale),
+      offset_(offset) {
+  ASSERT(basic->IsBasic());
+}
+
+bool InductionVar::ValueAt(int64_t iteration, int64_t* value) const {
+  int64_t initial_value = 0;
+  if (!IsInt32Constant(initial(), &initial_value)) {
+    return false;
+  }
+  *value = offset_ + scale_ * (initial_value + iteration * basic_->stride_);
+  return true;
+}
+
+const char* InductionVar::ToCString() const {
+  Zone* zone = Thread::Current()->zone();
+  if (IsBasic()) {
+    return zone->PrintToString("v%" Pd " <- phi(v%" Pd ", +%" Pd64 ")",
+                               def_->ssa_temp_index(),
+                               initial_->ssa_temp_index(), stride_);
+  }
+  return zone->PrintToString("v%" Pd " = %" Pd64 " * v%" Pd " + %" Pd64,
+                             def_->ssa_temp_index(), scale_,
+                             basic_->def()->ssa_temp_index(), offset_);
+}
+
+LoopInfo::LoopInfo(intptr_t id, BlockEntryInstr* header, BitVector* blocks)
+    : id_(id),
+      header_(header),
+      blocks_(blocks),
+      back_edges_(),
+      outer_(NULL),
+      inner_(NULL),
+      next_(NULL),
+      has_single_exit_(false),
+      induction_vars_(),
+      trip_count_(kUnknownTripCount) {
+  for (intptr_t i = 0; i < header->PredecessorCount(); ++i) {
+    BlockEntryInstr* pred = header->PredecessorAt(i);
+    if (Contains(pred)) {
+      back_edges_.Add(pred);
+    }
+  }
+}
+
+intptr_t LoopInfo::NestingDepth() const {
+  intptr_t depth = 1;
+  for (LoopInfo* loop = outer_; loop != NULL; loop = loop->outer()) {
+    depth++;
+  }
+  return depth;
+}
+
+bool LoopInfo::Contains(BlockEntryInstr* block) const {
+  return blocks_->Contains(block->preorder_number());
+}
+
+bool LoopInfo::IsBackEdge(BlockEntryInstr* block) const {
+  for (intptr_t i = 0; i < back_edges_.length(); ++i) {
+    if (back_edges_[i] == block) {
+      return true;
+    }
+  }
+  return false;
+}
+
+BlockEntryInstr* LoopInfo::PreHeader() const {
+  BlockEntryInstr* pre_header = NULL;
+  for (intptr_t i = 0; i < header_->PredecessorCount(); ++i) {
+    BlockEntryInstr* pred = header_->PredecessorAt(i);
+    if (!Contains(pred)) {
+      if (pre_header != NULL) {
+        return NULL;
+      }
+      pre_header = pred;
+    }
+  }
+  return pre_header;
+}
+
+InductionVar* LoopInfo::LookupInductionVar(Definition* def) const {
+  for (intptr_t i = 0; i < induction_vars_.length(); ++i) {
+    if (induction_vars_[i]->def() == def) {
+      return induction_vars_[i];
+    }
+  }
+  return NULL;
+}
+
+void LoopInfo::ComputeExits(const GrowableArray<BlockEntryInstr*>& preorder) {
+  intptr_t exits = 0;
+  for (BitVector::Iterator it(blocks_); !it.Done(); it.Advance()) {
+    BlockEntryInstr* block = preorder[it.Current()];
+    Instruction* last = block->last_instruction();
+    for (intptr_t i = 0; i < last->SuccessorCount(); ++i) {
+      if (!Contains(last->SuccessorAt(i))) {
+        if ((block != header_) || !last->IsBranch()) {
+          has_single_exit_ = false;
+          return;
+        }
+        exits++;
+      }
+    }
+  }
+  has_single_exit_ = (exits == 1);
+}
+
+// Matches phi + c, c + phi and phi - c.
+static bool IsIncrementOf(PhiInstr* phi, Definition* def, int64_t* stride) {
+  BinaryIntegerOpInstr* op = AsInductionOp(UnwrapValuePreserving(def));
+  if (op == NULL) {
+    return false;
+  }
+  Definition* left = UnwrapValuePreserving(op->left()->definition());
+  Definition* right = UnwrapValuePreserving(op->right()->definition());
+  int64_t constant = 0;
+  if ((left == phi) && IsInt32Constant(op->right()->definition(), &constant)) {
+    if (op->op_kind() == Token::kADD) {
+      *stride = constant;
+      return true;
+    } else if (op->op_kind() == Token::kSUB) {
+      *stride = -constant;
+      return true;
+    }
+  } else if ((right == phi) &&
+             IsInt32Constant(op->left()->definition(), &constant)) {
+    if (op->op_kind() == Token::kADD) {
+      *stride = constant;
+      return true;
+    }
+  }
+  return false;
+}
+
+InductionVar* LoopInfo::DetectBasicInductionVar(PhiInstr* phi) {
+  Definition* initial = NULL;
+  bool has_stride = false;
+  int64_t stride = 0;
+  for (intptr_t i = 0; i < phi->InputCount(); ++i) {
+    Definition* input = phi->InputAt(i)->definition();
+    if (!IsBackEdge(header_->PredecessorAt(i))) {
+      if ((initial != NULL) && (initial != input)) {
+        return NULL;
+      }
+      initial = input;
+      continue;
+    }
+    int64_t increment = 0;
+    if (!IsIncrementOf(phi, input, &increment) ||
+        (has_stride && (increment != stride))) {
+      return NULL;
+    }
+    has_stride = true;
+    stride = increment;
+  }
+  if ((initial == NULL) || !has_stride) {
+    return NULL;
+  }
+  return new InductionVar(phi, initial, stride);
+}
+
+InductionVar* LoopInfo::DetectDerivedInductionVar(Definition* def) {
+  if (def->IsBox() || def->IsUnbox() || def->IsRedefinition()) {
+    InductionVar* input = LookupInductionVar(def->InputAt(0)->definition());
+    if (input == NULL) {
+      return NULL;
+    }
+    return new InductionVar(def, input->basic(), input->scale(),
+                            input->offset());
+  }
+
+  BinaryIntegerOpInstr* op = AsInductionOp(def);
+  if (op == NULL) {
+    return NULL;
+  }
+  // One of the operands has to be an induction variable and the other one
+  // a constant.
+  InductionVar* input = LookupInductionVar(op->left()->definition());
+  int64_t constant = 0;
+  bool input_is_left = true;
+  if ((input == NULL) ||
+      !IsInt32Constant(op->right()->definition(), &constant)) {
+    input = LookupInductionVar(op->right()->definition());
+    input_is_left = false;
+    if ((input == NULL) ||
+        !IsInt32Constant(op->left()->definition(), &constant)) {
+      return NULL;
+    }
+  }
+
+  int64_t scale = 0;
+  int64_t offset = 0;
+  switch (op->op_kind()) {
+    case Token::kADD:
+      scale = input->scale();
+      offset = input->offset() + constant;
+      break;
+    case Token::kSUB:
+      if (input_is_left) {
+        scale = input->scale();
+        offset = input->offset() - constant;
+      } else {
+        scale = -input->scale();
+        offset = constant - input->offset();
+      }
+      break;
+    case Token::kMUL:
+      scale = input->scale() * constant;
+      offset = input->offset() * constant;
+      break;
+    case Token::kSHL:
+      if (!input_is_left || (constant < 0) || (constant >= 31)) {
+        return NULL;
+      }
+      scale = input->scale() * (static_cast<int64_t>(1) << constant);
+      offset = input->offset() * (static_cast<int64_t>(1) << constant);
+      break;
+    default:
+      return NULL;
+  }
+  if (!Utils::IsInt(32, scale) || !Utils::IsInt(32, offset)) {
+    return NULL;
+  }
+  return new InductionVar(def, input->basic(), scale, offset);
+}
+
+void LoopInfo::DiscoverInductionVars(
+    const GrowableArray<BlockEntryInstr*>& reverse_postorder) {
+  JoinEntryInstr* join = header_->AsJoinEntry();
+  if (join == NULL) {
+    return;
+  }
+  for (PhiIterator it(join); !it.Done(); it.Advance()) {
+    InductionVar* basic = DetectBasicInductionVar(it.Current());
+    if (basic != NULL) {
+      induction_vars_.Add(basic);
+    }
+  }
+  if (induction_vars_.is_empty()) {
+    return;
+  }
+
+  // Reverse postorder visits every definition after its inputs (ignoring
+  // phis), so derived induction variables can be discovered in one pass.
+  for (intptr_t i = 0; i < reverse_postorder.length(); ++i) {
+    BlockEntryInstr* block = reverse_postorder[i];
+    if (!Contains(block)) {
+      continue;
+    }
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      Definition* def = it.Current()->AsDefinition();
+      if ((def != NULL) && def->HasSSATemp()) {
+        InductionVar* derived = DetectDerivedInductionVar(def);
+        if (derived != NULL) {
+          induction_vars_.Add(derived);
+        }
+      }
+    }
+  }
+}
+
+// Computes the trip count of a loop controlled by a comparison of an
+// induction variable against a constant, e.g.
+//
+//                  for (var i = i0; i < N; i += S) { ... }
+//
+// runs ceil((N - i0) / S) times when i0 < N.
+void LoopInfo::ComputeTripCount() {
+  if (!has_single_exit_) {
+    return;
+  }
+  BranchInstr* branch = header_->last_instruction()->AsBranch();
+  RelationalOpInstr* compare = branch->comparison()->AsRelationalOp();
+  if ((compare == NULL) || ((compare->operation_cid() != kSmiCid) &&
+                            (compare->operation_cid() != kMintCid))) {
+    return;
+  }
+
+  // Normalize the comparison into "iv (op) limit" that holds as long as
+  // the loop keeps iterating.
+  Token::Kind op = compare->kind();
+  InductionVar* iv = LookupInductionVar(compare->left()->definition());
+  Value* bound = compare->right();
+  if (iv == NULL) {
+    iv = LookupInductionVar(compare->right()->definition());
+    bound = compare->left();
+    op = Token::FlipComparison(op);
+  }
+  int64_t limit = 0;
+  int64_t first = 0;
+  if ((iv == NULL) || !IsInt32Constant(bound->definition(), &limit) ||
+      !iv->ValueAt(0, &first)) {
+    return;
+  }
+  if (!Contains(branch->true_successor())) {
+    op = Token::NegateComparison(op);
+  }
+
+  // Further reduce to "iv < limit" with an increasing induction variable.
+  int64_t stride = iv->stride();
+  if (!Utils::IsInt(32, first) || !Utils::IsInt(32, stride)) {
+    return;
+  }
+  if (op == Token::kLTE) {
+    limit += 1;
+  } else if (op == Token::kGTE) {
+    limit -= 1;
+  }
+  if ((op == Token::kGT) || (op == Token::kGTE)) {
+    first = -first;
+    limit = -limit;
+    stride = -stride;
+  }
+  if (first >= limit) {
+    trip_count_ = 0;
+  } else if (stride > 0) {
+    trip_count_ = (limit - first + stride - 1) / stride;
+  }
+}
+
+const char* LoopInfo::ToCString() const {
+  char buffer[256];
+  BufferFormatter f(buffer, sizeof(buffer));
+  f.Print("loop %" Pd " B%" Pd " depth %" Pd, id_, header_->block_id(),
+          NestingDepth());
+  if (outer_ != NULL) {
+    f.Print(" outer %" Pd, outer_->id());
+  }
+  if (HasKnownTripCount()) {
+    f.Print(" trip count %" Pd64, trip_count_);
+  }
+  return Thread::Current()->zone()->MakeCopyOfString(buffer);
+}
+
+LoopHierarchy::LoopHierarchy(FlowGraph* flow_graph)
+    : flow_graph_(flow_graph),
+      loops_(),
+      block_to_loop_(flow_graph->preorder().length()),
+      top_(NULL) {
+  const ZoneGrowableArray<BlockEntryInstr*>& headers =
+      flow_graph->LoopHeaders();
+  for (intptr_t i = 0; i < headers.length(); ++i) {
+    BlockEntryInstr* header = headers[i];
+    loops_.Add(new LoopInfo(i, header, header->loop_info()));
+  }
+  ComputeNesting();
+  for (intptr_t i = 0; i < loops_.length(); ++i) {
+    LoopInfo* loop = loops_[i];
+    loop->ComputeExits(flow_graph->preorder());
+    loop->DiscoverInductionVars(flow_graph->reverse_postorder());
+    loop->ComputeTripCount();
+  }
+  if (FLAG_support_il_printer && FLAG_trace_loop_analysis &&
+      flow_graph->should_print()) {
+    Print();
+  }
+}
+
+void LoopHierarchy::ComputeNesting() {
+  // The loop that immediately encloses another loop is the smallest of the
+  // loops containing its header.
+  GrowableArray<intptr_t> sizes(loops_.length());
+  for (intptr_t i = 0; i < loops_.length(); ++i) {
+    intptr_t size = 0;
+    for (BitVector::Iterator it(loops_[i]->blocks()); !it.Done();
+         it.Advance()) {
+      size++;
+    }
+    sizes.Add(size);
+  }
+  for (intptr_t i = 0; i < loops_.length(); ++i) {
+    LoopInfo* loop = loops_[i];
+    intptr_t outer_size = 0;
+    for (intptr_t j = 0; j < loops_.length(); ++j) {
+      if ((i != j) && (sizes[j] > sizes[i]) &&
+          loops_[j]->Contains(loop->header()) &&
+          ((loop->outer_ == NULL) || (sizes[j] < outer_size))) {
+        loop->outer_ = loops_[j];
+        outer_size = sizes[j];
+      }
+    }
+    if (loop->outer_ == NULL) {
+      loop->next_ = top_;
+      top_ = loop;
+    } else {
+      loop->next_ = loop->outer_->inner_;
+      loop->outer_->inner_ = loop;
+    }
+  }
+
+  // Map every block to its innermost loop: deeper loops overwrite the
+  // entries of the loops enclosing them.
+  for (intptr_t i = 0; i < flow_graph_->preorder().length(); ++i) {
+    block_to_loop_.Add(NULL);
+  }
+  for (intptr_t i = 0; i < loops_.length(); ++i) {
+    LoopInfo* loop = loops_[i];
+    for (BitVector::Iterator it(loop->blocks()); !it.Done(); it.Advance()) {
+      LoopInfo* current = block_to_loop_[it.Current()];
+      if ((current == NULL) ||
+          (current->NestingDepth() < loop->NestingDepth())) {
+        block_to_loop_[it.Current()] = loop;
+      }
+    }
+  }
+}
+
+LoopInfo* LoopHierarchy::LoopFor(BlockEntryInstr* block) const {
+  return block_to_loop_[block->preorder_number()];
+}
+
+void LoopHierarchy::Print() const {
+  THR_Print("Loops of %s\n",
+            flow_graph_->function().ToFullyQualifiedCString());
+  for (intptr_t i = 0; i < loops_.length(); ++i) {
+    LoopInfo* loop = loops_[i];
+    THR_Print("  %s\n", loop->ToCString());
+    for (intptr_t j = 0; j < loop->induction_vars().length(); ++j) {
+      THR_Print("    %s\n", loop->induction_vars()[j]->ToCString());
+    }
+  }
+}
+
+void LoopUnroller::Optimize(FlowGraph* flow_graph) {
+  if (!FLAG_loop_unrolling || flow_graph->IsCompiledForOsr()) {
+    return;
+  }
+
+  LoopHierarchy loops(flow_graph);
+  LoopUnroller unroller(flow_graph);
+  bool changed = false;
+  for (intptr_t i = 0; i < loops.num_loops(); ++i) {
+    if (unroller.TryUnroll(loops.LoopAt(i))) {
+      changed = true;
+    }
+  }
+
+  if (changed) {
+    // Unrolled loops are guarded by constant branches: remove their bodies.
+    ConstantPropagator::OptimizeBranches(flow_graph);
+  }
+}
+
+bool LoopUnroller::CanClone(Instruction* instr) {
+  return instr->IsBinarySmiOp() || instr->IsBinaryInt32Op() ||
+         instr->IsBinaryInt64Op() || instr->IsBinaryDoubleOp() ||
+         instr->IsBox() || instr->IsUnbox() || instr->IsCheckSmi() ||
+         instr->IsCheckArrayBound() || instr->IsLoadIndexed() ||
+         instr->IsStoreIndexed();
+}
+
+// Unrolling is restricted to loops consisting of a header and a single body
+// block
+//
+//                  B0: ... goto B1
+//                  B1: phis; instructions; branch if (...) B2 else B3
+//                  B2: instructions; goto B1
+//
+// where the branch in the header is the only exit and all instructions are
+// side-effect free or simple loads and stores.
+bool LoopUnroller::CanUnroll(LoopInfo* loop, BlockEntryInstr** body) {
+  if (!loop->IsInnermost() || !loop->HasKnownTripCount() ||
+      (loop->trip_count() >
+       flow_graph_->ScaleForTier(FLAG_loop_unrolling_max_trip_count))) {
+    return false;
+  }
+
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  BlockEntryInstr* pre_header = loop->PreHeader();
+  if ((header == NULL) || header->InsideTryBlock() ||
+      (header->PredecessorCount() != 2) ||
+      (loop->back_edges().length() != 1) || (pre_header == NULL) ||
+      !pre_header->last_instruction()->IsGoto()) {
+    return false;
+  }
+
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  BlockEntryInstr* back_edge = loop->back_edges()[0];
+  BlockEntryInstr* entry = loop->Contains(branch->true_successor())
+                               ? branch->true_successor()
+                               : branch->false_successor();
+  if ((entry != back_edge) || !back_edge->last_instruction()->IsGoto()) {
+    return false;
+  }
+
+  intptr_t size = 0;
+  BlockEntryInstr* blocks[] = {header, back_edge};
+  for (intptr_t i = 0; i < 2; ++i) {
+    for (ForwardInstructionIterator it(blocks[i]); !it.Done(); it.Advance()) {
+      Instruction* current = it.Current();
+      if (current->IsCheckStackOverflow() || current->IsBranch() ||
+          current->IsGoto()) {
+        continue;
+      }
+      if (!CanClone(current)) {
+        return false;
+      }
+      size++;
+    }
+  }
+  if (size * loop->trip_count() >
+      flow_graph_->ScaleForTier(FLAG_loop_unrolling_max_size)) {
+    return false;
+  }
+
+  *body = back_edge;
+  return true;
+}
+
+Definition* LoopUnroller::Rename(Definition* def) {
+  if (def->HasSSATemp() && (def->ssa_temp_index() < renaming_.length()) &&
+      (renaming_[def->ssa_temp_index()] != NULL)) {
+    return renaming_[def->ssa_temp_index()];
+  }
+  return def;
+}
+
+static void CopyOverflowAttributes(BinaryIntegerOpInstr* from,
+                                   BinaryIntegerOpInstr* to) {
+  if (from->is_truncating()) {
+    to->mark_truncating();
+  } else {
+    to->set_can_overflow(from->can_overflow());
+  }
+}
+
+Instruction* LoopUnroller::Clone(Instruction* instr) {
+  GrowableArray<Value*> inputs(instr->InputCount());
+  for (intptr_t i = 0; i < instr->InputCount(); ++i) {
+    inputs.Add(new Value(Rename(instr->InputAt(i)->definition())));
+  }
+  const intptr_t deopt_id = instr->GetDeoptId();
+
+  if (BinarySmiOpInstr* op = instr->AsBinarySmiOp()) {
+    BinarySmiOpInstr* clone =
+        new BinarySmiOpInstr(op->op_kind(), inputs[0], inputs[1], deopt_id);
+    CopyOverflowAttributes(op, clone);
+    return clone;
+  } else if (BinaryInt32OpInstr* op = instr->AsBinaryInt32Op()) {
+    BinaryInt32OpInstr* clone =
+        new BinaryInt32OpInstr(op->op_kind(), inputs[0], inputs[1], deopt_id);
+    CopyOverflowAttributes(op, clone);
+    return clone;
+  } else if (BinaryInt64OpInstr* op = instr->AsBinaryInt64Op()) {
+    return new BinaryInt64OpInstr(op->op_kind(), inputs[0], inputs[1],
+                                  deopt_id, op->speculative_mode());
+  } else if (BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp()) {
+    return new BinaryDoubleOpInstr(op->op_kind(), inputs[0], inputs[1],
+                                   deopt_id, op->token_pos(),
+                                   op->speculative_mode());
+  } else if (BoxInstr* box = instr->AsBox()) {
+    return BoxInstr::Create(box->from_representation(), inputs[0]);
+  } else if (UnboxInstr* unbox = instr->AsUnbox()) {
+    return UnboxInstr::Create(unbox->representation(), inputs[0], deopt_id,
+                              unbox->speculative_mode());
+  } else if (CheckSmiInstr* check = instr->AsCheckSmi()) {
+    return new CheckSmiInstr(inputs[0], deopt_id, check->token_pos());
+  } else if (instr->IsCheckArrayBound()) {
+    return new CheckArrayBoundInstr(
+        inputs[CheckArrayBoundInstr::kLengthPos],
+        inputs[CheckArrayBoundInstr::kIndexPos], deopt_id);
+  } else if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+    return new LoadIndexedInstr(
+        inputs[0], inputs[1], load->index_scale(), load->class_id(),
+        load->aligned() ? kAlignedAccess : kUnalignedAccess, deopt_id,
+        load->token_pos());
+  } else if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+    return new StoreIndexedInstr(
+        inputs[StoreIndexedInstr::kArrayPos],
+        inputs[StoreIndexedInstr::kIndexPos],
+        inputs[StoreIndexedInstr::kValuePos], store->emit_store_barrier(),
+        store->index_scale(), store->class_id(),
+        store->aligned() ? kAlignedAccess : kUnalignedAccess, deopt_id,
+        store->token_pos());
+  }
+  UNREACHABLE();
+  return NULL;
+}
+
+void LoopUnroller::CopyEnvironment(Instruction* from, Instruction* to) {
+  if (from->env() == NULL) {
+    return;
+  }
+  // The copy describes the state of the iteration being unrolled.
+  Environment* env = from->env()->DeepCopy(flow_graph_->zone());
+  for (Environment::DeepIterator it(env); !it.Done(); it.Advance()) {
+    Value* value = it.CurrentValue();
+    value->set_definition(Rename(value->definition()));
+  }
+  to->SetEnvironment(env);
+  for (Environment::DeepIterator it(env); !it.Done(); it.Advance()) {
+    Value* value = it.CurrentValue();
+    value->definition()->AddEnvUse(value);
+  }
+}
+
+void LoopUnroller::CloneBlock(BlockEntryInstr* block,
+                              Instruction* insertion_point) {
+  for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsCheckStackOverflow() || current->IsBranch() ||
+        current->IsGoto()) {
+      continue;
+    }
+    Definition* def = current->AsDefinition();
+    const bool has_value = (def != NULL) && def->HasSSATemp();
+    Instruction* clone = Clone(current);
+    flow_graph_->InsertBefore(insertion_point, clone, NULL,
+                              has_value ? FlowGraph::kValue
+                                        : FlowGraph::kEffect);
+    CopyEnvironment(current, clone);
+    if (has_value) {
+      renaming_[def->ssa_temp_index()] = clone->AsDefinition();
+    }
+  }
+}
+
+bool LoopUnroller::TryUnroll(LoopInfo* loop) {
+  BlockEntryInstr* body = NULL;
+  if (!CanUnroll(loop, &body)) {
+    return false;
+  }
+
+  if (FLAG_support_il_printer && FLAG_trace_loop_analysis &&
+      flow_graph_->should_print()) {
+    THR_Print("Unrolling %s\n", loop->ToCString());
+  }
+
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  Instruction* insertion_point = loop->PreHeader()->last_instruction();
+  const intptr_t back_edge_index = header->IndexOfPredecessor(body);
+
+  renaming_.Clear();
+  for (intptr_t i = 0; i < flow_graph_->current_ssa_temp_index(); ++i) {
+    renaming_.Add(NULL);
+  }
+
+  // Replicate the header and the body once per iteration in front of the
+  // loop, threading the values of the phis through the copies.
+  GrowableArray<PhiInstr*> phis;
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    phis.Add(phi);
+    renaming_[phi->ssa_temp_index()] =
+        phi->InputAt(1 - back_edge_index)->definition();
+  }
+  GrowableArray<Definition*> next_values(phis.length());
+  for (int64_t i = 0; i < loop->trip_count(); ++i) {
+    CloneBlock(header, insertion_point);
+    CloneBlock(body, insertion_point);
+    next_values.Clear();
+    for (intptr_t j = 0; j < phis.length(); ++j) {
+      next_values.Add(Rename(phis[j]->InputAt(back_edge_index)->definition()));
+    }
+    for (intptr_t j = 0; j < phis.length(); ++j) {
+      renaming_[phis[j]->ssa_temp_index()] = next_values[j];
+    }
+  }
+
+  // The header now runs exactly once, as the final check that leaves the
+  // loop: it observes the values computed by the last iteration.
+  for (intptr_t i = 0; i < phis.length(); ++i) {
+    phis[i]->ReplaceUsesWith(Rename(phis[i]));
+  }
+  header->set_loop_info(NULL);
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  const bool exit_if_true = !loop->Contains(branch->true_successor());
+  ConstantInstr* constant_true = flow_graph_->GetConstant(Bool::True());
+  ConstantInstr* constant_exit =
+      flow_graph_->GetConstant(exit_if_true ? Bool::True() : Bool::False());
+  branch->SetComparison(new StrictCompareInstr(
+      branch->token_pos(), Token::kEQ_STRICT, new Value(constant_true),
+      new Value(constant_exit), /* number_check = */ false,
+      Thread::kNoDeoptId));
+  return true;
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
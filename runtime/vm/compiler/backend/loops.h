@@ -0,0 +1,202 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOPS_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOPS_H_
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+
+namespace dart {
+
+class BitVector;
+class BlockEntryInstr;
+class Definition;
+class FlowGraph;
+class Instruction;
+class PhiInstr;
+
+// Describes an integer value that changes by a constant amount on every
+// iteration of a loop. Basic induction variables are loop header phis of the
+// form
+//
+//                    i <- phi(i0, i + stride)
+//
+// and derived induction variables are linear functions of a basic one
+//
+//                    j <- offset + scale * i
+//
+// computed inside the same loop. A basic induction variable is represented
+// with scale 1 and offset 0 relative to itself.
+class InductionVar : public ZoneAllocated {
+ public:
+  // Creates a basic induction variable.
+  InductionVar(PhiInstr* phi, Definition* initial, int64_t stride);
+
+  // Creates an induction variable derived from the given basic one.
+  InductionVar(Definition* def,
+               InductionVar* basic,
+               int64_t scale,
+               int64_t offset);
+
+  Definition* def() const { return def_; }
+  InductionVar* basic() const { return basic_; }
+  bool IsBasic() const { return basic_ == this; }
+
+  // Value flowing into the basic induction variable from outside of the loop.
+  Definition* initial() const { return basic_->initial_; }
+
+  int64_t scale() const { return scale_; }
+  int64_t offset() const { return offset_; }
+
+  // Amount by which this induction variable changes on every iteration.
+  int64_t stride() const { return scale_ * basic_->stride_; }
+
+  // Returns true and sets *value to the value of this induction variable
+  // in the given iteration if the initial value is a known integer.
+  bool ValueAt(int64_t iteration, int64_t* value) const;
+
+  const char* ToCString() const;
+
+ private:
+  Definition* def_;
+  InductionVar* basic_;
+  Definition* initial_;
+  int64_t stride_;
+  int64_t scale_;
+  int64_t offset_;
+};
+
+// Describes a natural loop together with its position in the loop nest,
+// its induction variables and (when it can be computed) its trip count.
+class LoopInfo : public ZoneAllocated {
+ public:
+  static const int64_t kUnknownTripCount = -1;
+
+  LoopInfo(intptr_t id, BlockEntryInstr* header, BitVector* blocks);
+
+  intptr_t id() const { return id_; }
+  BlockEntryInstr* header() const { return header_; }
+  BitVector* blocks() const { return blocks_; }
+
+  // Blocks that have the header as a successor.
+  const GrowableArray<BlockEntryInstr*>& back_edges() const {
+    return back_edges_;
+  }
+
+  // Immediately enclosing loop, first nested loop and the next loop
+  // nested in the same outer loop.
+  LoopInfo* outer() const { return outer_; }
+  LoopInfo* inner() const { return inner_; }
+  LoopInfo* next() const { return next_; }
+
+  // Outermost loops have depth 1.
+  intptr_t NestingDepth() const;
+  bool IsInnermost() const { return inner_ == NULL; }
+
+  bool Contains(BlockEntryInstr* block) const;
+  bool IsBackEdge(BlockEntryInstr* block) const;
+
+  // Returns the only predecessor of the header that lies outside of the
+  // loop or NULL if there are several of them.
+  BlockEntryInstr* PreHeader() const;
+
+  // True if the loop can only be left through the branch at the end of
+  // the header.
+  bool HasSingleExit() const { return has_single_exit_; }
+
+  const GrowableArray<InductionVar*>& induction_vars() const {
+    return induction_vars_;
+  }
+  InductionVar* LookupInductionVar(Definition* def) const;
+
+  // Number of times the loop body executes, or kUnknownTripCount.
+  int64_t trip_count() const { return trip_count_; }
+  bool HasKnownTripCount() const { return trip_count_ != kUnknownTripCount; }
+
+  const char* ToCString() const;
+
+ private:
+  friend class LoopHierarchy;
+
+  void ComputeExits(const GrowableArray<BlockEntryInstr*>& preorder);
+  void DiscoverInductionVars(
+      const GrowableArray<BlockEntryInstr*>& reverse_postorder);
+  InductionVar* DetectBasicInductionVar(PhiInstr* phi);
+  InductionVar* DetectDerivedInductionVar(Definition* def);
+  void ComputeTripCount();
+
+  const intptr_t id_;
+  BlockEntryInstr* header_;
+  BitVector* blocks_;
+  GrowableArray<BlockEntryInstr*> back_edges_;
+  LoopInfo* outer_;
+  LoopInfo* inner_;
+  LoopInfo* next_;
+  bool has_single_exit_;
+  GrowableArray<InductionVar*> induction_vars_;
+  int64_t trip_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopInfo);
+};
+
+// The loop nest of a flow graph. Loops are computed from the natural loops
+// discovered by FlowGraph::LoopHeaders(); loops that share a header are
+// treated as a single loop. The hierarchy is a snapshot of the graph: it has
+// to be recomputed after the graph is changed.
+class LoopHierarchy : public ValueObject {
+ public:
+  explicit LoopHierarchy(FlowGraph* flow_graph);
+
+  intptr_t num_loops() const { return loops_.length(); }
+  LoopInfo* LoopAt(intptr_t index) const { return loops_[index]; }
+
+  // Outermost loops, linked through LoopInfo::next().
+  LoopInfo* top() const { return top_; }
+
+  // Returns the innermost loop containing the block or NULL.
+  LoopInfo* LoopFor(BlockEntryInstr* block) const;
+
+  void Print() const;
+
+ private:
+  void ComputeNesting();
+
+  FlowGraph* flow_graph_;
+  GrowableArray<LoopInfo*> loops_;
+  GrowableArray<LoopInfo*> block_to_loop_;
+  LoopInfo* top_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopHierarchy);
+};
+
+// Fully unrolls small innermost loops with a known trip count: the body is
+// replicated trip count times in front of the loop, which is then made
+// unreachable. Induction variables become constants in every copy, which
+// lets range analysis and constant propagation remove bounds checks and
+// loop overhead.
+class LoopUnroller : public ValueObject {
+ public:
+  explicit LoopUnroller(FlowGraph* flow_graph) : flow_graph_(flow_graph) {}
+
+  static void Optimize(FlowGraph* flow_graph);
+
+ private:
+  bool TryUnroll(LoopInfo* loop);
+  bool CanUnroll(LoopInfo* loop, BlockEntryInstr** body);
+  static bool CanClone(Instruction* instr);
+  Instruction* Clone(Instruction* instr);
+  void CloneBlock(BlockEntryInstr* block, Instruction* insertion_point);
+  Definition* Rename(Definition* def);
+  void CopyEnvironment(Instruction* from, Instruction* to);
+
+  FlowGraph* flow_graph_;
+  GrowableArray<Definition*> renaming_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopUnroller);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOPS_H_
@@ -51,11 +51,13 @@ static Definition* UnwrapConstraint(Definition* defn) {
 
 // Simple induction variable is a variable that satisfies the following pattern:
 //
-//                         v1 <- phi(v0, v1 + 1)
+//                         v1 <- phi(v0, v1 + S)
 //
-// If there are two simple induction variables in the same block and one of
-// them is constrained - then another one is constrained as well, e.g.
-// from
+// where the stride S is a positive constant.
+//
+// If there are two simple induction variables with the same stride in the same
+// block and one of them is constrained - then another one is constrained as
+// well, e.g. from
 //
 //                        B1:
 //                         v3 <- phi(v0, v3 + 1)
@@ -71,7 +73,7 @@ static Definition* UnwrapConstraint(Definition* defn) {
 // This pass essentially pattern matches induction variables introduced
 // like this:
 //
-//                  for (var i = i0, j = j0; i < L; i++, j++) {
+//                  for (var i = i0, j = j0; i < L; i += S, j += S) {
 //                      j is known to be within [j0, j0 + (L - i0 - 1)]
 //                  }
 //
@@ -80,16 +82,19 @@ class InductionVariableInfo : public ZoneAllocated {
   InductionVariableInfo(PhiInstr* phi,
                         Definition* initial_value,
                         BinarySmiOpInstr* increment,
+                        intptr_t stride,
                         ConstraintInstr* limit)
       : phi_(phi),
         initial_value_(initial_value),
         increment_(increment),
+        stride_(stride),
         limit_(limit),
         bound_(NULL) {}
 
   PhiInstr* phi() const { return phi_; }
   Definition* initial_value() const { return initial_value_; }
   BinarySmiOpInstr* increment() const { return increment_; }
+  intptr_t stride() const { return stride_; }
 
   // Outermost constraint that constrains this induction variable into
   // [-inf, X] range.
@@ -103,6 +108,7 @@ class InductionVariableInfo : public ZoneAllocated {
   PhiInstr* phi_;
   Definition* initial_value_;
   BinarySmiOpInstr* increment_;
+  intptr_t stride_;
   ConstraintInstr* limit_;
 
   PhiInstr* bound_;
@@ -150,14 +156,24 @@ static InductionVariableInfo* DetectSimpleInductionVariable(PhiInstr* phi) {
       UnwrapConstraint(phi->InputAt(backedge_idx)->definition())
           ->AsBinarySmiOp();
 
-  if ((increment != NULL) && (increment->op_kind() == Token::kADD) &&
-      (UnwrapConstraint(increment->left()->definition()) == phi) &&
-      increment->right()->BindsToConstant() &&
-      increment->right()->BoundConstant().IsSmi() &&
-      (Smi::Cast(increment->right()->BoundConstant()).Value() == 1)) {
+  if ((increment == NULL) || (increment->op_kind() != Token::kADD)) {
+    return NULL;
+  }
+
+  // Accept both phi + S and S + phi.
+  Value* phi_use = increment->left();
+  Value* stride = increment->right();
+  if (UnwrapConstraint(phi_use->definition()) != phi) {
+    phi_use = increment->right();
+    stride = increment->left();
+  }
+  if ((UnwrapConstraint(phi_use->definition()) == phi) &&
+      stride->BindsToConstant() && stride->BoundConstant().IsSmi() &&
+      (Smi::Cast(stride->BoundConstant()).Value() > 0)) {
     return new InductionVariableInfo(
         phi, initial_value, increment,
-        FindBoundingConstraint(phi, increment->left()->definition()));
+        Smi::Cast(stride->BoundConstant()).Value(),
+        FindBoundingConstraint(phi, phi_use->definition()));
   }
 
   return NULL;
@@ -201,7 +217,15 @@ void RangeAnalysis::DiscoverSimpleInductionVariables() {
     if (bound != NULL) {
       for (intptr_t i = 0; i < loop_variables.length(); i++) {
         InductionVariableInfo* info = loop_variables[i];
-        info->set_bound(bound->phi());
+        // Only variables advancing in lockstep with the bound can derive
+        // their upper bound from it.
+        if (info->stride() == bound->stride()) {
+          info->set_bound(bound->phi());
+        } else if (info->limit() != NULL) {
+          info->set_bound(info->phi());
+        } else {
+          continue;
+        }
         info->phi()->set_induction_variable_info(info);
       }
     }
@@ -266,28 +290,6 @@ void RangeAnalysis::CollectValues() {
   }
 }
 
-// For a comparison operation return an operation for the equivalent flipped
-// comparison: a (op) b === b (op') a.
-static Token::Kind FlipComparison(Token::Kind op) {
-  switch (op) {
-    case Token::kEQ:
-      return Token::kEQ;
-    case Token::kNE:
-      return Token::kNE;
-    case Token::kLT:
-      return Token::kGT;
-    case Token::kGT:
-      return Token::kLT;
-    case Token::kLTE:
-      return Token::kGTE;
-    case Token::kGTE:
-      return Token::kLTE;
-    default:
-      UNREACHABLE();
-      return Token::kILLEGAL;
-  }
-}
-
 // Given a boundary (right operand) and a comparison operation return
 // a symbolic range constraint for the left operand of the comparison assuming
 // that it evaluated to true.
@@ -360,7 +362,7 @@ bool RangeAnalysis::ConstrainValueAfterBranch(Value* use, Definition* defn) {
       boundary = rel_op->InputAt(0)->definition();
       // InsertConstraintFor assumes that defn is left operand of a
       // comparison if it is right operand flip the comparison.
-      op_kind = FlipComparison(rel_op->kind());
+      op_kind = Token::FlipComparison(rel_op->kind());
     }
 
     // Constrain definition at the true successor.
@@ -1120,7 +1122,7 @@ class BoundsCheckGeneralizer {
       if (point->IsDominatedBy(info.limit())) {
         // Given induction variable
         //
-        //          x <- phi(x0, x + 1)
+        //          x <- phi(x0, x + S)
         //
         // and a constraint x <= M that dominates the given
         // point we conclude that M is an upper bound for x.
@@ -1130,10 +1132,10 @@ class BoundsCheckGeneralizer {
       const InductionVariableInfo& bound_info =
           *info.bound()->induction_variable_info();
       if (point->IsDominatedBy(bound_info.limit())) {
-        // Given two induction variables
+        // Given two induction variables with the same stride
         //
-        //          x <- phi(x0, x + 1)
-        //          y <- phi(y0, y + 1)
+        //          x <- phi(x0, x + S)
+        //          y <- phi(y0, y + S)
         //
         // and a constraint x <= M that dominates the given
         // point we can conclude that
@@ -1155,9 +1157,9 @@ class BoundsCheckGeneralizer {
   }
 
   Definition* InductionVariableLowerBound(PhiInstr* phi, Instruction* point) {
-    // Given induction variable
+    // Given induction variable with a positive stride
     //
-    //          x <- phi(x0, x + 1)
+    //          x <- phi(x0, x + S)
     //
     // we can conclude that LowerBound(x) == x0.
     const InductionVariableInfo& info = *phi->induction_variable_info();
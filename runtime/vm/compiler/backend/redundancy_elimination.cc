@@ -17,6 +17,11 @@ namespace dart {
 
 DEFINE_FLAG(bool, dead_store_elimination, true, "Eliminate dead stores");
 DEFINE_FLAG(bool, load_cse, true, "Use redundant load elimination.");
+DEFINE_FLAG(bool,
+            partial_escape_analysis,
+            true,
+            "Copy allocations that escape only on some paths onto these "
+            "paths and sink the original allocation.");
 DEFINE_FLAG(bool,
             trace_load_optimization,
             false,
@@ -2864,8 +2869,16 @@ void AllocationSinking::DiscoverFailedCandidates() {
 }
 
 void AllocationSinking::Optimize() {
+  if (FLAG_partial_escape_analysis) {
+    SplitPartialEscapes();
+  }
+
   CollectCandidates();
 
+  // Copies of partially escaping allocations take the state of the original
+  // allocation at the point where it escapes.
+  InitializeEscapingCopies();
+
   // Insert MaterializeObject instructions that will describe the state of the
   // object at all deoptimization points. Each inserted materialization looks
   // like this (where v_0 is allocation that we are going to eliminate):
@@ -2937,6 +2950,28 @@ static bool AddSlot(ZoneGrowableArray<const Object*>* slots,
   return true;
 }
 
+// Collect all fields/offsets the given allocation is initialized with.
+static ZoneGrowableArray<const Object*>* CollectStoredSlots(Zone* zone,
+                                                           Definition* alloc) {
+  ZoneGrowableArray<const Object*>* slots =
+      new (zone) ZoneGrowableArray<const Object*>(5);
+
+  for (Value* use = alloc->input_use_list(); use != NULL;
+       use = use->next_use()) {
+    StoreInstanceFieldInstr* store = use->instruction()->AsStoreInstanceField();
+    if ((store != NULL) && (store->instance()->definition() == alloc)) {
+      if (!store->field().IsNull()) {
+        AddSlot(slots, Field::ZoneHandle(zone, store->field().Original()));
+      } else {
+        AddSlot(slots,
+                Smi::ZoneHandle(zone, Smi::New(store->offset_in_bytes())));
+      }
+    }
+  }
+
+  return slots;
+}
+
 // Find deoptimization exit for the given materialization assuming that all
 // materializations are emitted right before the instruction which is a
 // deoptimization exit.
@@ -3099,20 +3134,7 @@ void AllocationSinking::ExitsCollector::CollectTransitively(Definition* alloc) {
 
 void AllocationSinking::InsertMaterializations(Definition* alloc) {
   // Collect all fields that are written for this instance.
-  ZoneGrowableArray<const Object*>* slots =
-      new (Z) ZoneGrowableArray<const Object*>(5);
-
-  for (Value* use = alloc->input_use_list(); use != NULL;
-       use = use->next_use()) {
-    StoreInstanceFieldInstr* store = use->instruction()->AsStoreInstanceField();
-    if ((store != NULL) && (store->instance()->definition() == alloc)) {
-      if (!store->field().IsNull()) {
-        AddSlot(slots, Field::ZoneHandle(Z, store->field().Original()));
-      } else {
-        AddSlot(slots, Smi::ZoneHandle(Z, Smi::New(store->offset_in_bytes())));
-      }
-    }
-  }
+  ZoneGrowableArray<const Object*>* slots = CollectStoredSlots(Z, alloc);
 
   if (alloc->ArgumentCount() > 0) {
     AllocateObjectInstr* alloc_object = alloc->AsAllocateObject();
@@ -3131,6 +3153,260 @@ void AllocationSinking::InsertMaterializations(Definition* alloc) {
   }
 }
 
+// Location of the given use for the purposes of dominance: inputs of a phi
+// are used at the end of the corresponding predecessor.
+static Instruction* UseLocation(Value* use) {
+  PhiInstr* phi = use->instruction()->AsPhi();
+  if (phi != NULL) {
+    return phi->block()->PredecessorAt(use->use_index())->last_instruction();
+  }
+  return use->instruction();
+}
+
+static bool IsAllocation(Definition* defn) {
+  return defn->IsAllocateObject() || defn->IsAllocateUninitializedContext();
+}
+
+// Partial escape analysis: an allocation which escapes (is passed to a call,
+// merged by a phi, stored into a non-candidate object, etc.) only on some of
+// the paths through the graph is replaced by a copy on each of these paths.
+//
+//     v0 <- AllocateObject(P)               v0 <- AllocateObject(P)
+//     StoreInstanceField(v0.x, v1)          StoreInstanceField(v0.x, v1)
+//     if (...) {                            if (...) {
+//       PushArgument(v0)             =>       v2 <- LoadField(v0.x)
+//       StaticCall(f, v0)                     v3 <- AllocateObject(P)
+//     }                                       StoreInstanceField(v3.x, v2)
+//     ... v0 in environments ...              PushArgument(v3)
+//                                             StaticCall(f, v3)
+//                                           }
+//                                           ... v0 in environments ...
+//
+// After the split the original allocation is only used by stores into its
+// own fields and in environments, which makes it a candidate for allocation
+// sinking. Loads inserted in front of the copy are forwarded together with
+// the loads of materializations.
+void AllocationSinking::SplitPartialEscapes() {
+  GrowableArray<AllocateObjectInstr*> allocations;
+  for (BlockIterator block_it = flow_graph_->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      AllocateObjectInstr* alloc = it.Current()->AsAllocateObject();
+      if ((alloc != NULL) &&
+          !IsAllocationSinkingCandidate(alloc, kOptimisticCheck)) {
+        allocations.Add(alloc);
+      }
+    }
+  }
+
+  for (intptr_t i = 0; i < allocations.length(); i++) {
+    AllocateObjectInstr* alloc = allocations[i];
+    if (SplitPartialEscape(alloc) && FLAG_trace_optimization) {
+      THR_Print("allocation v%" Pd " is copied where it escapes\n",
+                alloc->ssa_temp_index());
+    }
+  }
+}
+
+bool AllocationSinking::SplitPartialEscape(AllocateObjectInstr* alloc) {
+  BlockEntryInstr* alloc_block = alloc->GetBlock();
+  BitVector* use_blocks =
+      new (Z) BitVector(Z, flow_graph_->preorder().length());
+
+  // Collect the points where the allocation escapes.
+  GrowableArray<Instruction*> exits;
+  for (Value* use = alloc->input_use_list(); use != NULL;
+       use = use->next_use()) {
+    Instruction* location = UseLocation(use);
+    use_blocks->Add(location->GetBlock()->preorder_number());
+
+    StoreInstanceFieldInstr* store = use->instruction()->AsStoreInstanceField();
+    if (store != NULL) {
+      // Stores between allocations are handled by CollectCandidates and
+      // must not be split apart.
+      Definition* instance = store->instance()->definition();
+      Definition* value = store->value()->definition();
+      if ((instance == value) || IsAllocation(value) ||
+          ((use == store->value()) && IsAllocation(instance))) {
+        return false;
+      }
+      if (use == store->instance()) {
+        continue;
+      }
+    }
+
+    if (location->GetBlock() == alloc_block) {
+      // Allocation escapes on every path.
+      return false;
+    }
+    AddInstruction(&exits, location);
+  }
+
+  if (exits.is_empty()) {
+    return false;
+  }
+
+  for (Value* use = alloc->env_use_list(); use != NULL;
+       use = use->next_use()) {
+    use_blocks->Add(use->instruction()->GetBlock()->preorder_number());
+  }
+
+  // Only the first escape on each path needs a copy: uses dominated by it
+  // are redirected to the copy as well.
+  intptr_t j = 0;
+  for (intptr_t i = 0; i < exits.length(); i++) {
+    bool dominated = false;
+    for (intptr_t k = 0; k < exits.length(); k++) {
+      if ((k != i) && exits[i]->IsDominatedBy(exits[k])) {
+        dominated = true;
+        break;
+      }
+    }
+    if (!dominated) {
+      exits[j++] = exits[i];
+    }
+  }
+  exits.TruncateTo(j);
+
+  for (intptr_t i = 0; i < exits.length(); i++) {
+    if (!ReachesOnlyDominatedUses(alloc, exits[i], use_blocks)) {
+      return false;
+    }
+  }
+
+  for (intptr_t i = 0; i < exits.length(); i++) {
+    AllocateObjectInstr* copy = CreateEscapingCopyAt(exits[i], alloc);
+    escaping_copies_.Add(copy);
+    copied_allocations_.Add(alloc);
+  }
+  return true;
+}
+
+// Check that after passing the given exit control can't reach any use of
+// the allocation which is not dominated by the exit without allocating
+// the object again.
+bool AllocationSinking::ReachesOnlyDominatedUses(Definition* alloc,
+                                                 Instruction* exit,
+                                                 BitVector* use_blocks) {
+  BlockEntryInstr* alloc_block = alloc->GetBlock();
+  BlockEntryInstr* exit_block = exit->GetBlock();
+  BitVector* visited = new (Z) BitVector(Z, flow_graph_->preorder().length());
+
+  GrowableArray<BlockEntryInstr*> worklist;
+  worklist.Add(exit_block);
+  while (!worklist.is_empty()) {
+    BlockEntryInstr* block = worklist.RemoveLast();
+    Instruction* last = block->last_instruction();
+    for (intptr_t i = 0; i < last->SuccessorCount(); i++) {
+      BlockEntryInstr* succ = last->SuccessorAt(i);
+      if ((succ == alloc_block) || visited->Contains(succ->preorder_number())) {
+        continue;
+      }
+      if (succ == exit_block) {
+        // The exit is in a loop which does not contain the allocation.
+        return false;
+      }
+      if (!exit_block->Dominates(succ) &&
+          use_blocks->Contains(succ->preorder_number())) {
+        return false;
+      }
+      visited->Add(succ->preorder_number());
+      worklist.Add(succ);
+    }
+  }
+  return true;
+}
+
+// Insert a copy of the given allocation in front of the exit and redirect
+// all uses dominated by the exit to it. The copy is initialized from the
+// fields of the original allocation later (see InitializeEscapingCopies),
+// once the original allocation is known to be a sinking candidate.
+AllocateObjectInstr* AllocationSinking::CreateEscapingCopyAt(
+    Instruction* exit,
+    AllocateObjectInstr* alloc) {
+  PushArgumentsArray* arguments =
+      new (Z) PushArgumentsArray(alloc->ArgumentCount());
+  if (alloc->ArgumentCount() > 0) {
+    PushArgumentInstr* push_type_args = new (Z) PushArgumentInstr(
+        new (Z) Value(alloc->PushArgumentAt(0)->value()->definition()));
+    flow_graph_->InsertBefore(exit, push_type_args, NULL, FlowGraph::kEffect);
+    arguments->Add(push_type_args);
+  }
+  AllocateObjectInstr* copy =
+      new (Z) AllocateObjectInstr(alloc->token_pos(), alloc->cls(), arguments);
+  copy->set_closure_function(alloc->closure_function());
+  flow_graph_->InsertBefore(exit, copy, NULL, FlowGraph::kValue);
+
+  GrowableArray<Value*> uses;
+  for (Value* use = alloc->input_use_list(); use != NULL;
+       use = use->next_use()) {
+    Instruction* location = UseLocation(use);
+    if ((location == exit) || location->IsDominatedBy(exit)) {
+      uses.Add(use);
+    }
+  }
+  for (intptr_t i = 0; i < uses.length(); i++) {
+    uses[i]->BindTo(copy);
+  }
+
+  uses.Clear();
+  for (Value* use = alloc->env_use_list(); use != NULL;
+       use = use->next_use()) {
+    if (use->instruction()->IsDominatedBy(exit)) {
+      uses.Add(use);
+    }
+  }
+  for (intptr_t i = 0; i < uses.length(); i++) {
+    Value* use = uses[i];
+    use->RemoveFromUseList();
+    use->set_definition(copy);
+    copy->AddEnvUse(use);
+  }
+
+  return copy;
+}
+
+// Initialize each copy created by SplitPartialEscapes with the values of
+// the original allocation's fields at the point where the copy is made.
+void AllocationSinking::InitializeEscapingCopies() {
+  for (intptr_t i = 0; i < escaping_copies_.length(); i++) {
+    AllocateObjectInstr* copy = escaping_copies_[i];
+    AllocateObjectInstr* alloc = copied_allocations_[i];
+
+    // The original allocation is only used by stores into its own fields
+    // and in environments.
+    ASSERT(alloc->Identity().IsAllocationSinkingCandidate());
+
+    ZoneGrowableArray<const Object*>* slots = CollectStoredSlots(Z, alloc);
+    Instruction* prev = copy;
+    for (intptr_t j = 0; j < slots->length(); j++) {
+      const Object& slot = *(*slots)[j];
+      LoadFieldInstr* load =
+          slot.IsField()
+              ? new (Z) LoadFieldInstr(
+                    new (Z) Value(alloc), &Field::Cast(slot),
+                    AbstractType::ZoneHandle(Z), alloc->token_pos(), NULL)
+              : new (Z) LoadFieldInstr(
+                    new (Z) Value(alloc), Smi::Cast(slot).Value(),
+                    AbstractType::ZoneHandle(Z), alloc->token_pos());
+      flow_graph_->InsertBefore(copy, load, NULL, FlowGraph::kValue);
+
+      StoreInstanceFieldInstr* store =
+          slot.IsField()
+              ? new (Z) StoreInstanceFieldInstr(
+                    Field::Cast(slot), new (Z) Value(copy),
+                    new (Z) Value(load), kEmitStoreBarrier, alloc->token_pos())
+              : new (Z) StoreInstanceFieldInstr(
+                    Smi::Cast(slot).Value(), new (Z) Value(copy),
+                    new (Z) Value(load), kEmitStoreBarrier, alloc->token_pos());
+      store->set_is_initialization(true);
+      flow_graph_->InsertAfter(prev, store, NULL, FlowGraph::kEffect);
+      prev = store;
+    }
+  }
+}
+
 void TryCatchAnalyzer::Optimize(FlowGraph* flow_graph) {
   // For every catch-block: Iterate over all call instructions inside the
   // corresponding try-block and figure out for each environment value if it
@@ -52,6 +52,19 @@ class AllocationSinking : public ZoneAllocated {
     GrowableArray<Definition*> worklist_;
   };
 
+  void SplitPartialEscapes();
+
+  bool SplitPartialEscape(AllocateObjectInstr* alloc);
+
+  bool ReachesOnlyDominatedUses(Definition* alloc,
+                                Instruction* exit,
+                                BitVector* use_blocks);
+
+  AllocateObjectInstr* CreateEscapingCopyAt(Instruction* exit,
+                                            AllocateObjectInstr* alloc);
+
+  void InitializeEscapingCopies();
+
   void CollectCandidates();
 
   void NormalizeMaterializations();
@@ -76,6 +89,11 @@ class AllocationSinking : public ZoneAllocated {
   GrowableArray<Definition*> candidates_;
   GrowableArray<MaterializeObjectInstr*> materializations_;
 
+  // Copies of partially escaping allocations created at the points where
+  // they escape and the allocations they copy (see SplitPartialEscapes).
+  GrowableArray<AllocateObjectInstr*> escaping_copies_;
+  GrowableArray<AllocateObjectInstr*> copied_allocations_;
+
   ExitsCollector exits_collector_;
 };
 
@@ -0,0 +1,597 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/vectorizer.h"
+
+#include "vm/bit_vector.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_vectorization,
+            true,
+            "Use SIMD operations for simple loops over typed data.");
+
+DECLARE_FLAG(bool, trace_loop_analysis);
+
+// Number of elements of the given typed data class that fit into a 128-bit
+// SIMD register, or 0 if loops over such arrays are not vectorized.
+static intptr_t LanesFor(intptr_t class_id) {
+  switch (class_id) {
+    case kTypedDataInt8ArrayCid:
+    case kTypedDataUint8ArrayCid:
+      return 16;
+    case kTypedDataFloat32ArrayCid:
+      return 4;
+    case kTypedDataFloat64ArrayCid:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+// Typed data class used to access lanes elements of the given class at once.
+static intptr_t VectorArrayCid(intptr_t class_id) {
+  switch (class_id) {
+    case kTypedDataInt8ArrayCid:
+    case kTypedDataUint8ArrayCid:
+      return kTypedDataInt32x4ArrayCid;
+    case kTypedDataFloat32ArrayCid:
+      return kTypedDataFloat32x4ArrayCid;
+    case kTypedDataFloat64ArrayCid:
+      return kTypedDataFloat64x2ArrayCid;
+    default:
+      UNREACHABLE();
+      return kIllegalCid;
+  }
+}
+
+// Class of the values produced by the vector operations.
+static intptr_t VectorCid(intptr_t class_id) {
+  switch (VectorArrayCid(class_id)) {
+    case kTypedDataInt32x4ArrayCid:
+      return kInt32x4Cid;
+    case kTypedDataFloat32x4ArrayCid:
+      return kFloat32x4Cid;
+    default:
+      return kFloat64x2Cid;
+  }
+}
+
+static bool IsIntegerConstant(Definition* def, int64_t* value) {
+  while (def->IsBox() || def->IsUnbox()) {
+    def = def->InputAt(0)->definition();
+  }
+  ConstantInstr* constant = def->AsConstant();
+  if ((constant == NULL) || !constant->value().IsInteger()) {
+    return false;
+  }
+  *value = Integer::Cast(constant->value()).AsInt64Value();
+  return true;
+}
+
+static void AddUnique(GrowableArray<Definition*>* list, Definition* def) {
+  for (intptr_t i = 0; i < list->length(); ++i) {
+    if ((*list)[i] == def) {
+      return;
+    }
+  }
+  list->Add(def);
+}
+
+LoopVectorizer::LoopVectorizer(FlowGraph* flow_graph)
+    : flow_graph_(flow_graph),
+      header_(NULL),
+      pre_header_(NULL),
+      body_(NULL),
+      index_(NULL),
+      increment_(NULL),
+      bound_(NULL),
+      stack_check_(NULL),
+      element_cid_(kIllegalCid),
+      arrays_(),
+      lengths_(),
+      vector_defs_(NULL),
+      vectors_(),
+      vector_index_(NULL),
+      limit_(NULL),
+      vector_exits_(),
+      scalar_indices_() {}
+
+bool LoopVectorizer::IsSupported() {
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+  return FlowGraphCompiler::SupportsUnboxedSimd128();
+#else
+  // The ARM backend only emits 128-bit LoadIndexed and StoreIndexed at
+  // aligned addresses.
+  return false;
+#endif
+}
+
+void LoopVectorizer::Optimize(FlowGraph* flow_graph) {
+  if (!FLAG_loop_vectorization || flow_graph->IsCompiledForOsr() ||
+      !IsSupported()) {
+    return;
+  }
+
+  LoopHierarchy loops(flow_graph);
+  LoopVectorizer vectorizer(flow_graph);
+  for (intptr_t i = 0; i < loops.num_loops(); ++i) {
+    vectorizer.TryVectorize(loops.LoopAt(i));
+  }
+  if (vectorizer.vector_exits_.is_empty()) {
+    return;
+  }
+
+  flow_graph->DiscoverBlocks();
+  vectorizer.FixPhiInputs();
+  GrowableArray<BitVector*> dominance_frontier;
+  flow_graph->ComputeDominators(&dominance_frontier);
+}
+
+bool LoopVectorizer::IsInvariant(Definition* def) const {
+  return def->GetBlock()->Dominates(pre_header_);
+}
+
+bool LoopVectorizer::IsIndex(Value* value) const {
+  return value->definition() == index_;
+}
+
+bool LoopVectorizer::IsVector(Definition* def) const {
+  return def->HasSSATemp() &&
+         (def->ssa_temp_index() < vector_defs_->length()) &&
+         vector_defs_->Contains(def->ssa_temp_index());
+}
+
+void LoopVectorizer::MarkVector(Definition* def) {
+  vector_defs_->Add(def->ssa_temp_index());
+}
+
+// All arrays accessed in the loop have to hold elements of the same size
+// and kind, so that every vector operation covers the same iterations.
+bool LoopVectorizer::CheckElementCid(intptr_t class_id) {
+  if (LanesFor(class_id) == 0) {
+    return false;
+  }
+  if (element_cid_ == kIllegalCid) {
+    element_cid_ = class_id;
+    return true;
+  }
+  return VectorArrayCid(class_id) == VectorArrayCid(element_cid_);
+}
+
+// Matches a header of the form
+//
+//                  i <- phi(i0, i + 1)
+//                  CheckStackOverflow
+//                  if (i < n) goto body else goto exit
+//
+// where i0 is a non-negative constant and n is loop invariant.
+bool LoopVectorizer::CheckHeader(LoopInfo* loop) {
+  index_ = NULL;
+  for (PhiIterator it(header_); !it.Done(); it.Advance()) {
+    if (index_ != NULL) {
+      return false;
+    }
+    index_ = it.Current();
+  }
+  if ((index_ == NULL) || (index_->representation() != kTagged)) {
+    return false;
+  }
+  InductionVar* iv = loop->LookupInductionVar(index_);
+  int64_t initial = 0;
+  if ((iv == NULL) || (iv->stride() != 1) || !iv->ValueAt(0, &initial) ||
+      (initial < 0)) {
+    return false;
+  }
+  increment_ =
+      index_->InputAt(header_->IndexOfPredecessor(body_))->definition();
+  if (!increment_->IsBinarySmiOp()) {
+    return false;
+  }
+
+  stack_check_ = NULL;
+  for (ForwardInstructionIterator it(header_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsCheckStackOverflow() && (stack_check_ == NULL)) {
+      stack_check_ = current->AsCheckStackOverflow();
+    } else if (!current->IsBranch()) {
+      return false;
+    }
+  }
+
+  BranchInstr* branch = header_->last_instruction()->AsBranch();
+  RelationalOpInstr* compare = branch->comparison()->AsRelationalOp();
+  if ((compare == NULL) || (compare->operation_cid() != kSmiCid)) {
+    return false;
+  }
+  if ((compare->kind() == Token::kLT) && IsIndex(compare->left())) {
+    bound_ = compare->right()->definition();
+  } else if ((compare->kind() == Token::kGT) && IsIndex(compare->right())) {
+    bound_ = compare->left()->definition();
+  } else {
+    return false;
+  }
+  return IsInvariant(bound_);
+}
+
+// Float32x4 operations round their results to single precision, while the
+// scalar code computes in double precision and only rounds when storing.
+// For a single operation on values loaded from Float32List both are exact,
+// chains of operations would differ.
+bool LoopVectorizer::CheckDoubleOp(BinaryDoubleOpInstr* op) {
+  switch (op->op_kind()) {
+    case Token::kADD:
+    case Token::kSUB:
+    case Token::kMUL:
+    case Token::kDIV:
+      break;
+    default:
+      return false;
+  }
+  Definition* left = op->left()->definition();
+  Definition* right = op->right()->definition();
+  if (element_cid_ == kTypedDataFloat32ArrayCid) {
+    return IsVector(left) && left->IsLoadIndexed() && IsVector(right) &&
+           right->IsLoadIndexed();
+  } else if (element_cid_ != kTypedDataFloat64ArrayCid) {
+    return false;
+  }
+  if (!IsVector(left) && !IsVector(right)) {
+    return false;
+  }
+  // Loop invariant operands are broadcast into all lanes.
+  for (intptr_t i = 0; i < op->InputCount(); ++i) {
+    Definition* input = op->InputAt(i)->definition();
+    if (!IsVector(input) && (!IsInvariant(input) ||
+                             (input->representation() != kUnboxedDouble))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Bitwise operations on bytes can be performed on Int32x4 values holding
+// sixteen bytes: the low byte of the result, which is all that a store into
+// Int8List or Uint8List keeps, only depends on the low bytes of the operands.
+bool LoopVectorizer::CheckBitOp(BinaryIntegerOpInstr* op) {
+  switch (op->op_kind()) {
+    case Token::kBIT_AND:
+    case Token::kBIT_OR:
+    case Token::kBIT_XOR:
+      break;
+    default:
+      return false;
+  }
+  if ((element_cid_ != kTypedDataInt8ArrayCid) &&
+      (element_cid_ != kTypedDataUint8ArrayCid)) {
+    return false;
+  }
+  Definition* left = op->left()->definition();
+  Definition* right = op->right()->definition();
+  int64_t constant = 0;
+  return (IsVector(left) &&
+          (IsVector(right) || IsIntegerConstant(right, &constant))) ||
+         (IsVector(right) && IsIntegerConstant(left, &constant));
+}
+
+// The body has to consist of accesses to typed data indexed by the loop
+// induction variable, bounds checks of the induction variable and
+// arithmetic on the loaded values. Everything else, in particular calls,
+// other uses of the induction variable and values carried between
+// iterations, prevents vectorization.
+bool LoopVectorizer::CanVectorize(LoopInfo* loop) {
+  if (!loop->IsInnermost() || !loop->HasSingleExit()) {
+    return false;
+  }
+  header_ = loop->header()->AsJoinEntry();
+  pre_header_ = loop->PreHeader();
+  if ((header_ == NULL) || header_->InsideTryBlock() ||
+      (header_->PredecessorCount() != 2) ||
+      (loop->back_edges().length() != 1) || (pre_header_ == NULL) ||
+      !pre_header_->last_instruction()->IsGoto()) {
+    return false;
+  }
+  BranchInstr* branch = header_->last_instruction()->AsBranch();
+  body_ = loop->back_edges()[0];
+  if ((branch->true_successor() != body_) ||
+      !body_->last_instruction()->IsGoto() || !CheckHeader(loop)) {
+    return false;
+  }
+
+  element_cid_ = kIllegalCid;
+  arrays_.Clear();
+  lengths_.Clear();
+  vector_defs_ = new (flow_graph_->zone())
+      BitVector(flow_graph_->zone(), flow_graph_->current_ssa_temp_index());
+  bool has_store = false;
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto() || (current == increment_)) {
+      continue;
+    }
+    if (CheckArrayBoundInstr* check = current->AsCheckArrayBound()) {
+      Definition* length = check->length()->definition();
+      if (!IsIndex(check->index()) || !IsInvariant(length)) {
+        return false;
+      }
+      AddUnique(&lengths_, length);
+    } else if (LoadIndexedInstr* load = current->AsLoadIndexed()) {
+      Definition* array = load->array()->definition();
+      if (!IsIndex(load->index()) || !IsInvariant(array) ||
+          !CheckElementCid(load->class_id())) {
+        return false;
+      }
+      AddUnique(&arrays_, array);
+      MarkVector(load);
+    } else if (StoreIndexedInstr* store = current->AsStoreIndexed()) {
+      Definition* array = store->array()->definition();
+      if (!IsIndex(store->index()) || !IsInvariant(array) ||
+          !CheckElementCid(store->class_id()) ||
+          !IsVector(store->value()->definition())) {
+        return false;
+      }
+      AddUnique(&arrays_, array);
+      has_store = true;
+    } else if (current->IsBox() || current->IsUnbox()) {
+      Definition* input = current->InputAt(0)->definition();
+      int64_t constant = 0;
+      if (IsVector(input)) {
+        MarkVector(current->AsDefinition());
+      } else if (!IsIntegerConstant(input, &constant)) {
+        return false;
+      }
+    } else if (BinaryDoubleOpInstr* op = current->AsBinaryDoubleOp()) {
+      if (!CheckDoubleOp(op)) {
+        return false;
+      }
+      MarkVector(op);
+    } else if (BinaryIntegerOpInstr* op = current->AsBinaryIntegerOp()) {
+      if (!CheckBitOp(op)) {
+        return false;
+      }
+      MarkVector(op);
+    } else {
+      return false;
+    }
+  }
+  if (!has_store) {
+    return false;
+  }
+  return !loop->HasKnownTripCount() ||
+         (loop->trip_count() >= LanesFor(element_cid_));
+}
+
+// Returns the vector with the value of the given operand in every lane.
+Definition* LoopVectorizer::Splat(Definition* scalar) {
+  Definition* vector = vectors_[scalar->ssa_temp_index()];
+  if (vector != NULL) {
+    return vector;
+  }
+  Instruction* insertion_point = pre_header_->last_instruction();
+  GrowableArray<Value*> inputs(4);
+  SimdOpInstr::Kind kind;
+  if (VectorCid(element_cid_) == kFloat64x2Cid) {
+    kind = SimdOpInstr::kFloat64x2Splat;
+    inputs.Add(new Value(scalar));
+  } else {
+    int64_t value = 0;
+    if (!IsIntegerConstant(scalar, &value)) {
+      UNREACHABLE();
+    }
+    const int32_t bytes = static_cast<int32_t>((value & 0xFF) * 0x01010101);
+    UnboxedConstantInstr* constant = new UnboxedConstantInstr(
+        Smi::ZoneHandle(flow_graph_->zone(), Smi::New(bytes)), kUnboxedInt32);
+    flow_graph_->InsertBefore(insertion_point, constant, NULL,
+                              FlowGraph::kValue);
+    kind = SimdOpInstr::kInt32x4Constructor;
+    for (intptr_t i = 0; i < 4; ++i) {
+      inputs.Add(new Value(constant));
+    }
+  }
+  vector = SimdOpInstr::Create(kind, inputs, Thread::kNoDeoptId);
+  flow_graph_->InsertBefore(insertion_point, vector, NULL, FlowGraph::kValue);
+  vectors_[scalar->ssa_temp_index()] = vector;
+  return vector;
+}
+
+Definition* LoopVectorizer::VectorOperand(Value* value) {
+  Definition* def = value->definition();
+  return IsVector(def) ? vectors_[def->ssa_temp_index()] : Splat(def);
+}
+
+// The vector loop may run as long as the whole vector is inside of every
+// accessed array and satisfies both the loop condition and all bounds checks
+// of the scalar loop.
+void LoopVectorizer::EmitLimit() {
+  Instruction* insertion_point = pre_header_->last_instruction();
+  for (intptr_t i = 0; i < arrays_.length(); ++i) {
+    LoadFieldInstr* length = new LoadFieldInstr(
+        new Value(arrays_[i]),
+        NativeFieldDesc::GetLengthFieldForArrayCid(element_cid_),
+        TokenPosition::kNoSource);
+    flow_graph_->InsertBefore(insertion_point, length, NULL,
+                              FlowGraph::kValue);
+    AddUnique(&lengths_, length);
+  }
+  limit_ = bound_;
+  for (intptr_t i = 0; i < lengths_.length(); ++i) {
+    limit_ = new MathMinMaxInstr(MethodRecognizer::kMathMin, new Value(limit_),
+                                 new Value(lengths_[i]), Thread::kNoDeoptId,
+                                 kSmiCid);
+    flow_graph_->InsertBefore(insertion_point, limit_, NULL,
+                              FlowGraph::kValue);
+  }
+}
+
+void LoopVectorizer::EmitBody(Instruction* insertion_point) {
+  const intptr_t array_cid = VectorArrayCid(element_cid_);
+  const intptr_t vector_cid = VectorCid(element_cid_);
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    Definition* vector = NULL;
+    if (LoadIndexedInstr* load = current->AsLoadIndexed()) {
+      vector = new LoadIndexedInstr(
+          new Value(load->array()->definition()), new Value(vector_index_),
+          load->index_scale(), array_cid, kUnalignedAccess,
+          Thread::kNoDeoptId, load->token_pos());
+    } else if (StoreIndexedInstr* store = current->AsStoreIndexed()) {
+      StoreIndexedInstr* vector_store = new StoreIndexedInstr(
+          new Value(store->array()->definition()), new Value(vector_index_),
+          new Value(VectorOperand(store->value())), kNoStoreBarrier,
+          store->index_scale(), array_cid, kUnalignedAccess,
+          Thread::kNoDeoptId, store->token_pos());
+      flow_graph_->InsertBefore(insertion_point, vector_store, NULL,
+                                FlowGraph::kEffect);
+    } else if (current->IsBox() || current->IsUnbox()) {
+      Definition* def = current->AsDefinition();
+      if (IsVector(def)) {
+        vectors_[def->ssa_temp_index()] =
+            vectors_[def->InputAt(0)->definition()->ssa_temp_index()];
+      }
+    } else if (BinaryDoubleOpInstr* op = current->AsBinaryDoubleOp()) {
+      vector = SimdOpInstr::Create(
+          SimdOpInstr::KindForOperator(vector_cid, op->op_kind()),
+          new Value(VectorOperand(op->left())),
+          new Value(VectorOperand(op->right())), Thread::kNoDeoptId);
+    } else if (BinaryIntegerOpInstr* op = current->AsBinaryIntegerOp()) {
+      if (op != increment_) {
+        vector = SimdOpInstr::Create(
+            SimdOpInstr::KindForOperator(vector_cid, op->op_kind()),
+            new Value(VectorOperand(op->left())),
+            new Value(VectorOperand(op->right())), Thread::kNoDeoptId);
+      }
+    }
+    if (vector != NULL) {
+      flow_graph_->InsertBefore(insertion_point, vector, NULL,
+                                FlowGraph::kValue);
+      vectors_[current->AsDefinition()->ssa_temp_index()] = vector;
+    }
+  }
+}
+
+bool LoopVectorizer::TryVectorize(LoopInfo* loop) {
+  if (!CanVectorize(loop)) {
+    return false;
+  }
+
+  if (FLAG_support_il_printer && FLAG_trace_loop_analysis &&
+      flow_graph_->should_print()) {
+    THR_Print("Vectorizing %s\n", loop->ToCString());
+  }
+
+  Zone* zone = flow_graph_->zone();
+  GotoInstr* pre_header_goto = pre_header_->last_instruction()->AsGoto();
+  BranchInstr* branch = header_->last_instruction()->AsBranch();
+  const intptr_t pre_header_index = header_->IndexOfPredecessor(pre_header_);
+  Definition* initial = index_->InputAt(pre_header_index)->definition();
+
+  vectors_.Clear();
+  for (intptr_t i = 0; i < flow_graph_->current_ssa_temp_index(); ++i) {
+    vectors_.Add(NULL);
+  }
+  EmitLimit();
+
+  JoinEntryInstr* vector_header = new (zone) JoinEntryInstr(
+      flow_graph_->allocate_block_id(), header_->try_index(),
+      Thread::kNoDeoptId);
+  vector_header->InheritDeoptTarget(zone, branch);
+  TargetEntryInstr* vector_body = new (zone) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), header_->try_index(),
+      Thread::kNoDeoptId);
+  vector_body->InheritDeoptTarget(zone, branch);
+  TargetEntryInstr* vector_exit = new (zone) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), header_->try_index(),
+      Thread::kNoDeoptId);
+  vector_exit->InheritDeoptTarget(zone, branch);
+
+  // The vector header advances the vector index by a full vector and
+  // leaves the vector loop when the next vector would not fit.
+  vector_index_ = flow_graph_->AddPhi(vector_header, initial, initial);
+  const intptr_t lanes = LanesFor(element_cid_);
+  ConstantInstr* step =
+      flow_graph_->GetConstant(Smi::ZoneHandle(zone, Smi::New(lanes)));
+  BinarySmiOpInstr* end =
+      new (zone) BinarySmiOpInstr(Token::kADD, new Value(vector_index_),
+                                  new Value(step), Thread::kNoDeoptId);
+  end->set_can_overflow(false);
+  RelationalOpInstr* compare = new (zone) RelationalOpInstr(
+      branch->token_pos(), Token::kLTE, new Value(end), new Value(limit_),
+      kSmiCid, Thread::kNoDeoptId);
+  BranchInstr* vector_branch =
+      new (zone) BranchInstr(compare, Thread::kNoDeoptId);
+  vector_branch->InheritDeoptTarget(zone, branch);
+  *vector_branch->true_successor_address() = vector_body;
+  *vector_branch->false_successor_address() = vector_exit;
+  vector_header->AppendInstruction(vector_branch);
+  vector_header->set_last_instruction(vector_branch);
+  flow_graph_->InsertBefore(vector_branch, end, NULL, FlowGraph::kValue);
+  vector_index_->InputAt(1)->BindTo(end);
+
+  if ((stack_check_ != NULL) && (stack_check_->env() != NULL)) {
+    // Deoptimizing here resumes the scalar loop at the vector index.
+    CheckStackOverflowInstr* check = new (zone) CheckStackOverflowInstr(
+        stack_check_->token_pos(), stack_check_->loop_depth(),
+        stack_check_->GetDeoptId(), stack_check_->kind());
+    flow_graph_->InsertBefore(end, check, NULL, FlowGraph::kEffect);
+    Environment* env = stack_check_->env()->DeepCopy(zone);
+    for (Environment::DeepIterator it(env); !it.Done(); it.Advance()) {
+      if (it.CurrentValue()->definition() == index_) {
+        it.CurrentValue()->set_definition(vector_index_);
+      }
+    }
+    check->SetEnvironment(env);
+    for (Environment::DeepIterator it(env); !it.Done(); it.Advance()) {
+      Value* value = it.CurrentValue();
+      value->definition()->AddEnvUse(value);
+    }
+  }
+
+  GotoInstr* back_edge =
+      new (zone) GotoInstr(vector_header, Thread::kNoDeoptId);
+  back_edge->InheritDeoptTarget(zone, branch);
+  vector_body->AppendInstruction(back_edge);
+  vector_body->set_last_instruction(back_edge);
+  EmitBody(back_edge);
+
+  // The scalar loop finishes the remaining iterations.
+  GotoInstr* exit_goto = new (zone) GotoInstr(header_, Thread::kNoDeoptId);
+  exit_goto->InheritDeoptTarget(zone, branch);
+  vector_exit->AppendInstruction(exit_goto);
+  vector_exit->set_last_instruction(exit_goto);
+  index_->InputAt(pre_header_index)->BindTo(vector_index_);
+  pre_header_goto->set_successor(vector_header);
+  vector_exits_.Add(vector_exit);
+  scalar_indices_.Add(index_);
+  return true;
+}
+
+// Predecessors of join blocks are kept sorted by block id, so the vector
+// exit which replaced the pre-header of a scalar loop may now come after its
+// back edge. Reorder the inputs of the index phi to match.
+void LoopVectorizer::FixPhiInputs() {
+  for (intptr_t i = 0; i < scalar_indices_.length(); ++i) {
+    PhiInstr* phi = scalar_indices_[i];
+    const intptr_t exit_index =
+        phi->block()->IndexOfPredecessor(vector_exits_[i]);
+    // The value flowing in from the vector loop is its index phi, the one
+    // flowing in from the back edge is the increment.
+    if (!phi->InputAt(exit_index)->definition()->IsPhi()) {
+      Value* first = phi->InputAt(0);
+      Value* second = phi->InputAt(1);
+      phi->SetInputAt(0, second);
+      phi->SetInputAt(1, first);
+    }
+  }
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
@@ -0,0 +1,105 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_VECTORIZER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_VECTORIZER_H_
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+
+namespace dart {
+
+class BinaryDoubleOpInstr;
+class BinaryIntegerOpInstr;
+class BitVector;
+class BlockEntryInstr;
+class CheckStackOverflowInstr;
+class Definition;
+class FlowGraph;
+class Instruction;
+class JoinEntryInstr;
+class LoopInfo;
+class PhiInstr;
+class Value;
+
+// Rewrites simple counted loops over typed data into SIMD operations.
+// A loop such as
+//
+//                  for (var i = 0; i < n; i++) {
+//                    c[i] = a[i] * b[i];
+//                  }
+//
+// where all arrays are indexed by the induction variable is preceded by a
+// vector loop that processes lanes() elements per iteration with Float64x2,
+// Float32x4 or Int32x4 operations:
+//
+//                  B0: limit <- min(n, a.length, b.length, c.length)
+//                  VH: j <- phi(0, j + lanes)
+//                      if (j + lanes <= limit) VB else VE
+//                  VB: c[j..] = a[j..] * b[j..]; goto VH
+//                  VE: goto B1
+//                  B1: i <- phi(j, i + 1) ...
+//
+// The original loop is kept unchanged and acts as the scalar epilogue: it
+// handles the remaining elements and raises any errors in the same order
+// as the unoptimized code.
+class LoopVectorizer : public ValueObject {
+ public:
+  explicit LoopVectorizer(FlowGraph* flow_graph);
+
+  static void Optimize(FlowGraph* flow_graph);
+
+  // Whether the target implements the unaligned 128-bit loads and stores
+  // that the vector loops use.
+  static bool IsSupported();
+
+ private:
+  bool TryVectorize(LoopInfo* loop);
+  bool CanVectorize(LoopInfo* loop);
+  bool CheckHeader(LoopInfo* loop);
+  bool CheckElementCid(intptr_t class_id);
+  bool CheckDoubleOp(BinaryDoubleOpInstr* op);
+  bool CheckBitOp(BinaryIntegerOpInstr* op);
+  bool IsInvariant(Definition* def) const;
+  bool IsIndex(Value* value) const;
+  bool IsVector(Definition* def) const;
+  void MarkVector(Definition* def);
+
+  void EmitLimit();
+  void EmitBody(Instruction* insertion_point);
+  Definition* VectorOperand(Value* value);
+  Definition* Splat(Definition* scalar);
+  void FixPhiInputs();
+
+  FlowGraph* flow_graph_;
+
+  // State of the loop being vectorized.
+  JoinEntryInstr* header_;
+  BlockEntryInstr* pre_header_;
+  BlockEntryInstr* body_;
+  PhiInstr* index_;
+  Definition* increment_;
+  Definition* bound_;
+  CheckStackOverflowInstr* stack_check_;
+  intptr_t element_cid_;
+  GrowableArray<Definition*> arrays_;
+  GrowableArray<Definition*> lengths_;
+  BitVector* vector_defs_;
+
+  // Vector counterparts of scalar definitions, indexed by SSA temp index.
+  GrowableArray<Definition*> vectors_;
+  PhiInstr* vector_index_;
+  Definition* limit_;
+
+  // Exits of the vector loops created so far and the index phis of the
+  // scalar loops they enter.
+  GrowableArray<BlockEntryInstr*> vector_exits_;
+  GrowableArray<PhiInstr*> scalar_indices_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopVectorizer);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_VECTORIZER_H_
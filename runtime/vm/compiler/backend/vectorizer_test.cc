@@ -0,0 +1,102 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/vectorizer.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/jit/compiler.h"
+#include "vm/dart_api_impl.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+TEST_CASE(LoopVectorizer_IsSupported) {
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+  EXPECT_EQ(FlowGraphCompiler::SupportsUnboxedSimd128(),
+            LoopVectorizer::IsSupported());
+#else
+  EXPECT(!LoopVectorizer::IsSupported());
+#endif
+}
+
+// Compiles loops over typed data with optimizations, which vectorizes them
+// where supported, and checks their results on the current architecture.
+TEST_CASE(LoopVectorizer_TypedDataLoops) {
+  const char* kScriptChars =
+      "import 'dart:typed_data';\n"
+      "mul(Float64List c, Float64List a, Float64List b) {\n"
+      "  for (int i = 0; i < c.length; i++) {\n"
+      "    c[i] = a[i] * b[i];\n"
+      "  }\n"
+      "}\n"
+      "add(Float32List c, Float32List a, Float32List b) {\n"
+      "  for (int i = 0; i < c.length; i++) {\n"
+      "    c[i] = a[i] + b[i];\n"
+      "  }\n"
+      "}\n"
+      "mask(Uint8List dst, Uint8List src, int key) {\n"
+      "  for (int i = 0; i < src.length; i++) {\n"
+      "    dst[i] = src[i] ^ key;\n"
+      "  }\n"
+      "}\n"
+      "test() {\n"
+      "  for (int n in [0, 1, 3, 17, 35]) {\n"
+      "    var a = new Float64List(n);\n"
+      "    var b = new Float64List(n);\n"
+      "    var c = new Float64List(n);\n"
+      "    var a32 = new Float32List(n);\n"
+      "    var c32 = new Float32List(n);\n"
+      "    var src = new Uint8List(n);\n"
+      "    var dst = new Uint8List(n);\n"
+      "    for (int i = 0; i < n; i++) {\n"
+      "      a[i] = i + 0.5;\n"
+      "      b[i] = 2.0 - i;\n"
+      "      a32[i] = i * 0.25;\n"
+      "      src[i] = (i * 31) & 0xFF;\n"
+      "    }\n"
+      "    mul(c, a, b);\n"
+      "    add(c32, a32, a32);\n"
+      "    mask(dst, src, 0x5A);\n"
+      "    for (int i = 0; i < n; i++) {\n"
+      "      if (c[i] != a[i] * b[i]) return false;\n"
+      "      if (c32[i] != i * 0.5) return false;\n"
+      "      if (dst[i] != (src[i] ^ 0x5A)) return false;\n"
+      "    }\n"
+      "  }\n"
+      "  return true;\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+
+  // Collect type feedback in unoptimized code.
+  Dart_Handle result = Dart_Invoke(lib, NewString("test"), 0, NULL);
+  EXPECT_VALID(result);
+  EXPECT_TRUE(result);
+
+  const char* kNames[] = {"mul", "add", "mask"};
+  {
+    TransitionNativeToVM transition(thread);
+    const Library& library =
+        Library::Handle(Library::RawCast(Api::UnwrapHandle(lib)));
+    Function& function = Function::Handle();
+    Object& code = Object::Handle();
+    for (intptr_t i = 0; i < static_cast<intptr_t>(ARRAY_SIZE(kNames)); i++) {
+      function =
+          library.LookupLocalFunction(String::Handle(String::New(kNames[i])));
+      EXPECT(!function.IsNull());
+      code = Compiler::CompileOptimizedFunction(thread, function);
+      EXPECT(code.IsCode());
+      EXPECT(function.HasOptimizedCode());
+    }
+  }
+
+  result = Dart_Invoke(lib, NewString("test"), 0, NULL);
+  EXPECT_VALID(result);
+  EXPECT_TRUE(result);
+}
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+}  // namespace dart
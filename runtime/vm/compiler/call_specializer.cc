@@ -1334,7 +1334,8 @@ void CallSpecializer::ReplaceWithInstanceOf(InstanceCallInstr* call) {
   const ICData& unary_checks =
       ICData::ZoneHandle(Z, call->ic_data()->AsUnaryClassChecks());
   const intptr_t number_of_checks = unary_checks.NumberOfChecks();
-  if (number_of_checks > 0 && number_of_checks <= FLAG_max_polymorphic_checks) {
+  if ((number_of_checks > 0) &&
+      (number_of_checks <= flow_graph()->MaxPolymorphicChecks())) {
     ZoneGrowableArray<intptr_t>* results =
         new (Z) ZoneGrowableArray<intptr_t>(number_of_checks * 2);
     const Bool& as_bool =
@@ -1454,7 +1455,8 @@ void CallSpecializer::ReplaceWithTypeCast(InstanceCallInstr* call) {
   const ICData& unary_checks =
       ICData::ZoneHandle(Z, call->ic_data()->AsUnaryClassChecks());
   const intptr_t number_of_checks = unary_checks.NumberOfChecks();
-  if (number_of_checks > 0 && number_of_checks <= FLAG_max_polymorphic_checks) {
+  if ((number_of_checks > 0) &&
+      (number_of_checks <= flow_graph()->MaxPolymorphicChecks())) {
     ZoneGrowableArray<intptr_t>* results =
         new (Z) ZoneGrowableArray<intptr_t>(number_of_checks * 2);
     const Bool& as_bool =
@@ -12,9 +12,11 @@
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/linearscan.h"
+#include "vm/compiler/backend/loops.h"
 #include "vm/compiler/backend/range_analysis.h"
 #include "vm/compiler/backend/redundancy_elimination.h"
 #include "vm/compiler/backend/type_propagator.h"
+#include "vm/compiler/backend/vectorizer.h"
 #include "vm/compiler/call_specializer.h"
 #if defined(DART_PRECOMPILER)
 #include "vm/compiler/aot/aot_call_specializer.h"
@@ -236,6 +238,8 @@ void CompilerPass::RunPipeline(PipelineMode mode,
   INVOKE_PASS(LICM);
   INVOKE_PASS(TryOptimizePatterns);
   INVOKE_PASS(DSE);
+  INVOKE_PASS(LoopUnrolling);
+  INVOKE_PASS(LoopVectorization);
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(RangeAnalysis);
   INVOKE_PASS(OptimizeBranches);
@@ -344,6 +348,19 @@ COMPILER_PASS(LICM, {
 
 COMPILER_PASS(DSE, { DeadStoreElimination::Optimize(flow_graph); });
 
+COMPILER_PASS(LoopUnrolling, {
+  // Unroll after LICM so that loop invariant code is not replicated, and
+  // before range analysis so that it sees the constant indices in the
+  // unrolled copies.
+  LoopUnroller::Optimize(flow_graph);
+});
+
+COMPILER_PASS(LoopVectorization, {
+  // Vectorize the loops that were too long to be unrolled. Range analysis
+  // then only has to deal with the scalar epilogues.
+  LoopVectorizer::Optimize(flow_graph);
+});
+
 COMPILER_PASS(RangeAnalysis, {
   // We have to perform range analysis after LICM because it
   // optimistically moves CheckSmi through phis into loop preheaders
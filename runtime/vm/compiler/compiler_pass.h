@@ -32,6 +32,8 @@ namespace dart {
   V(IfConvert)                                                                 \
   V(Inlining)                                                                  \
   V(LICM)                                                                      \
+  V(LoopUnrolling)                                                             \
+  V(LoopVectorization)                                                         \
   V(OptimisticallySpecializeSmiPhis)                                           \
   V(OptimizeBranches)                                                          \
   V(RangeAnalysis)                                                             \
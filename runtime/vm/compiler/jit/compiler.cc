@@ -31,6 +31,7 @@
 #include "vm/deopt_instructions.h"
 #include "vm/exceptions.h"
 #include "vm/flags.h"
+#include "vm/hash_map.h"
 #include "vm/kernel.h"
 #include "vm/longjump.h"
 #include "vm/object.h"
@@ -53,6 +54,10 @@ DEFINE_FLAG(
     max_deoptimization_counter_threshold,
     16,
     "How many times we allow deoptimization before we disallow optimization.");
+DEFINE_FLAG(int,
+            background_compiler_threads,
+            1,
+            "Number of threads running optimizing compilation in background.");
 DEFINE_FLAG(charp, optimization_filter, NULL, "Optimize only named function");
 DEFINE_FLAG(bool, print_flow_graph, false, "Print the IR flow graph.");
 DEFINE_FLAG(bool,
@@ -88,6 +93,7 @@ DEFINE_FLAG(bool,
             "Enable compiler verification assertions");
 
 DECLARE_FLAG(bool, huge_method_cutoff_in_code_size);
+DECLARE_FLAG(int, second_tier_counter_threshold);
 DECLARE_FLAG(bool, trace_failed_optimization_attempts);
 DECLARE_FLAG(bool, unbox_numeric_fields);
 
@@ -641,6 +647,7 @@ RawCode* CompileParsedFunctionHelper::FinalizeCompilation(
       const bool is_osr = osr_id() != Compiler::kNoOSRDeoptId;
       if (!is_osr) {
         function.InstallOptimizedCode(code);
+        function.set_optimization_tier(flow_graph->optimization_tier());
       }
       ASSERT(code.owner() == function.raw());
     } else {
@@ -687,6 +694,7 @@ RawCode* CompileParsedFunctionHelper::FinalizeCompilation(
         const bool is_osr = osr_id() != Compiler::kNoOSRDeoptId;
         ASSERT(!is_osr);  // OSR is not compiled in background.
         function.InstallOptimizedCode(code);
+        function.set_optimization_tier(flow_graph->optimization_tier());
       } else {
         code = Code::null();
       }
@@ -834,6 +842,15 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       }
 #endif
 
+      if (optimized()) {
+        // Reoptimizing a function that already runs optimized code means it
+        // stayed hot, so compile it in the second tier.
+        const bool second_tier = (FLAG_second_tier_counter_threshold >= 0) &&
+                                 (osr_id() == Compiler::kNoOSRDeoptId) &&
+                                 function.HasOptimizedCode();
+        flow_graph->set_optimization_tier(second_tier ? 2 : 1);
+      }
+
       const bool print_flow_graph =
           (FLAG_print_flow_graph ||
            (optimized() && FLAG_print_flow_graph_optimized)) &&
@@ -1613,105 +1630,158 @@ void Compiler::AbortBackgroundCompilation(intptr_t deopt_id, const char* msg) {
 class QueueElement {
  public:
   explicit QueueElement(const Function& function)
-      : next_(NULL), function_(function.raw()) {}
+      : function_(function.raw()),
+        enqueue_micros_(OS::GetCurrentMonotonicMicros()),
+        in_progress_(false) {}
 
-  virtual ~QueueElement() {
-    next_ = NULL;
-    function_ = Function::null();
-  }
+  virtual ~QueueElement() { function_ = Function::null(); }
 
   RawFunction* Function() const { return function_; }
 
-  void set_next(QueueElement* elem) { next_ = elem; }
-  QueueElement* next() const { return next_; }
-
   RawObject* function() const { return function_; }
   RawObject** function_ptr() {
     return reinterpret_cast<RawObject**>(&function_);
   }
 
+  int64_t enqueue_micros() const { return enqueue_micros_; }
+
+  // Claimed by a compiler thread.
+  bool in_progress() const { return in_progress_; }
+  void set_in_progress() { in_progress_ = true; }
+
  private:
-  QueueElement* next_;
   RawFunction* function_;
+  int64_t enqueue_micros_;
+  bool in_progress_;
 
   DISALLOW_COPY_AND_ASSIGN(QueueElement);
 };
 
+// Maps a function to its queue element. Keyed on the raw address, so it is
+// rebuilt whenever the GC may have moved the functions.
+class QueueElementKeyValueTrait {
+ public:
+  typedef RawFunction* Key;
+  typedef QueueElement* Value;
+  typedef QueueElement* Pair;
+
+  static Key KeyOf(Pair kv) { return kv->Function(); }
+  static Value ValueOf(Pair kv) { return kv; }
+  static inline intptr_t Hashcode(Key key) {
+    return reinterpret_cast<uword>(key) >> kObjectAlignmentLog2;
+  }
+  static inline bool IsKeyEqual(Pair kv, Key key) {
+    return kv->Function() == key;
+  }
+};
+
 // Allocated in C-heap. Handles both input and output of background compilation.
-// It implements a FIFO queue, using Peek, Add, Remove operations.
+// Holds the functions waiting to be compiled and the ones being compiled, with
+// constant-time lookup of either. Claim hands out the hottest waiting function
+// first: its usage counter was reset when it was queued, so the counter is the
+// number of calls made to it since then. The counters change while functions
+// wait, which rules out keeping the elements in heap order; the waiting
+// elements are few and the scan is cheap next to a compilation.
 class BackgroundCompilationQueue {
  public:
-  BackgroundCompilationQueue() : first_(NULL), last_(NULL) {}
-  virtual ~BackgroundCompilationQueue() { Clear(); }
+  BackgroundCompilationQueue() : elements_(), index_(), num_in_progress_(0) {}
+  virtual ~BackgroundCompilationQueue() {
+    Clear();
+    ASSERT(num_in_progress_ == 0);
+  }
 
   void VisitObjectPointers(ObjectPointerVisitor* visitor) {
     ASSERT(visitor != NULL);
-    QueueElement* p = first_;
-    while (p != NULL) {
-      visitor->VisitPointer(p->function_ptr());
-      p = p->next();
+    for (intptr_t i = 0; i < elements_.length(); i++) {
+      visitor->VisitPointer(elements_[i]->function_ptr());
+    }
+    index_.Clear();
+    for (intptr_t i = 0; i < elements_.length(); i++) {
+      index_.Insert(elements_[i]);
     }
   }
 
-  bool IsEmpty() const { return first_ == NULL; }
+  // Whether no function is waiting to be claimed.
+  bool IsEmpty() const { return Length() == 0; }
+
+  // The number of functions waiting to be claimed.
+  intptr_t Length() const { return elements_.length() - num_in_progress_; }
 
   void Add(QueueElement* value) {
     ASSERT(value != NULL);
-    ASSERT(value->next() == NULL);
-    if (first_ == NULL) {
-      first_ = value;
-      ASSERT(last_ == NULL);
-    } else {
-      ASSERT(last_ != NULL);
-      last_->set_next(value);
+    ASSERT(!value->in_progress());
+    ASSERT(!index_.HasKey(value->Function()));
+    elements_.Add(value);
+    index_.Insert(value);
+  }
+
+  // Marks the hottest waiting function as in progress and returns it, or
+  // returns NULL if none is waiting.
+  QueueElement* Claim() {
+    QueueElement* result = NULL;
+    intptr_t max_usage = 0;
+    Function& function = Function::Handle();
+    for (intptr_t i = 0; i < elements_.length(); i++) {
+      QueueElement* e = elements_[i];
+      if (e->in_progress()) {
+        continue;
+      }
+      function = e->Function();
+      const intptr_t usage = function.usage_counter();
+      if ((result == NULL) || (usage > max_usage)) {
+        result = e;
+        max_usage = usage;
+      }
     }
-    last_ = value;
-    ASSERT(first_ != NULL && last_ != NULL);
-  }
-
-  QueueElement* Peek() const { return first_; }
-
-  RawFunction* PeekFunction() const {
-    QueueElement* e = Peek();
-    if (e == NULL) {
-      return Function::null();
-    } else {
-      return e->Function();
+    if (result != NULL) {
+      result->set_in_progress();
+      num_in_progress_++;
     }
+    return result;
   }
 
-  QueueElement* Remove() {
-    ASSERT(first_ != NULL);
-    QueueElement* result = first_;
-    first_ = first_->next();
-    if (first_ == NULL) {
-      last_ = NULL;
-    }
-    return result;
+  // Removes an element returned by Claim. The caller deletes it.
+  void Release(QueueElement* value) {
+    ASSERT(value->in_progress());
+    RemoveElement(value);
+    num_in_progress_--;
   }
 
   bool ContainsObj(const Object& obj) const {
-    QueueElement* p = first_;
-    while (p != NULL) {
-      if (p->function() == obj.raw()) {
-        return true;
-      }
-      p = p->next();
-    }
-    return false;
+    return index_.HasKey(static_cast<RawFunction*>(obj.raw()));
   }
 
+  // Deletes the waiting elements. Elements in progress are released by their
+  // compiler threads.
   void Clear() {
-    while (!IsEmpty()) {
-      QueueElement* e = Remove();
-      delete e;
+    intptr_t i = 0;
+    while (i < elements_.length()) {
+      QueueElement* e = elements_[i];
+      if (e->in_progress()) {
+        i++;
+      } else {
+        RemoveElement(e);
+        delete e;
+      }
     }
-    ASSERT((first_ == NULL) && (last_ == NULL));
   }
 
  private:
-  QueueElement* first_;
-  QueueElement* last_;
+  void RemoveElement(QueueElement* value) {
+    index_.Remove(value->Function());
+    for (intptr_t i = 0; i < elements_.length(); i++) {
+      if (elements_[i] == value) {
+        elements_[i] = elements_.Last();
+        elements_.RemoveLast();
+        return;
+      }
+    }
+    UNREACHABLE();
+  }
+
+  MallocGrowableArray<QueueElement*> elements_;
+  MallocDirectChainedHashMap<QueueElementKeyValueTrait> index_;
+  intptr_t num_in_progress_;
 
   DISALLOW_COPY_AND_ASSIGN(BackgroundCompilationQueue);
 };
@@ -1723,6 +1793,7 @@ BackgroundCompiler::BackgroundCompiler(Isolate* isolate)
       done_monitor_(new Monitor()),
       running_(false),
       done_(true),
+      num_tasks_(0),
       disabled_depth_(0) {}
 
 // Fields all deleted in ::Stop; here clear them.
@@ -1744,43 +1815,65 @@ void BackgroundCompiler::Run() {
       Zone* zone = stack_zone.GetZone();
       HANDLESCOPE(thread);
       Function& function = Function::Handle(zone);
-      {
-        MonitorLocker ml(queue_monitor_);
-        function = function_queue()->PeekFunction();
-      }
-      while (running_ && !function.IsNull() && !isolate_->IsTopLevelParsing()) {
+      while (true) {
+        QueueElement* qelem = NULL;
+        intptr_t queue_length = 0;
+        {
+          MonitorLocker ml(queue_monitor_);
+          if (running_ && !isolate_->IsTopLevelParsing()) {
+            qelem = function_queue()->Claim();
+          }
+          if (qelem == NULL) {
+            break;
+          }
+          function = qelem->Function();
+          queue_length = function_queue()->Length();
+          RecordQueueTime(qelem);
+          RecordQueueLength();
+        }
+#if !defined(PRODUCT)
+        // Outside of the queue monitor, as this allocates.
+        TimelineStream* stream = Timeline::GetCompilerStream();
+        ASSERT(stream != NULL);
+        TimelineEvent* event = stream->StartEvent();
+        if (event != NULL) {
+          event->Duration("BackgroundCompilationQueued",
+                          qelem->enqueue_micros(),
+                          OS::GetCurrentMonotonicMicros());
+          event->SetNumArguments(2);
+          event->CopyArgument(0, "function",
+                              function.ToFullyQualifiedCString());
+          event->FormatArgument(1, "queueLength", "%" Pd, queue_length);
+          event->Complete();
+        }
+#endif  // !defined(PRODUCT)
         // Check that we have aggregated and cleared the stats.
         ASSERT(thread->compiler_stats()->IsCleared());
         Compiler::CompileOptimizedFunction(thread, function,
                                            Compiler::kNoOSRDeoptId);
-#ifndef PRODUCT
-        Isolate* isolate = thread->isolate();
-        isolate->aggregate_compiler_stats()->Add(*thread->compiler_stats());
-        thread->compiler_stats()->Clear();
-#endif  // PRODUCT
 
-        QueueElement* qelem = NULL;
         {
           MonitorLocker ml(queue_monitor_);
-          if (function_queue()->IsEmpty()) {
-            // We are shutting down, queue was cleared.
-            function = Function::null();
-          } else {
-            qelem = function_queue()->Remove();
-            const Function& old = Function::Handle(qelem->Function());
-            if ((!old.HasOptimizedCode() && old.IsOptimizable()) ||
+#ifndef PRODUCT
+          // The queue monitor also serializes the compiler threads here.
+          Isolate* isolate = thread->isolate();
+          isolate->aggregate_compiler_stats()->Add(*thread->compiler_stats());
+          thread->compiler_stats()->Clear();
+#endif  // PRODUCT
+          function_queue()->Release(qelem);
+          // Unless we are shutting down and the queue was cleared.
+          if (running_) {
+            if ((!function.HasOptimizedCode() && function.IsOptimizable()) ||
                 FLAG_stress_test_background_compilation) {
-              if (Compiler::CanOptimizeFunction(thread, old)) {
-                QueueElement* repeat_qelem = new QueueElement(old);
+              if (Compiler::CanOptimizeFunction(thread, function)) {
+                QueueElement* repeat_qelem = new QueueElement(function);
                 function_queue()->Add(repeat_qelem);
               }
             }
-            function = function_queue()->PeekFunction();
           }
+          RecordQueueLength();
         }
-        if (qelem != NULL) {
-          delete qelem;
-        }
+        delete qelem;
       }
     }
     Thread::ExitIsolateAsHelper();
@@ -1795,13 +1888,33 @@ void BackgroundCompiler::Run() {
   }  // while running
 
   {
-    // Notify that the thread is done.
+    // Notify when the last thread is done.
     MonitorLocker ml_done(done_monitor_);
-    done_ = true;
-    ml_done.Notify();
+    num_tasks_--;
+    if (num_tasks_ == 0) {
+      done_ = true;
+      ml_done.Notify();
+    }
   }
 }
 
+void BackgroundCompiler::RecordQueueTime(QueueElement* qelem) {
+#if !defined(PRODUCT)
+  const int64_t queue_micros =
+      OS::GetCurrentMonotonicMicros() - qelem->enqueue_micros();
+  Metric* total = isolate_->GetCompilerQueueTimeMetric();
+  total->set_value(total->value() + queue_micros);
+  isolate_->GetCompilerQueueTimeMaxMetric()->SetValue(queue_micros);
+#endif  // !defined(PRODUCT)
+}
+
+void BackgroundCompiler::RecordQueueLength() {
+#if !defined(PRODUCT)
+  isolate_->GetCompilerQueueLengthMetric()->set_value(
+      function_queue()->Length());
+#endif  // !defined(PRODUCT)
+}
+
 void BackgroundCompiler::CompileOptimized(const Function& function) {
   ASSERT(Thread::Current()->IsMutatorThread());
   // TODO(srdjan): Checking different strategy for collecting garbage
@@ -1817,6 +1930,7 @@ void BackgroundCompiler::CompileOptimized(const Function& function) {
     }
     QueueElement* elem = new QueueElement(function);
     function_queue()->Add(elem);
+    RecordQueueLength();
     ml.Notify();
   }
 }
@@ -1825,6 +1939,21 @@ void BackgroundCompiler::VisitPointers(ObjectPointerVisitor* visitor) {
   function_queue_->VisitObjectPointers(visitor);
 }
 
+#if defined(TESTING)
+RawFunction* BackgroundCompiler::ClaimForTesting() {
+  MonitorLocker ml(queue_monitor_);
+  QueueElement* qelem = function_queue()->Claim();
+  if (qelem == NULL) {
+    return Function::null();
+  }
+  RawFunction* result = qelem->Function();
+  function_queue()->Release(qelem);
+  RecordQueueLength();
+  delete qelem;
+  return result;
+}
+#endif  // TESTING
+
 class BackgroundCompilerTask : public ThreadPool::Task {
  public:
   explicit BackgroundCompilerTask(BackgroundCompiler* background_compiler)
@@ -1860,9 +1989,18 @@ void BackgroundCompiler::Start() {
   if (running_ || !done_) return;
   running_ = true;
   done_ = false;
-  bool task_started =
-      Dart::thread_pool()->Run(new BackgroundCompilerTask(this));
-  if (!task_started) {
+  ASSERT(num_tasks_ == 0);
+  const intptr_t num_threads =
+      Utils::Maximum(FLAG_background_compiler_threads, 1);
+  for (intptr_t i = 0; i < num_threads; i++) {
+    // A task cannot finish and decrement the count before we release
+    // done_monitor_.
+    if (!Dart::thread_pool()->Run(new BackgroundCompilerTask(this))) {
+      break;
+    }
+    num_tasks_++;
+  }
+  if (num_tasks_ == 0) {
     running_ = false;
     done_ = true;
   }
@@ -1877,7 +2015,8 @@ void BackgroundCompiler::Stop() {
     MonitorLocker ml(queue_monitor_);
     running_ = false;
     function_queue_->Clear();
-    ml.Notify();  // Stop waiting for the queue.
+    RecordQueueLength();
+    ml.NotifyAll();  // Stop waiting for the queue.
   }
 
   {
@@ -2011,6 +2150,13 @@ void BackgroundCompiler::VisitPointers(ObjectPointerVisitor* visitor) {
   UNREACHABLE();
 }
 
+#if defined(TESTING)
+RawFunction* BackgroundCompiler::ClaimForTesting() {
+  UNREACHABLE();
+  return Function::null();
+}
+#endif  // TESTING
+
 void BackgroundCompiler::Start() {
   UNREACHABLE();
 }
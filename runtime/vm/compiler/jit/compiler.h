@@ -157,9 +157,10 @@ class Compiler : public AllStatic {
   static void AbortBackgroundCompilation(intptr_t deopt_id, const char* msg);
 };
 
-// Class to run optimizing compilation in a background thread.
-// Current implementation: one task per isolate, it dies with the owning
-// isolate.
+// Class to run optimizing compilation in background threads.
+// Current implementation: --background_compiler_threads tasks per isolate,
+// sharing one queue that hands out the hottest function first. They die with
+// the owning isolate.
 // No OSR compilation in the background compiler.
 class BackgroundCompiler {
  public:
@@ -214,6 +215,12 @@ class BackgroundCompiler {
   BackgroundCompilationQueue* function_queue() const { return function_queue_; }
   bool is_running() const { return running_; }
 
+#if defined(TESTING)
+  // Claims the next waiting function as a compiler thread would and removes
+  // it from the queue. Returns Function::null() if none is waiting.
+  RawFunction* ClaimForTesting();
+#endif
+
   void Run();
 
  private:
@@ -224,14 +231,19 @@ class BackgroundCompiler {
   bool IsDisabled();
   bool IsRunning() { return !done_; }
 
+  // Called with queue_monitor_ held.
+  void RecordQueueTime(QueueElement* qelem);
+  void RecordQueueLength();
+
   Isolate* isolate_;
 
   Monitor* queue_monitor_;  // Controls access to the queue.
   BackgroundCompilationQueue* function_queue_;
 
-  Monitor* done_monitor_;   // Notify/wait that the thread is done.
+  Monitor* done_monitor_;   // Notify/wait that the threads are done.
   bool running_;            // While true, will try to read queue and compile.
-  bool done_;               // True if the thread is done.
+  bool done_;               // True if all threads are done.
+  intptr_t num_tasks_;      // Threads not yet done.
 
   int16_t disabled_depth_;
 
@@ -152,7 +152,8 @@ void JitCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
   // non-deopting megamorphic call stub when it sees new receiver classes.
   if (has_one_target && FLAG_polymorphic_with_deopt &&
       (!instr->ic_data()->HasDeoptReason(ICData::kDeoptCheckClass) ||
-       unary_checks.NumberOfChecks() <= FLAG_max_polymorphic_checks)) {
+       unary_checks.NumberOfChecks() <=
+           flow_graph()->MaxPolymorphicChecks())) {
     // Type propagation has not run yet, we cannot eliminate the check.
     // TODO(erikcorry): The receiver check should use the off-heap targets
     // array, not the IC array.
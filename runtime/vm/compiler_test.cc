@@ -110,6 +110,89 @@ ISOLATE_UNIT_TEST_CASE(CompileFunctionOnHelperThread) {
   BackgroundCompiler::Stop(isolate);
 }
 
+DECLARE_FLAG(int, background_compiler_threads);
+
+ISOLATE_UNIT_TEST_CASE(CompileFunctionsOnHelperThreads) {
+  // Create simple functions and compile them without optimization.
+  const char* kScriptChars =
+      "class A {\n"
+      "  static foo() { return 42; }\n"
+      "  static bar() { return 43; }\n"
+      "  static baz() { return 44; }\n"
+      "}\n";
+  String& url =
+      String::Handle(String::New("dart-test:CompileFunctionsOnHelperThreads"));
+  String& source = String::Handle(String::New(kScriptChars));
+  Script& script =
+      Script::Handle(Script::New(url, source, RawScript::kScriptTag));
+  Library& lib = Library::Handle(Library::CoreLibrary());
+  EXPECT(CompilerTest::TestCompileScript(lib, script));
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  Class& cls =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!cls.IsNull());
+  const char* kNames[] = {"foo", "bar", "baz"};
+  const intptr_t kNumFunctions = ARRAY_SIZE(kNames);
+  const Array& functions = Array::Handle(Array::New(kNumFunctions));
+  Function& func = Function::Handle();
+  for (intptr_t i = 0; i < kNumFunctions; i++) {
+    func = cls.LookupStaticFunction(String::Handle(String::New(kNames[i])));
+    EXPECT(!func.IsNull());
+    CompilerTest::TestCompileFunction(func);
+    EXPECT(func.HasCode());
+    EXPECT(!func.HasOptimizedCode());
+    // The hottest function is claimed first.
+    func.SetUsageCounter(i);
+    functions.SetAt(i, func);
+  }
+#if !defined(PRODUCT)
+  // Constant in product mode.
+  const bool saved_background_compilation = FLAG_background_compilation;
+  FLAG_background_compilation = true;
+#endif
+  const intptr_t saved_threads = FLAG_background_compiler_threads;
+  FLAG_background_compiler_threads = 2;
+  Isolate* isolate = thread->isolate();
+  BackgroundCompiler* background_compiler = isolate->background_compiler();
+  BackgroundCompiler::Start(isolate);
+
+  // Compiler threads do not claim functions during top level parsing, which
+  // lets the test claim them in place of the threads.
+  isolate->IncrTopLevelParsingCount();
+  for (intptr_t i = 0; i < kNumFunctions; i++) {
+    func ^= functions.At(i);
+    background_compiler->CompileOptimized(func);
+    // Duplicate requests are ignored.
+    background_compiler->CompileOptimized(func);
+  }
+  for (intptr_t i = kNumFunctions - 1; i >= 0; i--) {
+    func = background_compiler->ClaimForTesting();
+    EXPECT(func.raw() == functions.At(i));
+  }
+  EXPECT(background_compiler->ClaimForTesting() == Function::null());
+  isolate->DecrTopLevelParsingCount();
+
+  // Enqueued again, the functions are compiled by the compiler threads.
+  for (intptr_t i = 0; i < kNumFunctions; i++) {
+    func ^= functions.At(i);
+    background_compiler->CompileOptimized(func);
+  }
+  Monitor* m = new Monitor();
+  for (intptr_t i = 0; i < kNumFunctions; i++) {
+    func ^= functions.At(i);
+    MonitorLocker ml(m);
+    while (!func.HasOptimizedCode()) {
+      ml.WaitWithSafepointCheck(thread, 1);
+    }
+  }
+  delete m;
+  BackgroundCompiler::Stop(isolate);
+  FLAG_background_compiler_threads = saved_threads;
+#if !defined(PRODUCT)
+  FLAG_background_compilation = saved_background_compilation;
+#endif
+}
+
 TEST_CASE(RegenerateAllocStubs) {
   const char* kScriptChars =
       "class A {\n"
@@ -133,6 +133,12 @@ char* Dart::InitOnce(const uint8_t* vm_isolate_snapshot,
       FLAG_verify_on_transition) {
     FLAG_verify_gc_contains = true;
   }
+#endif
+#if !defined(TARGET_ARCH_X64)
+  // Only the x64 assembler emits the marking write barrier.
+  if (FLAG_concurrent_mark) {
+    return strdup("--concurrent_mark is only supported on x64");
+  }
 #endif
   set_thread_exit_callback(thread_exit);
   SetFileCallbacks(file_open, file_read, file_write, file_close);
@@ -723,6 +729,11 @@ const char* Dart::FeaturesString(Isolate* isolate,
 #else
 #error What architecture?
 #endif
+
+    // Generated code includes the marking write barrier.
+    if (FLAG_concurrent_mark) {
+      buffer.AddString(" concurrent-mark");
+    }
   }
 
   if (FLAG_precompiled_mode && FLAG_dwarf_stack_traces) {
@@ -11,11 +11,13 @@
 #include "platform/text_buffer.h"
 #include "platform/utils.h"
 #include "vm/class_finalizer.h"
+#include "vm/compilation_trace.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/dart_api_state.h"
 #include "vm/debugger_api_impl_test.h"
 #include "vm/heap/verifier.h"
 #include "vm/lockers.h"
+#include "vm/object_store.h"
 #include "vm/timeline.h"
 #include "vm/unit_test.h"
 
@@ -9090,6 +9092,114 @@ TEST_CASE(DartAPI_NotifyLowMemory) {
   EXPECT_VALID(result);
 }
 
+TEST_CASE(DartAPI_TypeFeedback) {
+  const char* kScriptChars =
+      "class A { foo() => 1; }\n"
+      "class B { foo() => 2; }\n"
+      "callFoo(x) => x.foo();\n"
+      "main() {\n"
+      "  var sum = 0;\n"
+      "  var a = new A();\n"
+      "  var b = new B();\n"
+      "  for (var i = 0; i < 100; i++) {\n"
+      "    sum += callFoo(a);\n"
+      "    if (i % 10 == 0) sum += callFoo(b);\n"
+      "  }\n"
+      "  return sum;\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+
+  uint8_t* buffer = NULL;
+  intptr_t size = 0;
+  result = Dart_SaveTypeFeedback(&buffer, &size);
+  EXPECT_VALID(result);
+  EXPECT(size > 4);
+  EXPECT(memcmp(buffer, "DTFB", 4) == 0);
+
+  Function& function = Function::Handle();
+  {
+    TransitionNativeToVM transition(thread);
+    const Library& library =
+        Library::Handle(Library::RawCast(Api::UnwrapHandle(lib)));
+    function ^=
+        library.LookupLocalFunction(String::Handle(String::New("callFoo")));
+    EXPECT(!function.IsNull());
+    EXPECT(function.usage_counter() > 0);
+    function.SetUsageCounter(0);
+  }
+
+  // Loading restores the usage counter recorded in the training run.
+  result = Dart_LoadTypeFeedback(buffer, size);
+  EXPECT_VALID(result);
+  {
+    TransitionNativeToVM transition(thread);
+    EXPECT(function.usage_counter() > 0);
+  }
+
+  // Truncated feedback is rejected before any of it is applied.
+  {
+    TransitionNativeToVM transition(thread);
+    function.SetUsageCounter(0);
+  }
+  result = Dart_LoadTypeFeedback(buffer, size - 1);
+  EXPECT_ERROR(result, "Type feedback is truncated");
+  {
+    TransitionNativeToVM transition(thread);
+    EXPECT_EQ(0, function.usage_counter());
+  }
+
+  // When precompiling, the feedback goes to the object store instead, with
+  // the usage of each function. The receivers of x.foo() are listed with their
+  // counts, the hotter A first.
+  {
+    TransitionNativeToVM transition(thread);
+    TypeFeedbackLoader loader(thread, /* precompiling = */ true);
+    const Object& error = Object::Handle(loader.LoadFeedback(buffer, size));
+    EXPECT(error.IsNull());
+    const GrowableObjectArray& loaded = GrowableObjectArray::Handle(
+        thread->isolate()->object_store()->type_feedback());
+    EXPECT(!loaded.IsNull());
+    Array& call_sites = Array::Handle();
+    intptr_t usage = 0;
+    for (intptr_t i = 0; i < loaded.Length(); i += 3) {
+      if (loaded.At(i) == function.raw()) {
+        usage = Smi::Value(Smi::RawCast(loaded.At(i + 1)));
+        call_sites ^= loaded.At(i + 2);
+      }
+    }
+    EXPECT_LT(0, usage);
+    EXPECT(!call_sites.IsNull());
+    // Call sites are (token pos, selector, count, receivers) tuples.
+    Array& receivers = Array::Handle();
+    String& selector = String::Handle();
+    for (intptr_t i = 0; i < call_sites.Length(); i += 4) {
+      selector ^= call_sites.At(i + 1);
+      if (selector.Equals("foo")) {
+        receivers ^= call_sites.At(i + 3);
+      }
+    }
+    EXPECT(!receivers.IsNull());
+    EXPECT_EQ(4, receivers.Length());
+    Class& cls = Class::Handle();
+    cls ^= receivers.At(0);
+    EXPECT_STREQ("A", String::Handle(cls.Name()).ToCString());
+    cls ^= receivers.At(2);
+    EXPECT_STREQ("B", String::Handle(cls.Name()).ToCString());
+    const intptr_t a_count = Smi::Value(Smi::RawCast(receivers.At(1)));
+    const intptr_t b_count = Smi::Value(Smi::RawCast(receivers.At(3)));
+    EXPECT_LT(0, b_count);
+    EXPECT_LT(b_count, a_count);
+    thread->isolate()->object_store()->set_type_feedback(
+        GrowableObjectArray::Handle());
+  }
+
+  buffer[0] = 'X';
+  result = Dart_LoadTypeFeedback(buffer, size);
+  EXPECT_ERROR(result, "Type feedback has an unrecognized format");
+}
+
 // There exists another test by name DartAPI_Invoke_CrossLibrary.
 // However, that currently fails for the dartk configuration as it
 // uses Dart_LoadLibray. This test here effectively tests the same
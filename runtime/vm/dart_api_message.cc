@@ -631,6 +631,17 @@ Dart_CObject* ApiMessageReader::ReadInternalVMObject(intptr_t class_id,
       AddBackRef(object_id, object, kIsDeserialized);
       return object;
     }
+    case kTransferableTypedDataCid: {
+      // Native ports receive the transferred bytes as a Uint8List.
+      intptr_t len = Read<int64_t>();
+      Dart_CObject* object =
+          AllocateDartCObjectTypedData(Dart_TypedData_kUint8, len);
+      AddBackRef(object_id, object, kIsDeserialized);
+      FinalizableData finalizable_data = finalizable_data_->Take();
+      memmove(object->value.as_typed_data.values, finalizable_data.data, len);
+      finalizable_data.callback(NULL, NULL, finalizable_data.peer);
+      return object;
+    }
 
 #define READ_TYPED_DATA_HEADER(type)                                           \
   intptr_t len = ReadSmiValue();                                               \
@@ -82,6 +82,9 @@ class ReadStream : public ValueObject {
 
   const uint8_t* AddressOfCurrentPosition() const { return current_; }
 
+  const uint8_t* buffer() const { return buffer_; }
+  intptr_t size() const { return end_ - buffer_; }
+
   void Advance(intptr_t value) {
     ASSERT((end_ - current_) > value);
     current_ = current_ + value;
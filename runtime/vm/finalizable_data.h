@@ -15,6 +15,9 @@ struct FinalizableData {
   void* data;
   void* peer;
   Dart_WeakPersistentHandleFinalizer callback;
+  // Invoked with [peer] once the message is completely written. Until then
+  // [data] still belongs to the sender.
+  Dart_WeakPersistentHandleFinalizer successful_write_callback;
 };
 
 class MessageFinalizableData {
@@ -23,22 +26,40 @@ class MessageFinalizableData {
 
   ~MessageFinalizableData() {
     for (intptr_t i = position_; i < records_.length(); i++) {
-      records_[i].callback(NULL, NULL, records_[i].peer);
+      if (records_[i].successful_write_callback == NULL) {
+        records_[i].callback(NULL, NULL, records_[i].peer);
+      }
     }
   }
 
-  void Put(intptr_t external_size,
-           void* data,
-           void* peer,
-           Dart_WeakPersistentHandleFinalizer callback) {
+  void Put(
+      intptr_t external_size,
+      void* data,
+      void* peer,
+      Dart_WeakPersistentHandleFinalizer callback,
+      Dart_WeakPersistentHandleFinalizer successful_write_callback = NULL) {
     FinalizableData finalizable_data;
     finalizable_data.data = data;
     finalizable_data.peer = peer;
     finalizable_data.callback = callback;
+    finalizable_data.successful_write_callback = successful_write_callback;
     records_.Add(finalizable_data);
     external_size_ += external_size;
   }
 
+  // Hands the data that is transferred rather than copied over to the
+  // message. From then on the message owns it and [callback] is invoked with
+  // the data as its peer.
+  void SerializationSucceeded() {
+    for (intptr_t i = position_; i < records_.length(); i++) {
+      if (records_[i].successful_write_callback != NULL) {
+        records_[i].successful_write_callback(NULL, NULL, records_[i].peer);
+        records_[i].successful_write_callback = NULL;
+        records_[i].peer = records_[i].data;
+      }
+    }
+  }
+
   FinalizableData Take() {
     ASSERT(position_ < records_.length());
     return records_[position_++];
@@ -62,6 +62,8 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Collects all dynamic function names to identify unique targets")          \
   P(compactor_tasks, int, 2,                                                   \
     "The number of tasks to use for parallel compaction.")                     \
+  P(concurrent_mark, bool, false,                                              \
+    "Concurrent mark for old generation.")                                     \
   P(concurrent_sweep, bool, USING_MULTICORE,                                   \
     "Concurrent sweep for old generation.")                                    \
   R(dedup_instructions, true, bool, false,                                     \
@@ -94,6 +96,9 @@ constexpr bool kDartPrecompiledRuntime = false;
   C(force_clone_compiler_objects, false, false, bool, false,                   \
     "Force cloning of objects needed in compiler (ICData and Field).")         \
   R(gc_at_alloc, false, bool, false, "GC at every allocation.")                \
+  P(gc_pause_target_ms, int, 0,                                                \
+    "Target maximum GC pause. Sizes new space, and grows old space and "       \
+    "chooses marking and compaction from measured GC costs (0 disables).")     \
   P(getter_setter_ratio, int, 13,                                              \
     "Ratio of getter/setter usage used for double field unboxing heuristics")  \
   P(guess_icdata_cid, bool, true,                                              \
@@ -104,8 +109,12 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Consider thread pool isolates for idle tasks after this long.")           \
   P(idle_duration_micros, int, 500 * kMicrosecondsPerMillisecond,              \
     "Allow idle tasks to run for this long.")                                  \
+  P(incremental_compaction, bool, false,                                       \
+    "Evacuate the most fragmented old-space pages during old-space GC.")       \
   P(interpret_irregexp, bool, USING_DBC, "Use irregexp bytecode interpreter")  \
   P(lazy_dispatchers, bool, true, "Generate dispatchers lazily")               \
+  P(lazy_sweep, bool, false,                                                   \
+    "Sweep old-space pages on allocation demand and in parallel tasks.")       \
   P(link_natives_lazily, bool, false, "Link native calls lazily")              \
   C(load_deferred_eagerly, true, true, bool, false,                            \
     "Load deferred libraries eagerly.")                                        \
@@ -127,6 +136,8 @@ constexpr bool kDartPrecompiledRuntime = false;
   P(old_gen_heap_size, int, kDefaultMaxOldGenHeapSize,                         \
     "Max size of old gen heap size in MB, or 0 for unlimited,"                 \
     "e.g: --old_gen_heap_size=1024 allows up to 1024MB old gen heap")          \
+  P(old_gen_labs, bool, false,                                                 \
+    "Allocate small old-space objects from thread-local buffers.")             \
   R(pause_isolates_on_start, false, bool, false,                               \
     "Pause isolates before starting.")                                         \
   R(pause_isolates_on_exit, false, bool, false, "Pause isolates exiting.")     \
@@ -156,6 +167,9 @@ constexpr bool kDartPrecompiledRuntime = false;
   P(reify_generic_functions, bool, false,                                      \
     "Enable reification of generic functions (not yet supported).")            \
   P(reorder_basic_blocks, bool, true, "Reorder basic blocks")                  \
+  P(scavenger_tasks, int, 0,                                                   \
+    "The number of tasks to spawn during scavenging (0 means perform all "     \
+    "scavenging on main thread).")                                             \
   C(stress_async_stacks, false, false, bool, false,                            \
     "Stress test async stack traces")                                          \
   P(strong, bool, false, "Enable strong mode.")                                \
@@ -167,6 +181,8 @@ constexpr bool kDartPrecompiledRuntime = false;
   C(support_reload, false, false, bool, true, "Support isolate reload.")       \
   R(support_service, false, bool, true, "Support the service protocol.")       \
   R(support_timeline, false, bool, true, "Support timeline.")                  \
+  P(sweeper_tasks, int, 2,                                                     \
+    "The number of tasks to use for lazy sweeping.")                           \
   D(trace_cha, bool, false, "Trace CHA operations")                            \
   D(trace_field_guards, bool, false, "Trace changes in field's cids.")         \
   C(trace_irregexp, false, false, bool, false, "Trace irregexps.")             \
@@ -382,18 +382,14 @@ void CompactorTask::SlidePage(HeapPage* page) {
   }
 }
 
-// Plans the destination for a set of live objects starting with the first
-// live object that starts in a block, up to and including the last live
-// object that starts in that block.
-uword CompactorTask::PlanBlock(uword first_object,
-                               ForwardingPage* forwarding_page) {
-  uword block_start = first_object & kBlockMask;
-  uword block_end = block_start + kBlockSize;
-  ForwardingBlock* forwarding_block = forwarding_page->BlockFor(first_object);
-
-  // 1. Compute bitvector of surviving allocation units in the block.
-  intptr_t block_live_size = 0;
-  intptr_t block_dead_size = 0;
+// Computes the bitvector of surviving allocation units for the objects that
+// start in the block of 'first_object'. Returns the first object in the next
+// block.
+static uword RecordLiveObjects(uword first_object,
+                               ForwardingBlock* forwarding_block,
+                               intptr_t* block_live_size) {
+  uword block_end = (first_object & kBlockMask) + kBlockSize;
+  intptr_t live_size = 0;
   uword current = first_object;
   while (current < block_end) {
     RawObject* obj = RawObject::FromAddr(current);
@@ -401,13 +397,26 @@ uword CompactorTask::PlanBlock(uword first_object,
     if (obj->IsMarked()) {
       forwarding_block->RecordLive(current, size);
       ASSERT(static_cast<intptr_t>(forwarding_block->Lookup(current)) ==
-             block_live_size);
-      block_live_size += size;
-    } else {
-      block_dead_size += size;
+             live_size);
+      live_size += size;
     }
     current += size;
   }
+  *block_live_size = live_size;
+  return current;
+}
+
+// Plans the destination for a set of live objects starting with the first
+// live object that starts in a block, up to and including the last live
+// object that starts in that block.
+uword CompactorTask::PlanBlock(uword first_object,
+                               ForwardingPage* forwarding_page) {
+  ForwardingBlock* forwarding_block = forwarding_page->BlockFor(first_object);
+
+  // 1. Compute bitvector of surviving allocation units in the block.
+  intptr_t block_live_size = 0;
+  uword current =
+      RecordLiveObjects(first_object, forwarding_block, &block_live_size);
 
   // 2. Find the next contiguous space that can fit the live objects that
   // start in the block.
@@ -487,6 +496,178 @@ void CompactorTask::PlanMoveToContiguousSize(intptr_t size) {
   }
 }
 
+// Selective evacuation (--incremental_compaction). Plans the live objects of
+// the given pages into fresh pages block by block, exactly as the sliding
+// compactor does, then copies them and forwards pointers. The copies keep
+// their mark bits and the unused tail of the last fresh page is merely made
+// walkable, so the sweeper that follows treats the fresh pages like any other.
+intptr_t GCCompactor::Evacuate(HeapPage* pages) {
+  SetupImagePageBoundaries();
+  PageSpace* old_space = heap_->old_space();
+
+  // 1. Plan. Only the evacuated pages get forwarding pages, so ForwardPointer
+  // leaves every other object in place.
+  HeapPage* first_to_page = NULL;
+  HeapPage* to_page = NULL;
+  uword to_current = 0;
+  uword to_end = 0;
+  intptr_t moved_size = 0;
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread(), "Plan");
+    for (HeapPage* page = pages; page != NULL; page = page->next()) {
+      ForwardingPage* forwarding_page = page->AllocateForwardingPage();
+      uword current = page->object_start();
+      while (current < page->object_end()) {
+        ForwardingBlock* forwarding_block = forwarding_page->BlockFor(current);
+        intptr_t block_live_size = 0;
+        current =
+            RecordLiveObjects(current, forwarding_block, &block_live_size);
+        if (static_cast<intptr_t>(to_end - to_current) < block_live_size) {
+          to_page = AllocateEvacuationPage();
+          if (to_page == NULL) {
+            // Out of memory. Fresh pages already allocated are empty and will
+            // be released by the sweeper.
+            for (HeapPage* p = pages; p != NULL; p = p->next()) {
+              if (p->forwarding_page() != NULL) {
+                p->FreeForwardingPage();
+              }
+            }
+            return -1;
+          }
+          if (first_to_page == NULL) {
+            first_to_page = to_page;
+          }
+          to_current = to_page->object_start();
+          to_end = to_page->object_end();
+        }
+        forwarding_block->set_new_address(to_current);
+        to_current += block_live_size;
+        moved_size += block_live_size;
+      }
+    }
+  }
+
+  // 2. Copy. Fresh pages are allocated at the tail of the page list in the
+  // order they were planned.
+  if (first_to_page != NULL) {
+    TIMELINE_FUNCTION_GC_DURATION(thread(), "Copy");
+    to_page = first_to_page;
+    to_current = to_page->object_start();
+    to_end = to_page->object_end();
+    for (HeapPage* page = pages; page != NULL; page = page->next()) {
+      ForwardingPage* forwarding_page = page->forwarding_page();
+      uword old_addr = page->object_start();
+      while (old_addr < page->object_end()) {
+        RawObject* old_obj = RawObject::FromAddr(old_addr);
+        intptr_t size = old_obj->Size();
+        if (old_obj->IsMarked()) {
+          uword new_addr = forwarding_page->Lookup(old_addr);
+          if (new_addr != to_current) {
+            // Moving on to the next fresh page.
+            if (to_end > to_current) {
+              FreeListElement::AsElement(to_current, to_end - to_current);
+            }
+            to_page = to_page->next();
+            ASSERT(to_page != NULL);
+            to_current = to_page->object_start();
+            to_end = to_page->object_end();
+            ASSERT(to_current == new_addr);
+          }
+          memmove(reinterpret_cast<void*>(new_addr),
+                  reinterpret_cast<void*>(old_addr), size);
+          to_current += size;
+        }
+        old_addr += size;
+      }
+    }
+    if (to_end > to_current) {
+      FreeListElement::AsElement(to_current, to_end - to_current);
+    }
+  }
+
+  // 3. Forward. Unlike sliding, forwarding is idempotent here since no object
+  // moves into an evacuated page, so the copies may be visited with the rest
+  // of the heap. Unmarked objects are about to be swept and are skipped.
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread(), "ForwardPages");
+    for (HeapPage* page = old_space->pages_; page != NULL;
+         page = page->next()) {
+      uword current = page->object_start();
+      while (current < page->object_end()) {
+        RawObject* obj = RawObject::FromAddr(current);
+        if (obj->IsMarked()) {
+          current += obj->VisitPointers(this);
+        } else {
+          current += obj->Size();
+        }
+      }
+    }
+  }
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread(), "ForwardLargePages");
+    for (HeapPage* large_page = old_space->large_pages_; large_page != NULL;
+         large_page = large_page->next()) {
+      large_page->VisitObjectPointers(this);
+    }
+  }
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread(), "ForwardNewSpace");
+    heap_->new_space()->VisitObjectPointers(this);
+  }
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread(), "ForwardRememberedSet");
+    isolate()->store_buffer()->VisitObjectPointers(this);
+  }
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread(), "ForwardWeakTables");
+    heap_->ForwardWeakTables(this);
+  }
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread(), "ForwardWeakHandles");
+    isolate()->VisitWeakPersistentHandles(this);
+  }
+#ifndef PRODUCT
+  if (FLAG_support_service) {
+    TIMELINE_FUNCTION_GC_DURATION(thread(), "ForwardObjectIdRing");
+    isolate()->object_id_ring()->VisitPointers(this);
+  }
+#endif  // !PRODUCT
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread(), "ForwardStackPointers");
+    ForwardStackPointers();
+  }
+
+  // 4. Release the evacuated pages to the OS.
+  {
+    MutexLocker ml(old_space->pages_lock_);
+    HeapPage* page = pages;
+    while (page != NULL) {
+      HeapPage* next = page->next();
+      old_space->IncreaseCapacityInWordsLocked(
+          -(page->memory_->size() >> kWordSizeLog2));
+      page->FreeForwardingPage();
+      page->Deallocate();
+      page = next;
+    }
+  }
+  return moved_size;
+}
+
+HeapPage* GCCompactor::AllocateEvacuationPage() {
+  PageSpace* old_space = heap_->old_space();
+  if (!old_space->CanIncreaseCapacityInWords(kPageSizeInWords)) {
+    return NULL;
+  }
+  HeapPage* page = old_space->AllocatePage(HeapPage::kData);
+  if (page == NULL) {
+    return NULL;
+  }
+  // Keep the page walkable until it is filled.
+  FreeListElement::AsElement(page->object_start(),
+                             page->object_end() - page->object_start());
+  return page;
+}
+
 void GCCompactor::SetupImagePageBoundaries() {
   for (intptr_t i = 0; i < kMaxImagePages; i++) {
     image_page_ranges_[i].base = 0;
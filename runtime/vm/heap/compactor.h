@@ -31,8 +31,16 @@ class GCCompactor : public ValueObject,
 
   void Compact(HeapPage* pages, FreeList* freelist, Mutex* mutex);
 
+  // Moves the marked objects of 'pages', which have been unlinked from the
+  // page space, to fresh data pages, forwards all pointers to them and frees
+  // 'pages'. Runs before sweeping. Returns the number of bytes moved, or -1
+  // if no fresh page could be allocated, in which case nothing has moved and
+  // 'pages' remain owned by the caller.
+  intptr_t Evacuate(HeapPage* pages);
+
  private:
   void SetupImagePageBoundaries();
+  HeapPage* AllocateEvacuationPage();
   void ForwardStackPointers();
   void ForwardPointer(RawObject** ptr);
   void VisitPointers(RawObject** first, RawObject** last);
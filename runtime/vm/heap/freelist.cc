@@ -4,6 +4,7 @@
 
 #include "vm/heap/freelist.h"
 
+#include "platform/atomic.h"
 #include "vm/bit_set.h"
 #include "vm/hash_map.h"
 #include "vm/lockers.h"
@@ -54,6 +55,7 @@ intptr_t FreeListElement::HeaderSizeFor(intptr_t size) {
 
 FreeList::FreeList()
     : mutex_(new Mutex()),
+      unindexed_(0),
       freelist_search_budget_(kInitialFreeListSearchBudget) {
   Reset();
 }
@@ -74,106 +76,67 @@ uword FreeList::TryAllocateLocked(intptr_t size, bool is_protected) {
 
   // Postcondition: if allocation succeeds, the allocated block is writable.
   int index = IndexForSize(size);
-  if ((index != kNumLists) && free_map_.Test(index)) {
-    FreeListElement* element = DequeueElement(index);
-    if (is_protected) {
-      VirtualMemory::Protect(reinterpret_cast<void*>(element), size,
-                             VirtualMemory::kReadWrite);
-    }
-    return reinterpret_cast<uword>(element);
-  }
-
-  if ((index + 1) < kNumLists) {
-    intptr_t next_index = free_map_.Next(index + 1);
-    if (next_index != -1) {
-      // Dequeue an element from the list, split and enqueue the remainder in
-      // the appropriate list.
-      FreeListElement* element = DequeueElement(next_index);
+  FreeListElement* element = NULL;
+  if (index != kNumLists) {
+    IndexSmallList(index);
+    if (free_map_.Test(index)) {
+      element = DequeueElement(index);
       if (is_protected) {
-        // Make the allocated block and the header of the remainder element
-        // writable.  The remainder will be non-writable if necessary after
-        // the call to SplitElementAfterAndEnqueue.
-        // If the remainder size is zero, only the element itself needs to
-        // be made writable.
-        intptr_t remainder_size = element->Size() - size;
-        intptr_t region_size =
-            size + FreeListElement::HeaderSizeFor(remainder_size);
-        VirtualMemory::Protect(reinterpret_cast<void*>(element), region_size,
+        VirtualMemory::Protect(reinterpret_cast<void*>(element), size,
                                VirtualMemory::kReadWrite);
       }
-      SplitElementAfterAndEnqueue(element, size, is_protected);
       return reinterpret_cast<uword>(element);
     }
-  }
-
-  FreeListElement* previous = NULL;
-  FreeListElement* current = free_lists_[kNumLists];
-  // We are willing to search the freelist further for a big block.
-  // For each successful free-list search we:
-  //   * increase the search budget by #allocated-words
-  //   * decrease the search budget by #free-list-entries-traversed
-  //     which guarantees us to not waste more than around 1 search step per
-  //     word of allocation
-  //
-  // If we run out of search budget we fall back to allocating a new page and
-  // reset the search budget.
-  intptr_t tries_left = freelist_search_budget_ + (size >> kWordSizeLog2);
-  while (current != NULL) {
-    if (current->Size() >= size) {
-      // Found an element large enough to hold the requested size. Dequeue,
-      // split and enqueue the remainder.
-      intptr_t remainder_size = current->Size() - size;
-      intptr_t region_size =
-          size + FreeListElement::HeaderSizeFor(remainder_size);
-      if (is_protected) {
-        // Make the allocated block and the header of the remainder element
-        // writable.  The remainder will be non-writable if necessary after
-        // the call to SplitElementAfterAndEnqueue.
-        VirtualMemory::Protect(reinterpret_cast<void*>(current), region_size,
-                               VirtualMemory::kReadWrite);
+    if ((index + 1) < kNumLists) {
+      intptr_t next_index = NextSmallIndex(index + 1);
+      if (next_index != -1) {
+        element = DequeueElement(next_index);
       }
-
-      if (previous == NULL) {
-        free_lists_[kNumLists] = current->next();
-      } else {
-        // If the previous free list element's next field is protected, it
-        // needs to be unprotected before storing to it and reprotected
-        // after.
-        bool target_is_protected = false;
-        uword target_address = 0L;
-        if (is_protected) {
-          uword writable_start = reinterpret_cast<uword>(current);
-          uword writable_end = writable_start + region_size - 1;
-          target_address = previous->next_address();
-          target_is_protected =
-              !VirtualMemory::InSamePage(target_address, writable_start) &&
-              !VirtualMemory::InSamePage(target_address, writable_end);
-        }
-        if (target_is_protected) {
-          VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
-                                 kWordSize, VirtualMemory::kReadWrite);
-        }
-        previous->set_next(current->next());
-        if (target_is_protected) {
-          VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
-                                 kWordSize, VirtualMemory::kReadExecute);
-        }
+    }
+    if (element == NULL) {
+      // Any large element will do.
+      intptr_t large_index = large_map_.Next(0);
+      if (large_index != -1) {
+        element = DequeueLargeElement(large_index);
       }
-      SplitElementAfterAndEnqueue(current, size, is_protected);
-      freelist_search_budget_ =
-          Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
-      return reinterpret_cast<uword>(current);
-    } else if (tries_left-- < 0) {
-      freelist_search_budget_ = kInitialFreeListSearchBudget;
-      return 0;  // Trigger allocation of new page.
     }
-    previous = current;
-    current = current->next();
+  } else {
+    element = FindLargeElement(size, is_protected);
   }
-  return 0;
+  if (element == NULL) {
+    return 0;  // Trigger allocation of new page.
+  }
+
+  // Split the element and enqueue the remainder in the appropriate list.
+  if (is_protected) {
+    // Make the allocated block and the header of the remainder element
+    // writable.  The remainder will be non-writable if necessary after
+    // the call to SplitElementAfterAndEnqueue.
+    // If the remainder size is zero, only the element itself needs to
+    // be made writable.
+    intptr_t remainder_size = element->Size() - size;
+    intptr_t region_size =
+        size + FreeListElement::HeaderSizeFor(remainder_size);
+    VirtualMemory::Protect(reinterpret_cast<void*>(element), region_size,
+                           VirtualMemory::kReadWrite);
+  }
+  SplitElementAfterAndEnqueue(element, size, is_protected);
+  return reinterpret_cast<uword>(element);
 }
 
 void FreeList::Free(uword addr, intptr_t size) {
+  intptr_t index = IndexForSize(size);
+  if (index != kNumLists) {
+    // Small elements are pushed without the lock, e.g., by the concurrent
+    // sweeper while the mutator allocates.
+    PushSmall(FreeListElement::AsElement(addr, size), index);
+    // Signal the push after it is visible. Skip the write when the signal is
+    // already set: it is then cleared only by a scan that follows the push.
+    if (AtomicOperations::LoadRelaxed(&unindexed_) == 0) {
+      AtomicOperations::CompareAndSwapWord(&unindexed_, 0, 1);
+    }
+    return;
+  }
   MutexLocker ml(mutex_);
   FreeLocked(addr, size);
 }
@@ -194,10 +157,15 @@ void FreeList::FreeLocked(uword addr, intptr_t size) {
 void FreeList::Reset() {
   MutexLocker ml(mutex_);
   free_map_.Reset();
+  large_map_.Reset();
   last_free_small_size_ = -1;
-  for (int i = 0; i < (kNumLists + 1); i++) {
+  unindexed_ = 0;
+  for (int i = 0; i < kNumLists; i++) {
     free_lists_[i] = NULL;
   }
+  for (int i = 0; i < kNumLargeLists; i++) {
+    large_lists_[i] = NULL;
+  }
 }
 
 intptr_t FreeList::IndexForSize(intptr_t size) {
@@ -211,21 +179,35 @@ intptr_t FreeList::IndexForSize(intptr_t size) {
   return index;
 }
 
+intptr_t FreeList::LargeIndexForSize(intptr_t size) {
+  if (size < (2 * kMinLargeSize)) {
+    return 0;
+  }
+  return Utils::Minimum<intptr_t>(Utils::HighestBit(size / kMinLargeSize),
+                                  kNumLargeLists - 1);
+}
+
 void FreeList::EnqueueElement(FreeListElement* element, intptr_t index) {
-  FreeListElement* next = free_lists_[index];
-  if (next == NULL && index != kNumLists) {
-    free_map_.Set(index, true);
-    last_free_small_size_ =
-        Utils::Maximum(last_free_small_size_, index << kObjectAlignmentLog2);
+  if (index != kNumLists) {
+    PushSmall(element, index);
+    IndexSmallList(index);
+    return;
+  }
+  intptr_t large_index = LargeIndexForSize(element->Size());
+  FreeListElement* next = large_lists_[large_index];
+  if (next == NULL) {
+    large_map_.Set(large_index, true);
   }
   element->set_next(next);
-  free_lists_[index] = element;
+  large_lists_[large_index] = element;
 }
 
 FreeListElement* FreeList::DequeueElement(intptr_t index) {
-  FreeListElement* result = free_lists_[index];
-  FreeListElement* next = result->next();
-  if (next == NULL && index != kNumLists) {
+  ASSERT(index != kNumLists);
+  ASSERT(free_map_.Test(index));
+  FreeListElement* result = PopSmall(index);
+  ASSERT(result != NULL);
+  if (AtomicOperations::LoadRelaxed(&free_lists_[index]) == NULL) {
     intptr_t size = index << kObjectAlignmentLog2;
     if (size == last_free_small_size_) {
       // Note: This is -1 * kObjectAlignment if no other small sizes remain.
@@ -235,10 +217,136 @@ FreeListElement* FreeList::DequeueElement(intptr_t index) {
       free_map_.Set(index, false);
     }
   }
-  free_lists_[index] = next;
   return result;
 }
 
+FreeListElement* FreeList::DequeueLargeElement(intptr_t large_index) {
+  FreeListElement* result = large_lists_[large_index];
+  FreeListElement* next = result->next();
+  if (next == NULL) {
+    large_map_.Set(large_index, false);
+  }
+  large_lists_[large_index] = next;
+  return result;
+}
+
+// Searches the list for the size class of 'size' first fit, then takes any
+// element of a larger size class. Returns NULL if neither is found within the
+// search budget.
+FreeListElement* FreeList::FindLargeElement(intptr_t size, bool is_protected) {
+  const intptr_t large_index = LargeIndexForSize(size);
+  // We are willing to search the freelist further for a big block.
+  // For each successful free-list search we:
+  //   * increase the search budget by #allocated-words
+  //   * decrease the search budget by #free-list-entries-traversed
+  //     which guarantees us to not waste more than around 1 search step per
+  //     word of allocation
+  //
+  // If we run out of search budget we fall back to a larger size class, or
+  // to allocating a new page, and reset the search budget.
+  intptr_t tries_left = freelist_search_budget_ + (size >> kWordSizeLog2);
+  FreeListElement* previous = NULL;
+  FreeListElement* current = large_lists_[large_index];
+  while (current != NULL) {
+    FreeListElement* next = current->next();
+    if (current->Size() >= size) {
+      freelist_search_budget_ =
+          Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
+      if (previous == NULL) {
+        return DequeueLargeElement(large_index);
+      }
+      // If the previous free list element's next field is protected, it
+      // needs to be unprotected before storing to it and reprotected after.
+      uword target_address = previous->next_address();
+      if (is_protected) {
+        VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
+                               kWordSize, VirtualMemory::kReadWrite);
+      }
+      previous->set_next(next);
+      if (is_protected) {
+        VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
+                               kWordSize, VirtualMemory::kReadExecute);
+      }
+      return current;
+    } else if (tries_left-- < 0) {
+      freelist_search_budget_ = kInitialFreeListSearchBudget;
+      break;
+    }
+    previous = current;
+    current = next;
+  }
+
+  // Every element of a larger size class fits.
+  if ((large_index + 1) < kNumLargeLists) {
+    intptr_t next_index = large_map_.Next(large_index + 1);
+    if (next_index != -1) {
+      return DequeueLargeElement(next_index);
+    }
+  }
+  return NULL;
+}
+
+void FreeList::PushSmall(FreeListElement* element, intptr_t index) {
+  FreeListElement* next = AtomicOperations::LoadRelaxed(&free_lists_[index]);
+  while (true) {
+    element->set_next(next);
+    FreeListElement* actual =
+        AtomicOperations::CompareAndSwapPointer(&free_lists_[index], next,
+                                                element);
+    if (actual == next) {
+      return;
+    }
+    next = actual;
+  }
+}
+
+// Only called under the lock. Concurrent pushes only ever replace the head,
+// and an element cannot be popped and pushed again while we hold the lock, so
+// the compare-and-swap does not suffer from ABA.
+FreeListElement* FreeList::PopSmall(intptr_t index) {
+  DEBUG_ASSERT(mutex_->IsOwnedByCurrentThread());
+  FreeListElement* element =
+      AtomicOperations::LoadRelaxed(&free_lists_[index]);
+  while (element != NULL) {
+    FreeListElement* actual = AtomicOperations::CompareAndSwapPointer(
+        &free_lists_[index], element, element->next());
+    if (actual == element) {
+      break;
+    }
+    element = actual;
+  }
+  return element;
+}
+
+void FreeList::IndexSmallList(intptr_t index) {
+  if (!free_map_.Test(index) &&
+      (AtomicOperations::LoadRelaxed(&free_lists_[index]) != NULL)) {
+    free_map_.Set(index, true);
+    last_free_small_size_ =
+        Utils::Maximum(last_free_small_size_, index << kObjectAlignmentLog2);
+  }
+}
+
+void FreeList::IndexSmallLists() {
+  // Clear first, with a full barrier so that the scan cannot read the lists
+  // before the clear is visible: pushes racing with the scan set it again.
+  AtomicOperations::CompareAndSwapWord(&unindexed_, 1, 0);
+  for (intptr_t i = 1; i < kNumLists; i++) {
+    IndexSmallList(i);
+  }
+}
+
+// Returns the first non-empty small list at or above 'index', or -1.
+intptr_t FreeList::NextSmallIndex(intptr_t index) {
+  intptr_t next_index = free_map_.Next(index);
+  if ((next_index == -1) &&
+      (AtomicOperations::LoadRelaxed(&unindexed_) != 0)) {
+    IndexSmallLists();
+    next_index = free_map_.Next(index);
+  }
+  return next_index;
+}
+
 intptr_t FreeList::LengthLocked(int index) const {
   DEBUG_ASSERT(mutex_->IsOwnedByCurrentThread());
   ASSERT(index >= 0);
@@ -303,15 +411,17 @@ void FreeList::PrintLarge() const {
   intptr_t large_bytes = 0;
   MallocDirectChainedHashMap<NumbersKeyValueTrait<IntptrPair> > map;
   FreeListElement* node;
-  for (node = free_lists_[kNumLists]; node != NULL; node = node->next()) {
-    IntptrPair* pair = map.Lookup(node->Size());
-    if (pair == NULL) {
-      large_sizes += 1;
-      map.Insert(IntptrPair(node->Size(), 1));
-    } else {
-      pair->set_second(pair->second() + 1);
+  for (int i = 0; i < kNumLargeLists; ++i) {
+    for (node = large_lists_[i]; node != NULL; node = node->next()) {
+      IntptrPair* pair = map.Lookup(node->Size());
+      if (pair == NULL) {
+        large_sizes += 1;
+        map.Insert(IntptrPair(node->Size(), 1));
+      } else {
+        pair->set_second(pair->second() + 1);
+      }
+      large_objects += 1;
     }
-    large_objects += 1;
   }
 
   MallocDirectChainedHashMap<NumbersKeyValueTrait<IntptrPair> >::Iterator it =
@@ -369,44 +479,27 @@ FreeListElement* FreeList::TryAllocateLarge(intptr_t minimum_size) {
 
 FreeListElement* FreeList::TryAllocateLargeLocked(intptr_t minimum_size) {
   DEBUG_ASSERT(mutex_->IsOwnedByCurrentThread());
-  FreeListElement* previous = NULL;
-  FreeListElement* current = free_lists_[kNumLists];
-  // TODO(koda): Find largest.
-  // We are willing to search the freelist further for a big block.
-  intptr_t tries_left =
-      freelist_search_budget_ + (minimum_size >> kWordSizeLog2);
-  while (current != NULL) {
-    FreeListElement* next = current->next();
-    if (current->Size() >= minimum_size) {
-      if (previous == NULL) {
-        free_lists_[kNumLists] = next;
-      } else {
-        previous->set_next(next);
-      }
-      freelist_search_budget_ =
-          Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
-      return current;
-    } else if (tries_left-- < 0) {
-      freelist_search_budget_ = kInitialFreeListSearchBudget;
-      return 0;  // Trigger allocation of new page.
-    }
-    previous = current;
-    current = next;
-  }
-  return NULL;
+  return FindLargeElement(minimum_size, false);
 }
 
 uword FreeList::TryAllocateSmallLocked(intptr_t size) {
   DEBUG_ASSERT(mutex_->IsOwnedByCurrentThread());
+  if ((size > last_free_small_size_) &&
+      (AtomicOperations::LoadRelaxed(&unindexed_) != 0)) {
+    IndexSmallLists();
+  }
   if (size > last_free_small_size_) {
     return 0;
   }
   int index = IndexForSize(size);
-  if (index != kNumLists && free_map_.Test(index)) {
-    return reinterpret_cast<uword>(DequeueElement(index));
+  if (index != kNumLists) {
+    IndexSmallList(index);
+    if (free_map_.Test(index)) {
+      return reinterpret_cast<uword>(DequeueElement(index));
+    }
   }
   if ((index + 1) < kNumLists) {
-    intptr_t next_index = free_map_.Next(index + 1);
+    intptr_t next_index = NextSmallIndex(index + 1);
     if (next_index != -1) {
       FreeListElement* element = DequeueElement(next_index);
       SplitElementAfterAndEnqueue(element, size, false);
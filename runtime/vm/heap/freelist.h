@@ -74,6 +74,11 @@ class FreeListElement {
   DISALLOW_IMPLICIT_CONSTRUCTORS(FreeListElement);
 };
 
+// Small elements are kept in one list per size in allocation units, with a
+// bitmap of the non-empty lists. Small elements are pushed without taking the
+// lock, so the concurrent sweeper does not block allocation; they are only
+// popped under the lock, which keeps the lists free of ABA races. Large
+// elements are kept in lists segregated by powers of two.
 class FreeList {
  public:
   FreeList();
@@ -100,14 +105,27 @@ class FreeList {
 
  private:
   static const int kNumLists = 128;
+  static const int kNumLargeLists = 16;
+  static const intptr_t kMinLargeSize = kNumLists << kObjectAlignmentLog2;
   static const intptr_t kInitialFreeListSearchBudget = 1000;
 
   static intptr_t IndexForSize(intptr_t size);
+  static intptr_t LargeIndexForSize(intptr_t size);
 
   intptr_t LengthLocked(int index) const;
 
   void EnqueueElement(FreeListElement* element, intptr_t index);
   FreeListElement* DequeueElement(intptr_t index);
+  FreeListElement* DequeueLargeElement(intptr_t large_index);
+  FreeListElement* FindLargeElement(intptr_t size, bool is_protected);
+
+  // Lock-free push onto a small list. The bitmap is brought up to date when
+  // an allocation would otherwise miss the list.
+  void PushSmall(FreeListElement* element, intptr_t index);
+  FreeListElement* PopSmall(intptr_t index);
+  void IndexSmallList(intptr_t index);
+  void IndexSmallLists();
+  intptr_t NextSmallIndex(intptr_t index);
 
   void SplitElementAfterAndEnqueue(FreeListElement* element,
                                    intptr_t size,
@@ -116,12 +134,25 @@ class FreeList {
   void PrintSmall() const;
   void PrintLarge() const;
 
-  // Lock protecting the free list data structures.
+  // Lock protecting the free list data structures, except for pushes onto
+  // the small lists.
   Mutex* mutex_;
 
+  // Non-empty small lists. Never set for an empty list, but may be clear for
+  // a non-empty list after a lock-free push.
   BitSet<kNumLists> free_map_;
 
-  FreeListElement* free_lists_[kNumLists + 1];
+  FreeListElement* free_lists_[kNumLists];
+
+  // Set by lock-free pushes that have not been reflected in free_map_ yet.
+  uword unindexed_;
+
+  // Non-empty large lists.
+  BitSet<kNumLargeLists> large_map_;
+
+  // Large elements of [kMinLargeSize << i, kMinLargeSize << (i + 1)), except
+  // for the last list, which holds all larger ones.
+  FreeListElement* large_lists_[kNumLargeLists];
 
   intptr_t freelist_search_budget_;
 
@@ -4,6 +4,9 @@
 
 #include "vm/heap/freelist.h"
 #include "platform/assert.h"
+#include "vm/dart.h"
+#include "vm/lockers.h"
+#include "vm/thread_pool.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -182,4 +185,153 @@ TEST_CASE(FreeListProtectedVariableSizeObjects) {
   delete[] objects;
 }
 
+// Large allocations from a free list that holds many blocks of assorted
+// sizes, e.g., after sweeping a fragmented page.
+TEST_CASE(FreeListFragmentedLargeAllocation) {
+  FreeList* free_list = new FreeList();
+  const intptr_t kBlobSize = 8 * MB;
+  const intptr_t kMaxBlocks = kBlobSize / KB;
+  uword* blocks = new uword[kMaxBlocks];
+  intptr_t* sizes = new intptr_t[kMaxBlocks];
+
+  VirtualMemory* blob =
+      VirtualMemory::Allocate(kBlobSize, /* is_executable = */ false, NULL);
+  blob->Protect(VirtualMemory::kReadWrite);
+  free_list->Free(blob->start(), blob->size());
+
+  // Carve the blob into blocks of 1KB to 16KB and free every other one.
+  intptr_t num_blocks = 0;
+  while (num_blocks < kMaxBlocks) {
+    intptr_t size = ((num_blocks * 7) % 16 + 1) * KB;
+    uword block = free_list->TryAllocate(size, false);
+    if (block == 0) {
+      break;
+    }
+    blocks[num_blocks] = block;
+    sizes[num_blocks] = size;
+    num_blocks++;
+  }
+  // The carving stopped at a block that did not fit the rest of the blob,
+  // which stays on the free list.
+  const intptr_t kLargestSize = 16 * KB;
+  intptr_t free_in_bytes = blob->size();
+  for (intptr_t i = 0; i < num_blocks; i++) {
+    free_in_bytes -= sizes[i];
+  }
+  EXPECT_LT(free_in_bytes, kLargestSize);
+
+  // Free every other block. The freed blocks are not adjacent, so none of
+  // them can be merged.
+  intptr_t free_blocks = 0;
+  intptr_t largest_blocks = 0;
+  for (intptr_t i = 0; i < num_blocks; i += 2) {
+    free_list->Free(blocks[i], sizes[i]);
+    free_blocks++;
+    free_in_bytes += sizes[i];
+    if (sizes[i] == kLargestSize) {
+      largest_blocks++;
+    }
+  }
+  EXPECT(free_blocks > 100);
+  EXPECT(largest_blocks > 0);
+
+  // Each allocation of the largest size is served by one of the freed blocks
+  // of that size, however many smaller blocks precede it.
+  for (intptr_t i = 0; i < largest_blocks; i++) {
+    uword block = free_list->TryAllocate(kLargestSize, false);
+    EXPECT_NE(0U, block);
+    bool found = false;
+    for (intptr_t j = 0; j < num_blocks; j += 2) {
+      if ((blocks[j] == block) && (sizes[j] == kLargestSize)) {
+        found = true;
+        break;
+      }
+    }
+    EXPECT(found);
+    free_in_bytes -= kLargestSize;
+  }
+  EXPECT_EQ(0U, free_list->TryAllocate(kLargestSize, false));
+
+  // Splitting the remaining blocks loses no memory.
+  intptr_t allocated = 0;
+  while (free_list->TryAllocate(KB, false) != 0) {
+    allocated++;
+  }
+  EXPECT_EQ(free_in_bytes / KB, allocated);
+
+  delete blob;
+  delete free_list;
+  delete[] blocks;
+  delete[] sizes;
+}
+
+class FreeListFreeTask : public ThreadPool::Task {
+ public:
+  FreeListFreeTask(FreeList* free_list,
+                   uword start,
+                   intptr_t size,
+                   intptr_t object_size,
+                   Monitor* monitor,
+                   intptr_t* done)
+      : free_list_(free_list),
+        start_(start),
+        size_(size),
+        object_size_(object_size),
+        monitor_(monitor),
+        done_(done) {}
+
+  virtual void Run() {
+    for (intptr_t offset = 0; offset < size_; offset += object_size_) {
+      free_list_->Free(start_ + offset, object_size_);
+    }
+    MonitorLocker ml(monitor_);
+    ++*done_;
+    ml.Notify();
+  }
+
+ private:
+  FreeList* free_list_;
+  uword start_;
+  intptr_t size_;
+  intptr_t object_size_;
+  Monitor* monitor_;
+  intptr_t* done_;
+};
+
+// Small blocks are freed without the lock while the owner allocates.
+TEST_CASE(FreeListConcurrentFree) {
+  FreeList* free_list = new FreeList();
+  const intptr_t kNumTasks = 4;
+  const intptr_t kChunkSize = 256 * KB;
+  const intptr_t kObjectSize = 4 * kWordSize;
+
+  VirtualMemory* blob = VirtualMemory::Allocate(
+      kNumTasks * kChunkSize, /* is_executable = */ false, NULL);
+  blob->Protect(VirtualMemory::kReadWrite);
+
+  Monitor monitor;
+  intptr_t done = 0;
+  for (intptr_t i = 0; i < kNumTasks; i++) {
+    Dart::thread_pool()->Run(
+        new FreeListFreeTask(free_list, blob->start() + i * kChunkSize,
+                             kChunkSize, kObjectSize, &monitor, &done));
+  }
+  intptr_t allocated = 0;
+  bool finished = false;
+  while (!finished) {
+    {
+      MonitorLocker ml(&monitor);
+      finished = (done == kNumTasks);
+    }
+    while (free_list->TryAllocate(kObjectSize, false) != 0) {
+      allocated++;
+    }
+  }
+  EXPECT_EQ(kNumTasks * kChunkSize / kObjectSize, allocated);
+  EXPECT_EQ(0U, free_list->TryAllocate(kObjectSize, false));
+
+  delete blob;
+  delete free_list;
+}
+
 }  // namespace dart
@@ -6,6 +6,7 @@
 
 #include "platform/assert.h"
 #include "platform/utils.h"
+#include "vm/dart.h"
 #include "vm/flags.h"
 #include "vm/heap/pages.h"
 #include "vm/heap/safepoint.h"
@@ -24,6 +25,7 @@
 #include "vm/stack_frame.h"
 #include "vm/tags.h"
 #include "vm/thread_pool.h"
+#include "vm/thread_registry.h"
 #include "vm/timeline.h"
 #include "vm/virtual_memory.h"
 
@@ -39,6 +41,10 @@ Heap::Heap(Isolate* isolate,
       old_space_(this, max_old_gen_words),
       barrier_(new Monitor()),
       barrier_done_(new Monitor()),
+      idle_notifications_(0),
+      idle_requested_micros_(0),
+      idle_used_micros_(0),
+      idle_overrun_micros_(0),
       read_only_(false),
       gc_new_space_in_progress_(false),
       gc_old_space_in_progress_(false) {
@@ -80,14 +86,28 @@ uword Heap::AllocateNew(intptr_t size) {
 }
 
 uword Heap::AllocateOld(intptr_t size, HeapPage::PageType type) {
-  ASSERT(Thread::Current()->no_safepoint_scope_depth() == 0);
-  uword addr = old_space_.TryAllocate(size, type);
+  Thread* thread = Thread::Current();
+  ASSERT(thread->no_safepoint_scope_depth() == 0);
+  uword addr = 0;
+  if (FLAG_old_gen_labs && (type == HeapPage::kData) &&
+      (isolate_ != Dart::vm_isolate())) {
+    addr = old_space_.TryAllocateThreadLocal(thread, size);
+    if (addr != 0) {
+      return addr;
+    }
+  }
+  addr = old_space_.TryAllocate(size, type);
+  if (addr != 0) {
+    return addr;
+  }
+  // Sweep the pages left by a lazy sweep ourselves rather than waiting for the
+  // sweeper tasks.
+  addr = old_space_.TryAllocateSweepingOnDemand(size, type);
   if (addr != 0) {
     return addr;
   }
   // If we are in the process of running a sweep, wait for the sweeper to free
   // memory.
-  Thread* thread = Thread::Current();
   if (thread->CanCollectGarbage()) {
     // Wait for any GC tasks that are in progress.
     WaitForSweeperTasks(thread);
@@ -221,6 +241,11 @@ HeapIterationScope::HeapIterationScope(Thread* thread, bool writable)
   }
 
   isolate()->safepoint_handler()->SafepointThreads(thread);
+  isolate()->thread_registry()->AbandonOldSpaceBuffers();
+
+  // The heap is about to be iterated (and possibly mutated) as a whole; start
+  // over with the next concurrent marking cycle rather than finishing this one.
+  old_space_->AbortConcurrentMark();
 
   if (writable_) {
     heap_->WriteProtectCode(false);
@@ -359,20 +384,55 @@ void Heap::EndOldSpaceGC() {
 
 void Heap::NotifyIdle(int64_t deadline) {
   Thread* thread = Thread::Current();
+  const int64_t start = OS::GetCurrentMonotonicMicros();
   if (new_space_.ShouldPerformIdleScavenge(deadline)) {
     TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
     CollectNewSpaceGarbage(thread, kIdle);
   }
   // Because we use a deadline instead of a timeout, we automatically take any
-  // time used up by a scavenge into account when deciding if we can complete
-  // a mark-sweep on time.
-  if (old_space_.ShouldPerformIdleMarkCompact(deadline)) {
+  // time used up by earlier steps into account when deciding if the next one
+  // can complete on time.
+  if (old_space_.IsConcurrentMarking()) {
+    if (old_space_.ShouldFinishIdleConcurrentMark(deadline)) {
+      TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
+      CollectOldSpaceGarbage(thread, kMarkSweep, kIdle);
+    }
+  } else if (old_space_.ShouldPerformIdleMarkCompact(deadline)) {
     TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
     CollectOldSpaceGarbage(thread, kMarkCompact, kIdle);
   } else if (old_space_.ShouldPerformIdleMarkSweep(deadline)) {
     TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
     CollectOldSpaceGarbage(thread, kMarkSweep, kIdle);
+  } else if (old_space_.ShouldStartIdleConcurrentMark(deadline)) {
+    StartConcurrentMark(thread);
+  }
+  // The remaining steps are cheap enough to check the clock between them.
+  old_space_.SweepUntil(deadline);
+  if (OS::GetCurrentMonotonicMicros() < deadline) {
+    SemiSpace::ReleaseCache();
   }
+  RecordIdle(start, deadline);
+}
+
+void Heap::RecordIdle(int64_t start, int64_t deadline) {
+  const int64_t end = OS::GetCurrentMonotonicMicros();
+  idle_notifications_++;
+  idle_requested_micros_ += Utils::Maximum<int64_t>(deadline - start, 0);
+  idle_used_micros_ += end - start;
+  idle_overrun_micros_ +=
+      Utils::Maximum<int64_t>(end - Utils::Maximum(start, deadline), 0);
+#if !defined(PRODUCT)
+  TimelineStream* stream = Timeline::GetGCStream();
+  TimelineEvent* event = stream->StartEvent();
+  if (event != NULL) {
+    event->Instant("NotifyIdle");
+    event->SetNumArguments(2);
+    event->FormatArgument(0, "requestedMicros", "%" Pd64,
+                          Utils::Maximum<int64_t>(deadline - start, 0));
+    event->FormatArgument(1, "usedMicros", "%" Pd64, end - start);
+    event->Complete();
+  }
+#endif  // !defined(PRODUCT)
 }
 
 void Heap::NotifyLowMemory() {
@@ -400,7 +460,7 @@ void Heap::CollectNewSpaceGarbage(Thread* thread, GCReason reason) {
     {
       VMTagScope tagScope(thread, VMTag::kGCNewSpaceTagId);
       TIMELINE_FUNCTION_GC_DURATION_BASIC(thread, "CollectNewGeneration");
-      new_space_.Scavenge();
+      new_space_.Scavenge(reason == kIdle);
       RecordAfterGC(kScavenge);
       PrintStats();
       NOT_IN_PRODUCT(PrintStatsToTimeline(&tds, reason));
@@ -408,10 +468,24 @@ void Heap::CollectNewSpaceGarbage(Thread* thread, GCReason reason) {
     }
     if ((reason == kNewSpace) && old_space_.NeedsGarbageCollection()) {
       CollectOldSpaceGarbage(thread, kMarkSweep, kPromotion);
+    } else if (old_space_.ShouldFinishConcurrentMark()) {
+      CollectOldSpaceGarbage(thread, kMarkSweep, kFinalize);
+    } else if (old_space_.ShouldStartConcurrentMark()) {
+      StartConcurrentMark(thread);
+    } else if ((reason == kNewSpace) && old_space_.ShouldMarkAfterScavenge()) {
+      CollectOldSpaceGarbage(thread, kMarkSweep, kPromotion);
     }
   }
 }
 
+void Heap::StartConcurrentMark(Thread* thread) {
+  if (BeginOldSpaceGC(thread)) {
+    VMTagScope tagScope(thread, VMTag::kGCOldSpaceTagId);
+    old_space_.StartConcurrentMark();
+    EndOldSpaceGC();
+  }
+}
+
 void Heap::CollectOldSpaceGarbage(Thread* thread,
                                   GCType type,
                                   GCReason reason) {
@@ -420,6 +494,9 @@ void Heap::CollectOldSpaceGarbage(Thread* thread,
   if (FLAG_use_compactor) {
     type = kMarkCompact;
   }
+  if ((type == kMarkSweep) && old_space_.ShouldCompact()) {
+    type = kMarkCompact;
+  }
   if (BeginOldSpaceGC(thread)) {
     RecordBeforeGC(type, reason);
     VMTagScope tagScope(thread, VMTag::kGCOldSpaceTagId);
@@ -659,6 +736,8 @@ const char* Heap::GCReasonToString(GCReason gc_reason) {
       return "low memory";
     case kDebugging:
       return "debugging";
+    case kFinalize:
+      return "finalize";
     default:
       UNREACHABLE();
       return "";
@@ -788,15 +867,18 @@ void Heap::PrintStats() {
         "[              |                      |     |       |      "
         "| new gen     | new gen     | new gen "
         "| old gen       | old gen       | old gen     "
-        "| sweep | safe- | roots/| stbuf/| tospc/| weaks/|               ]\n"
+        "| sweep | safe- | roots/| stbuf/| tospc/| weaks/|       |       "
+        "|               | swept | swept ]\n"
         "[ GC isolate   | space (reason)       | GC# | start | time "
         "| used (kB)   | capacity kB | external"
         "| used (kB)     | capacity (kB) | external kB "
-        "| thread| point |marking| reset | sweep |swplrge| data          ]\n"
+        "| thread| point |marking| reset | sweep |swplrge| cmark | remark"
+        "| data          | demand| bkgnd ]\n"
         "[              |                      |     |  (s)  | (ms) "
         "|before| after|before| after| b4 |aftr"
         "| before| after | before| after |before| after"
-        "| (ms)  | (ms)  | (ms)  | (ms)  | (ms)  | (ms)  |               ]\n");
+        "| (ms)  | (ms)  | (ms)  | (ms)  | (ms)  | (ms)  | (ms)  | (ms)  "
+        "|               | pages | pages ]\n");
   }
 
   // clang-format off
@@ -811,8 +893,8 @@ void Heap::PrintStats() {
     "%6" Pd ", %6" Pd ", "  // old gen: in use before/after
     "%6" Pd ", %6" Pd ", "  // old gen: capacity before/after
     "%5" Pd ", %5" Pd ", "  // old gen: external before/after
-    "%6.2f, %6.2f, %6.2f, %6.2f, %6.2f, %6.2f, "  // times
-    "%" Pd ", %" Pd ", %" Pd ", %" Pd ", "  // data
+    "%6.2f, %6.2f, %6.2f, %6.2f, %6.2f, %6.2f, %6.2f, %6.2f, "  // times
+    "%" Pd ", %" Pd ", %" Pd ", %" Pd ", %" Pd ", %" Pd ", "  // data
     "]\n",  // End with a comma to make it easier to import in spreadsheets.
     isolate()->name(),
     GCTypeToString(stats_.type_),
@@ -839,10 +921,14 @@ void Heap::PrintStats() {
     MicrosecondsToMilliseconds(stats_.times_[3]),
     MicrosecondsToMilliseconds(stats_.times_[4]),
     MicrosecondsToMilliseconds(stats_.times_[5]),
+    MicrosecondsToMilliseconds(stats_.times_[6]),
+    MicrosecondsToMilliseconds(stats_.times_[7]),
     stats_.data_[0],
     stats_.data_[1],
     stats_.data_[2],
-    stats_.data_[3]);
+    stats_.data_[3],
+    stats_.data_[4],
+    stats_.data_[5]);
   // clang-format on
 #endif  // !defined(PRODUCT)
 }
@@ -56,6 +56,7 @@ class Heap {
     kIdle,       // Dart_NotifyIdle
     kLowMemory,  // Dart_NotifyLowMemory
     kDebugging,  // service request, --gc_at_instance_allocation, etc.
+    kFinalize,   // Concurrent marking finished.
   };
 
   // Pattern for unused new space and swept old space.
@@ -111,9 +112,20 @@ class Heap {
   RawObject* FindNewObject(FindObjectVisitor* visitor) const;
   RawObject* FindObject(FindObjectVisitor* visitor) const;
 
+  // Performs bounded steps of GC work, each started only if it is estimated
+  // to finish before 'deadline': a scavenge, starting or finishing a
+  // concurrent marking cycle or a full collection, sweeping pages left by
+  // --lazy_sweep, and releasing the cached new-space semispace.
   void NotifyIdle(int64_t deadline);
   void NotifyLowMemory();
 
+  // Idle time offered through NotifyIdle, the part of it spent on GC work,
+  // and how far that work ran past the deadlines.
+  intptr_t idle_notifications() const { return idle_notifications_; }
+  int64_t idle_requested_micros() const { return idle_requested_micros_; }
+  int64_t idle_used_micros() const { return idle_used_micros_; }
+  int64_t idle_overrun_micros() const { return idle_overrun_micros_; }
+
   void CollectGarbage(Space space);
   void CollectGarbage(GCType type, GCReason reason);
   void CollectAllGarbage(GCReason reason = kFull);
@@ -283,8 +295,8 @@ class Heap {
       DISALLOW_COPY_AND_ASSIGN(Data);
     };
 
-    enum { kTimeEntries = 6 };
-    enum { kDataEntries = 4 };
+    enum { kTimeEntries = 8 };
+    enum { kDataEntries = 6 };
 
     Data before_;
     Data after_;
@@ -319,9 +331,11 @@ class Heap {
   // Helper functions for garbage collection.
   void CollectNewSpaceGarbage(Thread* thread, GCReason reason);
   void CollectOldSpaceGarbage(Thread* thread, GCType type, GCReason reason);
+  void StartConcurrentMark(Thread* thread);
   void EvacuateNewSpace(Thread* thread, GCReason reason);
 
   // GC stats collection.
+  void RecordIdle(int64_t start, int64_t deadline);
   void RecordBeforeGC(GCType type, GCReason reason);
   void RecordAfterGC(GCType type);
   void PrintStats();
@@ -350,6 +364,12 @@ class Heap {
   // GC stats collection.
   GCStats stats_;
 
+  // Idle time accounting, see NotifyIdle.
+  intptr_t idle_notifications_;
+  int64_t idle_requested_micros_;
+  int64_t idle_used_micros_;
+  int64_t idle_overrun_micros_;
+
   // This heap is in read-only mode: No allocation is allowed.
   bool read_only_;
 
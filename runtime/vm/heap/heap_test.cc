@@ -13,6 +13,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, card_marking);
+
 TEST_CASE(OldGC) {
   const char* kScriptChars =
       "main() {\n"
@@ -611,4 +613,342 @@ ISOLATE_UNIT_TEST_CASE(ExternalPromotion) {
   EXPECT_EQ(size_before, size_after);
 }
 
+// Builds a graph of young objects reachable from an old array, interleaved
+// with garbage, and scavenges it with a varying number of scavenger tasks.
+ISOLATE_UNIT_TEST_CASE(ParallelScavenge) {
+  Isolate* isolate = Isolate::Current();
+  Heap* heap = isolate->heap();
+  const intptr_t saved_scavenger_tasks = FLAG_scavenger_tasks;
+  const intptr_t kNumRoots = 1000;
+  const intptr_t kChainLength = 10;
+  const intptr_t kTaskCounts[] = {0, 1, 2, 4};
+  const intptr_t kArrayWords = Array::InstanceSize(2) / kWordSize;
+  const intptr_t kLiveWords = kNumRoots * (kChainLength + 1) * kArrayWords;
+  for (intptr_t t = 0; t < static_cast<intptr_t>(ARRAY_SIZE(kTaskCounts));
+       t++) {
+    FLAG_scavenger_tasks = kTaskCounts[t];
+    heap->CollectAllGarbage();
+
+    Array& old = Array::Handle(Array::New(kNumRoots, Heap::kOld));
+    Array& neu = Array::Handle();
+    Array& next = Array::Handle();
+    Array& garbage = Array::Handle();
+    for (intptr_t i = 0; i < kNumRoots; i++) {
+      neu = Array::New(2, Heap::kNew);
+      old.SetAt(i, neu);
+      for (intptr_t j = 0; j < kChainLength; j++) {
+        next = Array::New(2, Heap::kNew);
+        garbage = Array::New(2, Heap::kNew);
+        garbage.SetAt(0, next);
+        neu.SetAt(0, next);
+        neu.SetAt(1, Smi::Handle(Smi::New(i)));
+        neu = next.raw();
+      }
+    }
+    neu = Array::null();
+    next = Array::null();
+    garbage = Array::null();
+
+    const int64_t old_before = heap->UsedInWords(Heap::kOld);
+    heap->CollectGarbage(Heap::kNew);
+
+    // Every chain survives, copied within new space or promoted, and none of
+    // the garbage does.
+    const int64_t survived = heap->UsedInWords(Heap::kNew) +
+                             heap->UsedInWords(Heap::kOld) - old_before;
+    EXPECT_LE(kLiveWords, survived);
+    EXPECT_LT(survived, kLiveWords + kLiveWords / 2);
+    EXPECT(heap->Verify());
+
+    for (intptr_t i = 0; i < kNumRoots; i++) {
+      neu ^= old.At(i);
+      for (intptr_t j = 0; j < kChainLength; j++) {
+        EXPECT_EQ(i, Smi::Value(Smi::RawCast(neu.At(1))));
+        neu ^= neu.At(0);
+      }
+      EXPECT(neu.At(0) == Object::null());
+    }
+  }
+  FLAG_scavenger_tasks = saved_scavenger_tasks;
+}
+
+ISOLATE_UNIT_TEST_CASE(IncrementalCompaction) {
+  Isolate* isolate = Isolate::Current();
+  Heap* heap = isolate->heap();
+  PageSpace* old_space = heap->old_space();
+  const bool saved_incremental_compaction = FLAG_incremental_compaction;
+  const bool saved_concurrent_sweep = FLAG_concurrent_sweep;
+  FLAG_incremental_compaction = true;
+  FLAG_concurrent_sweep = false;
+  heap->CollectAllGarbage();
+
+  // Keep every tenth of many small old objects alive.
+  const intptr_t kNumObjects = 20000;
+  const intptr_t kKeepEvery = 10;
+  Array& objects = Array::Handle(Array::New(kNumObjects, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < kNumObjects; i++) {
+    element = Array::New(8, Heap::kOld);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    objects.SetAt(i, element);
+  }
+  heap->CollectAllGarbage();
+  const int64_t capacity_before = old_space->CapacityInWords();
+  for (intptr_t i = 0; i < kNumObjects; i++) {
+    if ((i % kKeepEvery) != 0) {
+      objects.SetAt(i, Object::null_object());
+    }
+  }
+
+  heap->CollectAllGarbage();
+  EXPECT(old_space->fragmentation() > 0.0);
+  EXPECT(old_space->evacuated_pages() > 0);
+  EXPECT(old_space->evacuated_in_words() > 0);
+  EXPECT(old_space->CapacityInWords() < capacity_before);
+
+  for (intptr_t i = 0; i < kNumObjects; i += kKeepEvery) {
+    element ^= objects.At(i);
+    EXPECT_EQ(i, Smi::Value(Smi::RawCast(element.At(0))));
+  }
+
+  FLAG_incremental_compaction = saved_incremental_compaction;
+  FLAG_concurrent_sweep = saved_concurrent_sweep;
+}
+
+ISOLATE_UNIT_TEST_CASE(LazySweep) {
+  Isolate* isolate = Isolate::Current();
+  Heap* heap = isolate->heap();
+  PageSpace* old_space = heap->old_space();
+  const bool saved_lazy_sweep = FLAG_lazy_sweep;
+  FLAG_lazy_sweep = true;
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+
+  // Keep every other one of many small old objects alive, so that the pages
+  // they occupy are neither full nor empty after the next GC.
+  const intptr_t kNumObjects = 20000;
+  Array& objects = Array::Handle(Array::New(kNumObjects, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < kNumObjects; i++) {
+    element = Array::New(8, Heap::kOld);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    objects.SetAt(i, element);
+  }
+  for (intptr_t i = 1; i < kNumObjects; i += 2) {
+    objects.SetAt(i, Object::null_object());
+  }
+  heap->CollectAllGarbage();
+
+  // Allocation reuses the garbage, sweeping on demand if the sweeper tasks
+  // have not got there first.
+  for (intptr_t i = 1; i < kNumObjects; i += 2) {
+    element = Array::New(8, Heap::kOld);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    objects.SetAt(i, element);
+  }
+  heap->WaitForSweeperTasks(thread);
+  EXPECT(old_space->pages_swept_on_demand() +
+             old_space->pages_swept_in_background() >
+         0);
+  for (intptr_t i = 0; i < kNumObjects; i++) {
+    element ^= objects.At(i);
+    EXPECT_EQ(i, Smi::Value(Smi::RawCast(element.At(0))));
+  }
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+
+  // Promotion also reuses the garbage instead of growing old space.
+  for (intptr_t i = 1; i < kNumObjects; i += 2) {
+    objects.SetAt(i, Object::null_object());
+  }
+  heap->CollectAllGarbage();
+  const int64_t capacity_after_gc = heap->CapacityInWords(Heap::kOld);
+  for (intptr_t i = 1; i < kNumObjects; i += 4) {
+    element = Array::New(8, Heap::kNew);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    objects.SetAt(i, element);
+  }
+  heap->CollectGarbage(Heap::kNew);
+  heap->CollectGarbage(Heap::kNew);
+  EXPECT_LE(heap->CapacityInWords(Heap::kOld), capacity_after_gc);
+  heap->WaitForSweeperTasks(thread);
+  for (intptr_t i = 0; i < kNumObjects; i += 2) {
+    element ^= objects.At(i);
+    EXPECT_EQ(i, Smi::Value(Smi::RawCast(element.At(0))));
+  }
+  for (intptr_t i = 1; i < kNumObjects; i += 4) {
+    element ^= objects.At(i);
+    EXPECT(element.IsOld());
+    EXPECT_EQ(i, Smi::Value(Smi::RawCast(element.At(0))));
+  }
+
+  FLAG_lazy_sweep = saved_lazy_sweep;
+}
+
+ISOLATE_UNIT_TEST_CASE(NewSpacePauseTarget) {
+  Heap* heap = Isolate::Current()->heap();
+  const int saved_gc_pause_target_ms = FLAG_gc_pause_target_ms;
+  // A generous target: new space grows to its maximum.
+  FLAG_gc_pause_target_ms = 100 * 1000;
+  heap->CollectGarbage(Heap::kNew);
+  heap->CollectGarbage(Heap::kScavenge, Heap::kIdle);
+  const int64_t idle_capacity = heap->new_space()->CapacityInWords();
+  EXPECT_EQ(Utils::Minimum<int64_t>(FLAG_new_gen_semi_max_size,
+                                    FLAG_new_gen_semi_initial_size) *
+                MBInWords,
+            idle_capacity);
+
+  for (intptr_t i = 0; i < 8; i++) {
+    heap->CollectGarbage(Heap::kNew);
+  }
+  EXPECT_EQ(FLAG_new_gen_semi_max_size * MBInWords,
+            heap->new_space()->CapacityInWords());
+
+  // Idle time shrinks it back.
+  heap->CollectGarbage(Heap::kScavenge, Heap::kIdle);
+  EXPECT_EQ(idle_capacity, heap->new_space()->CapacityInWords());
+
+  FLAG_gc_pause_target_ms = saved_gc_pause_target_ms;
+}
+
+ISOLATE_UNIT_TEST_CASE(PauseGoalCompaction) {
+  Isolate* isolate = Isolate::Current();
+  Heap* heap = isolate->heap();
+  PageSpace* old_space = heap->old_space();
+  const int saved_gc_pause_target_ms = FLAG_gc_pause_target_ms;
+  const bool saved_concurrent_sweep = FLAG_concurrent_sweep;
+  FLAG_concurrent_sweep = false;
+  heap->CollectAllGarbage();
+
+  // Leave most of the pages holding these objects free but in use.
+  const intptr_t kNumObjects = 200000;
+  Array& objects = Array::Handle(Array::New(kNumObjects, Heap::kOld));
+  for (intptr_t i = 0; i < kNumObjects; i++) {
+    objects.SetAt(i, Array::Handle(Array::New(8, Heap::kOld)));
+  }
+  heap->CollectAllGarbage();
+  for (intptr_t i = 0; i < kNumObjects; i++) {
+    if ((i % 10) != 0) {
+      objects.SetAt(i, Object::null_object());
+    }
+  }
+  heap->CollectAllGarbage();
+
+  FLAG_gc_pause_target_ms = 0;
+  EXPECT(!old_space->ShouldCompact());
+  // Any realistic compaction fits a pause target of 100s.
+  FLAG_gc_pause_target_ms = 100 * 1000;
+  EXPECT(old_space->ShouldCompact());
+
+  FLAG_gc_pause_target_ms = saved_gc_pause_target_ms;
+  FLAG_concurrent_sweep = saved_concurrent_sweep;
+}
+
+class CountingPointerVisitor : public ObjectPointerVisitor {
+ public:
+  explicit CountingPointerVisitor(Isolate* isolate)
+      : ObjectPointerVisitor(isolate), count_(0) {}
+
+  void VisitPointers(RawObject** first, RawObject** last) {
+    count_ += last - first + 1;
+  }
+
+  intptr_t count() const { return count_; }
+
+ private:
+  intptr_t count_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingPointerVisitor);
+};
+
+// The slots rescanned for a few stores into a card-remembered array do not
+// depend on the length of the array.
+ISOLATE_UNIT_TEST_CASE(CardMarking) {
+  Isolate* isolate = thread->isolate();
+  Heap* heap = isolate->heap();
+  const bool saved_card_marking = FLAG_card_marking;
+  FLAG_card_marking = true;
+  const intptr_t kLengths[] = {16 * KB, 1 * MB};
+  const intptr_t kNumLengths = static_cast<intptr_t>(ARRAY_SIZE(kLengths));
+  const intptr_t kNumStores = 16;
+  intptr_t visited_slots[kNumLengths];
+  Array& element = Array::Handle();
+  for (intptr_t l = 0; l < kNumLengths; l++) {
+    const intptr_t length = kLengths[l];
+    const Array& array = Array::Handle(Array::New(length, Heap::kOld));
+    EXPECT(array.raw()->IsCardRemembered());
+    heap->CollectGarbage(Heap::kNew);
+
+    // A few new objects in slots far apart.
+    for (intptr_t i = 0; i < kNumStores; i++) {
+      const intptr_t index = i * (length / kNumStores);
+      element = Array::New(1);
+      element.SetAt(0, Smi::Handle(Smi::New(index)));
+      array.SetAt(index, element);
+    }
+    CountingPointerVisitor visitor(isolate);
+    EXPECT_EQ(kNumStores,
+              HeapPage::Of(array.raw())->VisitRememberedCards(&visitor));
+    visited_slots[l] = visitor.count();
+    EXPECT_LE(visited_slots[l],
+              kNumStores * (HeapPage::kBytesPerCard / kWordSize));
+
+    // Visiting cleaned the cards; dirty them again for the scavenger.
+    for (intptr_t i = 0; i < kNumStores; i++) {
+      const intptr_t index = i * (length / kNumStores);
+      element ^= array.At(index);
+      array.SetAt(index, element);
+    }
+    // The elements survive until they are promoted.
+    heap->CollectGarbage(Heap::kNew);
+    heap->CollectGarbage(Heap::kNew);
+    for (intptr_t i = 0; i < kNumStores; i++) {
+      const intptr_t index = i * (length / kNumStores);
+      element ^= array.At(index);
+      EXPECT_EQ(index, Smi::Value(Smi::RawCast(element.At(0))));
+    }
+  }
+  EXPECT_EQ(visited_slots[0], visited_slots[1]);
+
+  // Ordinary pages get no card table, nor do large pages of other objects.
+  const Array& small = Array::Handle(Array::New(16, Heap::kOld));
+  EXPECT(!small.raw()->IsCardRemembered());
+  EXPECT(!HeapPage::Of(small.raw())->has_card_table());
+  const String& large =
+      String::Handle(OneByteString::New(1 * MB, Heap::kOld));
+  EXPECT(!HeapPage::Of(large.raw())->has_card_table());
+  FLAG_card_marking = saved_card_marking;
+}
+
+ISOLATE_UNIT_TEST_CASE(NotifyIdle) {
+  Heap* heap = Isolate::Current()->heap();
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+
+  // A deadline that has already passed leaves no time for any step.
+  intptr_t notifications = heap->idle_notifications();
+  int64_t requested = heap->idle_requested_micros();
+  int64_t used = heap->idle_used_micros();
+  int64_t overrun = heap->idle_overrun_micros();
+  heap->NotifyIdle(OS::GetCurrentMonotonicMicros() - 1000);
+  EXPECT_EQ(notifications + 1, heap->idle_notifications());
+  EXPECT_EQ(requested, heap->idle_requested_micros());
+  EXPECT_EQ(heap->idle_used_micros() - used,
+            heap->idle_overrun_micros() - overrun);
+
+  // A generous deadline is not used up by a small heap.
+  const int64_t kIdleMicros = 10 * kMicrosecondsPerSecond;
+  notifications = heap->idle_notifications();
+  requested = heap->idle_requested_micros();
+  used = heap->idle_used_micros();
+  overrun = heap->idle_overrun_micros();
+  heap->NotifyIdle(OS::GetCurrentMonotonicMicros() + kIdleMicros);
+  EXPECT_EQ(notifications + 1, heap->idle_notifications());
+  EXPECT_LE(heap->idle_requested_micros() - requested, kIdleMicros);
+  EXPECT_LT(heap->idle_used_micros() - used,
+            heap->idle_requested_micros() - requested);
+  EXPECT_EQ(overrun, heap->idle_overrun_micros());
+  heap->WaitForSweeperTasks(thread);
+}
+
 }  // namespace dart
@@ -131,17 +131,37 @@ class MarkerWorkList : public ValueObject {
     marking_stack_ = NULL;
   }
 
+  // Like Finalize, but hands any remaining work back to the marking stack.
+  void Flush() {
+    marking_stack_->PushBlock(work_);
+    work_ = NULL;
+    marking_stack_ = NULL;
+  }
+
  private:
   MarkingStack::Block* work_;
   MarkingStack* marking_stack_;
 };
 
+// The phase of the marking cycle a visitor takes part in.
+enum MarkingPhase {
+  // The whole cycle runs in a single pause.
+  kStopTheWorldMarking,
+  // Concurrent cycle, running alongside the mutator (or in the initial pause).
+  // Neither rebuilds the store buffer nor touches write-protected code pages.
+  kConcurrentMarking,
+  // Concurrent cycle, final pause.
+  kFinalMarking,
+};
+
 template <bool sync>
 class MarkingVisitorBase : public ObjectPointerVisitor {
  public:
   MarkingVisitorBase(Isolate* isolate,
                      PageSpace* page_space,
                      MarkingStack* marking_stack,
+                     MarkingStack* deferred_marking_stack,
+                     MarkingPhase phase,
                      SkippedCodeFunctions* skipped_code_functions)
       : ObjectPointerVisitor(isolate),
         thread_(Thread::Current()),
@@ -151,6 +171,8 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 #endif  // !PRODUCT
         page_space_(page_space),
         work_list_(marking_stack),
+        deferred_work_list_(deferred_marking_stack),
+        phase_(phase),
         delayed_weak_properties_(NULL),
         visiting_old_object_(NULL),
         skipped_code_functions_(skipped_code_functions),
@@ -167,13 +189,22 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   }
 
   uintptr_t marked_bytes() const { return marked_bytes_; }
+  MarkingPhase phase() const { return phase_; }
 
 #ifndef PRODUCT
+  intptr_t num_class_stats() const { return class_stats_count_.length(); }
+
   intptr_t live_count(intptr_t class_id) {
-    return class_stats_count_[class_id];
+    return (class_id < class_stats_count_.length())
+               ? class_stats_count_[class_id]
+               : 0;
   }
 
-  intptr_t live_size(intptr_t class_id) { return class_stats_size_[class_id]; }
+  intptr_t live_size(intptr_t class_id) {
+    return (class_id < class_stats_size_.length())
+               ? class_stats_size_[class_id]
+               : 0;
+  }
 #endif  // !PRODUCT
 
   bool ProcessPendingWeakProperties() {
@@ -239,6 +270,72 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
     VisitingOldObject(NULL);
   }
 
+  // Marks the objects greyed by the write barrier and drains the marking
+  // stack, reaching a safepoint between objects. Runs alongside the mutator,
+  // so new work may keep arriving; returns once both stacks were seen empty.
+  void DrainMarkingStackConcurrently(MarkingStack* barrier_marking_stack) {
+    ASSERT(phase_ == kConcurrentMarking);
+    do {
+      ProcessBarrierMarkingStack(barrier_marking_stack);
+      RawObject* raw_obj = work_list_.Pop();
+      while (raw_obj != NULL) {
+        VisitingOldObject(raw_obj);
+        const intptr_t class_id = raw_obj->GetClassId();
+        if (class_id != kWeakPropertyCid) {
+          marked_bytes_ += raw_obj->VisitPointersNonvirtual(this);
+        } else {
+          RawWeakProperty* raw_weak =
+              reinterpret_cast<RawWeakProperty*>(raw_obj);
+          marked_bytes_ += ProcessWeakProperty(raw_weak);
+        }
+        VisitingOldObject(NULL);
+        thread_->CheckForSafepoint();
+        raw_obj = work_list_.Pop();
+      }
+    } while (ProcessPendingWeakProperties() ||
+             !barrier_marking_stack->IsEmpty());
+  }
+
+  // Marks the (possibly already marked) objects greyed by the write barrier.
+  void ProcessBarrierMarkingStack(MarkingStack* barrier_marking_stack) {
+    MarkingStack::Block* block = barrier_marking_stack->PopNonEmptyBlock();
+    while (block != NULL) {
+      while (!block->IsEmpty()) {
+        MarkObject(block->Pop(), NULL);
+      }
+      // Return the emptied block for recycling.
+      barrier_marking_stack->PushBlock(block);
+      block = barrier_marking_stack->PopNonEmptyBlock();
+    }
+  }
+
+  // Handles the objects set aside until the final pause: unmarked ones are
+  // marked as usual, marked ones had their fields initialized without a
+  // barrier and are visited again.
+  void ProcessDeferredMarkingStack(MarkingStack* deferred_marking_stack) {
+    ASSERT(phase_ == kFinalMarking);
+    MarkingStack::Block* block = deferred_marking_stack->PopNonEmptyBlock();
+    while (block != NULL) {
+      while (!block->IsEmpty()) {
+        RawObject* raw_obj = block->Pop();
+        if (!raw_obj->IsMarked()) {
+          MarkObject(raw_obj, NULL);
+        } else if (raw_obj->GetClassId() == kWeakPropertyCid) {
+          // Let the weak property be handled with the rest of the work. Its
+          // size is already accounted for by the allocation.
+          marked_bytes_ -= raw_obj->Size();
+          work_list_.Push(raw_obj);
+        } else {
+          VisitingOldObject(raw_obj);
+          raw_obj->VisitPointersNonvirtual(this);
+          VisitingOldObject(NULL);
+        }
+      }
+      deferred_marking_stack->PushBlock(block);
+      block = deferred_marking_stack->PopNonEmptyBlock();
+    }
+  }
+
   void VisitPointers(RawObject** first, RawObject** last) {
     for (RawObject** current = first; current <= last; current++) {
       MarkObject(*current, current);
@@ -278,6 +375,7 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   // Called when all marking is complete.
   void Finalize() {
     work_list_.Finalize();
+    deferred_work_list_.Finalize();
     // Detach code from functions.
     if (skipped_code_functions_ != NULL) {
       skipped_code_functions_->DetachCode();
@@ -297,6 +395,23 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
     }
   }
 
+  // Called when this visitor stops before marking is complete: hands all of
+  // its work, including the pending weak properties, back to the stacks.
+  void Flush() {
+    RawWeakProperty* cur_weak = delayed_weak_properties_;
+    delayed_weak_properties_ = NULL;
+    while (cur_weak != NULL) {
+      uword next_weak = cur_weak->ptr()->next_;
+      cur_weak->ptr()->next_ = 0;
+      // It will be accounted for again when popped.
+      marked_bytes_ -= cur_weak->Size();
+      work_list_.Push(cur_weak);
+      cur_weak = reinterpret_cast<RawWeakProperty*>(next_weak);
+    }
+    work_list_.Flush();
+    deferred_work_list_.Flush();
+  }
+
   void VisitingOldObject(RawObject* obj) {
     ASSERT((obj == NULL) || obj->IsOldObject());
     visiting_old_object_ = obj;
@@ -311,10 +426,12 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
     // Push the marked object on the marking stack.
     ASSERT(raw_obj->IsMarked());
-    // We acquired the mark bit => no other task is modifying the header.
-    // TODO(koda): For concurrent mutator, this needs synchronization. Consider
-    // clearing these bits already in the CAS for the mark bit.
-    raw_obj->ClearRememberedBitUnsynchronized();
+    if (phase_ == kStopTheWorldMarking) {
+      // We acquired the mark bit => no other task is modifying the header.
+      // A concurrent cycle keeps the store buffer, and the remembered bits
+      // with it, intact.
+      raw_obj->ClearRememberedBitUnsynchronized();
+    }
     work_list_.Push(raw_obj);
   }
 
@@ -345,7 +462,17 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
     // if (marked) return;
     // ...
     if (raw_obj->IsNewObject()) {
-      ProcessNewSpaceObject(raw_obj, p);
+      if (phase_ == kStopTheWorldMarking) {
+        ProcessNewSpaceObject(raw_obj, p);
+      }
+      return;
+    }
+
+    if ((phase_ == kConcurrentMarking) &&
+        (raw_obj->GetClassId() == kInstructionsCid)) {
+      // Instructions live in pages that may be write-protected while the
+      // mutator runs; setting their mark bit waits for the final pause.
+      deferred_work_list_.Push(raw_obj);
       return;
     }
 
@@ -353,6 +480,7 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
       // Already marked.
       return;
     }
+    HeapPage::Of(raw_obj)->add_live_bytes(raw_obj->Size());
 
 #ifndef PRODUCT
     if (RawObject::IsVariableSizeClassId(raw_obj->GetClassId())) {
@@ -376,6 +504,12 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
   void ProcessNewSpaceObject(RawObject* raw_obj, RawObject** p) {
     // TODO(iposva): Add consistency check.
+    if ((visiting_old_object_ != NULL) &&
+        visiting_old_object_->IsCardRemembered()) {
+      ASSERT(p != NULL);
+      HeapPage::Of(visiting_old_object_)->RememberCard(p);
+      return;
+    }
     if ((visiting_old_object_ != NULL) &&
         TryAcquireRememberedBit(visiting_old_object_)) {
       // NOTE: We pass in the pointer to the address we are visiting
@@ -392,8 +526,17 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
 #ifndef PRODUCT
   void UpdateLiveOld(intptr_t class_id, intptr_t size) {
-    // TODO(koda): Support growing the array once mutator runs concurrently.
-    ASSERT(class_id < class_stats_count_.length());
+    if (class_id >= class_stats_count_.length()) {
+      // The mutator registered new classes while marking ran concurrently.
+      ASSERT(phase_ != kStopTheWorldMarking);
+      const intptr_t old_length = class_stats_count_.length();
+      class_stats_count_.SetLength(class_id + 1);
+      class_stats_size_.SetLength(class_id + 1);
+      for (intptr_t i = old_length; i <= class_id; ++i) {
+        class_stats_count_[i] = 0;
+        class_stats_size_[i] = 0;
+      }
+    }
     class_stats_count_[class_id] += 1;
     class_stats_size_[class_id] += size;
   }
@@ -406,6 +549,8 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 #endif  // !PRODUCT
   PageSpace* page_space_;
   MarkerWorkList work_list_;
+  MarkerWorkList deferred_work_list_;
+  const MarkingPhase phase_;
   RawWeakProperty* delayed_weak_properties_;
   RawObject* visiting_old_object_;
   SkippedCodeFunctions* skipped_code_functions_;
@@ -460,10 +605,21 @@ class MarkingWeakVisitor : public HandleVisitor {
   DISALLOW_COPY_AND_ASSIGN(MarkingWeakVisitor);
 };
 
+GCMarker::GCMarker(Heap* heap)
+    : heap_(heap), is_concurrent_(false), marked_bytes_(0) {}
+
+GCMarker::~GCMarker() {
+  ASSERT(marking_stack_.IsEmpty());
+  ASSERT(barrier_marking_stack_.IsEmpty());
+  ASSERT(deferred_marking_stack_.IsEmpty());
+}
+
 void GCMarker::Prologue(Isolate* isolate) {
   isolate->PrepareForGC();
-  // The store buffers will be rebuilt as part of marking, reset them now.
-  isolate->store_buffer()->Reset();
+  if (!is_concurrent_) {
+    // The store buffers will be rebuilt as part of marking, reset them now.
+    isolate->store_buffer()->Reset();
+  }
 }
 
 void GCMarker::Epilogue(Isolate* isolate) {}
@@ -525,6 +681,32 @@ class ObjectIdRingClearPointerVisitor : public ObjectPointerVisitor {
   }
 };
 
+void GCMarker::FilterStoreBuffer(Isolate* isolate) {
+  StoreBuffer* store_buffer = isolate->store_buffer();
+  StoreBufferBlock* pending = store_buffer->Blocks();
+  StoreBufferBlock* survivors = store_buffer->PopEmptyBlock();
+  while (pending != NULL) {
+    StoreBufferBlock* next = pending->next();
+    // Generated code appends to store buffers; tell MemorySanitizer.
+    MSAN_UNPOISON(pending, sizeof(*pending));
+    while (!pending->IsEmpty()) {
+      RawObject* raw_object = pending->Pop();
+      ASSERT(raw_object->IsRemembered());
+      if (raw_object->IsMarked()) {
+        if (survivors->IsFull()) {
+          store_buffer->PushBlock(survivors, StoreBuffer::kIgnoreThreshold);
+          survivors = store_buffer->PopEmptyBlock();
+        }
+        survivors->Push(raw_object);
+      }
+    }
+    pending->Reset();
+    store_buffer->PushBlock(pending, StoreBuffer::kIgnoreThreshold);
+    pending = next;
+  }
+  store_buffer->PushBlock(survivors, StoreBuffer::kIgnoreThreshold);
+}
+
 void GCMarker::ProcessObjectIdTable(Isolate* isolate) {
 #ifndef PRODUCT
   if (!FLAG_support_service) {
@@ -544,6 +726,7 @@ class MarkTask : public ThreadPool::Task {
            Heap* heap,
            PageSpace* page_space,
            MarkingStack* marking_stack,
+           MarkingPhase phase,
            ThreadBarrier* barrier,
            bool collect_code,
            intptr_t task_index,
@@ -554,6 +737,7 @@ class MarkTask : public ThreadPool::Task {
         heap_(heap),
         page_space_(page_space),
         marking_stack_(marking_stack),
+        phase_(phase),
         barrier_(barrier),
         collect_code_(collect_code),
         task_index_(task_index),
@@ -572,6 +756,7 @@ class MarkTask : public ThreadPool::Task {
       SkippedCodeFunctions* skipped_code_functions =
           collect_code_ ? new (zone) SkippedCodeFunctions() : NULL;
       SyncMarkingVisitor visitor(isolate_, page_space_, marking_stack_,
+                                 &marker_->deferred_marking_stack_, phase_,
                                  skipped_code_functions);
       // Phase 1: Iterate over roots and drain marking stack in tasks.
       marker_->IterateRoots(isolate_, &visitor, task_index_, num_tasks_);
@@ -651,6 +836,7 @@ class MarkTask : public ThreadPool::Task {
   Heap* heap_;
   PageSpace* page_space_;
   MarkingStack* marking_stack_;
+  const MarkingPhase phase_;
   ThreadBarrier* barrier_;
   bool collect_code_;
   const intptr_t task_index_;
@@ -660,30 +846,172 @@ class MarkTask : public ThreadPool::Task {
   DISALLOW_COPY_AND_ASSIGN(MarkTask);
 };
 
+class ConcurrentMarkTask : public ThreadPool::Task {
+ public:
+  ConcurrentMarkTask(GCMarker* marker,
+                     Isolate* isolate,
+                     PageSpace* page_space)
+      : marker_(marker), isolate_(isolate), page_space_(page_space) {
+    MonitorLocker ml(page_space_->tasks_lock());
+    page_space_->set_tasks(page_space_->tasks() + 1);
+  }
+
+  virtual void Run() {
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kMarkerTask);
+    ASSERT(result);
+    {
+      Thread* thread = Thread::Current();
+      TIMELINE_FUNCTION_GC_DURATION(thread, "ConcurrentMark");
+      StackZone stack_zone(thread);
+      // Code is not collected by concurrent cycles.
+      SyncMarkingVisitor visitor(isolate_, page_space_, &marker_->marking_stack_,
+                                 &marker_->deferred_marking_stack_,
+                                 kConcurrentMarking, NULL);
+      visitor.DrainMarkingStackConcurrently(&marker_->barrier_marking_stack_);
+      if (FLAG_log_marker_tasks) {
+        THR_Print("Concurrent mark task marked %" Pd " bytes.\n",
+                  visitor.marked_bytes());
+      }
+      marker_->FlushResultsFrom(&visitor);
+    }
+    // Exit isolate cleanly *before* notifying it, to avoid shutdown race.
+    Thread::ExitIsolateAsHelper();
+    // This marker task is done. Notify the original isolate.
+    {
+      MonitorLocker ml(page_space_->tasks_lock());
+      page_space_->set_tasks(page_space_->tasks() - 1);
+      ml.NotifyAll();
+    }
+  }
+
+ private:
+  GCMarker* marker_;
+  Isolate* isolate_;
+  PageSpace* page_space_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentMarkTask);
+};
+
+template <class MarkingVisitorType>
+void GCMarker::AccumulateResultsFrom(MarkingVisitorType* visitor) {
+  MutexLocker ml(&stats_mutex_);
+  marked_bytes_ += visitor->marked_bytes();
+#ifndef PRODUCT
+  if (visitor->phase() == kConcurrentMarking) {
+    // The class table is owned by the mutator until the final pause.
+    const intptr_t num_cids = visitor->num_class_stats();
+    while (concurrent_live_count_.length() < num_cids) {
+      concurrent_live_count_.Add(0);
+      concurrent_live_size_.Add(0);
+    }
+    for (intptr_t i = 0; i < num_cids; ++i) {
+      concurrent_live_count_[i] += visitor->live_count(i);
+      concurrent_live_size_[i] += visitor->live_size(i);
+    }
+    return;
+  }
+  // Class heap stats are not themselves thread-safe yet, so we update the
+  // stats while holding stats_mutex_.
+  ClassTable* table = heap_->isolate()->class_table();
+  for (intptr_t i = 0; i < table->NumCids(); ++i) {
+    const intptr_t count = visitor->live_count(i);
+    if (count > 0) {
+      const intptr_t size = visitor->live_size(i);
+      table->UpdateLiveOld(i, size, count);
+    }
+  }
+#endif  // !PRODUCT
+}
+
 template <class MarkingVisitorType>
 void GCMarker::FinalizeResultsFrom(MarkingVisitorType* visitor) {
-  {
-    MutexLocker ml(&stats_mutex_);
-    marked_bytes_ += visitor->marked_bytes();
+  AccumulateResultsFrom(visitor);
+  visitor->Finalize();
+}
+
+template <class MarkingVisitorType>
+void GCMarker::FlushResultsFrom(MarkingVisitorType* visitor) {
+  // Flush first: it adjusts the visitor's count of marked bytes.
+  visitor->Flush();
+  AccumulateResultsFrom(visitor);
+}
+
 #ifndef PRODUCT
-    // Class heap stats are not themselves thread-safe yet, so we update the
-    // stats while holding stats_mutex_.
-    ClassTable* table = heap_->isolate()->class_table();
-    for (intptr_t i = 0; i < table->NumCids(); ++i) {
-      const intptr_t count = visitor->live_count(i);
-      if (count > 0) {
-        const intptr_t size = visitor->live_size(i);
-        table->UpdateLiveOld(i, size, count);
-      }
+void GCMarker::PublishConcurrentClassStats(Isolate* isolate) {
+  ClassTable* table = isolate->class_table();
+  for (intptr_t i = 0; i < concurrent_live_count_.length(); ++i) {
+    const intptr_t count = concurrent_live_count_[i];
+    if ((count > 0) && (i < table->NumCids())) {
+      table->UpdateLiveOld(i, concurrent_live_size_[i], count);
     }
+  }
+  concurrent_live_count_.Clear();
+  concurrent_live_size_.Clear();
+}
 #endif  // !PRODUCT
+
+void GCMarker::StartConcurrentMark(Isolate* isolate, PageSpace* page_space) {
+  Thread* thread = Thread::Current();
+  ASSERT(thread->IsAtSafepoint());
+  ASSERT(!is_concurrent_);
+  is_concurrent_ = true;
+  marked_bytes_ = 0;
+
+  // From now on, the write barrier greys old objects and old-space
+  // allocation is black.
+  isolate->set_marking_stack(&barrier_marking_stack_);
+  isolate->thread_registry()->AcquireMarkingStacks();
+
+  {
+    StackZone stack_zone(thread);
+    UnsyncMarkingVisitor visitor(isolate, page_space, &marking_stack_,
+                                 &deferred_marking_stack_, kConcurrentMarking,
+                                 NULL);
+    IterateRoots(isolate, &visitor, 0, 1);
+    FlushResultsFrom(&visitor);
+  }
+
+  const intptr_t num_tasks = Utils::Maximum<intptr_t>(1, FLAG_marker_tasks);
+  for (intptr_t i = 0; i < num_tasks; ++i) {
+    Dart::thread_pool()->Run(new ConcurrentMarkTask(this, isolate, page_space));
   }
-  visitor->Finalize();
+}
+
+void GCMarker::AbortConcurrentMark(Isolate* isolate) {
+  ASSERT(is_concurrent_);
+  isolate->thread_registry()->ReleaseMarkingStacks();
+  isolate->set_marking_stack(NULL);
+  marking_stack_.Reset();
+  barrier_marking_stack_.Reset();
+  deferred_marking_stack_.Reset();
+#ifndef PRODUCT
+  concurrent_live_count_.Clear();
+  concurrent_live_size_.Clear();
+#endif  // !PRODUCT
+  is_concurrent_ = false;
+}
+
+void GCMarker::DeferMarking(RawObject* raw_obj) {
+  ASSERT(is_concurrent_);
+  ASSERT(raw_obj->IsOldObject());
+  MarkingStack::Block* block = deferred_marking_stack_.PopNonFullBlock();
+  block->Push(raw_obj);
+  deferred_marking_stack_.PushBlock(block);
 }
 
 void GCMarker::MarkObjects(Isolate* isolate,
                            PageSpace* page_space,
                            bool collect_code) {
+  MarkingPhase phase = kStopTheWorldMarking;
+  if (is_concurrent_) {
+    // Stop the write barrier; all greyed objects are now in the stacks.
+    isolate->thread_registry()->ReleaseMarkingStacks();
+    isolate->set_marking_stack(NULL);
+    phase = kFinalMarking;
+    // Functions visited concurrently have had their code marked already.
+    collect_code = false;
+  }
   Prologue(isolate);
   // The API prologue/epilogue may create/destroy zones, so we must not
   // depend on zone allocations surviving beyond the epilogue callback.
@@ -691,14 +1019,25 @@ void GCMarker::MarkObjects(Isolate* isolate,
     Thread* thread = Thread::Current();
     StackZone stack_zone(thread);
     Zone* zone = stack_zone.GetZone();
-    MarkingStack marking_stack;
-    marked_bytes_ = 0;
+    MarkingStack* marking_stack = &marking_stack_;
+    if (phase == kFinalMarking) {
+      NOT_IN_PRODUCT(PublishConcurrentClassStats(isolate));
+      // Turn the barrier and deferred stacks into regular marking work.
+      UnsyncMarkingVisitor visitor(isolate, page_space, marking_stack,
+                                   &deferred_marking_stack_, phase, NULL);
+      visitor.ProcessBarrierMarkingStack(&barrier_marking_stack_);
+      visitor.ProcessDeferredMarkingStack(&deferred_marking_stack_);
+      FlushResultsFrom(&visitor);
+    } else {
+      marked_bytes_ = 0;
+    }
     const int num_tasks = FLAG_marker_tasks;
     if (num_tasks == 0) {
       // Mark everything on main thread.
       SkippedCodeFunctions* skipped_code_functions =
           collect_code ? new (zone) SkippedCodeFunctions() : NULL;
-      UnsyncMarkingVisitor mark(isolate, page_space, &marking_stack,
+      UnsyncMarkingVisitor mark(isolate, page_space, marking_stack,
+                                &deferred_marking_stack_, phase,
                                 skipped_code_functions);
       IterateRoots(isolate, &mark, 0, 1);
       mark.DrainMarkingStack();
@@ -717,8 +1056,8 @@ void GCMarker::MarkObjects(Isolate* isolate,
       // Phase 1: Iterate over roots and drain marking stack in tasks.
       for (intptr_t i = 0; i < num_tasks; ++i) {
         MarkTask* mark_task =
-            new MarkTask(this, isolate, heap_, page_space, &marking_stack,
-                         &barrier, collect_code, i, num_tasks, &num_busy);
+            new MarkTask(this, isolate, heap_, page_space, marking_stack,
+                         phase, &barrier, collect_code, i, num_tasks, &num_busy);
         ThreadPool* pool = Dart::thread_pool();
         pool->Run(mark_task);
       }
@@ -756,8 +1095,12 @@ void GCMarker::MarkObjects(Isolate* isolate,
     }
     ProcessWeakTables(page_space);
     ProcessObjectIdTable(isolate);
+    if (phase == kFinalMarking) {
+      FilterStoreBuffer(isolate);
+    }
   }
   Epilogue(isolate);
+  is_concurrent_ = false;
 }
 
 }  // namespace dart
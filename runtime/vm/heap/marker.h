@@ -6,6 +6,8 @@
 #define RUNTIME_VM_HEAP_MARKER_H_
 
 #include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/heap/store_buffer.h"
 #include "vm/os_thread.h"  // Mutex.
 
 namespace dart {
@@ -20,13 +22,36 @@ class RawWeakProperty;
 
 // The class GCMarker is used to mark reachable old generation objects as part
 // of the mark-sweep collection. The marking bit used is defined in RawObject.
-class GCMarker : public ValueObject {
+//
+// With --concurrent_mark, marking may instead be split into phases:
+// StartConcurrentMark greys the roots at a safepoint and hands the rest of the
+// work to helper tasks that run alongside the mutator. While these run, the
+// write barrier greys old objects that are stored into the heap, and objects
+// allocated in old space are allocated black. MarkObjects then finishes the
+// cycle in a final pause (remark) that rescans the roots.
+class GCMarker {
  public:
-  explicit GCMarker(Heap* heap) : heap_(heap), marked_bytes_(0) {}
-  ~GCMarker() {}
+  explicit GCMarker(Heap* heap);
+  ~GCMarker();
 
   void MarkObjects(Isolate* isolate, PageSpace* page_space, bool collect_code);
 
+  // Marks the roots and starts marking concurrently with the mutator. Must be
+  // called at a safepoint. The cycle is finished by a later call to
+  // MarkObjects, which must not happen before all concurrent tasks are done.
+  void StartConcurrentMark(Isolate* isolate, PageSpace* page_space);
+
+  // Discards the work of a concurrent cycle. Must not run concurrently with
+  // the mutator or the concurrent tasks; leaves mark bits to the caller.
+  void AbortConcurrentMark(Isolate* isolate);
+
+  // Requests that 'raw_obj' be visited again in the final pause of a
+  // concurrent cycle. Used for old objects whose fields are (or will be)
+  // initialized without a write barrier while marking is in progress.
+  void DeferMarking(RawObject* raw_obj);
+
+  bool is_concurrent() const { return is_concurrent_; }
+
   intptr_t marked_words() { return marked_bytes_ >> kWordSizeLog2; }
 
  private:
@@ -41,19 +66,47 @@ class GCMarker : public ValueObject {
   void IterateWeakReferences(Isolate* isolate, MarkingVisitorType* visitor);
   void ProcessWeakTables(PageSpace* page_space);
   void ProcessObjectIdTable(Isolate* isolate);
+  // Drops entries for objects that were found dead by a concurrent cycle,
+  // which does not rebuild the store buffer.
+  void FilterStoreBuffer(Isolate* isolate);
 
   // Called by anyone: finalize and accumulate stats from 'visitor'.
   template <class MarkingVisitorType>
   void FinalizeResultsFrom(MarkingVisitorType* visitor);
+  // Called by concurrent tasks: accumulate stats from 'visitor' and hand its
+  // remaining work back to the shared marking stacks.
+  template <class MarkingVisitorType>
+  void FlushResultsFrom(MarkingVisitorType* visitor);
+  template <class MarkingVisitorType>
+  void AccumulateResultsFrom(MarkingVisitorType* visitor);
+#ifndef PRODUCT
+  void PublishConcurrentClassStats(Isolate* isolate);
+#endif  // !PRODUCT
 
   Heap* heap_;
 
+  // Marking stacks that persist across the phases of a concurrent cycle.
+  // marking_stack_ holds grey objects. barrier_marking_stack_ receives old
+  // objects stored by the mutator while marking, and deferred_marking_stack_
+  // holds objects that may only be visited in the final pause.
+  MarkingStack marking_stack_;
+  MarkingStack barrier_marking_stack_;
+  MarkingStack deferred_marking_stack_;
+  bool is_concurrent_;
+
   Mutex stats_mutex_;
   // TODO(koda): Remove after verifying it's redundant w.r.t. ClassHeapStats.
   uintptr_t marked_bytes_;
+#ifndef PRODUCT
+  // Class stats gathered by concurrent tasks, published in the final pause
+  // after the class table's old-space counters have been reset.
+  MallocGrowableArray<intptr_t> concurrent_live_count_;
+  MallocGrowableArray<intptr_t> concurrent_live_size_;
+#endif  // !PRODUCT
 
   friend class MarkTask;
-  DISALLOW_IMPLICIT_CONSTRUCTORS(GCMarker);
+  friend class ConcurrentMarkTask;
+  DISALLOW_COPY_AND_ASSIGN(GCMarker);
 };
 
 }  // namespace dart
@@ -17,6 +17,7 @@
 #include "vm/object.h"
 #include "vm/object_set.h"
 #include "vm/os_thread.h"
+#include "vm/timeline.h"
 #include "vm/virtual_memory.h"
 
 namespace dart {
@@ -29,6 +30,11 @@ DEFINE_FLAG(int,
             old_gen_growth_time_ratio,
             3,
             "The desired maximum percentage of time spent in old gen GC");
+DEFINE_FLAG(int,
+            gc_time_target,
+            5,
+            "With --gc_pause_target_ms, the desired maximum percentage of "
+            "time spent in old gen GC");
 DEFINE_FLAG(int,
             old_gen_growth_rate,
             280,
@@ -54,6 +60,21 @@ DEFINE_FLAG(bool,
             false,
             "Always try to drop code if the function's usage counter is >= 0");
 DEFINE_FLAG(bool, log_growth, false, "Log PageSpace growth policy decisions.");
+DEFINE_FLAG(int,
+            evacuation_threshold,
+            50,
+            "With --incremental_compaction, evacuate pages that are less than "
+            "this percentage live.");
+DEFINE_FLAG(int,
+            evacuation_budget,
+            16,
+            "With --incremental_compaction, the maximum number of pages "
+            "evacuated per old-space GC.");
+DEFINE_FLAG(bool,
+            card_marking,
+            true,
+            "Remember stores into large arrays per card instead of rescanning "
+            "the whole array on every scavenge.");
 
 HeapPage* HeapPage::Allocate(intptr_t size_in_words,
                              PageType type,
@@ -72,7 +93,9 @@ HeapPage* HeapPage::Allocate(intptr_t size_in_words,
   result->memory_ = memory;
   result->next_ = NULL;
   result->used_in_bytes_ = 0;
+  result->live_bytes_ = 0;
   result->forwarding_page_ = NULL;
+  result->card_table_ = NULL;
   result->type_ = type;
 
   LSAN_REGISTER_ROOT_REGION(result, sizeof(*result));
@@ -89,6 +112,8 @@ void HeapPage::Deallocate() {
     LSAN_UNREGISTER_ROOT_REGION(this, sizeof(*this));
   }
 
+  free(card_table_);
+
   // For a regular heap pages, the memory for this object will become
   // unavailable after the delete below.
   delete memory_;
@@ -100,6 +125,56 @@ void HeapPage::Deallocate() {
   }
 }
 
+void HeapPage::AllocateCardTable() {
+  ASSERT(card_table_ == NULL);
+  ASSERT(type_ == kData);
+  card_table_ = reinterpret_cast<uint8_t*>(calloc(card_table_size(), 1));
+}
+
+intptr_t HeapPage::VisitRememberedCards(ObjectPointerVisitor* visitor) {
+  ASSERT(has_card_table());
+  RawArray* raw_array =
+      reinterpret_cast<RawArray*>(RawObject::FromAddr(object_start()));
+  ASSERT(raw_array->IsCardRemembered());
+  ASSERT(raw_array->IsArray() || raw_array->IsImmutableArray());
+  // Cards extend past the slots of the array, which may also have been
+  // truncated since its cards were dirtied.
+  RawObject** obj_from = raw_array->from();
+  RawObject** obj_to = raw_array->to(Smi::Value(raw_array->ptr()->length_));
+  const intptr_t size = card_table_size();
+  if (raw_array->IsRemembered()) {
+    // A write barrier that does not know the slot, such as the store buffer
+    // stub, remembered the whole array.
+    raw_array->ClearRememberedBit();
+    memset(card_table_, 0, size);
+    visitor->VisitPointers(obj_from, obj_to);
+    return size;
+  }
+  intptr_t cards = 0;
+  for (intptr_t i = 0; i < size; i++) {
+    if (card_table_[i] == 0) {
+      continue;
+    }
+    // Clean the card before visiting it; the visitor dirties it again if a
+    // slot still points into new space.
+    card_table_[i] = 0;
+    cards++;
+    RawObject** card_from = reinterpret_cast<RawObject**>(
+        reinterpret_cast<uword>(this) + (i << kBytesPerCardLog2));
+    RawObject** card_to = card_from + (kBytesPerCard / kWordSize) - 1;
+    if (card_from < obj_from) {
+      card_from = obj_from;
+    }
+    if (card_to > obj_to) {
+      card_to = obj_to;
+    }
+    if (card_from <= card_to) {
+      visitor->VisitPointers(card_from, card_to);
+    }
+  }
+  return cards;
+}
+
 void HeapPage::VisitObjects(ObjectVisitor* visitor) const {
   ASSERT(Thread::Current()->IsAtSafepoint());
   NoSafepointScope no_safepoint;
@@ -181,6 +256,11 @@ PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
       max_capacity_in_words_(max_capacity_in_words),
       tasks_lock_(new Monitor()),
       tasks_(0),
+      sweep_next_(NULL),
+      sweep_last_(NULL),
+      pages_sweeping_(0),
+      pages_swept_on_demand_(0),
+      pages_swept_in_background_(0),
 #if defined(DEBUG)
       iterating_thread_(NULL),
 #endif
@@ -190,7 +270,13 @@ PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
                              FLAG_old_gen_growth_time_ratio),
       gc_time_micros_(0),
       collections_(0),
-      mark_words_per_micro_(kConservativeInitialMarkSpeed) {
+      mark_words_per_micro_(kConservativeInitialMarkSpeed),
+      marker_(NULL),
+      mark_start_micros_(0),
+      used_in_words_at_mark_start_(0),
+      fragmentation_(0.0),
+      evacuated_in_words_(0),
+      evacuated_pages_(0) {
   // We aren't holding the lock but no one can reference us yet.
   UpdateMaxCapacityLocked();
   UpdateMaxUsed();
@@ -203,6 +289,7 @@ PageSpace::~PageSpace() {
       ml.Wait();
     }
   }
+  delete marker_;
   FreePages(pages_);
   FreePages(exec_pages_);
   FreePages(large_pages_);
@@ -280,6 +367,17 @@ HeapPage* PageSpace::AllocateLargePage(intptr_t size, HeapPage::PageType type) {
   return page;
 }
 
+void PageSpace::SetUpCardRemembering(RawObject* raw_array, intptr_t size) {
+  ASSERT(raw_array->IsOldObject());
+  if (!FLAG_card_marking || (size < kAllocatablePageSize)) {
+    return;
+  }
+  HeapPage* page = HeapPage::Of(raw_array);
+  ASSERT(page->object_start() == RawObject::ToAddr(raw_array));
+  page->AllocateCardTable();
+  raw_array->SetCardRememberedBit();
+}
+
 void PageSpace::TruncateLargePage(HeapPage* page,
                                   intptr_t new_object_size_in_bytes) {
   const intptr_t old_object_size_in_bytes =
@@ -729,6 +827,11 @@ void PageSpace::PrintToJSONObject(JSONObject* object) const {
   space.AddProperty64("capacity", CapacityInWords() * kWordSize);
   space.AddProperty64("external", ExternalInWords() * kWordSize);
   space.AddProperty("time", MicrosecondsToSeconds(gc_time_micros()));
+  if (FLAG_incremental_compaction) {
+    space.AddProperty("fragmentation", fragmentation());
+    space.AddProperty64("evacuated", evacuated_in_words() * kWordSize);
+    space.AddProperty("evacuatedPages", evacuated_pages());
+  }
   if (collections() > 0) {
     int64_t run_time = isolate->UptimeMicros();
     run_time = Utils::Maximum(run_time, static_cast<int64_t>(0));
@@ -926,6 +1029,13 @@ void PageSpace::CollectGarbage(bool compact) {
 
     const int64_t start = OS::GetCurrentMonotonicMicros();
 
+    // The previous lazy sweep, if any, finished along with its tasks.
+    ASSERT(sweep_next_ == NULL);
+    heap_->RecordData(kSweptOnDemand, pages_swept_on_demand_);
+    heap_->RecordData(kSweptInBackground, pages_swept_in_background_);
+    pages_swept_on_demand_ = 0;
+    pages_swept_in_background_ = 0;
+
     NOT_IN_PRODUCT(isolate->class_table()->ResetCountersOld());
     // Perform various cleanup that relies on no tasks interfering.
     isolate->class_table()->FreeOldTables();
@@ -941,7 +1051,8 @@ void PageSpace::CollectGarbage(bool compact) {
 
     if (FLAG_verify_before_gc) {
       OS::PrintErr("Verifying before marking...");
-      heap_->VerifyGC();
+      // A concurrent cycle has already marked part of the heap.
+      heap_->VerifyGC((marker_ != NULL) ? kAllowMarked : kForbidMarked);
       OS::PrintErr(" done.\n");
     }
 
@@ -958,9 +1069,34 @@ void PageSpace::CollectGarbage(bool compact) {
     bool collect_code = FLAG_collect_code && ShouldCollectCode() &&
                         !isolate->HasAttemptedReload();
 #endif  // !defined(PRODUCT)
-    GCMarker marker(heap_);
-    marker.MarkObjects(isolate, this, collect_code);
-    usage_.used_in_words = marker.marked_words();
+    const bool finish_concurrent_mark = (marker_ != NULL);
+    if (finish_concurrent_mark) {
+      TIMELINE_FUNCTION_GC_DURATION(thread, "FinishConcurrentMark");
+      // The stop-the-world part of the cycle: draining the barrier stacks
+      // and rescanning the roots.
+      const int64_t remark_start = OS::GetCurrentMonotonicMicros();
+      marker_->MarkObjects(isolate, this, collect_code);
+      heap_->RecordTime(kRemark,
+                        OS::GetCurrentMonotonicMicros() - remark_start);
+      // Objects allocated since the start of the cycle are black but were
+      // not counted by the marker. Promoted objects are counted twice, which
+      // only makes the growth heuristics slightly conservative.
+      usage_.used_in_words = Utils::Minimum<intptr_t>(
+          usage_before.used_in_words,
+          marker_->marked_words() +
+              (usage_before.used_in_words - used_in_words_at_mark_start_));
+      heap_->RecordTime(kConcurrentMark,
+                        pre_wait_for_sweepers - mark_start_micros_);
+      delete marker_;
+      marker_ = NULL;
+    } else {
+      ResetLiveBytes();
+      GCMarker marker(heap_);
+      marker.MarkObjects(isolate, this, collect_code);
+      usage_.used_in_words = marker.marked_words();
+      heap_->RecordTime(kConcurrentMark, 0);
+      heap_->RecordTime(kRemark, 0);
+    }
 
     int64_t mid1 = OS::GetCurrentMonotonicMicros();
 
@@ -1020,8 +1156,14 @@ void PageSpace::CollectGarbage(bool compact) {
       mid3 = OS::GetCurrentMonotonicMicros();
     }
 
+    if (!compact && FLAG_incremental_compaction) {
+      Evacuate(thread);
+    }
+
     if (compact) {
       Compact(thread);
+    } else if (FLAG_lazy_sweep) {
+      LazySweep(isolate);
     } else if (FLAG_concurrent_sweep) {
       ConcurrentSweep(isolate);
     } else {
@@ -1037,13 +1179,16 @@ void PageSpace::CollectGarbage(bool compact) {
     page_space_controller_.EvaluateGarbageCollection(
         usage_before, GetCurrentUsage(), start, end);
 
-    int64_t mark_micros = mid3 - start;
-    if (mark_micros == 0) {
-      mark_micros = 1;  // Prevent division by zero.
-    }
-    mark_words_per_micro_ = usage_before.used_in_words / mark_micros;
-    if (mark_words_per_micro_ == 0) {
-      mark_words_per_micro_ = 1;  // Prevent division by zero.
+    // The final pause of a concurrent cycle says little about marking speed.
+    if (!finish_concurrent_mark) {
+      int64_t mark_micros = mid3 - start;
+      if (mark_micros == 0) {
+        mark_micros = 1;  // Prevent division by zero.
+      }
+      mark_words_per_micro_ = usage_before.used_in_words / mark_micros;
+      if (mark_words_per_micro_ == 0) {
+        mark_words_per_micro_ = 1;  // Prevent division by zero.
+      }
     }
 
     heap_->RecordTime(kConcurrentSweep, pre_safe_point - pre_wait_for_sweepers);
@@ -1074,6 +1219,150 @@ void PageSpace::CollectGarbage(bool compact) {
   }
 }
 
+bool PageSpace::ShouldCompact() {
+  return PageSpaceController::UsePauseGoal() &&
+         page_space_controller_.ShouldCompact(usage_, mark_words_per_micro_);
+}
+
+bool PageSpace::ShouldStartConcurrentMark() {
+  if (marker_ != NULL) {
+    return false;
+  }
+  // Only generated code on x64 has the marking write barrier.
+  if (!FLAG_concurrent_mark) {
+    return false;
+  }
+  // Start early enough for marking to finish before the next full collection
+  // would be needed.
+  return page_space_controller_.NeedsIdleGarbageCollection(usage_);
+}
+
+bool PageSpace::ShouldMarkAfterScavenge() {
+  if (FLAG_concurrent_mark || !PageSpaceController::UsePauseGoal()) {
+    return false;
+  }
+  return page_space_controller_.ShouldMarkAfterScavenge(usage_,
+                                                        mark_words_per_micro_);
+}
+
+bool PageSpace::ShouldFinishConcurrentMark() {
+  if (marker_ == NULL) {
+    return false;
+  }
+  MonitorLocker ml(tasks_lock());
+  return tasks() == 0;
+}
+
+// Both pauses of a concurrent cycle scan the roots, which are dominated by new
+// space; the old-space work happens in between, off the mutator thread.
+static int64_t EstimatedRootScanMicros(Heap* heap,
+                                       intptr_t mark_words_per_micro) {
+  return heap->UsedInWords(Heap::kNew) / mark_words_per_micro;
+}
+
+bool PageSpace::ShouldStartIdleConcurrentMark(int64_t deadline) {
+  NoSafepointScope no_safepoint;
+  // Idle time too short for a full mark-sweep can still start a cycle for a
+  // later notification, or the next collection, to finish. Like any cycle, it
+  // needs the marking write barrier of --concurrent_mark.
+  if (!FLAG_concurrent_mark || (marker_ != NULL) ||
+      !page_space_controller_.NeedsIdleGarbageCollection(usage_)) {
+    return false;
+  }
+  {
+    MonitorLocker locker(tasks_lock());
+    if (tasks() > 0) {
+      return false;
+    }
+  }
+  return OS::GetCurrentMonotonicMicros() +
+             EstimatedRootScanMicros(heap_, mark_words_per_micro_) <=
+         deadline;
+}
+
+bool PageSpace::ShouldFinishIdleConcurrentMark(int64_t deadline) {
+  NoSafepointScope no_safepoint;
+  if (!ShouldFinishConcurrentMark()) {
+    // Still marking; finishing now would wait for the marker tasks.
+    return false;
+  }
+  return OS::GetCurrentMonotonicMicros() +
+             EstimatedRootScanMicros(heap_, mark_words_per_micro_) <=
+         deadline;
+}
+
+void PageSpace::StartConcurrentMark() {
+  Thread* thread = Thread::Current();
+  Isolate* isolate = heap_->isolate();
+  ASSERT(isolate == Isolate::Current());
+  // Generated code only has the marking write barrier with the flag.
+  ASSERT(FLAG_concurrent_mark);
+
+  // Do not wait for pending tasks (e.g., sweepers); try again later instead.
+  {
+    MonitorLocker locker(tasks_lock());
+    if (tasks() > 0) {
+      return;
+    }
+    set_tasks(1);
+  }
+
+  {
+    SafepointOperationScope safepoint_scope(thread);
+    // Another thread may have started the cycle while we were waiting.
+    if (marker_ == NULL) {
+      TIMELINE_FUNCTION_GC_DURATION(thread, "StartConcurrentMark");
+      NoSafepointScope no_safepoints;
+      mark_start_micros_ = OS::GetCurrentMonotonicMicros();
+      used_in_words_at_mark_start_ = GetCurrentUsage().used_in_words;
+      ResetLiveBytes();
+      marker_ = new GCMarker(heap_);
+      marker_->StartConcurrentMark(isolate, this);
+    }
+  }
+
+  {
+    MonitorLocker ml(tasks_lock());
+    set_tasks(tasks() - 1);
+    ml.NotifyAll();
+  }
+}
+
+class ClearMarkBitsVisitor : public ObjectVisitor {
+ public:
+  ClearMarkBitsVisitor() {}
+
+  void VisitObject(RawObject* raw_obj) {
+    if (raw_obj->IsMarked()) {
+      raw_obj->ClearMarkBit();
+    }
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ClearMarkBitsVisitor);
+};
+
+void PageSpace::AbortConcurrentMark() {
+  if (marker_ == NULL) {
+    return;
+  }
+  // The caller has waited for the marker tasks to finish.
+  marker_->AbortConcurrentMark(heap_->isolate());
+  delete marker_;
+  marker_ = NULL;
+  // Objects in image pages stay marked.
+  WriteProtectCode(false);
+  ClearMarkBitsVisitor visitor;
+  VisitObjectsNoImagePages(&visitor);
+  WriteProtectCode(true);
+}
+
+void PageSpace::DeferMarking(RawObject* raw_obj) {
+  if (marker_ != NULL) {
+    marker_->DeferMarking(raw_obj);
+  }
+}
+
 void PageSpace::BlockingSweep() {
   MutexLocker mld(freelist_[HeapPage::kData].mutex());
   MutexLocker mle(freelist_[HeapPage::kExecutable].mutex());
@@ -1107,6 +1396,142 @@ void PageSpace::ConcurrentSweep(Isolate* isolate) {
                              &freelist_[HeapPage::kData]);
 }
 
+void PageSpace::LazySweep(Isolate* isolate) {
+  {
+    MonitorLocker ml(tasks_lock());
+    sweep_next_ = pages_;
+    sweep_last_ = pages_tail_;
+    pages_sweeping_ = 0;
+    pages_swept_on_demand_ = 0;
+    pages_swept_in_background_ = 0;
+  }
+  if (pages_ != NULL) {
+    GCSweeper::SweepLazily(isolate, FLAG_sweeper_tasks);
+  }
+}
+
+HeapPage* PageSpace::ClaimUnsweptPage() {
+  MonitorLocker ml(tasks_lock());
+  HeapPage* page = sweep_next_;
+  if (page != NULL) {
+    // Pages appended since the GC are not swept, and sweep_last_->next() may
+    // be changing under us.
+    sweep_next_ = (page == sweep_last_) ? NULL : page->next();
+    pages_sweeping_++;
+  }
+  return page;
+}
+
+void PageSpace::SweepClaimedPage(HeapPage* page,
+                                 bool on_demand,
+                                 bool is_locked) {
+  ASSERT(page->type() == HeapPage::kData);
+  // A page without live objects is left out of the freelist; it is released
+  // once every page has been swept, when nobody else walks the page list.
+  GCSweeper sweeper;
+  sweeper.SweepPage(page, &freelist_[HeapPage::kData], is_locked);
+
+  HeapPage* last = NULL;
+  {
+    MonitorLocker ml(tasks_lock());
+    pages_sweeping_--;
+    if (on_demand) {
+      pages_swept_on_demand_++;
+    } else {
+      pages_swept_in_background_++;
+    }
+    if ((sweep_next_ == NULL) && (pages_sweeping_ == 0) &&
+        (sweep_last_ != NULL)) {
+      last = sweep_last_;
+      sweep_last_ = NULL;
+    }
+    // Notify waiting allocations that we have added elements to the free
+    // list.
+    ml.NotifyAll();
+  }
+  if (last != NULL) {
+    FreeEmptyPages(last);
+  }
+}
+
+intptr_t PageSpace::SweepUntil(int64_t deadline) {
+  intptr_t swept = 0;
+  HeapPage* page;
+  while ((OS::GetCurrentMonotonicMicros() < deadline) &&
+         ((page = ClaimUnsweptPage()) != NULL)) {
+    SweepClaimedPage(page, /* on_demand = */ false, /* is_locked = */ false);
+    swept++;
+  }
+  return swept;
+}
+
+void PageSpace::FreeEmptyPages(HeapPage* last) {
+  HeapPage* empty_pages = NULL;
+  {
+    MutexLocker ml(pages_lock_);
+    HeapPage* prev_page = NULL;
+    HeapPage* page = pages_;
+    while (page != NULL) {
+      HeapPage* next_page = page->next();
+      const bool is_last = (page == last);
+      if (page->used_in_bytes() == 0) {
+        IncreaseCapacityInWordsLocked(
+            -(page->memory_->size() >> kWordSizeLog2));
+        if (prev_page != NULL) {
+          prev_page->set_next(next_page);
+        } else {
+          pages_ = next_page;
+        }
+        if (page == pages_tail_) {
+          pages_tail_ = prev_page;
+        }
+        page->set_next(empty_pages);
+        empty_pages = page;
+      } else {
+        prev_page = page;
+      }
+      if (is_last) break;
+      page = next_page;
+    }
+  }
+  FreePages(empty_pages);
+}
+
+uword PageSpace::TryAllocateSweepingOnDemand(intptr_t size,
+                                             HeapPage::PageType type) {
+  if ((type != HeapPage::kData) || (size >= kAllocatablePageSize)) {
+    return 0;
+  }
+  HeapPage* page;
+  while ((page = ClaimUnsweptPage()) != NULL) {
+    SweepClaimedPage(page, /* on_demand = */ true, /* is_locked = */ false);
+    uword result = freelist_[type].TryAllocate(size, false);
+    if (result != 0) {
+      AtomicOperations::IncrementBy(&(usage_.used_in_words),
+                                    (size >> kWordSizeLog2));
+      return result;
+    }
+  }
+  return 0;
+}
+
+uword PageSpace::TryAllocateSweepingOnDemandLocked(intptr_t size) {
+  if (size >= kAllocatablePageSize) {
+    return 0;
+  }
+  HeapPage* page;
+  while ((page = ClaimUnsweptPage()) != NULL) {
+    SweepClaimedPage(page, /* on_demand = */ true, /* is_locked = */ true);
+    uword result = freelist_[HeapPage::kData].TryAllocateLocked(size, false);
+    if (result != 0) {
+      AtomicOperations::IncrementBy(&(usage_.used_in_words),
+                                    (size >> kWordSizeLog2));
+      return result;
+    }
+  }
+  return 0;
+}
+
 void PageSpace::Compact(Thread* thread) {
   thread->isolate()->set_compaction_in_progress(true);
   GCCompactor compactor(thread, heap_);
@@ -1120,6 +1545,126 @@ void PageSpace::Compact(Thread* thread) {
   }
 }
 
+void PageSpace::ResetLiveBytes() {
+  for (HeapPage* page = pages_; page != NULL; page = page->next()) {
+    page->set_live_bytes(0);
+  }
+  for (HeapPage* page = exec_pages_; page != NULL; page = page->next()) {
+    page->set_live_bytes(0);
+  }
+  for (HeapPage* page = large_pages_; page != NULL; page = page->next()) {
+    page->set_live_bytes(0);
+  }
+}
+
+static int CompareLiveBytes(HeapPage* const* a, HeapPage* const* b) {
+  const intptr_t a_live = (*a)->live_bytes();
+  const intptr_t b_live = (*b)->live_bytes();
+  return (a_live < b_live) ? -1 : ((a_live > b_live) ? 1 : 0);
+}
+
+// Picks the sparsest data pages by the live bytes the marker counted and
+// moves their objects elsewhere so the pages can be released. The number of
+// pages per collection is bounded, so a badly fragmented heap is compacted
+// over several collections without the pause of a full mark-compact.
+void PageSpace::Evacuate(Thread* thread) {
+  TIMELINE_FUNCTION_GC_DURATION(thread, "Evacuate");
+  MallocGrowableArray<HeapPage*> candidates;
+  intptr_t capacity_in_bytes = 0;
+  intptr_t live_in_bytes = 0;
+  for (HeapPage* page = pages_; page != NULL; page = page->next()) {
+    const intptr_t page_live_in_bytes = page->live_bytes();
+    const intptr_t page_capacity_in_bytes =
+        page->object_end() - page->object_start();
+    capacity_in_bytes += page_capacity_in_bytes;
+    live_in_bytes += page_live_in_bytes;
+    if ((page_live_in_bytes * 100) <
+        (page_capacity_in_bytes * FLAG_evacuation_threshold)) {
+      candidates.Add(page);
+    }
+  }
+  fragmentation_ =
+      (capacity_in_bytes == 0)
+          ? 0.0
+          : (100.0 * (capacity_in_bytes - live_in_bytes)) / capacity_in_bytes;
+  evacuated_in_words_ = 0;
+  evacuated_pages_ = 0;
+
+  // Take the sparsest pages first, but only as many as will fit into fewer
+  // fresh pages; moving one page's worth of objects releases nothing.
+  candidates.Sort(CompareLiveBytes);
+  const intptr_t page_capacity_in_bytes =
+      kPageSize - HeapPage::ObjectStartOffset();
+  intptr_t num_evacuated = 0;
+  intptr_t evacuated_live_in_bytes = 0;
+  for (intptr_t i = 0;
+       (i < candidates.length()) && (i < FLAG_evacuation_budget); i++) {
+    evacuated_live_in_bytes += candidates[i]->live_bytes();
+    if (evacuated_live_in_bytes < (i * page_capacity_in_bytes)) {
+      num_evacuated = i + 1;
+    }
+  }
+  if (num_evacuated == 0) {
+    return;
+  }
+  candidates.TruncateTo(num_evacuated);
+
+  // Unlink the evacuated pages.
+  HeapPage* evacuated = NULL;
+  {
+    MutexLocker ml(pages_lock_);
+    HeapPage* prev_page = NULL;
+    HeapPage* page = pages_;
+    while (page != NULL) {
+      HeapPage* next_page = page->next();
+      bool is_candidate = false;
+      for (intptr_t i = 0; i < candidates.length(); i++) {
+        if (candidates[i] == page) {
+          is_candidate = true;
+          break;
+        }
+      }
+      if (is_candidate) {
+        if (prev_page != NULL) {
+          prev_page->set_next(next_page);
+        } else {
+          pages_ = next_page;
+        }
+        page->set_next(evacuated);
+        evacuated = page;
+      } else {
+        prev_page = page;
+      }
+      page = next_page;
+    }
+    pages_tail_ = prev_page;
+  }
+
+  thread->isolate()->set_compaction_in_progress(true);
+  GCCompactor compactor(thread, heap_);
+  const intptr_t moved_in_bytes = compactor.Evacuate(evacuated);
+  thread->isolate()->set_compaction_in_progress(false);
+
+  if (moved_in_bytes < 0) {
+    // Could not allocate a fresh page; keep the pages where they are.
+    MutexLocker ml(pages_lock_);
+    while (evacuated != NULL) {
+      HeapPage* next_page = evacuated->next();
+      evacuated->set_next(NULL);
+      if (pages_ == NULL) {
+        pages_ = evacuated;
+      } else {
+        pages_tail_->set_next(evacuated);
+      }
+      pages_tail_ = evacuated;
+      evacuated = next_page;
+    }
+    return;
+  }
+  evacuated_in_words_ = moved_in_bytes >> kWordSizeLog2;
+  evacuated_pages_ = num_evacuated;
+}
+
 uword PageSpace::TryAllocateDataBumpInternal(intptr_t size,
                                              GrowthPolicy growth_policy,
                                              bool is_locked) {
@@ -1181,6 +1726,51 @@ uword PageSpace::TryAllocateDataBumpLocked(intptr_t size,
   return TryAllocateDataBumpInternal(size, growth_policy, true);
 }
 
+uword PageSpace::TryAllocateThreadLocal(Thread* thread, intptr_t size) {
+  ASSERT(size >= kObjectAlignment);
+  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+  if (size > kMaxThreadLocalAllocationSize) {
+    return 0;
+  }
+  uword result = thread->old_top();
+  intptr_t remaining = thread->old_end() - result;
+  if (remaining < size) {
+    AbandonThreadLocalBuffer(thread);
+    // The whole buffer counts as used until it is abandoned.
+    const bool is_protected = false;
+    const bool is_locked = false;
+    result = TryAllocateInternal(kThreadLocalBufferSize, HeapPage::kData,
+                                 kControlGrowth, is_protected, is_locked);
+    if (result == 0) {
+      return 0;
+    }
+    thread->set_old_end(result + kThreadLocalBufferSize);
+    remaining = kThreadLocalBufferSize;
+  }
+  ASSERT(remaining >= size);
+  thread->set_old_top(result + size);
+#ifdef DEBUG
+  if (remaining > size) {
+    // Fail fast if we try to walk the remaining buffer.
+    COMPILE_ASSERT(kIllegalCid == 0);
+    *reinterpret_cast<uword*>(result + size) = 0;
+  }
+#endif  // DEBUG
+  return result;
+}
+
+void PageSpace::AbandonThreadLocalBuffer(Thread* thread) {
+  const uword top = thread->old_top();
+  const uword end = thread->old_end();
+  if (top < end) {
+    freelist_[HeapPage::kData].Free(top, end - top);
+    AtomicOperations::DecrementBy(&(usage_.used_in_words),
+                                  ((end - top) >> kWordSizeLog2));
+  }
+  thread->set_old_top(0);
+  thread->set_old_end(0);
+}
+
 uword PageSpace::TryAllocatePromoLocked(intptr_t size,
                                         GrowthPolicy growth_policy) {
   FreeList* freelist = &freelist_[HeapPage::kData];
@@ -1190,11 +1780,30 @@ uword PageSpace::TryAllocatePromoLocked(intptr_t size,
                                   (size >> kWordSizeLog2));
     return result;
   }
+  if (static_cast<intptr_t>(bump_end_ - bump_top_) < size) {
+    // Refilling the bump block may need a fresh page. Use the free blocks
+    // already on the freelist, then those in the pages left by a lazy sweep,
+    // before growing the heap.
+    result = freelist->TryAllocateLocked(size, false);
+    if (result != 0) {
+      AtomicOperations::IncrementBy(&(usage_.used_in_words),
+                                    (size >> kWordSizeLog2));
+      return result;
+    }
+    result = TryAllocateSweepingOnDemandLocked(size);
+    if (result != 0) return result;
+  }
   result = TryAllocateDataBumpLocked(size, growth_policy);
   if (result != 0) return result;
   return TryAllocateDataLocked(size, growth_policy);
 }
 
+void PageSpace::FreePromoLocked(uword addr, intptr_t size) {
+  freelist_[HeapPage::kData].FreeLocked(addr, size);
+  AtomicOperations::DecrementBy(&(usage_.used_in_words),
+                                (size >> kWordSizeLog2));
+}
+
 void PageSpace::SetupImagePage(void* pointer, uword size, bool is_executable) {
   // Setup a HeapPage so precompiled Instructions can be traversed.
   // Instructions are contiguous at [pointer, pointer + size). HeapPage
@@ -1212,6 +1821,7 @@ void PageSpace::SetupImagePage(void* pointer, uword size, bool is_executable) {
   page->object_end_ = memory->end();
   page->used_in_bytes_ = page->object_end_ - page->object_start();
   page->forwarding_page_ = NULL;
+  page->card_table_ = NULL;
   if (is_executable) {
     ASSERT(Utils::IsAligned(pointer, OS::PreferredCodeAlignment()));
     page->type_ = HeapPage::kExecutable;
@@ -1235,7 +1845,8 @@ PageSpaceController::PageSpaceController(Heap* heap,
       heap_growth_max_(heap_growth_max),
       garbage_collection_time_ratio_(garbage_collection_time_ratio),
       last_code_collection_in_us_(OS::GetCurrentMonotonicMicros()),
-      idle_gc_threshold_in_words_(0) {
+      idle_gc_threshold_in_words_(0),
+      last_gc_end_micros_(OS::GetCurrentMonotonicMicros()) {
   intptr_t grow_heap = heap_growth_max / 2;
   gc_threshold_in_words_ =
       last_usage_.capacity_in_words + (kPageSizeInWords * grow_heap);
@@ -1277,7 +1888,9 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
   const intptr_t allocated_since_previous_gc =
       before.CombinedUsedInWords() - last_usage_.CombinedUsedInWords();
   intptr_t grow_heap;
-  if (allocated_since_previous_gc > 0) {
+  if (UsePauseGoal()) {
+    grow_heap = PauseGoalGrowthInPages(before, start, end);
+  } else if (allocated_since_previous_gc > 0) {
     const intptr_t garbage =
         before.CombinedUsedInWords() - after.CombinedUsedInWords();
     ASSERT(garbage >= 0);
@@ -1350,6 +1963,7 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
   grow_heap = Utils::Maximum(grow_heap, freed_pages / 2);
   heap_->RecordData(PageSpace::kAllowedGrowth, grow_heap);
   last_usage_ = after;
+  last_gc_end_micros_ = end;
 
   // Save final threshold compared before growing.
   gc_threshold_in_words_ =
@@ -1367,6 +1981,106 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
   }
 }
 
+bool PageSpaceController::UsePauseGoal() {
+  return FLAG_gc_pause_target_ms > 0;
+}
+
+// Estimated pause of marking the used part of the heap at the given speed.
+static int64_t EstimatedMarkMicros(SpaceUsage current,
+                                   intptr_t mark_words_per_micro) {
+  return current.used_in_words /
+         Utils::Maximum<intptr_t>(mark_words_per_micro, 1);
+}
+
+bool PageSpaceController::ShouldCompact(SpaceUsage current,
+                                        intptr_t mark_words_per_micro) const {
+  ASSERT(UsePauseGoal());
+  // Compaction is only worth its extra pause on a fragmented heap. Discount
+  // two pages for the newest data and code pages, as in idle GC.
+  const intptr_t excess_in_words = current.capacity_in_words -
+                                   current.used_in_words -
+                                   2 * kPageSizeInWords;
+  if (excess_in_words < (current.capacity_in_words / 4)) {
+    return false;
+  }
+  // Assuming compaction takes as long as marking.
+  const int64_t estimated_pause_micros =
+      2 * EstimatedMarkMicros(current, mark_words_per_micro);
+  const bool compact = estimated_pause_micros <=
+                       FLAG_gc_pause_target_ms * kMicrosecondsPerMillisecond;
+  ReportDecision(compact ? "MarkCompact" : "MarkSweep", estimated_pause_micros,
+                 0);
+  return compact;
+}
+
+bool PageSpaceController::ShouldMarkAfterScavenge(
+    SpaceUsage current,
+    intptr_t mark_words_per_micro) const {
+  ASSERT(UsePauseGoal());
+  if (!NeedsIdleGarbageCollection(current)) {
+    return false;
+  }
+  const int64_t estimated_pause_micros =
+      EstimatedMarkMicros(current, mark_words_per_micro);
+  const bool mark = estimated_pause_micros <=
+                    FLAG_gc_pause_target_ms * kMicrosecondsPerMillisecond;
+  ReportDecision(mark ? "Mark" : "Scavenge", estimated_pause_micros, 0);
+  return mark;
+}
+
+// For a time fraction f in GC, a GC of length p must be followed by p(1-f)/f
+// of mutator time, during which the mutator allocates at the rate measured
+// since the previous GC.
+intptr_t PageSpaceController::PauseGoalGrowthInPages(SpaceUsage before,
+                                                     int64_t start,
+                                                     int64_t end) const {
+  const intptr_t allocated_in_words =
+      before.CombinedUsedInWords() - last_usage_.CombinedUsedInWords();
+  const int64_t mutator_micros = start - last_gc_end_micros_;
+  intptr_t grow_pages;
+  if ((allocated_in_words <= 0) || (mutator_micros <= 0)) {
+    // Nothing to go by; fall back to the maximum growth step.
+    grow_pages = heap_growth_max_;
+  } else {
+    const double words_per_micro =
+        allocated_in_words / static_cast<double>(mutator_micros);
+    const double f =
+        Utils::Minimum(Utils::Maximum(FLAG_gc_time_target, 1), 99) / 100.0;
+    const double headroom_in_words =
+        words_per_micro * (end - start) * (1.0 - f) / f;
+    grow_pages =
+        static_cast<intptr_t>(headroom_in_words / kPageSizeInWords) + 1;
+  }
+  ReportDecision("Grow", end - start, grow_pages);
+  return grow_pages;
+}
+
+void PageSpaceController::ReportDecision(const char* decision,
+                                         int64_t estimated_pause_micros,
+                                         intptr_t grow_pages) const {
+  if (FLAG_log_growth) {
+    THR_Print("%s: %s, pause=%" Pd64 "us, grow=%" Pd " pages\n",
+              heap_->isolate()->name(), decision, estimated_pause_micros,
+              grow_pages);
+  }
+#if !defined(PRODUCT)
+  TimelineStream* stream = Timeline::GetGCStream();
+  ASSERT(stream != NULL);
+  TimelineEvent* event = stream->StartEvent();
+  if (event != NULL) {
+    event->Instant("GCDecision");
+    event->SetNumArguments(4);
+    event->CopyArgument(0, "Decision", decision);
+    event->FormatArgument(1, "EstimatedPause (us)", "%" Pd64,
+                          estimated_pause_micros);
+    event->FormatArgument(2, "PauseTarget (ms)", "%d",
+                          FLAG_gc_pause_target_ms);
+    event->FormatArgument(3, "Growth (pages)", "%" Pd, grow_pages);
+    event->Complete();
+  }
+#endif  // !defined(PRODUCT)
+}
+
 void PageSpaceGarbageCollectionHistory::AddGarbageCollectionTime(int64_t start,
                                                                  int64_t end) {
   Entry entry;
@@ -20,6 +20,7 @@ DECLARE_FLAG(bool, always_drop_code);
 DECLARE_FLAG(bool, write_protect_code);
 
 // Forward declarations.
+class GCMarker;
 class Heap;
 class JSONObject;
 class ObjectPointerVisitor;
@@ -49,6 +50,14 @@ class HeapPage {
     used_in_bytes_ = value;
   }
 
+  // Bytes of the objects marked on this page during the current or last
+  // marking, including the objects allocated black while marking.
+  intptr_t live_bytes() const { return live_bytes_; }
+  void set_live_bytes(intptr_t value) { live_bytes_ = value; }
+  void add_live_bytes(intptr_t value) {
+    AtomicOperations::IncrementBy(&live_bytes_, value);
+  }
+
   ForwardingPage* forwarding_page() const { return forwarding_page_; }
   ForwardingPage* AllocateForwardingPage();
   void FreeForwardingPage();
@@ -81,12 +90,42 @@ class HeapPage {
     return reinterpret_cast<HeapPage*>(addr & kPageMask);
   }
 
+  // Large data pages keep one card per kBytesPerCard bytes of the page. A
+  // store of a new-space object into a card-remembered array dirties the card
+  // covering the slot, and the scavenger rescans only the dirty cards.
+  static const intptr_t kBytesPerCardLog2 = 9;
+  static const intptr_t kBytesPerCard = 1 << kBytesPerCardLog2;
+
+  bool has_card_table() const { return card_table_ != NULL; }
+
+  void RememberCard(RawObject* const* slot) {
+    ASSERT(Contains(reinterpret_cast<uword>(slot)));
+    ASSERT(has_card_table());
+    intptr_t index =
+        (reinterpret_cast<uword>(slot) - reinterpret_cast<uword>(this)) >>
+        kBytesPerCardLog2;
+    card_table_[index] = 1;
+  }
+
+  // Cleans the dirty cards of the card-remembered array on this page and
+  // visits the slots they cover. Returns the number of dirty cards.
+  intptr_t VisitRememberedCards(ObjectPointerVisitor* visitor);
+
+  static intptr_t card_table_offset() {
+    return OFFSET_OF(HeapPage, card_table_);
+  }
+
  private:
   void set_object_end(uword value) {
     ASSERT((value & kObjectAlignmentMask) == kOldObjectAlignmentOffset);
     object_end_ = value;
   }
 
+  intptr_t card_table_size() const {
+    return Utils::RoundUp(memory_->size(), kBytesPerCard) >> kBytesPerCardLog2;
+  }
+  void AllocateCardTable();
+
   // Returns NULL on OOM.
   static HeapPage* Allocate(intptr_t size_in_words,
                             PageType type,
@@ -100,7 +139,9 @@ class HeapPage {
   HeapPage* next_;
   uword object_end_;
   uword used_in_bytes_;
+  intptr_t live_bytes_;
   ForwardingPage* forwarding_page_;
+  uint8_t* card_table_;
   PageType type_;
 
   friend class PageSpace;
@@ -171,7 +212,27 @@ class PageSpaceController {
   void Disable() { is_enabled_ = false; }
   bool is_enabled() { return is_enabled_; }
 
+  // Pause-goal mode (--gc_pause_target_ms). Instead of the fixed growth
+  // ratios, the heap grows just enough to keep the time spent in GC below
+  // --gc_time_target, and the kind of collection is chosen by estimating its
+  // pause from the measured marking speed. Decisions are reported as
+  // "GCDecision" timeline events.
+  static bool UsePauseGoal();
+  bool ShouldCompact(SpaceUsage current, intptr_t mark_words_per_micro) const;
+  // Whether to mark old space right after a scavenge, once it nears its
+  // threshold, because the marking pause fits the target. Otherwise the
+  // scavenges continue until the threshold is reached.
+  bool ShouldMarkAfterScavenge(SpaceUsage current,
+                               intptr_t mark_words_per_micro) const;
+
  private:
+  intptr_t PauseGoalGrowthInPages(SpaceUsage before,
+                                  int64_t start,
+                                  int64_t end) const;
+  void ReportDecision(const char* decision,
+                      int64_t estimated_pause_micros,
+                      intptr_t grow_pages) const;
+
   Heap* heap_;
 
   bool is_enabled_;
@@ -207,6 +268,9 @@ class PageSpaceController {
   // Start considering idle GC when capacity exceeds this amount.
   intptr_t idle_gc_threshold_in_words_;
 
+  // End of the last evaluated GC, for measuring the allocation rate.
+  int64_t last_gc_end_micros_;
+
   PageSpaceGarbageCollectionHistory history_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(PageSpaceController);
@@ -267,6 +331,33 @@ class PageSpace {
   void VisitObjectsImagePages(ObjectVisitor* visitor) const;
   void VisitObjectPointers(ObjectPointerVisitor* visitor) const;
 
+  // Visits the dirty cards of the card-remembered arrays in large pages,
+  // telling the visitor which array it is in. The scavenger calls this while
+  // promoting into this space, so the large page list is walked without the
+  // pages lock; promotion only ever prepends to it. Returns the number of
+  // dirty cards.
+  template <class Visitor>
+  intptr_t VisitRememberedCards(Visitor* visitor) const {
+    intptr_t cards = 0;
+    for (HeapPage* page = large_pages_; page != NULL; page = page->next()) {
+      if (!page->has_card_table()) {
+        continue;
+      }
+      RawObject* raw_obj = RawObject::FromAddr(page->object_start());
+      if (raw_obj->IsCardRemembered()) {
+        visitor->VisitingOldObject(raw_obj);
+        cards += page->VisitRememberedCards(visitor);
+      }
+    }
+    visitor->VisitingOldObject(NULL);
+    return cards;
+  }
+
+  // Remembers stores into the new old-space array 'raw_array' of 'size'
+  // bytes per card if it got a large page of its own, allocating the card
+  // table of that page. Pages of other objects never get a card table.
+  static void SetUpCardRemembering(RawObject* raw_array, intptr_t size);
+
   RawObject* FindObject(FindObjectVisitor* visitor,
                         HeapPage::PageType type) const;
 
@@ -275,8 +366,29 @@ class PageSpace {
   bool ShouldCollectCode();
 
   // Collect the garbage in the page space using mark-sweep or mark-compact.
+  // Finishes the concurrent marking cycle, if one is in progress.
   void CollectGarbage(bool compact);
 
+  // Whether a collection requested as a mark-sweep should compact instead,
+  // when running with a pause goal.
+  bool ShouldCompact();
+  // Without --concurrent_mark, whether a pause goal calls for a full mark
+  // right after a scavenge.
+  bool ShouldMarkAfterScavenge();
+
+  // Concurrent marking (--concurrent_mark). A cycle is started at a
+  // safepoint, marks alongside the mutator, and is finished by the next call
+  // to CollectGarbage.
+  bool ShouldStartConcurrentMark();
+  bool ShouldFinishConcurrentMark();
+  void StartConcurrentMark();
+  // Discards a cycle in progress, e.g., before iterating the heap. Must not
+  // run concurrently with the mutator or with any GC task.
+  void AbortConcurrentMark();
+  bool IsConcurrentMarking() const { return marker_ != NULL; }
+  // See GCMarker::DeferMarking.
+  void DeferMarking(RawObject* raw_obj);
+
   void AddRegionsToObjectSet(ObjectSet* set) const;
 
   void InitGrowthControl() {
@@ -301,6 +413,10 @@ class PageSpace {
 
   bool ShouldPerformIdleMarkSweep(int64_t deadline);
   bool ShouldPerformIdleMarkCompact(int64_t deadline);
+  // Whether the root-scanning pause that starts, or the pause that finishes,
+  // a concurrent marking cycle is expected to complete before 'deadline'.
+  bool ShouldStartIdleConcurrentMark(int64_t deadline);
+  bool ShouldFinishIdleConcurrentMark(int64_t deadline);
 
   void AddGCTime(int64_t micros) { gc_time_micros_ += micros; }
 
@@ -310,6 +426,13 @@ class PageSpace {
 
   intptr_t collections() const { return collections_; }
 
+  // Results of the last collection with --incremental_compaction: the
+  // percentage of data page capacity not occupied by marked objects, and how
+  // much was evacuated to reduce it.
+  double fragmentation() const { return fragmentation_; }
+  intptr_t evacuated_in_words() const { return evacuated_in_words_; }
+  intptr_t evacuated_pages() const { return evacuated_pages_; }
+
 #ifndef PRODUCT
   void PrintToJSONObject(JSONObject* object) const;
   void PrintHeapMapToJSONStream(Isolate* isolate, JSONStream* stream) const;
@@ -339,14 +462,43 @@ class PageSpace {
   // Attempt to allocate from bump block rather than normal freelist.
   uword TryAllocateDataBump(intptr_t size, GrowthPolicy growth_policy);
   uword TryAllocateDataBumpLocked(intptr_t size, GrowthPolicy growth_policy);
-  // Prefer small freelist blocks, then chip away at the bump block.
+  // Prefer small freelist blocks, then chip away at the bump block. Sweeps
+  // unswept pages before growing the heap.
   uword TryAllocatePromoLocked(intptr_t size, GrowthPolicy growth_policy);
+  // Return the unused tail of a block obtained via TryAllocatePromoLocked.
+  void FreePromoLocked(uword addr, intptr_t size);
 
   void SetupImagePage(void* pointer, uword size, bool is_executable);
 
   // Return any bump allocation block to the freelist.
   void AbandonBumpAllocation();
 
+  // Thread-local allocation buffers (--old_gen_labs). Small data objects are
+  // bump allocated from a block carved out of the freelist or a fresh page,
+  // without taking the freelist lock. The unused part of a buffer is not
+  // walkable; it is returned when a safepoint operation starts and when the
+  // thread is unscheduled.
+  uword TryAllocateThreadLocal(Thread* thread, intptr_t size);
+  void AbandonThreadLocalBuffer(Thread* thread);
+
+  // Lazy sweeping (--lazy_sweep). After marking, regular data pages are left
+  // unswept. They are claimed one at a time by the lazy sweeper tasks, and by
+  // allocations that would otherwise have to wait for those tasks.
+  uword TryAllocateSweepingOnDemand(intptr_t size, HeapPage::PageType type);
+  // Same for promotion, with the data freelist lock held.
+  uword TryAllocateSweepingOnDemandLocked(intptr_t size);
+  HeapPage* ClaimUnsweptPage();
+  void SweepClaimedPage(HeapPage* page, bool on_demand, bool is_locked);
+  // Sweeps unswept pages on the current thread until 'deadline' passes.
+  // Returns the number of pages swept.
+  intptr_t SweepUntil(int64_t deadline);
+
+  // Pages swept since the last old-space GC.
+  intptr_t pages_swept_on_demand() const { return pages_swept_on_demand_; }
+  intptr_t pages_swept_in_background() const {
+    return pages_swept_in_background_;
+  }
+
  private:
   // Ids for time and data records in Heap::GCStats.
   enum {
@@ -357,14 +509,20 @@ class PageSpace {
     kResetFreeLists = 3,
     kSweepPages = 4,
     kSweepLargePages = 5,
+    kConcurrentMark = 6,
+    kRemark = 7,
     // Data
     kGarbageRatio = 0,
     kGCTimeFraction = 1,
     kPageGrowth = 2,
-    kAllowedGrowth = 3
+    kAllowedGrowth = 3,
+    kSweptOnDemand = 4,
+    kSweptInBackground = 5
   };
 
   static const intptr_t kAllocatablePageSize = 64 * KB;
+  static const intptr_t kThreadLocalBufferSize = 16 * KB;
+  static const intptr_t kMaxThreadLocalAllocationSize = 1 * KB;
 
   uword TryAllocateInternal(intptr_t size,
                             HeapPage::PageType type,
@@ -389,7 +547,12 @@ class PageSpace {
 
   void BlockingSweep();
   void ConcurrentSweep(Isolate* isolate);
+  void LazySweep(Isolate* isolate);
+  void FreeEmptyPages(HeapPage* last);
   void Compact(Thread* thread);
+  void Evacuate(Thread* thread);
+  // Clears the live bytes of all pages before marking.
+  void ResetLiveBytes();
 
   static intptr_t LargePageSizeInWordsFor(intptr_t size);
 
@@ -435,6 +598,14 @@ class PageSpace {
   // Keep track of running MarkSweep tasks.
   Monitor* tasks_lock_;
   intptr_t tasks_;
+
+  // Lazy sweeping state, protected by tasks_lock_. The data pages from
+  // sweep_next_ through sweep_last_ are still unswept.
+  HeapPage* sweep_next_;
+  HeapPage* sweep_last_;
+  intptr_t pages_sweeping_;
+  intptr_t pages_swept_on_demand_;
+  intptr_t pages_swept_in_background_;
 #if defined(DEBUG)
   Thread* iterating_thread_;
 #endif
@@ -444,6 +615,15 @@ class PageSpace {
   intptr_t collections_;
   intptr_t mark_words_per_micro_;
 
+  // The marker of the concurrent cycle in progress, if any.
+  GCMarker* marker_;
+  int64_t mark_start_micros_;
+  intptr_t used_in_words_at_mark_start_;
+
+  double fragmentation_;
+  intptr_t evacuated_in_words_;
+  intptr_t evacuated_pages_;
+
   friend class ExclusivePageIterator;
   friend class ExclusiveCodePageIterator;
   friend class ExclusiveLargePageIterator;
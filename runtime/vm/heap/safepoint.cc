@@ -20,6 +20,9 @@ SafepointOperationScope::SafepointOperationScope(Thread* T) : StackResource(T) {
   // Signal all threads to get to a safepoint and wait for them to
   // get to a safepoint.
   handler->SafepointThreads(T);
+
+  // Make the old space walkable for the duration of the operation.
+  I->thread_registry()->AbandonOldSpaceBuffers();
 }
 
 SafepointOperationScope::~SafepointOperationScope() {
@@ -7,6 +7,7 @@
 #include "vm/dart.h"
 #include "vm/dart_api_state.h"
 #include "vm/flag_list.h"
+#include "vm/heap/freelist.h"
 #include "vm/heap/safepoint.h"
 #include "vm/heap/store_buffer.h"
 #include "vm/heap/verifier.h"
@@ -17,6 +18,8 @@
 #include "vm/object_id_ring.h"
 #include "vm/object_set.h"
 #include "vm/stack_frame.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/thread_registry.h"
 #include "vm/timeline.h"
 #include "vm/visitor.h"
@@ -60,19 +63,40 @@ static inline void ForwardTo(uword original, uword target) {
   *reinterpret_cast<uword*>(original) = target | kForwarded;
 }
 
-class ScavengerVisitor : public ObjectPointerVisitor {
+// Parallel scavenger tasks claim to space and old space in chunks of this size
+// so that most copies are a thread-local bump allocation. Objects of at least
+// a quarter of this size are allocated directly.
+static const intptr_t kScavengerBufferSize = 16 * KB;
+
+template <bool parallel>
+class ScavengerVisitorBase : public ObjectPointerVisitor {
  public:
-  explicit ScavengerVisitor(Isolate* isolate,
-                            Scavenger* scavenger,
-                            SemiSpace* from)
+  explicit ScavengerVisitorBase(Isolate* isolate,
+                                Scavenger* scavenger,
+                                SemiSpace* from,
+                                MarkingStack* work_stack = NULL)
       : ObjectPointerVisitor(isolate),
         thread_(Thread::Current()),
         scavenger_(scavenger),
         from_(from),
         heap_(scavenger->heap_),
         page_space_(scavenger->heap_->old_space()),
+        delayed_weak_properties_(NULL),
         bytes_promoted_(0),
-        visiting_old_object_(NULL) {}
+        visiting_old_object_(NULL),
+        work_stack_(work_stack),
+        work_(NULL),
+        copy_top_(0),
+        copy_end_(0),
+        promo_top_(0),
+        promo_end_(0) {
+    ASSERT(parallel == (work_stack != NULL));
+    if (parallel) {
+      work_ = work_stack_->PopEmptyBlock();
+    }
+  }
+
+  ~ScavengerVisitorBase() { ASSERT(work_ == NULL); }
 
   void VisitPointers(RawObject** first, RawObject** last) {
     ASSERT(Utils::IsAligned(first, sizeof(*first)));
@@ -94,6 +118,66 @@ class ScavengerVisitor : public ObjectPointerVisitor {
 
   intptr_t bytes_promoted() const { return bytes_promoted_; }
 
+  // Scans the objects this or any other task has copied or promoted until no
+  // work is left in the shared work stack.
+  void DrainWorkStack() {
+    ASSERT(parallel);
+    RawObject* raw_obj;
+    while ((raw_obj = PopWork()) != NULL) {
+      if (raw_obj->IsOldObject()) {
+        // Promoted objects are never enqueued as weak properties, mirroring
+        // the promoted stack of the serial scavenger.
+        VisitingOldObject(raw_obj);
+        raw_obj->VisitPointersNonvirtual(this);
+        VisitingOldObject(NULL);
+      } else if (raw_obj->GetClassId() == kWeakPropertyCid) {
+        ProcessWeakProperty(reinterpret_cast<RawWeakProperty*>(raw_obj));
+      } else {
+        raw_obj->VisitPointersNonvirtual(this);
+      }
+    }
+  }
+
+  // Revisits the weak properties delayed by this task whose keys have since
+  // been copied, possibly by another task. Returns true if any were found.
+  bool ProcessPendingWeakProperties() {
+    ASSERT(parallel);
+    bool more_to_scavenge = false;
+    RawWeakProperty* cur_weak = delayed_weak_properties_;
+    delayed_weak_properties_ = NULL;
+    while (cur_weak != NULL) {
+      uword next_weak = cur_weak->ptr()->next_;
+      cur_weak->ptr()->next_ = 0;
+      RawObject* raw_key = cur_weak->ptr()->key_;
+      ASSERT(raw_key->IsNewObject());
+      uword header = AtomicOperations::LoadRelaxed(
+          reinterpret_cast<uword*>(RawObject::ToAddr(raw_key)));
+      if (IsForwarding(header)) {
+        cur_weak->VisitPointersNonvirtual(this);
+        more_to_scavenge = true;
+      } else {
+        DelayWeakProperty(cur_weak);
+      }
+      cur_weak = reinterpret_cast<RawWeakProperty*>(next_weak);
+    }
+    return more_to_scavenge;
+  }
+
+  // Returns the unused parts of this task's allocation buffers and its empty
+  // work block.
+  void Finalize() {
+    ASSERT(parallel);
+    ASSERT(work_->IsEmpty());
+    work_stack_->PushBlock(work_);
+    work_ = NULL;
+    // Fail fast on attempts to scavenge after finalizing.
+    work_stack_ = NULL;
+    RetireCopyBuffer();
+    page_space_->AcquireDataLock();
+    RetirePromoBufferLocked();
+    page_space_->ReleaseDataLock();
+  }
+
  private:
   void UpdateStoreBuffer(RawObject** p, RawObject* obj) {
     ASSERT(obj->IsHeapObject());
@@ -103,7 +187,20 @@ class ScavengerVisitor : public ObjectPointerVisitor {
       ASSERT(heap_->DataContains(ptr));
     }
     // If the newly written object is not a new object, drop it immediately.
-    if (!obj->IsNewObject() || visiting_old_object_->IsRemembered()) {
+    if (!obj->IsNewObject()) {
+      return;
+    }
+    if (visiting_old_object_->IsCardRemembered()) {
+      HeapPage::Of(visiting_old_object_)->RememberCard(p);
+      return;
+    }
+    if (parallel) {
+      if (visiting_old_object_->TryAcquireRememberedBit()) {
+        thread_->StoreBufferAddObjectGC(visiting_old_object_);
+      }
+      return;
+    }
+    if (visiting_old_object_->IsRemembered()) {
       return;
     }
     visiting_old_object_->SetRememberedBit();
@@ -123,13 +220,18 @@ class ScavengerVisitor : public ObjectPointerVisitor {
     ASSERT(from_->Contains(raw_addr));
     // Read the header word of the object and determine if the object has
     // already been copied.
-    uword header = *reinterpret_cast<uword*>(raw_addr);
+    uword header = parallel ? AtomicOperations::LoadRelaxed(
+                                  reinterpret_cast<uword*>(raw_addr))
+                            : *reinterpret_cast<uword*>(raw_addr);
     uword new_addr = 0;
     if (IsForwarding(header)) {
       // Get the new location of the object.
       new_addr = ForwardedAddr(header);
+    } else if (parallel) {
+      new_addr = CopyObjectParallel(raw_obj, header);
     } else {
       intptr_t size = raw_obj->Size();
+      bool promoted = false;
       NOT_IN_PRODUCT(intptr_t cid = raw_obj->GetClassId());
       NOT_IN_PRODUCT(ClassTable* class_table = isolate()->class_table());
       // Check whether object should be promoted.
@@ -153,6 +255,7 @@ class ScavengerVisitor : public ObjectPointerVisitor {
           scavenger_->PushToPromotedStack(new_addr);
           bytes_promoted_ += size;
           NOT_IN_PRODUCT(class_table->UpdateAllocatedOld(cid, size));
+          promoted = true;
         } else {
           // Promotion did not succeed. Copy into the to space instead.
           scavenger_->failed_to_promote_ = true;
@@ -168,6 +271,11 @@ class ScavengerVisitor : public ObjectPointerVisitor {
               reinterpret_cast<void*>(raw_addr), size);
       // Remember forwarding address.
       ForwardTo(raw_addr, new_addr);
+      if (promoted && thread_->is_marking()) {
+        // The concurrent marker has not seen this object as part of new
+        // space; grey it like the write barrier would.
+        thread_->MarkingStackAddObject(RawObject::FromAddr(new_addr));
+      }
     }
     // Update the reference.
     RawObject* new_obj = RawObject::FromAddr(new_addr);
@@ -178,6 +286,191 @@ class ScavengerVisitor : public ObjectPointerVisitor {
     }
   }
 
+  // Copies or promotes an object that other tasks may be copying at the same
+  // time. The task that installs the forwarding pointer wins; the others
+  // discard their copies. Returns the address of the winning copy.
+  uword CopyObjectParallel(RawObject* raw_obj, uword header) {
+    uword raw_addr = RawObject::ToAddr(raw_obj);
+    // The header in from space may be replaced by a forwarding pointer while
+    // we work, so everything is decoded from the snapshot we were given.
+    const uint32_t tags = static_cast<uint32_t>(header);
+    intptr_t size = raw_obj->HeapSize(tags);
+    NOT_IN_PRODUCT(intptr_t cid = RawObject::ClassIdTag::decode(tags));
+    NOT_IN_PRODUCT(ClassTable* class_table = isolate()->class_table());
+    uword new_addr = 0;
+    bool promoted = false;
+    if (scavenger_->survivor_end_ <= raw_addr) {
+      // Not a survivor of a previous scavenge. Copy into the to space unless
+      // the to space is exhausted by buffer fragmentation.
+      new_addr = TryAllocateCopy(size);
+    }
+    if (new_addr == 0) {
+      new_addr = TryAllocatePromo(size);
+      if (new_addr != 0) {
+        promoted = true;
+      } else {
+        // Promotion did not succeed. Copy into the to space instead.
+        scavenger_->failed_to_promote_ = true;
+        new_addr = TryAllocateCopy(size);
+        if (new_addr == 0) {
+          OUT_OF_MEMORY();
+        }
+      }
+    }
+    memmove(reinterpret_cast<void*>(new_addr),
+            reinterpret_cast<void*>(raw_addr), size);
+    // The copied header may already be another task's forwarding pointer.
+    *reinterpret_cast<uword*>(new_addr) = header;
+    ASSERT((new_addr & kForwardingMask) == 0);
+    uword old_header = AtomicOperations::CompareAndSwapWord(
+        reinterpret_cast<uword*>(raw_addr), header, new_addr | kForwarded);
+    if (old_header != header) {
+      // Lost the race; use the other task's copy.
+      if (promoted) {
+        UndoPromo(new_addr, size);
+      } else {
+        UndoCopy(new_addr, size);
+      }
+      return ForwardedAddr(old_header);
+    }
+    RawObject* new_obj = RawObject::FromAddr(new_addr);
+    if (promoted) {
+      bytes_promoted_ += size;
+      NOT_IN_PRODUCT(class_table->UpdateAllocatedOld(cid, size));
+      if (thread_->is_marking()) {
+        // The concurrent marker has not seen this object as part of new
+        // space; grey it like the write barrier would.
+        thread_->MarkingStackAddObject(new_obj);
+      }
+    } else {
+      NOT_IN_PRODUCT(class_table->UpdateLiveNew(cid, size));
+    }
+    PushWork(new_obj);
+    return new_addr;
+  }
+
+  uword TryAllocateCopy(intptr_t size) {
+    if (size <= static_cast<intptr_t>(copy_end_ - copy_top_)) {
+      uword result = copy_top_;
+      copy_top_ += size;
+      return result;
+    }
+    if (size >= (kScavengerBufferSize / 4)) {
+      return scavenger_->TryAllocateGCParallel(size);
+    }
+    RetireCopyBuffer();
+    uword buffer = scavenger_->TryAllocateGCParallel(kScavengerBufferSize);
+    if (buffer == 0) {
+      // Use up whatever is left of the to space.
+      return scavenger_->TryAllocateGCParallel(size);
+    }
+    copy_top_ = buffer + size;
+    copy_end_ = buffer + kScavengerBufferSize;
+    return buffer;
+  }
+
+  void UndoCopy(uword addr, intptr_t size) {
+    if (addr + size == copy_top_) {
+      copy_top_ = addr;
+    } else {
+      // Directly allocated; keep the to space iterable.
+      FreeListElement::AsElement(addr, size);
+    }
+  }
+
+  void RetireCopyBuffer() {
+    if (copy_top_ < copy_end_) {
+      FreeListElement::AsElement(copy_top_, copy_end_ - copy_top_);
+    }
+    copy_top_ = 0;
+    copy_end_ = 0;
+  }
+
+  uword TryAllocatePromo(intptr_t size) {
+    if (size <= static_cast<intptr_t>(promo_end_ - promo_top_)) {
+      uword result = promo_top_;
+      promo_top_ += size;
+      return result;
+    }
+    uword result = 0;
+    page_space_->AcquireDataLock();
+    if (size >= (kScavengerBufferSize / 4)) {
+      result =
+          page_space_->TryAllocatePromoLocked(size, PageSpace::kForceGrowth);
+    } else {
+      RetirePromoBufferLocked();
+      uword buffer = page_space_->TryAllocatePromoLocked(
+          kScavengerBufferSize, PageSpace::kForceGrowth);
+      if (buffer != 0) {
+        result = buffer;
+        promo_top_ = buffer + size;
+        promo_end_ = buffer + kScavengerBufferSize;
+      }
+    }
+    page_space_->ReleaseDataLock();
+    return result;
+  }
+
+  void UndoPromo(uword addr, intptr_t size) {
+    if (addr + size == promo_top_) {
+      promo_top_ = addr;
+    } else {
+      page_space_->AcquireDataLock();
+      page_space_->FreePromoLocked(addr, size);
+      page_space_->ReleaseDataLock();
+    }
+  }
+
+  void RetirePromoBufferLocked() {
+    if (promo_top_ < promo_end_) {
+      page_space_->FreePromoLocked(promo_top_, promo_end_ - promo_top_);
+    }
+    promo_top_ = 0;
+    promo_end_ = 0;
+  }
+
+  RawObject* PopWork() {
+    if (work_->IsEmpty()) {
+      MarkingStackBlock* new_work = work_stack_->PopNonEmptyBlock();
+      if (new_work == NULL) {
+        return NULL;
+      }
+      work_stack_->PushBlock(work_);
+      work_ = new_work;
+    }
+    return work_->Pop();
+  }
+
+  void PushWork(RawObject* raw_obj) {
+    if (work_->IsFull()) {
+      work_stack_->PushBlock(work_);
+      work_ = work_stack_->PopEmptyBlock();
+    }
+    work_->Push(raw_obj);
+  }
+
+  void ProcessWeakProperty(RawWeakProperty* raw_weak) {
+    // The fate of the weak property is determined by its key.
+    RawObject* raw_key = raw_weak->ptr()->key_;
+    if (raw_key->IsHeapObject() && raw_key->IsNewObject()) {
+      uword header = AtomicOperations::LoadRelaxed(
+          reinterpret_cast<uword*>(RawObject::ToAddr(raw_key)));
+      if (!IsForwarding(header)) {
+        // Key is white. Delay the weak property.
+        DelayWeakProperty(raw_weak);
+        return;
+      }
+    }
+    // Key is gray or black. Make the weak property black.
+    raw_weak->VisitPointersNonvirtual(this);
+  }
+
+  void DelayWeakProperty(RawWeakProperty* raw_weak) {
+    ASSERT(raw_weak->ptr()->next_ == 0);
+    raw_weak->ptr()->next_ = reinterpret_cast<uword>(delayed_weak_properties_);
+    delayed_weak_properties_ = raw_weak;
+  }
+
   Thread* thread_;
   Scavenger* scavenger_;
   SemiSpace* from_;
@@ -187,9 +480,18 @@ class ScavengerVisitor : public ObjectPointerVisitor {
   intptr_t bytes_promoted_;
   RawObject* visiting_old_object_;
 
+  // Only used by parallel scavenger tasks.
+  MarkingStack* work_stack_;
+  MarkingStackBlock* work_;
+  uword copy_top_;
+  uword copy_end_;
+  uword promo_top_;
+  uword promo_end_;
+
   friend class Scavenger;
+  friend class ParallelScavengerTask;
 
-  DISALLOW_COPY_AND_ASSIGN(ScavengerVisitor);
+  DISALLOW_COPY_AND_ASSIGN(ScavengerVisitorBase);
 };
 
 class ScavengerWeakVisitor : public HandleVisitor {
@@ -320,6 +622,16 @@ void SemiSpace::Delete() {
   delete old_cache;
 }
 
+void SemiSpace::ReleaseCache() {
+  SemiSpace* old_cache = NULL;
+  {
+    MutexLocker locker(mutex_);
+    old_cache = cache_;
+    cache_ = NULL;
+  }
+  delete old_cache;
+}
+
 void SemiSpace::WriteProtect(bool read_only) {
   if (reserved_ != NULL) {
     reserved_->Protect(read_only ? VirtualMemory::kReadOnly
@@ -379,10 +691,14 @@ Scavenger::~Scavenger() {
   to_->Delete();
 }
 
-intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
+intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words,
+                                   bool idle) const {
   if (stats_history_.Size() == 0) {
     return old_size_in_words;
   }
+  if (FLAG_gc_pause_target_ms > 0) {
+    return PauseTargetSizeInWords(old_size_in_words, idle);
+  }
   double garbage = stats_history_.Get(0).ExpectedGarbageFraction();
   if (garbage < (FLAG_new_gen_garbage_threshold / 100.0)) {
     return Utils::Minimum(max_semi_capacity_in_words_,
@@ -392,7 +708,53 @@ intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
   }
 }
 
-SemiSpace* Scavenger::Prologue(Isolate* isolate) {
+// The cost of a scavenge is dominated by copying the survivors, so a semispace
+// can hold as many words as, at the recent survival rate, leave survivors that
+// can be copied within the pause target. Low survival rates give a large new
+// space and infrequent scavenges; high survival rates give short pauses.
+intptr_t Scavenger::PauseTargetSizeInWords(intptr_t old_size_in_words,
+                                           bool idle) const {
+  const intptr_t min_size_in_words = Utils::Minimum(
+      max_semi_capacity_in_words_, FLAG_new_gen_semi_initial_size * MBInWords);
+  if (idle) {
+    // Give back the memory while nothing is allocating.
+    return min_size_in_words;
+  }
+
+  intptr_t survived_in_words = 0;
+  intptr_t used_in_words = 0;
+  int64_t micros = 0;
+  for (intptr_t i = 0; i < stats_history_.Size(); i++) {
+    survived_in_words += stats_history_.Get(i).SurvivedInWords();
+    used_in_words += stats_history_.Get(i).UsedBeforeInWords();
+    micros += stats_history_.Get(i).DurationMicros();
+  }
+  if ((used_in_words == 0) || (micros == 0)) {
+    return old_size_in_words;
+  }
+  const double kMinSurvivalRate = 0.005;
+  const double survival_rate = Utils::Maximum(
+      kMinSurvivalRate, survived_in_words / static_cast<double>(used_in_words));
+  const double copied_words_per_micro =
+      Utils::Maximum(1.0, survived_in_words / static_cast<double>(micros));
+  const double target_micros = FLAG_gc_pause_target_ms * 1000.0;
+  double size_in_words = copied_words_per_micro * target_micros / survival_rate;
+
+  // Move gradually to damp the effect of a single unusual scavenge.
+  size_in_words = Utils::Minimum(
+      size_in_words,
+      static_cast<double>(old_size_in_words * FLAG_new_gen_growth_factor));
+  size_in_words = Utils::Maximum(size_in_words, old_size_in_words / 2.0);
+  if (size_in_words >= max_semi_capacity_in_words_) {
+    return max_semi_capacity_in_words_;
+  }
+  const intptr_t result =
+      Utils::RoundUp(static_cast<intptr_t>(size_in_words), MBInWords);
+  return Utils::Maximum(min_size_in_words,
+                        Utils::Minimum(result, max_semi_capacity_in_words_));
+}
+
+SemiSpace* Scavenger::Prologue(Isolate* isolate, bool idle) {
   NOT_IN_PRODUCT(isolate->class_table()->ResetCountersNew());
 
   isolate->PrepareForGC();
@@ -404,7 +766,7 @@ SemiSpace* Scavenger::Prologue(Isolate* isolate) {
   const intptr_t kVmNameSize = 128;
   char vm_name[kVmNameSize];
   Heap::RegionName(heap_, Heap::kNew, vm_name, kVmNameSize);
-  to_ = SemiSpace::New(NewSizeInWords(from->size_in_words()), vm_name);
+  to_ = SemiSpace::New(NewSizeInWords(from->size_in_words(), idle), vm_name);
   if (to_ == NULL) {
     // TODO(koda): We could try to recover (collect old space, wait for another
     // isolate to finish scavenge, etc.).
@@ -529,7 +891,7 @@ bool Scavenger::ShouldPerformIdleScavenge(int64_t deadline) {
 }
 
 void Scavenger::IterateStoreBuffers(Isolate* isolate,
-                                    ScavengerVisitor* visitor) {
+                                    SerialScavengerVisitor* visitor) {
   // Iterating through the store buffers.
   // Grab the deduplication sets out of the isolate's consolidated store buffer.
   StoreBufferBlock* pending = isolate->store_buffer()->Blocks();
@@ -543,6 +905,10 @@ void Scavenger::IterateStoreBuffers(Isolate* isolate,
     while (!pending->IsEmpty()) {
       RawObject* raw_object = pending->Pop();
       ASSERT(!raw_object->IsForwardingCorpse());
+      if (raw_object->IsCardRemembered()) {
+        // Rescanned as a whole with the remembered cards.
+        continue;
+      }
       ASSERT(raw_object->IsRemembered());
       raw_object->ClearRememberedBit();
       visitor->VisitingOldObject(raw_object);
@@ -554,14 +920,13 @@ void Scavenger::IterateStoreBuffers(Isolate* isolate,
     pending = next;
   }
   heap_->RecordData(kStoreBufferEntries, total_count);
-  heap_->RecordData(kDataUnused1, 0);
   heap_->RecordData(kDataUnused2, 0);
   // Done iterating through old objects remembered in the store buffers.
   visitor->VisitingOldObject(NULL);
 }
 
 void Scavenger::IterateObjectIdTable(Isolate* isolate,
-                                     ScavengerVisitor* visitor) {
+                                     ObjectPointerVisitor* visitor) {
 #ifndef PRODUCT
   if (!FLAG_support_service) {
     return;
@@ -576,11 +941,14 @@ void Scavenger::IterateObjectIdTable(Isolate* isolate,
 #endif  // !PRODUCT
 }
 
-void Scavenger::IterateRoots(Isolate* isolate, ScavengerVisitor* visitor) {
+void Scavenger::IterateRoots(Isolate* isolate,
+                             SerialScavengerVisitor* visitor) {
   int64_t start = OS::GetCurrentMonotonicMicros();
   isolate->VisitObjectPointers(visitor, ValidationPolicy::kDontValidateFrames);
   int64_t middle = OS::GetCurrentMonotonicMicros();
   IterateStoreBuffers(isolate, visitor);
+  heap_->RecordData(kRememberedCards,
+                    heap_->old_space()->VisitRememberedCards(visitor));
   IterateObjectIdTable(isolate, visitor);
   int64_t end = OS::GetCurrentMonotonicMicros();
   heap_->RecordData(kToKBAfterStoreBuffer, RoundWordsToKB(UsedInWords()));
@@ -614,7 +982,7 @@ void Scavenger::IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor) {
   isolate->VisitWeakPersistentHandles(visitor);
 }
 
-void Scavenger::ProcessToSpace(ScavengerVisitor* visitor) {
+void Scavenger::ProcessToSpace(SerialScavengerVisitor* visitor) {
   // Iterate until all work has been drained.
   while ((resolved_top_ < top_) || PromotedStackHasMore()) {
     while (resolved_top_ < top_) {
@@ -718,8 +1086,18 @@ void Scavenger::EnqueueWeakProperty(RawWeakProperty* raw_weak) {
   delayed_weak_properties_ = raw_weak;
 }
 
+void Scavenger::EnqueueWeakProperties(RawWeakProperty* list) {
+  RawWeakProperty* cur_weak = list;
+  while (cur_weak != NULL) {
+    uword next_weak = cur_weak->ptr()->next_;
+    cur_weak->ptr()->next_ = 0;
+    EnqueueWeakProperty(cur_weak);
+    cur_weak = reinterpret_cast<RawWeakProperty*>(next_weak);
+  }
+}
+
 uword Scavenger::ProcessWeakProperty(RawWeakProperty* raw_weak,
-                                     ScavengerVisitor* visitor) {
+                                     SerialScavengerVisitor* visitor) {
   // The fate of the weak property is determined by its key.
   RawObject* raw_key = raw_weak->ptr()->key_;
   if (raw_key->IsHeapObject() && raw_key->IsNewObject()) {
@@ -844,7 +1222,239 @@ RawObject* Scavenger::FindObject(FindObjectVisitor* visitor) const {
   return Object::null();
 }
 
-void Scavenger::Scavenge() {
+class ParallelScavengerTask : public ThreadPool::Task {
+ public:
+  ParallelScavengerTask(Scavenger* scavenger,
+                        Isolate* isolate,
+                        SemiSpace* from,
+                        MarkingStack* work_stack,
+                        ThreadBarrier* barrier,
+                        Mutex* mutex,
+                        StoreBufferBlock** pending_blocks,
+                        intptr_t* store_buffer_entries,
+                        intptr_t* remembered_cards,
+                        intptr_t* bytes_promoted,
+                        intptr_t task_index,
+                        uintptr_t* num_busy)
+      : scavenger_(scavenger),
+        isolate_(isolate),
+        from_(from),
+        work_stack_(work_stack),
+        barrier_(barrier),
+        mutex_(mutex),
+        pending_blocks_(pending_blocks),
+        store_buffer_entries_(store_buffer_entries),
+        remembered_cards_(remembered_cards),
+        bytes_promoted_(bytes_promoted),
+        task_index_(task_index),
+        num_busy_(num_busy) {}
+
+  virtual void Run() {
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kScavengerTask, true);
+    ASSERT(result);
+    {
+      Thread* thread = Thread::Current();
+      TIMELINE_FUNCTION_GC_DURATION(thread, "ScavengeTask");
+      ParallelScavengerVisitor visitor(isolate_, scavenger_, from_,
+                                       work_stack_);
+      // Phase 1: Copy the roots, the store buffers and the remembered cards,
+      // and everything reachable from them.
+      if (task_index_ == 0) {
+        isolate_->VisitObjectPointers(&visitor,
+                                      ValidationPolicy::kDontValidateFrames);
+        scavenger_->IterateObjectIdTable(isolate_, &visitor);
+        // No other task visits card-remembered arrays, so cleaning and
+        // re-dirtying their cards needs no synchronization. The other tasks
+        // skip them in the store buffers.
+        *remembered_cards_ =
+            scavenger_->heap_->old_space()->VisitRememberedCards(&visitor);
+      }
+      IterateStoreBuffers(&visitor);
+
+      bool more_to_scavenge = false;
+      do {
+        do {
+          visitor.DrainWorkStack();
+
+          // I can't find more work right now. If no other task is busy,
+          // then there will never be more work (NB: 1 is *before* decrement).
+          if (AtomicOperations::FetchAndDecrement(num_busy_) == 1) break;
+
+          // Wait for some work to appear.
+          while (work_stack_->IsEmpty() &&
+                 AtomicOperations::LoadRelaxed(num_busy_) > 0) {
+          }
+
+          // If no tasks are busy, there will never be more work.
+          if (AtomicOperations::LoadRelaxed(num_busy_) == 0) break;
+
+          // I saw some work; get busy and compete for it.
+          AtomicOperations::FetchAndIncrement(num_busy_);
+        } while (true);
+        // Wait for all tasks to stop.
+        barrier_->Sync();
+#if defined(DEBUG)
+        ASSERT(AtomicOperations::LoadRelaxed(num_busy_) == 0);
+        // Caveat: must not allow any task to continue past the barrier
+        // before we checked num_busy, otherwise one of them might rush
+        // ahead and increment it.
+        barrier_->Sync();
+#endif
+        // Check if we have any pending weak properties whose keys have been
+        // copied, possibly by another task.
+        more_to_scavenge = visitor.ProcessPendingWeakProperties();
+        if (more_to_scavenge) {
+          // We have more work to do. Notify others.
+          AtomicOperations::FetchAndIncrement(num_busy_);
+        }
+
+        // Wait for all other tasks to finish processing their pending weak
+        // properties and decide if they need to continue scavenging.
+        // Caveat: we need two barriers here to make this decision in lock step
+        // between all tasks and the main thread.
+        barrier_->Sync();
+        if (!more_to_scavenge &&
+            (AtomicOperations::LoadRelaxed(num_busy_) > 0)) {
+          // All tasks continue as long as any single task has some work to
+          // do.
+          AtomicOperations::FetchAndIncrement(num_busy_);
+          more_to_scavenge = true;
+        }
+        barrier_->Sync();
+      } while (more_to_scavenge);
+
+      // Phase 2: Hand the results back to the main thread.
+      visitor.Finalize();
+      FinalizeResultsFrom(&visitor);
+    }
+    Thread::ExitIsolateAsHelper(true);
+
+    // This task is done. Notify the original thread.
+    barrier_->Exit();
+  }
+
+ private:
+  StoreBufferBlock* PopPendingBlock() {
+    MutexLocker ml(mutex_);
+    StoreBufferBlock* block = *pending_blocks_;
+    if (block != NULL) {
+      *pending_blocks_ = block->next();
+    }
+    return block;
+  }
+
+  void IterateStoreBuffers(ParallelScavengerVisitor* visitor) {
+    intptr_t total_count = 0;
+    StoreBufferBlock* pending;
+    while ((pending = PopPendingBlock()) != NULL) {
+      // Generated code appends to store buffers; tell MemorySanitizer.
+      MSAN_UNPOISON(pending, sizeof(*pending));
+      total_count += pending->Count();
+      while (!pending->IsEmpty()) {
+        RawObject* raw_object = pending->Pop();
+        ASSERT(!raw_object->IsForwardingCorpse());
+        if (raw_object->IsCardRemembered()) {
+          // Rescanned as a whole with the remembered cards.
+          continue;
+        }
+        ASSERT(raw_object->IsRemembered());
+        raw_object->ClearRememberedBit();
+        visitor->VisitingOldObject(raw_object);
+        raw_object->VisitPointersNonvirtual(visitor);
+      }
+      pending->Reset();
+      // Return the emptied block for recycling (no need to check threshold).
+      isolate_->store_buffer()->PushBlock(pending,
+                                          StoreBuffer::kIgnoreThreshold);
+    }
+    // Done iterating through old objects remembered in the store buffers.
+    visitor->VisitingOldObject(NULL);
+    AtomicOperations::IncrementBy(store_buffer_entries_, total_count);
+  }
+
+  void FinalizeResultsFrom(ParallelScavengerVisitor* visitor) {
+    MutexLocker ml(mutex_);
+    *bytes_promoted_ += visitor->bytes_promoted();
+    // The keys of the remaining weak properties are unreachable; queue them
+    // to be cleared by the main thread.
+    scavenger_->EnqueueWeakProperties(visitor->delayed_weak_properties_);
+    visitor->delayed_weak_properties_ = NULL;
+  }
+
+  Scavenger* scavenger_;
+  Isolate* isolate_;
+  SemiSpace* from_;
+  MarkingStack* work_stack_;
+  ThreadBarrier* barrier_;
+  Mutex* mutex_;
+  StoreBufferBlock** pending_blocks_;
+  intptr_t* store_buffer_entries_;
+  intptr_t* remembered_cards_;
+  intptr_t* bytes_promoted_;
+  intptr_t task_index_;
+  uintptr_t* num_busy_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavengerTask);
+};
+
+intptr_t Scavenger::ParallelScavenge(Isolate* isolate, SemiSpace* from) {
+  const intptr_t num_tasks = FLAG_scavenger_tasks;
+  ASSERT(num_tasks > 0);
+  MarkingStack work_stack;
+  Mutex mutex;
+  // Grab the deduplication sets out of the isolate's consolidated store
+  // buffer. The tasks pop them from this list under the mutex.
+  StoreBufferBlock* pending_blocks = isolate->store_buffer()->Blocks();
+  intptr_t store_buffer_entries = 0;
+  intptr_t remembered_cards = 0;
+  intptr_t bytes_promoted = 0;
+  {
+    ThreadBarrier barrier(num_tasks + 1, heap_->barrier(),
+                          heap_->barrier_done());
+    // Used to coordinate draining among tasks; all start out as 'busy'.
+    uintptr_t num_busy = num_tasks;
+    for (intptr_t i = 0; i < num_tasks; ++i) {
+      ParallelScavengerTask* task = new ParallelScavengerTask(
+          this, isolate, from, &work_stack, &barrier, &mutex, &pending_blocks,
+          &store_buffer_entries, &remembered_cards, &bytes_promoted, i,
+          &num_busy);
+      Dart::thread_pool()->Run(task);
+    }
+    bool more_to_scavenge = false;
+    do {
+      // Wait for all tasks to stop.
+      barrier.Sync();
+#if defined(DEBUG)
+      ASSERT(AtomicOperations::LoadRelaxed(&num_busy) == 0);
+      // Caveat: must not allow any task to continue past the barrier
+      // before we checked num_busy, otherwise one of them might rush
+      // ahead and increment it.
+      barrier.Sync();
+#endif
+      // Wait for all tasks to go through their weak properties and verify
+      // that there is nothing more to copy.
+      barrier.Sync();
+      more_to_scavenge = AtomicOperations::LoadRelaxed(&num_busy) > 0;
+      barrier.Sync();
+    } while (more_to_scavenge);
+    barrier.Exit();
+    // The barrier's destructor waits for all tasks to finalize and exit.
+  }
+  ASSERT(pending_blocks == NULL);
+  ASSERT(work_stack.IsEmpty());
+  heap_->RecordData(kStoreBufferEntries, store_buffer_entries);
+  heap_->RecordData(kRememberedCards, remembered_cards);
+  heap_->RecordData(kDataUnused2, 0);
+  heap_->RecordData(kToKBAfterStoreBuffer, RoundWordsToKB(UsedInWords()));
+  // Roots, store buffers and the transitive closure are processed together.
+  heap_->RecordTime(kVisitIsolateRoots, 0);
+  heap_->RecordTime(kIterateStoreBuffers, 0);
+  heap_->RecordTime(kDummyScavengeTime, 0);
+  return bytes_promoted;
+}
+
+void Scavenger::Scavenge(bool idle) {
   Isolate* isolate = heap_->isolate();
   // Ensure that all threads for this isolate are at a safepoint (either stopped
   // or in native code). If two threads are racing at this point, the loser
@@ -880,33 +1490,48 @@ void Scavenger::Scavenge() {
   SpaceUsage usage_before = GetCurrentUsage();
   intptr_t promo_candidate_words =
       (survivor_end_ - FirstObjectStart()) / kWordSize;
-  SemiSpace* from = Prologue(isolate);
+  SemiSpace* from = Prologue(isolate, idle);
   // The API prologue/epilogue may create/destroy zones, so we must not
   // depend on zone allocations surviving beyond the epilogue callback.
   {
     StackZone zone(thread);
-    // Setup the visitor and run the scavenge.
-    ScavengerVisitor visitor(isolate, this, from);
-    page_space->AcquireDataLock();
-    IterateRoots(isolate, &visitor);
-    int64_t iterate_roots = OS::GetCurrentMonotonicMicros();
-    ProcessToSpace(&visitor);
-    int64_t process_to_space = OS::GetCurrentMonotonicMicros();
+    // The parallel tasks take the data lock only to refill their promotion
+    // buffers.
+    const bool parallel = FLAG_scavenger_tasks > 0;
+    intptr_t bytes_promoted = 0;
+    int64_t iterate_roots = 0;
+    int64_t process_to_space = 0;
+    if (parallel) {
+      iterate_roots = OS::GetCurrentMonotonicMicros();
+      bytes_promoted = ParallelScavenge(isolate, from);
+      process_to_space = OS::GetCurrentMonotonicMicros();
+    } else {
+      // Setup the visitor and run the scavenge.
+      SerialScavengerVisitor visitor(isolate, this, from);
+      page_space->AcquireDataLock();
+      IterateRoots(isolate, &visitor);
+      iterate_roots = OS::GetCurrentMonotonicMicros();
+      ProcessToSpace(&visitor);
+      process_to_space = OS::GetCurrentMonotonicMicros();
+      bytes_promoted = visitor.bytes_promoted();
+    }
     {
       TIMELINE_FUNCTION_GC_DURATION(thread, "WeakHandleProcessing");
       ScavengerWeakVisitor weak_visitor(thread, this);
       IterateWeakRoots(isolate, &weak_visitor);
     }
     ProcessWeakReferences();
-    page_space->ReleaseDataLock();
+    if (!parallel) {
+      page_space->ReleaseDataLock();
+    }
 
     // Scavenge finished. Run accounting.
     int64_t end = OS::GetCurrentMonotonicMicros();
     heap_->RecordTime(kProcessToSpace, process_to_space - iterate_roots);
     heap_->RecordTime(kIterateWeaks, end - process_to_space);
-    stats_history_.Add(ScavengeStats(
-        start, end, usage_before, GetCurrentUsage(), promo_candidate_words,
-        visitor.bytes_promoted() >> kWordSizeLog2));
+    stats_history_.Add(ScavengeStats(start, end, usage_before,
+                                     GetCurrentUsage(), promo_candidate_words,
+                                     bytes_promoted >> kWordSizeLog2));
   }
   Epilogue(isolate, from);
 
@@ -6,6 +6,7 @@
 #define RUNTIME_VM_HEAP_SCAVENGER_H_
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "platform/utils.h"
 #include "vm/dart.h"
 #include "vm/flags.h"
@@ -23,7 +24,10 @@ class Heap;
 class Isolate;
 class JSONObject;
 class ObjectSet;
-class ScavengerVisitor;
+template <bool parallel>
+class ScavengerVisitorBase;
+typedef ScavengerVisitorBase<false> SerialScavengerVisitor;
+typedef ScavengerVisitorBase<true> ParallelScavengerVisitor;
 
 // Wrapper around VirtualMemory that adds caching and handles the empty case.
 class SemiSpace {
@@ -39,6 +43,9 @@ class SemiSpace {
   // Hand back an unused space.
   void Delete();
 
+  // Return the memory of the cached unused space, if any, to the OS.
+  static void ReleaseCache();
+
   void* pointer() const { return region_.pointer(); }
   uword start() const { return region_.start(); }
   uword end() const { return region_.end(); }
@@ -99,6 +106,11 @@ class ScavengeStats {
 
   intptr_t UsedBeforeInWords() const { return before_.used_in_words; }
 
+  // Words copied within new space or promoted.
+  intptr_t SurvivedInWords() const {
+    return after_.used_in_words + promoted_in_words_;
+  }
+
   int64_t DurationMicros() const { return end_micros_ - start_micros_; }
 
  private:
@@ -142,6 +154,24 @@ class Scavenger {
     return result;
   }
 
+  // Like AllocateGC, but may be called concurrently by parallel scavenger
+  // tasks. Returns 0 if the to space is exhausted.
+  uword TryAllocateGCParallel(intptr_t size) {
+    ASSERT(Utils::IsAligned(size, kObjectAlignment));
+    ASSERT(scavenging_);
+    uword top = AtomicOperations::LoadRelaxed(&top_);
+    while (size <= static_cast<intptr_t>(end_ - top)) {
+      uword old_top =
+          AtomicOperations::CompareAndSwapWord(&top_, top, top + size);
+      if (old_top == top) {
+        ASSERT((top & kObjectAlignmentMask) == object_alignment_);
+        return top;
+      }
+      top = old_top;
+    }
+    return 0;
+  }
+
   uword TryAllocateInTLAB(Thread* thread, intptr_t size) {
     ASSERT(Utils::IsAligned(size, kObjectAlignment));
     ASSERT(heap_ != Dart::vm_isolate()->heap());
@@ -168,8 +198,9 @@ class Scavenger {
     return result;
   }
 
-  // Collect the garbage in this scavenger.
-  void Scavenge();
+  // Collect the garbage in this scavenger. An idle scavenge may shrink new
+  // space back to its initial size.
+  void Scavenge(bool idle = false);
 
   // Promote all live objects.
   void Evacuate();
@@ -234,23 +265,25 @@ class Scavenger {
     kIterateWeaks = 5,
     // Data
     kStoreBufferEntries = 0,
-    kDataUnused1 = 1,
+    kRememberedCards = 1,
     kDataUnused2 = 2,
     kToKBAfterStoreBuffer = 3
   };
 
   uword FirstObjectStart() const { return to_->start() | object_alignment_; }
-  SemiSpace* Prologue(Isolate* isolate);
-  void IterateStoreBuffers(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateObjectIdTable(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateRoots(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateWeakProperties(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateWeakReferences(Isolate* isolate, ScavengerVisitor* visitor);
+  SemiSpace* Prologue(Isolate* isolate, bool idle);
+  void IterateStoreBuffers(Isolate* isolate, SerialScavengerVisitor* visitor);
+  void IterateObjectIdTable(Isolate* isolate, ObjectPointerVisitor* visitor);
+  void IterateRoots(Isolate* isolate, SerialScavengerVisitor* visitor);
+  void IterateWeakProperties(Isolate* isolate, SerialScavengerVisitor* visitor);
+  void IterateWeakReferences(Isolate* isolate, SerialScavengerVisitor* visitor);
   void IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor);
-  void ProcessToSpace(ScavengerVisitor* visitor);
+  void ProcessToSpace(SerialScavengerVisitor* visitor);
+  intptr_t ParallelScavenge(Isolate* isolate, SemiSpace* from);
   void EnqueueWeakProperty(RawWeakProperty* raw_weak);
+  void EnqueueWeakProperties(RawWeakProperty* list);
   uword ProcessWeakProperty(RawWeakProperty* raw_weak,
-                            ScavengerVisitor* visitor);
+                            SerialScavengerVisitor* visitor);
   void Epilogue(Isolate* isolate, SemiSpace* from);
 
   bool IsUnreachable(RawObject** p);
@@ -282,7 +315,8 @@ class Scavenger {
 
   void ProcessWeakReferences();
 
-  intptr_t NewSizeInWords(intptr_t old_size_in_words) const;
+  intptr_t NewSizeInWords(intptr_t old_size_in_words, bool idle) const;
+  intptr_t PauseTargetSizeInWords(intptr_t old_size_in_words, bool idle) const;
 
   uword top_;
   uword end_;
@@ -322,8 +356,10 @@ class Scavenger {
 
   bool failed_to_promote_;
 
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class ScavengerWeakVisitor;
+  friend class ParallelScavengerTask;
 
   DISALLOW_COPY_AND_ASSIGN(Scavenger);
 };
@@ -15,6 +15,11 @@ DEFINE_LEAF_RUNTIME_ENTRY(void, StoreBufferBlockProcess, 1, Thread* thread) {
 }
 END_LEAF_RUNTIME_ENTRY
 
+DEFINE_LEAF_RUNTIME_ENTRY(void, MarkingStackBlockProcess, 1, Thread* thread) {
+  thread->MarkingStackBlockProcess();
+}
+END_LEAF_RUNTIME_ENTRY
+
 template <int BlockSize>
 typename BlockStack<BlockSize>::List* BlockStack<BlockSize>::global_empty_ =
     NULL;
@@ -173,6 +173,8 @@ class MarkingStack : public BlockStack<kMarkingStackBlockSize> {
   }
 };
 
+typedef MarkingStack::Block MarkingStackBlock;
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_HEAP_STORE_BUFFER_H_
@@ -178,4 +178,54 @@ void GCSweeper::SweepConcurrent(Isolate* isolate,
   pool->Run(task);
 }
 
+class LazySweeperTask : public ThreadPool::Task {
+ public:
+  LazySweeperTask(Isolate* isolate, PageSpace* old_space)
+      : task_isolate_(isolate), old_space_(old_space) {
+    ASSERT(task_isolate_ != NULL);
+    ASSERT(old_space_ != NULL);
+    MonitorLocker ml(old_space_->tasks_lock());
+    old_space_->set_tasks(old_space_->tasks() + 1);
+  }
+
+  virtual void Run() {
+    bool result =
+        Thread::EnterIsolateAsHelper(task_isolate_, Thread::kSweeperTask);
+    ASSERT(result);
+    {
+      Thread* thread = Thread::Current();
+      TIMELINE_FUNCTION_GC_DURATION(thread, "LazySweeperTask");
+      while (true) {
+        thread->CheckForSafepoint();
+        HeapPage* page = old_space_->ClaimUnsweptPage();
+        if (page == NULL) break;
+        old_space_->SweepClaimedPage(page, /* on_demand = */ false,
+                                     /* is_locked = */ false);
+      }
+    }
+    // Exit isolate cleanly *before* notifying it, to avoid shutdown race.
+    Thread::ExitIsolateAsHelper();
+    // This sweeper task is done. Notify the original isolate.
+    {
+      MonitorLocker ml(old_space_->tasks_lock());
+      old_space_->set_tasks(old_space_->tasks() - 1);
+      ml.NotifyAll();
+    }
+  }
+
+ private:
+  Isolate* task_isolate_;
+  PageSpace* old_space_;
+};
+
+void GCSweeper::SweepLazily(Isolate* isolate, intptr_t num_tasks) {
+  // At least one task keeps the task count up until every page is swept, so
+  // that waiting for the sweeper tasks still implies a fully swept heap.
+  num_tasks = Utils::Maximum<intptr_t>(num_tasks, 1);
+  ThreadPool* pool = Dart::thread_pool();
+  for (intptr_t i = 0; i < num_tasks; i++) {
+    pool->Run(new LazySweeperTask(isolate, isolate->heap()->old_space()));
+  }
+}
+
 }  // namespace dart
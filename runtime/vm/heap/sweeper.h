@@ -39,6 +39,10 @@ class GCSweeper {
                               HeapPage* first,
                               HeapPage* last,
                               FreeList* freelist);
+
+  // Start tasks that sweep the unswept pages of the old space in parallel
+  // with each other and with on-demand sweeping by the mutator.
+  static void SweepLazily(Isolate* isolate, intptr_t num_tasks);
 };
 
 }  // namespace dart
@@ -101,6 +101,12 @@ DEFINE_FLAG_HANDLER(DeterministicModeHandler,
                     deterministic,
                     "Enable deterministic mode.");
 
+DEFINE_FLAG(int,
+            isolate_pool_size,
+            0,
+            "Number of isolates to create ahead of Isolate.spawn calls, per "
+            "spawning isolate and script. 0 disables the pool.");
+
 // Quick access to the locally defined thread() and isolate() methods.
 #define T (thread())
 #define I (isolate())
@@ -877,6 +883,7 @@ Isolate::Isolate(const Dart_IsolateFlags& api_flags)
       single_step_(false),
       isolate_flags_(0),
       background_compiler_(NULL),
+      marking_stack_(NULL),
 #if !defined(PRODUCT)
       debugger_(NULL),
       last_resume_timestamp_(OS::GetCurrentTimeMillis()),
@@ -937,6 +944,7 @@ Isolate::Isolate(const Dart_IsolateFlags& api_flags)
       boxed_field_list_(GrowableObjectArray::null()),
       spawn_count_monitor_(new Monitor()),
       spawn_count_(0),
+      isolate_pool_(NULL),
       handler_info_cache_(),
       catch_entry_state_cache_(),
       embedder_entry_points_(NULL),
@@ -1185,6 +1193,41 @@ RawError* Isolate::PausePostRequest() {
   return Error::null();
 }
 
+char* Isolate::BuildIsolateName(const char* script_uri, const char* main) {
+  if (script_uri == NULL) {
+    // Just use the main as the name.
+    if (main == NULL) {
+      return strdup("isolate");
+    } else {
+      return strdup(main);
+    }
+  }
+
+  if (ServiceIsolate::NameEquals(script_uri) ||
+      (strcmp(script_uri, DART_KERNEL_ISOLATE_NAME) == 0)) {
+    return strdup(script_uri);
+  }
+
+  // Skip past any slashes and backslashes in the script uri.
+  const char* last_slash = strrchr(script_uri, '/');
+  if (last_slash != NULL) {
+    script_uri = last_slash + 1;
+  }
+  const char* last_backslash = strrchr(script_uri, '\\');
+  if (last_backslash != NULL) {
+    script_uri = last_backslash + 1;
+  }
+  if (main == NULL) {
+    main = "main";
+  }
+
+  char* chars = NULL;
+  intptr_t len = Utils::SNPrint(NULL, 0, "%s:%s()", script_uri, main) + 1;
+  chars = reinterpret_cast<char*>(malloc(len));
+  Utils::SNPrint(chars, len, "%s:%s()", script_uri, main);
+  return chars;
+}
+
 void Isolate::BuildName(const char* name_prefix) {
   ASSERT(name_ == NULL);
   if (name_prefix == NULL) {
@@ -1804,6 +1847,13 @@ void Isolate::Shutdown() {
   delete background_compiler_;
   background_compiler_ = NULL;
 
+  if (isolate_pool_ != NULL) {
+    ASSERT(spawn_count_ == 0);
+    isolate_pool_->Shutdown();
+    delete isolate_pool_;
+    isolate_pool_ = NULL;
+  }
+
 #if defined(DEBUG)
   if (heap_ != NULL && FLAG_verify_on_transition) {
     // The VM isolate keeps all objects marked.
@@ -1842,6 +1892,8 @@ void Isolate::Shutdown() {
     while (old_space->tasks() > 0) {
       ml.Wait();
     }
+    // Detach the marking stacks from this isolate's threads.
+    old_space->AbortConcurrentMark();
   }
 
 #if !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
@@ -2695,6 +2747,20 @@ void Isolate::IncrementSpawnCount() {
   spawn_count_++;
 }
 
+void Isolate::DecrementSpawnCount() {
+  MonitorLocker ml(spawn_count_monitor_);
+  ASSERT(spawn_count_ > 0);
+  spawn_count_--;
+  ml.Notify();
+}
+
+IsolatePool* Isolate::isolate_pool() {
+  if (isolate_pool_ == NULL) {
+    isolate_pool_ = new IsolatePool(this);
+  }
+  return isolate_pool_;
+}
+
 void Isolate::WaitForOutstandingSpawns() {
   MonitorLocker ml(spawn_count_monitor_);
   while (spawn_count_ > 0) {
@@ -2764,6 +2830,12 @@ Thread* Isolate::ScheduleThread(bool is_mutator, bool bypass_safepoint) {
 void Isolate::UnscheduleThread(Thread* thread,
                                bool is_mutator,
                                bool bypass_safepoint) {
+  // Return the thread's old-space allocation buffer while the thread is
+  // still holding off safepoint operations.
+  if (this != Dart::vm_isolate()) {
+    heap()->old_space()->AbandonThreadLocalBuffer(thread);
+  }
+
   // Disassociate the 'Thread' structure and unschedule the thread
   // from this isolate.
   // We are disassociating the thread from an isolate and it would
@@ -3012,4 +3084,231 @@ void IsolateSpawnState::DecrementSpawnCount() {
   ml.Notify();
 }
 
+static const char* CopyOrNull(const char* chars) {
+  return (chars == NULL) ? NULL : NewConstChar(chars);
+}
+
+static bool StringsEqual(const char* a, const char* b) {
+  if ((a == NULL) || (b == NULL)) {
+    return a == b;
+  }
+  return strcmp(a, b) == 0;
+}
+
+// The pooled isolates of one script and the arguments to create more.
+class IsolatePool::Entry {
+ public:
+  explicit Entry(IsolateSpawnState* state)
+      : script_url_(CopyOrNull(state->script_url())),
+        package_root_(CopyOrNull(state->package_root())),
+        package_config_(CopyOrNull(state->package_config())),
+        function_name_(CopyOrNull(state->function_name())),
+        init_data_(state->init_data()),
+        flags_(*state->isolate_flags()),
+        isolates_(),
+        pending_(0),
+        failed_(false) {}
+
+  ~Entry() {
+    ASSERT(isolates_.is_empty());
+    ASSERT(pending_ == 0);
+    delete[] script_url_;
+    delete[] package_root_;
+    delete[] package_config_;
+    delete[] function_name_;
+  }
+
+  bool Matches(IsolateSpawnState* state) const {
+    return StringsEqual(script_url_, state->script_url()) &&
+           StringsEqual(package_root_, state->package_root()) &&
+           StringsEqual(package_config_, state->package_config());
+  }
+
+  // Creates an isolate through the create callback, or returns NULL.
+  Isolate* CreateIsolate() const {
+    Dart_IsolateCreateCallback callback = Isolate::CreateCallback();
+    if (callback == NULL) {
+      return NULL;
+    }
+    // The callback may change the flags it is handed.
+    Dart_IsolateFlags api_flags = flags_;
+    char* error = NULL;
+    Isolate* isolate = reinterpret_cast<Isolate*>(
+        (callback)(script_url_, function_name_, package_root_,
+                   package_config_, &api_flags, init_data_, &error));
+    free(error);
+    return isolate;
+  }
+
+  MallocGrowableArray<Isolate*>* isolates() { return &isolates_; }
+  intptr_t pending() const { return pending_; }
+  void set_pending(intptr_t value) { pending_ = value; }
+  bool failed() const { return failed_; }
+  void set_failed() { failed_ = true; }
+
+ private:
+  const char* script_url_;
+  const char* package_root_;
+  const char* package_config_;
+  const char* function_name_;
+  void* init_data_;
+  Dart_IsolateFlags flags_;
+  MallocGrowableArray<Isolate*> isolates_;
+  // Number of refills scheduled but not completed.
+  intptr_t pending_;
+  // Set when the create callback fails, to stop refilling.
+  bool failed_;
+
+  DISALLOW_COPY_AND_ASSIGN(Entry);
+};
+
+class IsolatePool::RefillTask : public ThreadPool::Task {
+ public:
+  RefillTask(IsolatePool* pool, Entry* entry) : pool_(pool), entry_(entry) {}
+
+  virtual void Run() {
+    // The owner waits for this task as for a spawn, so the pool and the
+    // entry outlive it.
+    Isolate* owner = pool_->owner_;
+    pool_->Add(entry_, entry_->CreateIsolate());
+    owner->DecrementSpawnCount();
+  }
+
+ private:
+  IsolatePool* pool_;
+  Entry* entry_;
+
+  DISALLOW_COPY_AND_ASSIGN(RefillTask);
+};
+
+class ShutdownPooledIsolatesTask : public ThreadPool::Task {
+ public:
+  explicit ShutdownPooledIsolatesTask(MallocGrowableArray<Isolate*>* isolates)
+      : isolates_(isolates) {}
+
+  virtual void Run() {
+    for (intptr_t i = 0; i < isolates_->length(); i++) {
+      ShutdownIsolate(reinterpret_cast<uword>(isolates_->At(i)));
+    }
+    delete isolates_;
+  }
+
+ private:
+  MallocGrowableArray<Isolate*>* isolates_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShutdownPooledIsolatesTask);
+};
+
+intptr_t IsolatePool::hits_ = 0;
+intptr_t IsolatePool::misses_ = 0;
+
+IsolatePool::IsolatePool(Isolate* owner)
+    : owner_(owner), mutex_(NOT_IN_PRODUCT("IsolatePool::mutex_")) {}
+
+IsolatePool::~IsolatePool() {
+  ASSERT(entries_.is_empty());
+}
+
+Isolate* IsolatePool::Claim(IsolateSpawnState* state) {
+  Entry* entry = NULL;
+  Isolate* isolate = NULL;
+  {
+    MutexLocker ml(&mutex_);
+    entry = LookupOrAddEntry(state);
+    if (!entry->isolates()->is_empty()) {
+      isolate = entry->isolates()->RemoveLast();
+    }
+  }
+  AtomicOperations::IncrementBy((isolate != NULL) ? &hits_ : &misses_, 1);
+  if (isolate != NULL) {
+    // The pooled isolate was named after the function of the spawn that
+    // created the entry, not the one it is handed to.
+    char* name =
+        Isolate::BuildIsolateName(state->script_url(), state->function_name());
+    isolate->set_name(name);
+    free(name);
+  }
+  Refill(entry);
+  return isolate;
+}
+
+IsolatePool::Entry* IsolatePool::LookupOrAddEntry(IsolateSpawnState* state) {
+  ASSERT(mutex_.IsOwnedByCurrentThread());
+  for (intptr_t i = 0; i < entries_.length(); i++) {
+    if (entries_[i]->Matches(state)) {
+      return entries_[i];
+    }
+  }
+  Entry* entry = new Entry(state);
+  entries_.Add(entry);
+  return entry;
+}
+
+void IsolatePool::Refill(Entry* entry) {
+  intptr_t count = 0;
+  {
+    MutexLocker ml(&mutex_);
+    if (entry->failed()) {
+      return;
+    }
+    count = FLAG_isolate_pool_size - entry->isolates()->length() -
+            entry->pending();
+    if (count <= 0) {
+      return;
+    }
+    entry->set_pending(entry->pending() + count);
+  }
+  for (intptr_t i = 0; i < count; i++) {
+    owner_->IncrementSpawnCount();
+    RefillTask* task = new RefillTask(this, entry);
+    if (!Dart::thread_pool()->Run(task)) {
+      delete task;
+      Add(entry, NULL);
+      owner_->DecrementSpawnCount();
+    }
+  }
+}
+
+void IsolatePool::Add(Entry* entry, Isolate* isolate) {
+  MutexLocker ml(&mutex_);
+  ASSERT(entry->pending() > 0);
+  entry->set_pending(entry->pending() - 1);
+  if (isolate == NULL) {
+    entry->set_failed();
+  } else {
+    entry->isolates()->Add(isolate);
+  }
+}
+
+void IsolatePool::Shutdown() {
+  MallocGrowableArray<Isolate*>* isolates = new MallocGrowableArray<Isolate*>();
+  {
+    MutexLocker ml(&mutex_);
+    for (intptr_t i = 0; i < entries_.length(); i++) {
+      Entry* entry = entries_[i];
+      ASSERT(entry->pending() == 0);
+      while (!entry->isolates()->is_empty()) {
+        isolates->Add(entry->isolates()->RemoveLast());
+      }
+      delete entry;
+    }
+    entries_.Clear();
+  }
+  // The pooled isolates are shut down on another thread, since this one is
+  // still in the isolate that owned them.
+  if (isolates->is_empty() ||
+      !Dart::thread_pool()->Run(new ShutdownPooledIsolatesTask(isolates))) {
+    delete isolates;
+  }
+}
+
+#ifndef PRODUCT
+void IsolatePool::PrintJSON(JSONObject* jsobj) {
+  JSONObject pool(jsobj, "_isolatePool");
+  pool.AddProperty64("size", FLAG_isolate_pool_size);
+  pool.AddProperty64("hits", hits_);
+  pool.AddProperty64("misses", misses_);
+}
+#endif  // !PRODUCT
+
 }  // namespace dart
@@ -41,8 +41,11 @@ class ICData;
 class Interpreter;
 class IsolateProfilerData;
 class IsolateReloadContext;
+class IsolatePool;
 class IsolateSpawnState;
+class JSONObject;
 class Log;
+class MarkingStack;
 class Message;
 class MessageHandler;
 class Mutex;
@@ -204,6 +207,11 @@ class Isolate : public BaseIsolate {
 
   StoreBuffer* store_buffer() { return store_buffer_; }
 
+  // Non-NULL while the old generation is being marked concurrently; receives
+  // the objects greyed by the write barrier of this isolate's threads.
+  MarkingStack* marking_stack() const { return marking_stack_; }
+  void set_marking_stack(MarkingStack* value) { marking_stack_ = value; }
+
   ThreadRegistry* thread_registry() const { return thread_registry_; }
   SafepointHandler* safepoint_handler() const { return safepoint_handler_; }
   ClassTable* class_table() { return &class_table_; }
@@ -236,6 +244,10 @@ class Isolate : public BaseIsolate {
   const char* name() const { return name_; }
   void set_name(const char* name);
 
+  // Returns the malloc'ed name of an isolate that runs [main] of the script
+  // at [script_uri], such as "script.dart:main()".
+  static char* BuildIsolateName(const char* script_uri, const char* main);
+
   int64_t UptimeMicros() const;
 
   Dart_Port main_port() const { return main_port_; }
@@ -415,8 +427,13 @@ class Isolate : public BaseIsolate {
   intptr_t* spawn_count() { return &spawn_count_; }
 
   void IncrementSpawnCount();
+  void DecrementSpawnCount();
   void WaitForOutstandingSpawns();
 
+  // The pool of isolates created ahead of the Isolate.spawn calls of this
+  // isolate, created on first use. Only used by the isolate's own thread.
+  IsolatePool* isolate_pool();
+
   static void SetCreateCallback(Dart_IsolateCreateCallback cb) {
     create_callback_ = cb;
   }
@@ -889,6 +906,8 @@ class Isolate : public BaseIsolate {
   // Background compilation.
   BackgroundCompiler* background_compiler_;
 
+  MarkingStack* marking_stack_;
+
 // Fields that aren't needed in a product build go here with boolean flags at
 // the top.
 #if !defined(PRODUCT)
@@ -992,6 +1011,7 @@ class Isolate : public BaseIsolate {
   // destroyed while there are child isolates in the midst of a spawn.
   Monitor* spawn_count_monitor_;
   intptr_t spawn_count_;
+  IsolatePool* isolate_pool_;
 
   HandlerInfoCache handler_info_cache_;
   CatchEntryStateCache catch_entry_state_cache_;
@@ -1027,6 +1047,7 @@ class Isolate : public BaseIsolate {
   friend class SafepointHandler;
   friend class ObjectGraph;  // VisitObjectPointers
   friend class Scavenger;    // VisitObjectPointers
+  friend class ParallelScavengerTask;  // VisitObjectPointers
   friend class HeapIterationScope;  // VisitObjectPointers
   friend class ServiceIsolate;
   friend class Thread;
@@ -1159,6 +1180,50 @@ class IsolateSpawnState {
   bool errors_are_fatal_;
 };
 
+// Isolates created ahead of the Isolate.spawn calls of an isolate, enabled
+// with --isolate_pool_size. The first spawn of a script creates its isolate
+// through the create callback as usual and starts filling the pool for that
+// script on the thread pool. Later spawns of the script claim a pooled
+// isolate, which only has to be started, and the pool is refilled in the
+// background. Pooled isolates have not run any Dart code yet; they are shut
+// down together with the isolate that owns the pool.
+class IsolatePool {
+ public:
+  explicit IsolatePool(Isolate* owner);
+  ~IsolatePool();
+
+  // Returns a pooled isolate created for the script and packages of
+  // [state], renamed after its function, or NULL if there is none, and
+  // schedules the creation of isolates to replace it. [state] must keep the
+  // spawn count of the owner raised while this runs.
+  Isolate* Claim(IsolateSpawnState* state);
+
+  // Shuts down the pooled isolates. Called when the owner shuts down, after
+  // its outstanding spawns, which include the refills, have completed.
+  void Shutdown();
+
+#ifndef PRODUCT
+  static void PrintJSON(JSONObject* jsobj);
+#endif
+
+ private:
+  class Entry;
+  class RefillTask;
+
+  Entry* LookupOrAddEntry(IsolateSpawnState* state);
+  void Refill(Entry* entry);
+  void Add(Entry* entry, Isolate* isolate);
+
+  Isolate* owner_;
+  Mutex mutex_;
+  MallocGrowableArray<Entry*> entries_;
+
+  static intptr_t hits_;
+  static intptr_t misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(IsolatePool);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_ISOLATE_H_
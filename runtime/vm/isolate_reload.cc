@@ -1846,6 +1846,7 @@ class MarkFunctionsForRecompilation : public ObjectVisitor {
       func.set_deoptimization_counter(0);
       func.set_optimized_instruction_count(0);
       func.set_optimized_call_site_count(0);
+      func.set_optimization_tier(0);
     }
   }
 
@@ -285,6 +285,26 @@ int64_t MetricHeapUsed::Value() const {
          isolate()->heap()->UsedInWords(Heap::kOld) * kWordSize;
 }
 
+int64_t MetricHeapIdleCount::Value() const {
+  ASSERT(isolate() == Isolate::Current());
+  return isolate()->heap()->idle_notifications();
+}
+
+int64_t MetricHeapIdleRequested::Value() const {
+  ASSERT(isolate() == Isolate::Current());
+  return isolate()->heap()->idle_requested_micros();
+}
+
+int64_t MetricHeapIdleUsed::Value() const {
+  ASSERT(isolate() == Isolate::Current());
+  return isolate()->heap()->idle_used_micros();
+}
+
+int64_t MetricHeapIdleOverrun::Value() const {
+  ASSERT(isolate() == Isolate::Current());
+  return isolate()->heap()->idle_overrun_micros();
+}
+
 int64_t MetricIsolateCount::Value() const {
   return Isolate::IsolateListLength();
 }
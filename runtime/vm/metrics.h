@@ -26,6 +26,14 @@ class JSONStream;
   V(MetricHeapNewExternal, HeapNewExternal, "heap.new.external", kByte)        \
   V(MetricHeapUsed, HeapGlobalUsed, "heap.global.used", kByte)                 \
   V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)               \
+  V(MetricHeapIdleCount, HeapIdleCount, "heap.idle.count", kCounter)           \
+  V(MetricHeapIdleRequested, HeapIdleRequested, "heap.idle.requested",         \
+    kMicrosecond)                                                              \
+  V(MetricHeapIdleUsed, HeapIdleUsed, "heap.idle.used", kMicrosecond)          \
+  V(MetricHeapIdleOverrun, HeapIdleOverrun, "heap.idle.overrun", kMicrosecond) \
+  V(Metric, CompilerQueueLength, "compiler.queue.length", kCounter)            \
+  V(Metric, CompilerQueueTime, "compiler.queue.time", kMicrosecond)            \
+  V(MaxMetric, CompilerQueueTimeMax, "compiler.queue.time.max", kMicrosecond)  \
   V(Metric, RunnableLatency, "isolate.runnable.latency", kMicrosecond)         \
   V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)
 
@@ -158,6 +166,26 @@ class MetricHeapNewExternal : public Metric {
   virtual int64_t Value() const;
 };
 
+class MetricHeapIdleCount : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricHeapIdleRequested : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricHeapIdleUsed : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricHeapIdleOverrun : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
 class MetricIsolateCount : public Metric {
  protected:
   virtual int64_t Value() const;
@@ -1476,6 +1476,11 @@ RawError* Object::Init(Isolate* isolate,
     RegisterPrivateClass(cls, Symbols::_SendPortImpl(), isolate_lib);
     pending_classes.Add(cls);
 
+    cls = Class::New<TransferableTypedData>();
+    RegisterPrivateClass(cls, Symbols::_TransferableTypedDataImpl(),
+                         isolate_lib);
+    pending_classes.Add(cls);
+
     const Class& stacktrace_cls = Class::Handle(zone, Class::New<StackTrace>());
     RegisterPrivateClass(stacktrace_cls, Symbols::_StackTrace(), core_lib);
     pending_classes.Add(stacktrace_cls);
@@ -1957,6 +1962,7 @@ RawError* Object::Init(Isolate* isolate,
     cls = Class::New<Capability>();
     cls = Class::New<ReceivePort>();
     cls = Class::New<SendPort>();
+    cls = Class::New<TransferableTypedData>();
     cls = Class::New<StackTrace>();
     cls = Class::New<RegExp>();
     cls = Class::New<Number>();
@@ -2006,6 +2012,13 @@ void Object::InitializeObject(uword address,
   tags = RawObject::ClassIdTag::update(class_id, tags);
   tags = RawObject::SizeTag::update(size, tags);
   tags = RawObject::VMHeapObjectTag::update(is_vm_object, tags);
+  const bool is_old =
+      (address & kNewObjectAlignmentOffset) == kOldObjectAlignmentOffset;
+  if (is_old && FLAG_concurrent_mark && Thread::Current()->is_marking()) {
+    // Allocate black while the old generation is being marked concurrently.
+    tags = RawObject::MarkBit::update(true, tags);
+    HeapPage::Of(address)->add_live_bytes(size);
+  }
   reinterpret_cast<RawObject*>(address)->tags_ = tags;
 #if defined(HASH_IN_OBJECT_HEADER)
   reinterpret_cast<RawObject*>(address)->hash_ = 0;
@@ -2114,9 +2127,6 @@ RawObject* Object::Clone(const Object& orig, Heap::Space space) {
   intptr_t size = orig.raw()->Size();
   RawObject* raw_clone = Object::Allocate(cls.id(), size, space);
   NoSafepointScope no_safepoint;
-  // TODO(koda): This will trip when we start allocating black.
-  // Revisit code below at that point, to account for the new write barrier.
-  ASSERT(!raw_clone->IsMarked());
   // Copy the body of the original into the clone.
   uword orig_addr = RawObject::ToAddr(orig.raw());
   uword clone_addr = RawObject::ToAddr(raw_clone);
@@ -2124,11 +2134,17 @@ RawObject* Object::Clone(const Object& orig, Heap::Space space) {
   memmove(reinterpret_cast<uint8_t*>(clone_addr + kHeaderSizeInBytes),
           reinterpret_cast<uint8_t*>(orig_addr + kHeaderSizeInBytes),
           size - kHeaderSizeInBytes);
+  // A clone allocated black was filled in without the marking barrier.
+  if (raw_clone->IsMarked()) {
+    ASSERT(raw_clone->IsOldObject());
+    Isolate::Current()->heap()->old_space()->DeferMarking(raw_clone);
+  }
   // Add clone to store buffer, if needed.
   if (!raw_clone->IsOldObject()) {
     // No need to remember an object in new space.
     return raw_clone;
-  } else if (orig.raw()->IsOldObject() && !orig.raw()->IsRemembered()) {
+  } else if (orig.raw()->IsOldObject() && !orig.raw()->IsRemembered() &&
+             !orig.raw()->IsCardRemembered()) {
     // Old original doesn't need to be remembered, so neither does the clone.
     return raw_clone;
   }
@@ -2916,6 +2932,7 @@ RawFunction* Function::CreateDynamicInvocationForwarder(
   forwarder.set_deoptimization_counter(0);
   forwarder.set_optimized_instruction_count(0);
   forwarder.set_inlining_depth(0);
+  forwarder.set_optimization_tier(0);
   forwarder.set_optimized_call_site_count(0);
   forwarder.set_kernel_offset(kernel_offset());
 
@@ -5756,6 +5773,7 @@ void Function::ClearCode() const {
   ASSERT(Thread::Current()->IsMutatorThread());
   StorePointer(&raw_ptr()->unoptimized_code_, Code::null());
   SetInstructions(Code::Handle(StubCode::LazyCompile_entry()->code()));
+  set_optimization_tier(0);
 #endif
 }
 
@@ -5792,6 +5810,7 @@ void Function::SwitchToUnoptimizedCode() const {
   const Code& unopt_code = Code::Handle(zone, unoptimized_code());
   AttachCode(unopt_code);
   unopt_code.Enable();
+  NOT_IN_PRECOMPILED(set_optimization_tier(0));
   isolate->TrackDeoptimizedCode(current_code);
 }
 
@@ -5807,6 +5826,7 @@ void Function::SwitchToLazyCompiledUnoptimizedCode() const {
   const Code& current_code = Code::Handle(zone, CurrentCode());
   TIR_Print("Disabling optimized code for %s\n", ToCString());
   current_code.DisableDartCode();
+  NOT_IN_PRECOMPILED(set_optimization_tier(0));
 
   const Code& unopt_code = Code::Handle(zone, unoptimized_code());
   if (unopt_code.IsNull()) {
@@ -7195,6 +7215,7 @@ RawFunction* Function::New(const String& name,
   NOT_IN_PRECOMPILED(result.set_optimized_instruction_count(0));
   NOT_IN_PRECOMPILED(result.set_optimized_call_site_count(0));
   NOT_IN_PRECOMPILED(result.set_inlining_depth(0));
+  NOT_IN_PRECOMPILED(result.set_optimization_tier(0));
   NOT_IN_PRECOMPILED(result.set_kernel_offset(0));
   result.set_is_optimizable(is_native ? false : true);
   result.set_is_background_optimizable(is_native ? false : true);
@@ -7235,6 +7256,7 @@ RawFunction* Function::Clone(const Class& new_owner) const {
   clone.set_deoptimization_counter(0);
   clone.set_optimized_instruction_count(0);
   clone.set_inlining_depth(0);
+  clone.set_optimization_tier(0);
   clone.set_optimized_call_site_count(0);
 
   if (new_owner.NumTypeParameters() > 0) {
@@ -8890,6 +8912,27 @@ void Field::RecordStore(const Object& value) const {
   }
 }
 
+RawObject* Field::ValueForStore(const Object& value) const {
+  if (!is_unboxing_candidate() || is_nullable() || is_final()) {
+    return value.raw();
+  }
+  switch (guarded_cid()) {
+    case kDoubleCid:
+      return Double::New(Double::Cast(value).value());
+    case kFloat32x4Cid:
+      return Float32x4::New(Float32x4::Cast(value).value());
+    case kFloat64x2Cid:
+      return Float64x2::New(Float64x2::Cast(value).value());
+    case kMintCid:
+      // RecordStore has guarded the field to Mint only if the value is a
+      // Mint, which never holds a value that fits in a Smi.
+      ASSERT(value.IsMint());
+      return Mint::New(Mint::Cast(value).value());
+    default:
+      return value.raw();
+  }
+}
+
 void Field::ForceDynamicGuardedCidAndLength() const {
   // Assume nothing about this field.
   set_is_unboxing_candidate(false);
@@ -21305,6 +21348,10 @@ RawArray* Array::New(intptr_t class_id, intptr_t len, Heap::Space space) {
         Object::Allocate(class_id, Array::InstanceSize(len), space));
     NoSafepointScope no_safepoint;
     raw->StoreSmi(&(raw->ptr()->length_), Smi::New(len));
+    // Arrays that get a large page of their own are remembered per card.
+    if (raw->IsOldObject()) {
+      PageSpace::SetUpCardRemembering(raw, Array::InstanceSize(len));
+    }
     return raw;
   }
 }
@@ -22051,6 +22098,49 @@ const char* SendPort::ToCString() const {
   return "SendPort";
 }
 
+static void TransferableTypedDataFinalizer(void* isolate_callback_data,
+                                           Dart_WeakPersistentHandle handle,
+                                           void* peer) {
+  delete reinterpret_cast<TransferableTypedDataPeer*>(peer);
+}
+
+void TransferableTypedDataPeer::ClearData() {
+  handle_->EnsureFreeExternal(Isolate::Current());
+  data_ = NULL;
+  length_ = 0;
+}
+
+TransferableTypedDataPeer* TransferableTypedData::peer() const {
+  return reinterpret_cast<TransferableTypedDataPeer*>(
+      Isolate::Current()->heap()->GetPeer(raw()));
+}
+
+RawTransferableTypedData* TransferableTypedData::New(uint8_t* data,
+                                                     intptr_t length,
+                                                     Heap::Space space) {
+  TransferableTypedDataPeer* peer = new TransferableTypedDataPeer(data, length);
+
+  Isolate* isolate = Isolate::Current();
+  TransferableTypedData& result = TransferableTypedData::Handle();
+  {
+    RawObject* raw =
+        Object::Allocate(TransferableTypedData::kClassId,
+                         TransferableTypedData::InstanceSize(), space);
+    NoSafepointScope no_safepoint;
+    isolate->heap()->SetPeer(raw, peer);
+    result ^= raw;
+  }
+  // The finalizer frees the bytes unless they were handed over before the
+  // object dies.
+  peer->set_handle(dart::AddFinalizer(
+      result, peer, &TransferableTypedDataFinalizer, length));
+  return result.raw();
+}
+
+const char* TransferableTypedData::ToCString() const {
+  return "TransferableTypedData";
+}
+
 const char* Closure::ToCString() const {
   const Function& fun = Function::Handle(function());
   const bool is_implicit_closure = fun.IsImplicitClosureFunction();
@@ -3328,6 +3328,11 @@ class Field : public Object {
   // deoptimization of dependent optimized code.
   void RecordStore(const Object& value) const;
 
+  // Returns the object an instance should hold for the given value: unboxed
+  // fields own a box which optimized code updates in place, so a fresh copy
+  // of the value is returned for them.
+  RawObject* ValueForStore(const Object& value) const;
+
   void InitializeGuardedListLengthInObjectOffset() const;
 
   // Return the list of optimized code objects that were optimized under
@@ -5613,7 +5618,7 @@ class Instance : public Object {
 
   void SetField(const Field& field, const Object& value) const {
     field.RecordStore(value);
-    StorePointer(FieldAddr(field), value.raw());
+    StorePointer(FieldAddr(field), field.ValueForStore(value));
   }
 
   RawAbstractType* GetType(Heap::Space space) const;
@@ -6997,8 +7002,10 @@ class Mint : public Integer {
   }
 
  protected:
-  // Only Integer::NewXXX is allowed to call Mint::NewXXX directly.
+  // Only Integer::NewXXX is allowed to call Mint::NewXXX directly. Fields
+  // holding unboxed int64 values need a mutable Mint box of their own.
   friend class Integer;
+  friend class Field;
 
   static RawMint* New(int64_t value, Heap::Space space = Heap::kNew);
 
@@ -8862,6 +8869,51 @@ class SendPort : public Instance {
   friend class Class;
 };
 
+// Owns the bytes of a TransferableTypedData until they are handed over to a
+// message or materialized into an external typed data.
+class TransferableTypedDataPeer {
+ public:
+  // [data] must be malloc'ed, not new'ed.
+  TransferableTypedDataPeer(uint8_t* data, intptr_t length)
+      : data_(data), length_(length), handle_(NULL) {}
+  ~TransferableTypedDataPeer() { free(data_); }
+
+  uint8_t* data() const { return data_; }
+  intptr_t length() const { return length_; }
+  FinalizablePersistentHandle* handle() const { return handle_; }
+  void set_handle(FinalizablePersistentHandle* handle) { handle_ = handle; }
+
+  // Forgets the bytes after their ownership moved elsewhere and stops
+  // accounting them as external size of the current isolate.
+  void ClearData();
+
+ private:
+  uint8_t* data_;
+  intptr_t length_;
+  FinalizablePersistentHandle* handle_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransferableTypedDataPeer);
+};
+
+// A block of bytes that is passed between isolates by transferring ownership
+// instead of copying. Once sent or materialized, the object is empty.
+class TransferableTypedData : public Instance {
+ public:
+  TransferableTypedDataPeer* peer() const;
+
+  static intptr_t InstanceSize() {
+    return RoundedAllocationSize(sizeof(RawTransferableTypedData));
+  }
+  // Takes ownership of [data], which must be malloc'ed.
+  static RawTransferableTypedData* New(uint8_t* data,
+                                       intptr_t length,
+                                       Heap::Space space = Heap::kNew);
+
+ private:
+  FINAL_HEAP_OBJECT_IMPLEMENTATION(TransferableTypedData, Instance);
+  friend class Class;
+};
+
 // Internal stacktrace object used in exceptions for printing stack traces.
 class StackTrace : public Instance {
  public:
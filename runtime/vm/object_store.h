@@ -130,6 +130,8 @@ class ObjectPointerVisitor;
   RW(Array, obfuscation_map)                                                   \
   RW(GrowableObjectArray, type_testing_stubs)                                  \
   RW(GrowableObjectArray, changed_in_last_reload)                              \
+  RW(GrowableObjectArray, type_feedback)                                       \
+  RW(Array, code_order)                                                        \
 // Please remember the last entry must be referred in the 'to' function below.
 
 // The object store is a per isolate instance which stores references to
@@ -222,7 +224,7 @@ class ObjectStore {
                           DECLARE_OBJECT_STORE_FIELD)
 #undef DECLARE_OBJECT_STORE_FIELD
   RawObject** to() {
-    return reinterpret_cast<RawObject**>(&changed_in_last_reload_);
+    return reinterpret_cast<RawObject**>(&code_order_);
   }
   RawObject** to_snapshot(Snapshot::Kind kind) {
     switch (kind) {
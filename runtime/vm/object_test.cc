@@ -3041,6 +3041,47 @@ ISOLATE_UNIT_TEST_CASE(FieldTests) {
                String::Handle(Field::NameFromSetter(setter_f)).ToCString());
 }
 
+// Runtime stores into an unboxed int64 field install a box of their own, and
+// a value in the Smi range makes the field boxed again.
+TEST_CASE(Field_SetUnboxedInt64Field) {
+  const char* kScript =
+      "class A {\n"
+      "  int x;\n"
+      "  A(this.x);\n"
+      "}\n"
+      "make() => new A(0x4000000000000000);\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle result = Dart_Invoke(lib, NewString("make"), 0, NULL);
+  EXPECT_VALID(result);
+
+  TransitionNativeToVM transition(thread);
+  const Instance& instance =
+      Instance::Handle(Instance::RawCast(Api::UnwrapHandle(result)));
+  const Class& cls = Class::Handle(instance.clazz());
+  const Field& field = Field::Handle(
+      cls.LookupInstanceFieldAllowPrivate(String::Handle(String::New("x"))));
+  EXPECT(!field.IsNull());
+  EXPECT_EQ(kMintCid, field.guarded_cid());
+  EXPECT(!field.is_nullable());
+  EXPECT(field.is_unboxing_candidate());
+
+  Integer& value = Integer::Handle(Integer::New(kMaxInt64));
+  EXPECT(value.IsMint());
+  instance.SetField(field, value);
+  Object& stored = Object::Handle(instance.GetField(field));
+  EXPECT(stored.IsMint());
+  EXPECT(stored.raw() != value.raw());
+  EXPECT_EQ(kMaxInt64, Mint::Cast(stored).value());
+
+  value = Integer::New(5);
+  EXPECT(value.IsSmi());
+  instance.SetField(field, value);
+  EXPECT_EQ(kDynamicCid, field.guarded_cid());
+  stored = instance.GetField(field);
+  EXPECT(stored.raw() == value.raw());
+}
+
 // Expose helper function from object.cc for testing.
 bool EqualsIgnoringPrivate(const String& name, const String& private_name);
 
@@ -15,56 +15,124 @@
 namespace dart {
 
 Mutex* PortMap::mutex_ = NULL;
-PortMap::Entry* PortMap::map_ = NULL;
-MessageHandler* PortMap::deleted_entry_ = reinterpret_cast<MessageHandler*>(1);
-intptr_t PortMap::capacity_ = 0;
+PortMap::Map* PortMap::map_ = NULL;
+PortMap::Entry PortMap::deleted_entry_ = {ILLEGAL_PORT, NULL,
+                                          PortMap::kNewPort};
 intptr_t PortMap::used_ = 0;
 intptr_t PortMap::deleted_ = 0;
 Random* PortMap::prng_ = NULL;
 
-intptr_t PortMap::FindPort(Dart_Port port) {
-  // ILLEGAL_PORT (0) is used as a sentinel value in Entry.port. The loop below
-  // could return the index to a deleted port when we are searching for
-  // port id ILLEGAL_PORT. Return -1 immediately to indicate the port
-  // does not exist.
+// Lookups that don't take PortMap::mutex_ announce themselves in one of two
+// read epochs. To wait for the lookups in progress, a writer moves new
+// lookups to the other epoch and waits until no lookup is left in the old
+// one, once for each epoch. The counts are spread over cache line sized
+// stripes by thread, so that concurrent lookups don't contend on them.
+static const intptr_t kReaderStripes = 16;
+
+typedef struct {
+  intptr_t count[2];
+  uint8_t padding[64 - 2 * sizeof(intptr_t)];
+} ReaderCount;
+
+static ReaderCount reader_counts[kReaderStripes];
+static intptr_t read_epoch = 0;
+
+class PortMapReadScope : public ValueObject {
+ public:
+  PortMapReadScope() {
+    const intptr_t stripe =
+        Utils::WordHash(OSThread::ThreadIdToIntPtr(
+            OSThread::GetCurrentThreadId())) %
+        kReaderStripes;
+    epoch_ = AtomicOperations::LoadRelaxed(&read_epoch) & 1;
+    count_ = &reader_counts[stripe].count[epoch_];
+    // Full barrier: the map is read after the count is raised.
+    AtomicOperations::FetchAndIncrement(count_);
+  }
+
+  ~PortMapReadScope() { AtomicOperations::FetchAndDecrement(count_); }
+
+ private:
+  intptr_t epoch_;
+  intptr_t* count_;
+
+  DISALLOW_COPY_AND_ASSIGN(PortMapReadScope);
+};
+
+void PortMap::WaitForReaders() {
+  ASSERT(mutex_->IsOwnedByCurrentThread());
+  for (intptr_t i = 0; i < 2; i++) {
+    // Full barrier: the changes to the map are visible to the lookups that
+    // start after the epoch moves.
+    const intptr_t epoch = AtomicOperations::FetchAndIncrement(&read_epoch) & 1;
+    for (intptr_t stripe = 0; stripe < kReaderStripes; stripe++) {
+      intptr_t* count = &reader_counts[stripe].count[epoch];
+      while (AtomicOperations::LoadRelaxed(count) != 0) {
+        OS::SleepMicros(0);
+      }
+    }
+  }
+}
+
+PortMap::Entry* PortMap::FindEntry(Map* map, Dart_Port port, intptr_t* index) {
+  // ILLEGAL_PORT (0) is the port of deleted_entry_. Return NULL immediately
+  // to indicate the port does not exist.
   if (port == ILLEGAL_PORT) {
-    return -1;
+    return NULL;
   }
-  ASSERT(port != ILLEGAL_PORT);
-  intptr_t index = port % capacity_;
-  intptr_t start_index = index;
-  Entry entry = map_[index];
-  while (entry.handler != NULL) {
-    if (entry.port == port) {
-      return index;
+  intptr_t i = port % map->capacity;
+  intptr_t start_index = i;
+  Entry* entry = AtomicOperations::LoadRelaxed(&map->entries[i]);
+  while (entry != NULL) {
+    if (entry->port == port) {
+      if (index != NULL) {
+        *index = i;
+      }
+      return entry;
     }
-    index = (index + 1) % capacity_;
+    i = (i + 1) % map->capacity;
     // Prevent endless loops.
-    ASSERT(index != start_index);
-    entry = map_[index];
+    ASSERT(i != start_index);
+    entry = AtomicOperations::LoadRelaxed(&map->entries[i]);
   }
-  return -1;
+  return NULL;
 }
 
-void PortMap::Rehash(intptr_t new_capacity) {
-  Entry* new_ports = new Entry[new_capacity];
-  memset(new_ports, 0, new_capacity * sizeof(Entry));
+intptr_t PortMap::FindPort(Dart_Port port) {
+  ASSERT(mutex_->IsOwnedByCurrentThread());
+  intptr_t index = -1;
+  FindEntry(map_, port, &index);
+  return index;
+}
+
+PortMap::Map* PortMap::NewMap(intptr_t capacity) {
+  Map* map = new Map();
+  map->capacity = capacity;
+  map->entries = new Entry*[capacity];
+  memset(map->entries, 0, capacity * sizeof(Entry*));
+  return map;
+}
 
-  for (intptr_t i = 0; i < capacity_; i++) {
-    Entry entry = map_[i];
+void PortMap::Rehash(intptr_t new_capacity) {
+  Map* new_map = NewMap(new_capacity);
+  for (intptr_t i = 0; i < map_->capacity; i++) {
+    Entry* entry = map_->entries[i];
     // Skip free and deleted entries.
-    if (entry.port != 0) {
-      intptr_t new_index = entry.port % new_capacity;
-      while (new_ports[new_index].port != 0) {
+    if ((entry != NULL) && (entry != &deleted_entry_)) {
+      intptr_t new_index = entry->port % new_capacity;
+      while (new_map->entries[new_index] != NULL) {
         new_index = (new_index + 1) % new_capacity;
       }
-      new_ports[new_index] = entry;
+      new_map->entries[new_index] = entry;
     }
   }
-  delete[] map_;
-  map_ = new_ports;
-  capacity_ = new_capacity;
+  Map* old_map = map_;
+  AtomicOperations::CompareAndSwapPointer(&map_, old_map, new_map);
   deleted_ = 0;
+  // Lookups may still be probing the old table.
+  WaitForReaders();
+  delete[] old_map->entries;
+  delete old_map;
 }
 
 const char* PortMap::PortStateString(PortState kind) {
@@ -100,11 +168,12 @@ void PortMap::SetPortState(Dart_Port port, PortState state) {
   MutexLocker ml(mutex_);
   intptr_t index = FindPort(port);
   ASSERT(index >= 0);
-  PortState old_state = map_[index].state;
+  Entry* entry = map_->entries[index];
+  PortState old_state = entry->state;
   ASSERT(old_state == kNewPort);
-  map_[index].state = state;
+  entry->state = state;
   if (state == kLivePort) {
-    map_[index].handler->increment_live_ports();
+    entry->handler->increment_live_ports();
   }
   if (FLAG_trace_isolates) {
     OS::PrintErr(
@@ -112,19 +181,20 @@ void PortMap::SetPortState(Dart_Port port, PortState state) {
         "\thandler:    %s\n"
         "\tport:       %" Pd64 "\n",
         PortStateString(old_state), PortStateString(state),
-        map_[index].handler->name(), port);
+        entry->handler->name(), port);
   }
 }
 
 void PortMap::MaintainInvariants() {
-  intptr_t empty = capacity_ - used_ - deleted_;
-  if (used_ > ((capacity_ / 4) * 3)) {
+  const intptr_t capacity = map_->capacity;
+  intptr_t empty = capacity - used_ - deleted_;
+  if (used_ > ((capacity / 4) * 3)) {
     // Grow the port map.
-    Rehash(capacity_ * 2);
+    Rehash(capacity * 2);
   } else if (empty < deleted_) {
     // Rehash without growing the table to flush the deleted slots out of the
     // map.
-    Rehash(capacity_);
+    Rehash(capacity);
   }
 }
 
@@ -135,33 +205,31 @@ Dart_Port PortMap::CreatePort(MessageHandler* handler) {
   handler->CheckAccess();
 #endif
 
-  Entry entry;
-  entry.port = AllocatePort();
-  entry.handler = handler;
-  entry.state = kNewPort;
+  Entry* entry = new Entry();
+  entry->port = AllocatePort();
+  entry->handler = handler;
+  entry->state = kNewPort;
 
   // Search for the first unused slot. Make use of the knowledge that here is
   // currently no port with this id in the port map.
-  ASSERT(FindPort(entry.port) < 0);
-  intptr_t index = entry.port % capacity_;
-  Entry cur = map_[index];
+  ASSERT(FindPort(entry->port) < 0);
+  intptr_t index = entry->port % map_->capacity;
+  Entry* cur = map_->entries[index];
   // Stop the search at the first found unused (free or deleted) slot.
-  while (cur.port != 0) {
-    index = (index + 1) % capacity_;
-    cur = map_[index];
+  while ((cur != NULL) && (cur != &deleted_entry_)) {
+    index = (index + 1) % map_->capacity;
+    cur = map_->entries[index];
   }
 
   // Insert the newly created port at the index.
   ASSERT(index >= 0);
-  ASSERT(index < capacity_);
-  ASSERT(map_[index].port == 0);
-  ASSERT((map_[index].handler == NULL) ||
-         (map_[index].handler == deleted_entry_));
-  if (map_[index].handler == deleted_entry_) {
+  ASSERT(index < map_->capacity);
+  if (cur == &deleted_entry_) {
     // Consuming a deleted entry.
     deleted_--;
   }
-  map_[index] = entry;
+  // Full barrier: lookups that find the entry see it initialized.
+  AtomicOperations::CompareAndSwapPointer(&map_->entries[index], cur, entry);
 
   // Increment number of used slots and grow if necessary.
   used_++;
@@ -172,10 +240,10 @@ Dart_Port PortMap::CreatePort(MessageHandler* handler) {
         "[+] Opening port: \n"
         "\thandler:    %s\n"
         "\tport:       %" Pd64 "\n",
-        handler->name(), entry.port);
+        handler->name(), entry->port);
   }
 
-  return entry.port;
+  return entry->port;
 }
 
 bool PortMap::ClosePort(Dart_Port port) {
@@ -186,26 +254,29 @@ bool PortMap::ClosePort(Dart_Port port) {
     if (index < 0) {
       return false;
     }
-    ASSERT(index < capacity_);
-    ASSERT(map_[index].port != 0);
-    ASSERT(map_[index].handler != deleted_entry_);
-    ASSERT(map_[index].handler != NULL);
+    ASSERT(index < map_->capacity);
+    Entry* entry = map_->entries[index];
+    ASSERT(entry != &deleted_entry_);
+    ASSERT(entry->handler != NULL);
 
-    handler = map_[index].handler;
+    handler = entry->handler;
 #if defined(DEBUG)
     handler->CheckAccess();
 #endif
     // Before releasing the lock mark the slot in the map as deleted. This makes
     // it possible to release the port map lock before flushing all of its
     // pending messages below.
-    map_[index].port = 0;
-    map_[index].handler = deleted_entry_;
-    if (map_[index].state == kLivePort) {
+    map_->entries[index] = &deleted_entry_;
+    if (entry->state == kLivePort) {
       handler->decrement_live_ports();
     }
 
     used_--;
     deleted_++;
+    // Once the lookups that may have found the port are done, no message
+    // can be posted to it anymore.
+    WaitForReaders();
+    delete entry;
     MaintainInvariants();
   }
   handler->ClosePort(port);
@@ -219,60 +290,67 @@ bool PortMap::ClosePort(Dart_Port port) {
 void PortMap::ClosePorts(MessageHandler* handler) {
   {
     MutexLocker ml(mutex_);
-    for (intptr_t i = 0; i < capacity_; i++) {
-      if (map_[i].handler == handler) {
+    MallocGrowableArray<Entry*> closed;
+    for (intptr_t i = 0; i < map_->capacity; i++) {
+      Entry* entry = map_->entries[i];
+      if ((entry != NULL) && (entry->handler == handler)) {
         // Mark the slot as deleted.
-        map_[i].port = 0;
-        map_[i].handler = deleted_entry_;
-        if (map_[i].state == kLivePort) {
+        map_->entries[i] = &deleted_entry_;
+        if (entry->state == kLivePort) {
           handler->decrement_live_ports();
         }
+        closed.Add(entry);
         used_--;
         deleted_++;
       }
     }
+    WaitForReaders();
+    for (intptr_t i = 0; i < closed.length(); i++) {
+      delete closed[i];
+    }
     MaintainInvariants();
   }
   handler->CloseAllPorts();
 }
 
 bool PortMap::PostMessage(Message* message) {
-  MutexLocker ml(mutex_);
-  intptr_t index = FindPort(message->dest_port());
-  if (index < 0) {
+  PortMapReadScope read_scope;
+  Map* map = AtomicOperations::LoadRelaxed(&map_);
+  Entry* entry = FindEntry(map, message->dest_port(), NULL);
+  if (entry == NULL) {
     delete message;
     return false;
   }
-  ASSERT(index >= 0);
-  ASSERT(index < capacity_);
-  MessageHandler* handler = map_[index].handler;
-  ASSERT(map_[index].port != 0);
-  ASSERT((handler != NULL) && (handler != deleted_entry_));
+  MessageHandler* handler = entry->handler;
+  ASSERT(entry->port != 0);
+  ASSERT(handler != NULL);
   handler->PostMessage(message);
   return true;
 }
 
 bool PortMap::IsLocalPort(Dart_Port id) {
-  MutexLocker ml(mutex_);
-  intptr_t index = FindPort(id);
-  if (index < 0) {
+  PortMapReadScope read_scope;
+  Map* map = AtomicOperations::LoadRelaxed(&map_);
+  Entry* entry = FindEntry(map, id, NULL);
+  if (entry == NULL) {
     // Port does not exist.
     return false;
   }
 
-  MessageHandler* handler = map_[index].handler;
+  MessageHandler* handler = entry->handler;
   return handler->IsCurrentIsolate();
 }
 
 Isolate* PortMap::GetIsolate(Dart_Port id) {
-  MutexLocker ml(mutex_);
-  intptr_t index = FindPort(id);
-  if (index < 0) {
+  PortMapReadScope read_scope;
+  Map* map = AtomicOperations::LoadRelaxed(&map_);
+  Entry* entry = FindEntry(map, id, NULL);
+  if (entry == NULL) {
     // Port does not exist.
     return NULL;
   }
 
-  MessageHandler* handler = map_[index].handler;
+  MessageHandler* handler = entry->handler;
   return handler->isolate();
 }
 
@@ -283,9 +361,7 @@ void PortMap::InitOnce() {
   static const intptr_t kInitialCapacity = 8;
   // TODO(iposva): Verify whether we want to keep exponentially growing.
   ASSERT(Utils::IsPowerOfTwo(kInitialCapacity));
-  map_ = new Entry[kInitialCapacity];
-  memset(map_, 0, kInitialCapacity * sizeof(Entry));
-  capacity_ = kInitialCapacity;
+  map_ = NewMap(kInitialCapacity);
   used_ = 0;
   deleted_ = 0;
 }
@@ -302,13 +378,14 @@ void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
   {
     JSONArray ports(&jsobj, "ports");
     SafepointMutexLocker ml(mutex_);
-    for (intptr_t i = 0; i < capacity_; i++) {
-      if (map_[i].handler == handler) {
-        if (map_[i].state == kLivePort) {
+    for (intptr_t i = 0; i < map_->capacity; i++) {
+      Entry* entry = map_->entries[i];
+      if ((entry != NULL) && (entry->handler == handler)) {
+        if (entry->state == kLivePort) {
           JSONObject port(&ports);
           port.AddProperty("type", "_Port");
-          port.AddPropertyF("name", "Isolate Port (%" Pd64 ")", map_[i].port);
-          msg_handler = DartLibraryCalls::LookupHandler(map_[i].port);
+          port.AddPropertyF("name", "Isolate Port (%" Pd64 ")", entry->port);
+          msg_handler = DartLibraryCalls::LookupHandler(entry->port);
           port.AddProperty("handler", msg_handler);
         }
       }
@@ -320,11 +397,12 @@ void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
 void PortMap::DebugDumpForMessageHandler(MessageHandler* handler) {
   SafepointMutexLocker ml(mutex_);
   Object& msg_handler = Object::Handle();
-  for (intptr_t i = 0; i < capacity_; i++) {
-    if (map_[i].handler == handler) {
-      if (map_[i].state == kLivePort) {
-        OS::PrintErr("Live Port = %" Pd64 "\n", map_[i].port);
-        msg_handler = DartLibraryCalls::LookupHandler(map_[i].port);
+  for (intptr_t i = 0; i < map_->capacity; i++) {
+    Entry* entry = map_->entries[i];
+    if ((entry != NULL) && (entry->handler == handler)) {
+      if (entry->state == kLivePort) {
+        OS::PrintErr("Live Port = %" Pd64 "\n", entry->port);
+        msg_handler = DartLibraryCalls::LookupHandler(entry->port);
         OS::PrintErr("Handler = %s\n", msg_handler.ToCString());
       }
     }
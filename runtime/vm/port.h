@@ -66,14 +66,26 @@ class PortMap : public AllStatic {
 
   // Mapping between port numbers and handlers.
   //
-  // Free entries have id == 0 and handler == NULL. Deleted entries
-  // have id == 0 and handler == deleted_entry_.
+  // The map is an open addressing hash table of pointers to entries. Free
+  // slots are NULL and deleted slots point to deleted_entry_.
+  //
+  // PostMessage, IsLocalPort and GetIsolate look ports up without taking
+  // mutex_. All other operations take mutex_. They only change an entry
+  // that other threads may see by replacing the slot that points to it, and
+  // they replace the table as a whole when it is resized. Before they free
+  // a replaced entry or table, or return from closing a port, they wait for
+  // the lookups that may still see it (see WaitForReaders).
   typedef struct {
     Dart_Port port;
     MessageHandler* handler;
-    PortState state;
+    PortState state;  // Only accessed with mutex_ held.
   } Entry;
 
+  typedef struct {
+    intptr_t capacity;
+    Entry** entries;
+  } Map;
+
   static const char* PortStateString(PortState state);
 
   // Allocate a new unique port.
@@ -82,18 +94,24 @@ class PortMap : public AllStatic {
   static bool IsActivePort(Dart_Port id);
   static bool IsLivePort(Dart_Port id);
 
+  // Returns the entry of [port] in [map], or NULL if there is none. Sets
+  // [index] to the slot of the entry if given.
+  static Entry* FindEntry(Map* map, Dart_Port port, intptr_t* index);
   static intptr_t FindPort(Dart_Port port);
+  static Map* NewMap(intptr_t capacity);
   static void Rehash(intptr_t new_capacity);
 
   static void MaintainInvariants();
 
-  // Lock protecting access to the port map.
+  // Waits until all lookups that started before the call have completed.
+  static void WaitForReaders();
+
+  // Lock protecting changes to the port map.
   static Mutex* mutex_;
 
   // Hashmap of ports.
-  static Entry* map_;
-  static MessageHandler* deleted_entry_;
-  static intptr_t capacity_;
+  static Map* map_;
+  static Entry deleted_entry_;
   static intptr_t used_;
   static intptr_t deleted_;
 
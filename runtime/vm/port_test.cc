@@ -4,9 +4,11 @@
 
 #include "vm/port.h"
 #include "platform/assert.h"
+#include "vm/dart.h"
 #include "vm/lockers.h"
 #include "vm/message_handler.h"
 #include "vm/os.h"
+#include "vm/thread_pool.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -25,7 +27,7 @@ class PortMapTestPeer {
     if (index < 0) {
       return false;
     }
-    return PortMap::map_[index].state == PortMap::kLivePort;
+    return PortMap::map_->entries[index]->state == PortMap::kLivePort;
   }
 };
 
@@ -181,4 +183,71 @@ TEST_CASE(PortMap_PostMessageClosedPort) {
                   message_len, NULL, Message::kNormalPriority)));
 }
 
+class PortTestPostTask : public ThreadPool::Task {
+ public:
+  PortTestPostTask(Dart_Port port,
+                   intptr_t count,
+                   Monitor* monitor,
+                   intptr_t* done)
+      : port_(port), count_(count), monitor_(monitor), done_(done) {}
+
+  virtual void Run() {
+    for (intptr_t i = 0; i < count_; i++) {
+      EXPECT(PortMap::PostMessage(
+          new Message(port_, Smi::New(i), Message::kNormalPriority)));
+    }
+    MonitorLocker ml(monitor_);
+    ++*done_;
+    ml.Notify();
+  }
+
+ private:
+  Dart_Port port_;
+  intptr_t count_;
+  Monitor* monitor_;
+  intptr_t* done_;
+};
+
+// Posts messages from several threads while ports are created and closed,
+// so that lookups race with the port map being changed and resized.
+TEST_CASE(PortMap_ConcurrentPostMessage) {
+  const intptr_t kTasks = 4;
+  const intptr_t kMessages = 10000;
+  PortTestMessageHandler handlers[kTasks];
+  Dart_Port ports[kTasks];
+  for (intptr_t i = 0; i < kTasks; i++) {
+    ports[i] = PortMap::CreatePort(&handlers[i]);
+  }
+
+  Monitor monitor;
+  intptr_t done = 0;
+  for (intptr_t i = 0; i < kTasks; i++) {
+    Dart::thread_pool()->Run(
+        new PortTestPostTask(ports[i], kMessages, &monitor, &done));
+  }
+
+  PortTestMessageHandler churn_handler;
+  const intptr_t kChurnPorts = 64;
+  Dart_Port churn_ports[kChurnPorts];
+  bool finished = false;
+  while (!finished) {
+    for (intptr_t i = 0; i < kChurnPorts; i++) {
+      churn_ports[i] = PortMap::CreatePort(&churn_handler);
+    }
+    for (intptr_t i = 0; i < kChurnPorts; i += 2) {
+      EXPECT(PortMap::ClosePort(churn_ports[i]));
+    }
+    PortMap::ClosePorts(&churn_handler);
+    MonitorLocker ml(&monitor);
+    finished = (done == kTasks);
+  }
+
+  for (intptr_t i = 0; i < kTasks; i++) {
+    EXPECT_EQ(kMessages, handlers[i].notify_count);
+    PortMap::ClosePorts(&handlers[i]);
+    EXPECT(!PortMap::PostMessage(
+        new Message(ports[i], Smi::New(0), Message::kNormalPriority)));
+  }
+}
+
 }  // namespace dart
@@ -8,12 +8,18 @@
 #include "vm/dart.h"
 #include "vm/heap/become.h"
 #include "vm/heap/freelist.h"
+#include "vm/heap/pages.h"
 #include "vm/isolate.h"
 #include "vm/object.h"
 #include "vm/visitor.h"
 
 namespace dart {
 
+void RawObject::RememberCard(RawObject* const* slot) {
+  ASSERT(IsCardRemembered());
+  HeapPage::Of(this)->RememberCard(slot);
+}
+
 void RawObject::Validate(Isolate* isolate) const {
   if (Object::void_class_ == reinterpret_cast<RawClass*>(kHeapObjectTag)) {
     // Validation relies on properly initialized class classes. Skip if the
@@ -52,11 +58,11 @@ void RawObject::Validate(Isolate* isolate) const {
 // Can't look at the class object because it can be called during
 // compaction when the class objects are moving. Can use the class
 // id in the header and the sizes in the Class Table.
-intptr_t RawObject::SizeFromClass() const {
+intptr_t RawObject::SizeFromClass(uint32_t tags) const {
   // Only reasonable to be called on heap objects.
   ASSERT(IsHeapObject());
 
-  intptr_t class_id = GetClassId();
+  intptr_t class_id = ClassIdTag::decode(tags);
   intptr_t instance_size = 0;
   switch (class_id) {
     case kCodeCid: {
@@ -118,9 +124,9 @@ intptr_t RawObject::SizeFromClass() const {
       CLASS_LIST_TYPED_DATA(SIZE_FROM_CLASS) {
         const RawTypedData* raw_obj =
             reinterpret_cast<const RawTypedData*>(this);
-        intptr_t cid = raw_obj->GetClassId();
         intptr_t array_len = Smi::Value(raw_obj->ptr()->length_);
-        intptr_t lengthInBytes = array_len * TypedData::ElementSizeInBytes(cid);
+        intptr_t lengthInBytes =
+            array_len * TypedData::ElementSizeInBytes(class_id);
         instance_size = TypedData::InstanceSize(lengthInBytes);
         break;
       }
@@ -186,8 +192,7 @@ intptr_t RawObject::SizeFromClass() const {
       ClassTable* class_table = isolate->class_table();
       if (!class_table->IsValidIndex(class_id) ||
           !class_table->HasValidClassAt(class_id)) {
-        FATAL2("Invalid class id: %" Pd " from tags %x\n", class_id,
-               ptr()->tags_);
+        FATAL2("Invalid class id: %" Pd " from tags %x\n", class_id, tags);
       }
 #endif  // DEBUG
       instance_size = isolate->GetClassSizeForHeapWalkAt(class_id);
@@ -195,7 +200,6 @@ intptr_t RawObject::SizeFromClass() const {
   }
   ASSERT(instance_size != 0);
 #if defined(DEBUG)
-  uint32_t tags = ptr()->tags_;
   intptr_t tags_size = SizeTag::decode(tags);
   if ((class_id == kArrayCid) && (instance_size > tags_size && tags_size > 0)) {
     // TODO(22501): Array::MakeFixedLength could be in the process of shrinking
@@ -409,6 +413,7 @@ NULL_VISITOR(Float64x2)
 NULL_VISITOR(Bool)
 NULL_VISITOR(Capability)
 NULL_VISITOR(SendPort)
+NULL_VISITOR(TransferableTypedData)
 VARIABLE_NULL_VISITOR(Instructions, Instructions::Size(raw_obj))
 VARIABLE_NULL_VISITOR(PcDescriptors, raw_obj->ptr()->length_)
 VARIABLE_NULL_VISITOR(CodeSourceMap, raw_obj->ptr()->length_)
@@ -79,6 +79,7 @@ typedef RawObject* RawCompressed;
   V(Capability)                                                                \
   V(ReceivePort)                                                               \
   V(SendPort)                                                                  \
+  V(TransferableTypedData)                                                     \
   V(StackTrace)                                                                \
   V(RegExp)                                                                    \
   V(WeakProperty)                                                              \
@@ -292,8 +293,9 @@ class RawObject {
     kCanonicalBit = 1,
     kVMHeapObjectBit = 2,
     kRememberedBit = 3,
-    kReservedTagPos = 4,  // kReservedBit{10K,100K,1M,10M}
-    kReservedTagSize = 4,
+    kCardRememberedBit = 4,
+    kReservedTagPos = 5,  // kReservedBit{100K,1M,10M}
+    kReservedTagSize = 3,
     kSizeTagPos = kReservedTagPos + kReservedTagSize,  // = 8
     kSizeTagSize = 8,
     kClassIdTagPos = kSizeTagPos + kSizeTagSize,  // = 16
@@ -428,6 +430,19 @@ class RawObject {
   DART_WARN_UNUSED_RESULT
   bool TryAcquireRememberedBit() { return TryAcquireTagBit<RememberedBit>(); }
 
+  // Large old-space arrays are remembered per card of their heap page rather
+  // than as a whole, so a scavenge only rescans the parts of the array written
+  // since the last one. Barriers that do not know the slot still set the
+  // remembered bit, which makes the next scavenge rescan the whole array.
+  bool IsCardRemembered() const {
+    return CardRememberedBit::decode(ptr()->tags_);
+  }
+  void SetCardRememberedBit() {
+    ASSERT(IsOldObject());
+    ASSERT(!IsRemembered());
+    UpdateTagBit<CardRememberedBit>(true);
+  }
+
 #define DEFINE_IS_CID(clazz)                                                   \
   bool Is##clazz() const { return ((GetClassId() == k##clazz##Cid)); }
   CLASS_LIST(DEFINE_IS_CID)
@@ -489,6 +504,19 @@ class RawObject {
     return result;
   }
 
+  // Like Size, but decodes the given snapshot of the header instead of
+  // re-reading tags_, which a parallel scavenger may overwrite with a
+  // forwarding address at any time.
+  intptr_t HeapSize(uint32_t tags) const {
+    intptr_t result = SizeTag::decode(tags);
+    if (result != 0) {
+      return result;
+    }
+    result = SizeFromClass(tags);
+    ASSERT(result > SizeTag::kMaxSizeTag);
+    return result;
+  }
+
   bool Contains(uword addr) const {
     intptr_t this_size = Size();
     uword this_addr = RawObject::ToAddr(this);
@@ -589,6 +617,9 @@ class RawObject {
 
   class RememberedBit : public BitField<uint32_t, bool, kRememberedBit, 1> {};
 
+  class CardRememberedBit
+      : public BitField<uint32_t, bool, kCardRememberedBit, 1> {};
+
   class CanonicalObjectTag : public BitField<uint32_t, bool, kCanonicalBit, 1> {
   };
 
@@ -609,7 +640,8 @@ class RawObject {
   intptr_t VisitPointersPredefined(ObjectPointerVisitor* visitor,
                                    intptr_t class_id);
 
-  intptr_t SizeFromClass() const;
+  intptr_t SizeFromClass() const { return SizeFromClass(ptr()->tags_); }
+  intptr_t SizeFromClass(uint32_t tags) const;
 
   intptr_t GetClassId() const {
     uint32_t tags = ptr()->tags_;
@@ -639,6 +671,10 @@ class RawObject {
     return !TagBitField::decode(old_tags);
   }
 
+  // Dirties the card of the heap page covering 'slot'. Out of line because
+  // this header cannot see HeapPage.
+  void RememberCard(RawObject* const* slot);
+
   // All writes to heap objects should ultimately pass through one of the
   // methods below or their counterparts in Object, to ensure that the
   // write barrier is correctly applied.
@@ -648,9 +684,22 @@ class RawObject {
     *const_cast<type*>(addr) = value;
     // Filter stores based on source and target.
     if (!value->IsHeapObject()) return;
-    if (value->IsNewObject() && this->IsOldObject() && !this->IsRemembered()) {
-      this->SetRememberedBit();
-      Thread::Current()->StoreBufferAddObject(this);
+    if (value->IsNewObject()) {
+      if (this->IsOldObject() && !this->IsRemembered()) {
+        if (this->IsCardRemembered()) {
+          RememberCard(reinterpret_cast<RawObject* const*>(addr));
+        } else {
+          this->SetRememberedBit();
+          Thread::Current()->StoreBufferAddObject(this);
+        }
+      }
+    } else if (FLAG_concurrent_mark && !value->IsMarked()) {
+      // Insertion barrier: while marking runs concurrently, the marker must
+      // not miss an old object that is only reachable through this slot.
+      Thread* thread = Thread::Current();
+      if (thread->is_marking()) {
+        thread->MarkingStackAddObject(value);
+      }
     }
   }
 
@@ -695,7 +744,8 @@ class RawObject {
   friend class RawString;
   friend class RawTypedData;
   friend class Scavenger;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class SizeExcludingClassVisitor;  // GetClassId
   friend class InstanceAccumulator;        // GetClassId
   friend class RetainingPathVisitor;       // GetClassId
@@ -970,7 +1020,8 @@ class RawFunction : public RawObject {
   F(intptr_t, uint16_t, optimized_call_site_count)                             \
   F(int8_t, int8_t, deoptimization_counter)                                    \
   F(intptr_t, int8_t, state_bits)                                              \
-  F(int, int8_t, inlining_depth)
+  F(int, int8_t, inlining_depth)                                               \
+  F(int, int8_t, optimization_tier)
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
 #define DECLARE(return_type, type, name) type name##_;
@@ -2063,6 +2114,7 @@ class RawArray : public RawInstance {
   friend class LinkedHashMapSerializationCluster;
   friend class LinkedHashMapDeserializationCluster;
   friend class Deserializer;
+  friend class HeapPage;  // VisitRememberedCards
   friend class RawCode;
   friend class RawImmutableArray;
   friend class SnapshotReader;
@@ -2215,6 +2267,13 @@ class RawSendPort : public RawInstance {
   friend class ReceivePort;
 };
 
+// The bytes are owned by a TransferableTypedDataPeer stored as the object's
+// peer in the heap.
+class RawTransferableTypedData : public RawInstance {
+  RAW_HEAP_OBJECT_IMPLEMENTATION(TransferableTypedData);
+  VISIT_NOTHING();
+};
+
 class RawReceivePort : public RawInstance {
   RAW_HEAP_OBJECT_IMPLEMENTATION(ReceivePort);
 
@@ -2294,7 +2353,8 @@ class RawWeakProperty : public RawInstance {
   template <bool>
   friend class MarkingVisitorBase;
   friend class Scavenger;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
 };
 
 // MirrorReferences are used by mirrors to hold reflectees that are VM
@@ -2832,6 +2832,68 @@ void RawCapability::WriteTo(SnapshotWriter* writer,
   writer->Write<uint64_t>(ptr()->id_);
 }
 
+RawTransferableTypedData* TransferableTypedData::ReadFrom(
+    SnapshotReader* reader,
+    intptr_t object_id,
+    intptr_t tags,
+    Snapshot::Kind kind,
+    bool as_reference) {
+  ASSERT(reader != NULL);
+  ASSERT(kind == Snapshot::kMessage);
+  intptr_t length = reader->Read<int64_t>();
+
+  // Take over the bytes the sender handed to the message.
+  FinalizableData finalizable_data =
+      static_cast<MessageSnapshotReader*>(reader)->finalizable_data()->Take();
+  uint8_t* data = reinterpret_cast<uint8_t*>(finalizable_data.data);
+  TransferableTypedData& result = TransferableTypedData::ZoneHandle(
+      reader->zone(), TransferableTypedData::New(data, length));
+  reader->AddBackRef(object_id, &result, kIsDeserialized);
+  return result.raw();
+}
+
+// Detaches the bytes from the sending TransferableTypedData once the message
+// holding them is completely written.
+static void TransferableTypedDataHandOver(void* isolate_callback_data,
+                                          Dart_WeakPersistentHandle handle,
+                                          void* peer) {
+  reinterpret_cast<TransferableTypedDataPeer*>(peer)->ClearData();
+}
+
+void RawTransferableTypedData::WriteTo(SnapshotWriter* writer,
+                                       intptr_t object_id,
+                                       Snapshot::Kind kind,
+                                       bool as_reference) {
+  ASSERT(writer != NULL);
+  ASSERT(kind == Snapshot::kMessage);
+  TransferableTypedDataPeer* peer =
+      reinterpret_cast<TransferableTypedDataPeer*>(
+          writer->isolate()->heap()->GetPeer(this));
+  ASSERT(peer != NULL);
+  if (peer->data() == NULL) {
+    writer->SetWriteException(
+        Exceptions::kArgument,
+        "Illegal argument in isolate message"
+        " : (TransferableTypedData has been transferred already)");
+  }
+
+  // Write out the serialization header value for this object.
+  writer->WriteInlinedObjectHeader(object_id);
+
+  // Write out the class and tags information.
+  writer->WriteIndexedObject(kTransferableTypedDataCid);
+  writer->WriteTags(writer->GetObjectTags(this));
+
+  // The bytes are not copied. The sender keeps them until the message is
+  // completely written, and then they belong to the message.
+  writer->Write<int64_t>(peer->length());
+  static_cast<MessageWriter*>(writer)->finalizable_data()->Put(
+      peer->length(),
+      peer->data(),  // data
+      peer,          // peer
+      IsolateMessageTypedDataFinalizer, TransferableTypedDataHandOver);
+}
+
 RawReceivePort* ReceivePort::ReadFrom(SnapshotReader* reader,
                                       intptr_t object_id,
                                       intptr_t tags,
@@ -45,6 +45,11 @@ DEFINE_FLAG(int,
             reoptimization_counter_threshold,
             4000,
             "Counter threshold before a function gets reoptimized.");
+DEFINE_FLAG(int,
+            second_tier_counter_threshold,
+            -1,
+            "Invocation count of optimized code before it is reoptimized with "
+            "larger budgets, -1 means never");
 DEFINE_FLAG(bool, trace_deoptimization, false, "Trace deoptimization");
 DEFINE_FLAG(bool,
             trace_deoptimization_verbose,
@@ -225,6 +230,16 @@ DEFINE_RUNTIME_ENTRY(ArgumentErrorUnboxedInt64, 0) {
   Exceptions::ThrowArgumentError(value);
 }
 
+// Compiled code initializes the result of an allocation slow path without a
+// write barrier. If that result was allocated black because the old generation
+// is being marked concurrently, the marker has to revisit it.
+static void DeferMarkingIfAllocatedBlack(Thread* thread, const Object& obj) {
+  if (thread->is_marking() && obj.raw()->IsOldObject() &&
+      obj.raw()->IsMarked()) {
+    thread->isolate()->heap()->old_space()->DeferMarking(obj.raw());
+  }
+}
+
 // Allocation of a fixed length array of given element type.
 // This runtime entry is never called for allocating a List of a generic type,
 // because a prior run time call instantiates the element type if necessary.
@@ -245,6 +260,7 @@ DEFINE_RUNTIME_ENTRY(AllocateArray, 2) {
     const intptr_t len = Smi::Cast(length).Value();
     if ((len >= 0) && (len <= Array::kMaxElements)) {
       const Array& array = Array::Handle(Array::New(len, Heap::kNew));
+      DeferMarkingIfAllocatedBlack(thread, array);
       arguments.SetReturn(array);
       TypeArguments& element_type =
           TypeArguments::CheckedHandle(arguments.ArgAt(1));
@@ -294,6 +310,7 @@ DEFINE_RUNTIME_ENTRY(AllocateObject, 2) {
 #endif
   Heap::Space space = Heap::kNew;
   const Instance& instance = Instance::Handle(Instance::New(cls, space));
+  DeferMarkingIfAllocatedBlack(thread, instance);
 
   arguments.SetReturn(instance);
   if (cls.NumTypeArguments() == 0) {
@@ -441,7 +458,10 @@ DEFINE_RUNTIME_ENTRY(SubtypeCheck, 5) {
 // Return value: newly allocated context.
 DEFINE_RUNTIME_ENTRY(AllocateContext, 1) {
   const Smi& num_variables = Smi::CheckedHandle(zone, arguments.ArgAt(0));
-  arguments.SetReturn(Context::Handle(Context::New(num_variables.Value())));
+  const Context& context =
+      Context::Handle(zone, Context::New(num_variables.Value()));
+  DeferMarkingIfAllocatedBlack(thread, context);
+  arguments.SetReturn(context);
 }
 
 // Make a copy of the given context, including the values of the captured
@@ -4363,6 +4363,7 @@ void Service::PrintJSONForVM(JSONStream* js, bool ref) {
   jsobj.AddPropertyTimeMillis(
       "startTime", OS::GetCurrentTimeMillis() - Dart::UptimeMillis());
   MallocHooks::PrintToJSONObject(&jsobj);
+  IsolatePool::PrintJSON(&jsobj);
   PrintJSONForEmbedderInformation(&jsobj);
   // Construct the isolate list.
   {
@@ -1860,10 +1860,11 @@ void Simulator::DecodeLoadStoreReg(Instr* instr) {
           WriteX(address, vt_val, instr);
           break;
         case 4: {
+          // Like hardware, allow unaligned q register stores, which unaligned
+          // 128-bit StoreIndexed emits.
           simd_value_t val;
           get_vregister(vt, &val);
-          WriteX(address, val.bits.i64[0], instr);
-          WriteX(address + kWordSize, val.bits.i64[1], instr);
+          memmove(reinterpret_cast<void*>(address), &val, sizeof(val));
           break;
         }
         default:
@@ -1882,9 +1883,9 @@ void Simulator::DecodeLoadStoreReg(Instr* instr) {
           set_vregisterd(vt, 1, 0);
           break;
         case 4: {
+          // Like hardware, allow unaligned q register loads.
           simd_value_t val;
-          val.bits.i64[0] = ReadX(address, instr);
-          val.bits.i64[1] = ReadX(address + kWordSize, instr);
+          memmove(&val, reinterpret_cast<void*>(address), sizeof(val));
           set_vregister(vt, val);
           break;
         }
@@ -1681,6 +1681,7 @@ Message* MessageWriter::WriteMessage(const Object& obj,
     ThrowException(exception_type(), exception_msg());
   }
 
+  finalizable_data_->SerializationSucceeded();
   MessageFinalizableData* finalizable_data = finalizable_data_;
   finalizable_data_ = NULL;
   return new Message(dest_port, buffer(), BytesWritten(), finalizable_data,
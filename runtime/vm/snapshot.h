@@ -84,6 +84,7 @@ class RawStackMap;
 class RawStackTrace;
 class RawSubtypeTestCache;
 class RawTokenStream;
+class RawTransferableTypedData;
 class RawTwoByteString;
 class RawType;
 class RawTypeArguments;
@@ -782,6 +783,7 @@ class SnapshotWriter : public BaseWriter {
   friend class RawStackTrace;
   friend class RawSubtypeTestCache;
   friend class RawTokenStream;
+  friend class RawTransferableTypedData;
   friend class RawType;
   friend class RawTypeRef;
   friend class RawBoundedType;
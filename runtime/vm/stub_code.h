@@ -18,6 +18,13 @@ class RawCode;
 class SnapshotReader;
 class SnapshotWriter;
 
+// Only the x64 assembler emits the marking barrier of StoreIntoObject.
+#if defined(TARGET_ARCH_X64)
+#define VM_MARKING_STUB_CODE_LIST(V) V(UpdateMarkingStack)
+#else
+#define VM_MARKING_STUB_CODE_LIST(V)
+#endif
+
 // List of stubs created in the VM isolate, these stubs are shared by different
 // isolates running in this dart process.
 #if !defined(TARGET_ARCH_DBC)
@@ -27,6 +34,7 @@ class SnapshotWriter;
   V(RunExceptionHandler)                                                       \
   V(DeoptForRewind)                                                            \
   V(UpdateStoreBuffer)                                                         \
+  VM_MARKING_STUB_CODE_LIST(V)                                                 \
   V(PrintStopMessage)                                                          \
   V(AllocateArray)                                                             \
   V(AllocateContext)                                                           \
@@ -1286,6 +1286,48 @@ void StubCode::GenerateUpdateStoreBufferStub(Assembler* assembler) {
   __ ret();
 }
 
+// Helper stub to implement the marking barrier of Assembler::StoreIntoObject.
+// Input parameters:
+//   RDX: Old object being stored
+void StubCode::GenerateUpdateMarkingStackStub(Assembler* assembler) {
+  // Save registers being destroyed.
+  __ pushq(RAX);
+  __ pushq(RCX);
+
+  // Load the MarkingStack block out of the thread. Then load top_ out of the
+  // MarkingStackBlock and add the value to the pointers_.
+  // RDX: Old object being stored
+  __ movq(RAX, Address(THR, Thread::marking_stack_block_offset()));
+  __ movl(RCX, Address(RAX, MarkingStackBlock::top_offset()));
+  __ movq(Address(RAX, RCX, TIMES_8, MarkingStackBlock::pointers_offset()),
+          RDX);
+
+  // Increment top_ and check for overflow.
+  // RCX: top_
+  // RAX: MarkingStackBlock
+  Label overflow;
+  __ incq(RCX);
+  __ movl(Address(RAX, MarkingStackBlock::top_offset()), RCX);
+  __ cmpl(RCX, Immediate(MarkingStackBlock::kSize));
+  // Restore values.
+  __ popq(RCX);
+  __ popq(RAX);
+  __ j(EQUAL, &overflow, Assembler::kNearJump);
+  __ ret();
+
+  // Handle overflow: Call the runtime leaf function.
+  __ Bind(&overflow);
+  // Setup frame, push callee-saved registers.
+  __ pushq(CODE_REG);
+  __ movq(CODE_REG, Address(THR, Thread::update_marking_stack_code_offset()));
+  __ EnterCallRuntimeFrame(0);
+  __ movq(CallingConventions::kArg1Reg, THR);
+  __ CallRuntime(kMarkingStackBlockProcessRuntimeEntry, 1);
+  __ LeaveCallRuntimeFrame();
+  __ popq(CODE_REG);
+  __ ret();
+}
+
 // Called for inline allocation of objects.
 // Input parameters:
 //   RSP + 8 : type arguments object (only if class is parameterized).
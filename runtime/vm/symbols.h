@@ -231,6 +231,7 @@ class ObjectPointerVisitor;
   V(_CapabilityImpl, "_CapabilityImpl")                                        \
   V(_RawReceivePortImpl, "_RawReceivePortImpl")                                \
   V(_SendPortImpl, "_SendPortImpl")                                            \
+  V(_TransferableTypedDataImpl, "_TransferableTypedDataImpl")                  \
   V(_StackTrace, "_StackTrace")                                                \
   V(_RegExp, "_RegExp")                                                        \
   V(RegExp, "RegExp")                                                          \
@@ -66,6 +66,7 @@ Thread::Thread(Isolate* isolate)
       end_(0),
       top_exit_frame_info_(0),
       store_buffer_block_(NULL),
+      marking_stack_block_(NULL),
       vm_tag_(0),
       task_kind_(kUnknownTask),
       async_stack_trace_(StackTrace::null()),
@@ -76,6 +77,8 @@ Thread::Thread(Isolate* isolate)
       zone_(NULL),
       current_zone_capacity_(0),
       zone_high_watermark_(0),
+      old_top_(0),
+      old_end_(0),
       api_reusable_scope_(NULL),
       api_top_scope_(NULL),
       top_resource_(NULL),
@@ -288,6 +291,10 @@ const char* Thread::TaskKindToCString(TaskKind kind) {
       return "kSweeperTask";
     case kMarkerTask:
       return "kMarkerTask";
+    case kCompactorTask:
+      return "kCompactorTask";
+    case kScavengerTask:
+      return "kScavengerTask";
     default:
       UNREACHABLE();
       return "";
@@ -318,6 +325,9 @@ bool Thread::EnterIsolate(Isolate* isolate) {
     ASSERT(thread->store_buffer_block_ == NULL);
     thread->task_kind_ = kMutatorTask;
     thread->StoreBufferAcquire();
+    if (isolate->marking_stack() != NULL) {
+      thread->MarkingStackAcquire();
+    }
     return true;
   }
   return false;
@@ -334,6 +344,9 @@ void Thread::ExitIsolate() {
   // Clear since GC will not visit the thread once it is unscheduled.
   thread->ClearReusableHandles();
   thread->StoreBufferRelease();
+  if (thread->is_marking()) {
+    thread->MarkingStackRelease();
+  }
   if (isolate->is_runnable()) {
     thread->set_vm_tag(VMTag::kIdleTagId);
   } else {
@@ -356,6 +369,9 @@ bool Thread::EnterIsolateAsHelper(Isolate* isolate,
     // before Scavenge.
     thread->store_buffer_block_ =
         thread->isolate()->store_buffer()->PopEmptyBlock();
+    if (isolate->marking_stack() != NULL) {
+      thread->MarkingStackAcquire();
+    }
     // This thread should not be the main mutator.
     thread->task_kind_ = kind;
     ASSERT(!thread->IsMutatorThread());
@@ -373,6 +389,9 @@ void Thread::ExitIsolateAsHelper(bool bypass_safepoint) {
   // Clear since GC will not visit the thread once it is unscheduled.
   thread->ClearReusableHandles();
   thread->StoreBufferRelease();
+  if (thread->is_marking()) {
+    thread->MarkingStackRelease();
+  }
   Isolate* isolate = thread->isolate();
   ASSERT(isolate != NULL);
   const bool kIsNotMutatorThread = false;
@@ -588,6 +607,29 @@ void Thread::StoreBufferAcquire() {
   store_buffer_block_ = isolate()->store_buffer()->PopNonFullBlock();
 }
 
+void Thread::MarkingStackBlockProcess() {
+  MarkingStackRelease();
+  MarkingStackAcquire();
+}
+
+void Thread::MarkingStackAddObject(RawObject* obj) {
+  marking_stack_block_->Push(obj);
+  if (marking_stack_block_->IsFull()) {
+    MarkingStackBlockProcess();
+  }
+}
+
+void Thread::MarkingStackRelease() {
+  MarkingStackBlock* block = marking_stack_block_;
+  marking_stack_block_ = NULL;
+  isolate()->marking_stack()->PushBlock(block);
+}
+
+void Thread::MarkingStackAcquire() {
+  ASSERT(marking_stack_block_ == NULL);
+  marking_stack_block_ = isolate()->marking_stack()->PopEmptyBlock();
+}
+
 bool Thread::IsMutatorThread() const {
   return ((isolate_ != NULL) && (isolate_->mutator_thread() == this));
 }
@@ -78,12 +78,25 @@ class Zone;
   V(TypeArguments)                                                             \
   V(TypeParameter)
 
+#if defined(TARGET_ARCH_X64)
+#define CACHED_MARKING_STUBS_LIST(V)                                           \
+  V(RawCode*, update_marking_stack_code_,                                      \
+    StubCode::UpdateMarkingStack_entry()->code(), NULL)
+#define CACHED_MARKING_STUBS_ADDRESSES_LIST(V)                                 \
+  V(uword, update_marking_stack_entry_point_,                                  \
+    StubCode::UpdateMarkingStack_entry()->EntryPoint(), 0)
+#else
+#define CACHED_MARKING_STUBS_LIST(V)
+#define CACHED_MARKING_STUBS_ADDRESSES_LIST(V)
+#endif
+
 #if defined(TARGET_ARCH_DBC)
 #define CACHED_VM_STUBS_LIST(V)
 #else
 #define CACHED_VM_STUBS_LIST(V)                                                \
   V(RawCode*, update_store_buffer_code_,                                       \
     StubCode::UpdateStoreBuffer_entry()->code(), NULL)                         \
+  CACHED_MARKING_STUBS_LIST(V)                                                 \
   V(RawCode*, fix_callers_target_code_,                                        \
     StubCode::FixCallersTarget_entry()->code(), NULL)                          \
   V(RawCode*, fix_allocation_stub_code_,                                       \
@@ -140,6 +153,7 @@ class Zone;
 #define CACHED_VM_STUBS_ADDRESSES_LIST(V)                                      \
   V(uword, update_store_buffer_entry_point_,                                   \
     StubCode::UpdateStoreBuffer_entry()->EntryPoint(), 0)                      \
+  CACHED_MARKING_STUBS_ADDRESSES_LIST(V)                                       \
   V(uword, call_to_runtime_entry_point_,                                       \
     StubCode::CallToRuntime_entry()->EntryPoint(), 0)                          \
   V(uword, null_error_shared_without_fpu_regs_entry_point_,                    \
@@ -204,6 +218,7 @@ class Thread : public BaseThread {
     kMarkerTask = 0x4,
     kSweeperTask = 0x8,
     kCompactorTask = 0x10,
+    kScavengerTask = 0x20,
   };
   // Converts a TaskKind to its corresponding C-String name.
   static const char* TaskKindToCString(TaskKind kind);
@@ -419,6 +434,17 @@ class Thread : public BaseThread {
     return OFFSET_OF(Thread, store_buffer_block_);
   }
 
+  // Whether the write barrier must grey old objects stored into the heap,
+  // i.e., the old generation is being marked concurrently.
+  bool is_marking() const { return marking_stack_block_ != NULL; }
+  void MarkingStackAddObject(RawObject* obj);
+  void MarkingStackBlockProcess();
+  void MarkingStackAcquire();
+  void MarkingStackRelease();
+  static intptr_t marking_stack_block_offset() {
+    return OFFSET_OF(Thread, marking_stack_block_);
+  }
+
   uword top_exit_frame_info() const { return top_exit_frame_info_; }
   void set_top_exit_frame_info(uword top_exit_frame_info) {
     top_exit_frame_info_ = top_exit_frame_info;
@@ -452,6 +478,12 @@ class Thread : public BaseThread {
   static intptr_t top_offset() { return OFFSET_OF(Thread, top_); }
   static intptr_t end_offset() { return OFFSET_OF(Thread, end_); }
 
+  // Old-space allocation buffer (--old_gen_labs), managed by PageSpace.
+  uword old_top() const { return old_top_; }
+  uword old_end() const { return old_end_; }
+  void set_old_top(uword value) { old_top_ = value; }
+  void set_old_end(uword value) { old_end_ = value; }
+
   int32_t no_handle_scope_depth() const {
 #if defined(DEBUG)
     return no_handle_scope_depth_;
@@ -803,6 +835,7 @@ class Thread : public BaseThread {
   uword end_;
   uword top_exit_frame_info_;
   StoreBufferBlock* store_buffer_block_;
+  MarkingStackBlock* marking_stack_block_;
   uword vm_tag_;
   TaskKind task_kind_;
   RawStackTrace* async_stack_trace_;
@@ -832,6 +865,8 @@ class Thread : public BaseThread {
   Zone* zone_;
   uintptr_t current_zone_capacity_;
   uintptr_t zone_high_watermark_;
+  uword old_top_;
+  uword old_end_;
   ApiLocalScope* api_reusable_scope_;
   ApiLocalScope* api_top_scope_;
   StackResource* top_resource_;
@@ -4,6 +4,8 @@
 
 #include "vm/thread_registry.h"
 
+#include "vm/heap/heap.h"
+#include "vm/heap/pages.h"
 #include "vm/isolate.h"
 #include "vm/json_stream.h"
 #include "vm/lockers.h"
@@ -87,6 +89,37 @@ void ThreadRegistry::PrepareForGC() {
   }
 }
 
+void ThreadRegistry::AcquireMarkingStacks() {
+  MonitorLocker ml(threads_lock());
+  Thread* thread = active_list_;
+  while (thread != NULL) {
+    thread->MarkingStackAcquire();
+    thread = thread->next_;
+  }
+}
+
+void ThreadRegistry::ReleaseMarkingStacks() {
+  MonitorLocker ml(threads_lock());
+  Thread* thread = active_list_;
+  while (thread != NULL) {
+    if (thread->is_marking()) {
+      thread->MarkingStackRelease();
+    }
+    thread = thread->next_;
+  }
+}
+
+void ThreadRegistry::AbandonOldSpaceBuffers() {
+  MonitorLocker ml(threads_lock());
+  Thread* thread = active_list_;
+  while (thread != NULL) {
+    if (thread->old_top() < thread->old_end()) {
+      thread->heap()->old_space()->AbandonThreadLocalBuffer(thread);
+    }
+    thread = thread->next_;
+  }
+}
+
 #ifndef PRODUCT
 void ThreadRegistry::PrintJSON(JSONStream* stream) const {
   MonitorLocker ml(threads_lock());
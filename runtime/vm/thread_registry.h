@@ -32,6 +32,11 @@ class ThreadRegistry {
   void VisitObjectPointers(ObjectPointerVisitor* visitor,
                            ValidationPolicy validate_frames);
   void PrepareForGC();
+  // Turns the marking write barrier on or off for all scheduled threads.
+  void AcquireMarkingStacks();
+  void ReleaseMarkingStacks();
+  // Returns the old-space allocation buffers of all scheduled threads.
+  void AbandonOldSpaceBuffers();
   Thread* mutator_thread() const { return mutator_thread_; }
 
 #ifndef PRODUCT
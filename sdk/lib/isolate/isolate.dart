@@ -17,6 +17,7 @@
 library dart.isolate;
 
 import "dart:async";
+import "dart:typed_data" show ByteBuffer, TypedData, Uint8List;
 
 part "capability.dart";
 
@@ -730,3 +731,35 @@ class RemoteError implements Error {
         stackTrace = new StackTrace.fromString(stackDescription);
   String toString() => _description;
 }
+
+/**
+ * An efficiently transferable sequence of byte values.
+ *
+ * A [TransferableTypedData] is created from a number of bytes, which takes
+ * time proportional to the number of bytes. Sending it through a [SendPort]
+ * then takes constant time, because the bytes are moved to the receiving
+ * isolate instead of being copied.
+ *
+ * Once sent, the local [TransferableTypedData] can no longer be
+ * materialized, and the received object is the only way to access the data.
+ */
+abstract class TransferableTypedData {
+  /**
+   * Creates a new [TransferableTypedData] containing the bytes of [list].
+   *
+   * It must be possible to create a single [Uint8List] containing the bytes,
+   * so creation fails if there are more bytes than the platform allows in a
+   * single [Uint8List].
+   */
+  external factory TransferableTypedData.fromList(List<TypedData> list);
+
+  /**
+   * Creates a new [ByteBuffer] containing the bytes stored in this
+   * [TransferableTypedData] without copying them.
+   *
+   * The [TransferableTypedData] is a cross-isolate single-use resource. This
+   * method must not be called more than once on the same underlying bytes,
+   * and not after they have been sent to another isolate.
+   */
+  ByteBuffer materialize();
+}